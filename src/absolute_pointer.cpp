@@ -0,0 +1,138 @@
+// absolute_pointer.cpp — отображение ориентации на экран и перевод курсора хоста относительными отчетами
+#include "absolute_pointer.h"
+#include "motion_pipeline.h"
+#include <math.h>
+
+// Наименьший угловой размер прямоугольника (градусы): меньше — дрожание руки займет весь экран
+#define ABSOLUTE_MIN_SPAN 2.0f
+
+static inline float wrap_angle(float a)
+{
+  if (a >= 180.0f)
+    return a - 360.0f;
+  if (a < -180.0f)
+    return a + 360.0f;
+  return a;
+}
+
+bool absolute_pointer_config_valid(const AbsolutePointerConfig &cfg)
+{
+  if (!(fabsf(wrap_angle(cfg.right - cfg.left)) >= ABSOLUTE_MIN_SPAN) || !(fabsf(cfg.bottom - cfg.top) >= ABSOLUTE_MIN_SPAN))
+    return false;
+  if (!(fabsf(cfg.left) <= 180 && fabsf(cfg.right) <= 180 && fabsf(cfg.top) <= 180 && fabsf(cfg.bottom) <= 180))
+    return false;
+  return cfg.width > 0 && cfg.height > 0;
+}
+
+void absolute_pointer_home(AbsolutePointer &p, const AbsolutePointerConfig &cfg)
+{
+  p.x = 0;
+  p.y = 0;
+  p.homeX = -((int32_t)cfg.width + ABSOLUTE_HOME_MARGIN);
+  p.homeY = -((int32_t)cfg.height + ABSOLUTE_HOME_MARGIN);
+  p.homeWaitUs = p.homePeriodUs; // первый шаг — сразу
+}
+
+void absolute_pointer_begin(AbsolutePointer &p, const AbsolutePointerConfig &cfg, uint32_t homePeriodUs)
+{
+  p.primed = false;
+  p.homePeriodUs = homePeriodUs;
+  absolute_pointer_home(p, cfg);
+  p.offsetX = 0;
+  p.offsetY = 0;
+  one_euro_reset(p.filter);
+}
+
+// Доля прямоугольника 0..1 по оси. Прямоугольник может пересекать ±180 по рысканию
+static inline float fraction(float a, float from, float to)
+{
+  float u = wrap_angle(a - from) / wrap_angle(to - from);
+  return u < 0 ? 0 : (u > 1 ? 1 : u);
+}
+
+void absolute_pointer_map(const AbsolutePointer &p, const AbsolutePointerConfig &cfg, float angleX, float angleY, int32_t &x, int32_t &y)
+{
+  float u = fraction(wrap_angle(angleX + p.offsetX), cfg.left, cfg.right);
+  float v = fraction(wrap_angle(angleY + p.offsetY), cfg.top, cfg.bottom);
+  x = (int32_t)lrintf(u * (cfg.width - 1));
+  y = (int32_t)lrintf(v * (cfg.height - 1));
+}
+
+bool absolute_pointer_step(AbsolutePointer &p, const AbsolutePointerConfig &cfg, float angleX, float angleY, uint32_t dtUs, int32_t &dx, int32_t &dy)
+{
+  // Сглаживание — по приращениям угла, тем же фильтром, что и у курсора
+  if (!p.primed)
+  {
+    p.primed = true;
+    p.angleX = angleX;
+    p.angleY = angleY;
+  }
+  else
+  {
+    float fx = wrap_angle(angleX - p.rawX);
+    float fy = wrap_angle(angleY - p.rawY);
+    if (cfg.filter.enabled)
+    {
+      float scale = dtUs ? (float)MOTION_REF_PERIOD_US / dtUs : 1.0f;
+      float ax = fabsf(fx) * scale, ay = fabsf(fy) * scale;
+      one_euro_float(p.filter, cfg.filter, fx, fy, ax > ay ? ax + ay * 0.375f : ay + ax * 0.375f, dtUs);
+    }
+    p.angleX = wrap_angle(p.angleX + fx);
+    p.angleY = wrap_angle(p.angleY + fy);
+  }
+  p.rawX = angleX;
+  p.rawY = angleY;
+
+  // Упор в левый верхний угол: по отчету за период, пока не уйдет запас больше любого экрана
+  if (p.homeX || p.homeY)
+  {
+    p.homeWaitUs += dtUs;
+    if (p.homeWaitUs < p.homePeriodUs)
+      return false;
+    p.homeWaitUs -= p.homePeriodUs;
+    if (p.homeWaitUs >= p.homePeriodUs)
+      p.homeWaitUs = 0; // после долгого перерыва шаги не догоняют — иначе снова копится очередь отчетов
+    dx = p.homeX < -ABSOLUTE_HOME_STEP ? -ABSOLUTE_HOME_STEP : p.homeX;
+    dy = p.homeY < -ABSOLUTE_HOME_STEP ? -ABSOLUTE_HOME_STEP : p.homeY;
+    p.homeX -= dx;
+    p.homeY -= dy;
+    return true;
+  }
+
+  int32_t tx, ty;
+  absolute_pointer_map(p, cfg, p.angleX, p.angleY, tx, ty);
+  dx = tx - p.x;
+  dy = ty - p.y;
+  p.x = tx;
+  p.y = ty;
+  return dx || dy;
+}
+
+void absolute_pointer_recenter(AbsolutePointer &p, const AbsolutePointerConfig &cfg, float angleX, float angleY)
+{
+  float centerX = wrap_angle(cfg.left + wrap_angle(cfg.right - cfg.left) * 0.5f);
+  float centerY = (cfg.top + cfg.bottom) * 0.5f;
+  p.offsetX = wrap_angle(centerX - angleX);
+  p.offsetY = centerY - angleY;
+}
+
+bool absolute_calibration_capture(AbsoluteCalibration &c, AbsolutePointerConfig &cfg, float angleX, float angleY)
+{
+  if (c.step == 0)
+  {
+    c.left = angleX;
+    c.top = angleY;
+    c.step = 1;
+    return false;
+  }
+  c.step = 0;
+  AbsolutePointerConfig next = cfg;
+  next.left = c.left;
+  next.top = c.top;
+  next.right = angleX;
+  next.bottom = angleY;
+  if (!absolute_pointer_config_valid(next))
+    return false; // углы слишком близко — начинаем заново с левого верхнего
+  cfg = next;
+  return true;
+}
@@ -0,0 +1,73 @@
+// absolute_pointer.h — режим «лазерной указки»: ориентация пульта -> точка экрана через калиброванный прямоугольник
+#pragma once
+
+#include <stdint.h>
+#include "one_euro.h"
+
+// Запас при упоре в угол: курсор гарантированно доходит до края, даже если оценка экрана занижена
+#define ABSOLUTE_HOME_MARGIN 256
+// Не больше одного HID-отчета движения на шаг упора в угол
+#define ABSOLUTE_HOME_STEP 127
+
+// Параметры указки. Хранятся в /mouse.bin
+struct AbsolutePointerConfig
+{
+  float left;           // angleX, при котором пульт смотрит на левый край экрана (градусы)
+  float top;            // angleY на верхнем крае
+  float right;          // angleX на правом крае
+  float bottom;         // angleY на нижнем крае
+  uint16_t width;       // ширина экрана в отсчетах HID (при выключенном ускорении указателя хоста — пиксели)
+  uint16_t height;      // высота экрана
+  OneEuroConfig filter; // сглаживание дрожания руки: в абсолютном режиме оно видно сильнее, чем в относительном
+};
+
+struct AbsolutePointer
+{
+  bool primed;         // углы заданы
+  float rawX;          // углы прошлого отсчета до фильтра (градусы)
+  float rawY;
+  float angleX;        // отфильтрованные углы
+  float angleY;
+  float offsetX;       // поправка дрейфа рыскания после перецентровки
+  float offsetY;
+  int32_t x;           // оценка положения курсора хоста (отсчеты HID от левого верхнего угла)
+  int32_t y;
+  int32_t homeX;       // осталось отправить до упора в левый верхний угол (<= 0)
+  int32_t homeY;
+  uint32_t homePeriodUs; // шаг упора не чаще (интервал HID-отчетов): иначе планировщик отчетов сожмет накопленное
+  uint32_t homeWaitUs;   // прошло с прошлого шага упора
+  OneEuroState filter;
+};
+
+// Калибровка по двум углам экрана
+struct AbsoluteCalibration
+{
+  uint8_t step; // 0 — ждем левый верхний угол, 1 — правый нижний
+  float left;   // снятый левый верхний угол
+  float top;
+};
+
+// Прямоугольник не вырожден, экран задан
+bool absolute_pointer_config_valid(const AbsolutePointerConfig &cfg);
+
+// Вход в режим: курсор хоста сначала упирается в левый верхний угол, оттуда положение известно.
+// Шаги упора — не чаще homePeriodUs (0 — на каждом отсчете). Перецентровка сбрасывается
+void absolute_pointer_begin(AbsolutePointer &p, const AbsolutePointerConfig &cfg, uint32_t homePeriodUs);
+
+// Повторный упор в угол, когда оценка разошлась с курсором хоста (часть движения сжата или сброшена
+// при отключении). Перецентровка и фильтр сохраняются
+void absolute_pointer_home(AbsolutePointer &p, const AbsolutePointerConfig &cfg);
+
+// Точка экрана для углов (с учетом перецентровки), с ограничением по краям
+void absolute_pointer_map(const AbsolutePointer &p, const AbsolutePointerConfig &cfg, float angleX, float angleY, int32_t &x, int32_t &y);
+
+// Отсчет ориентации -> относительное смещение, которое переводит курсор хоста в нужную точку.
+// Возвращает true, если есть что отправить
+bool absolute_pointer_step(AbsolutePointer &p, const AbsolutePointerConfig &cfg, float angleX, float angleY, uint32_t dtUs, int32_t &dx, int32_t &dy);
+
+// Текущее направление пульта становится центром экрана (ушедшее рыскание без магнитометра)
+void absolute_pointer_recenter(AbsolutePointer &p, const AbsolutePointerConfig &cfg, float angleX, float angleY);
+
+// Снятие угла калибровки: сначала левый верхний, затем правый нижний.
+// Возвращает true, когда прямоугольник снят и записан в cfg; при вырожденном прямоугольнике начинает заново
+bool absolute_calibration_capture(AbsoluteCalibration &c, AbsolutePointerConfig &cfg, float angleX, float angleY);
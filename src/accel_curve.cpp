@@ -0,0 +1,124 @@
+// accel_curve.cpp — вычисление кривых ускорения и построение таблицы усиления
+#include "accel_curve.h"
+#include <math.h>
+
+#define ACCEL_GAIN_MAX 20.0f     // ограничение усиления
+#define ACCEL_VELOCITY_MAX 50.0f // ограничение скорости в параметрах
+
+static float clampf(float v, float lo, float hi)
+{
+  if (!(v >= lo)) // NaN тоже сюда
+    return lo;
+  return v > hi ? hi : v;
+}
+
+float accel_curve_eval(const AccelCurveConfig &curve, float velocity)
+{
+  float span = curve.maxGain - curve.minGain;
+  switch (curve.type)
+  {
+  case ACCEL_CURVE_STEP:
+    if (velocity > curve.threshold)
+      return curve.maxGain;
+    if (velocity < curve.param)
+      return curve.minGain;
+    return 1.0f;
+  case ACCEL_CURVE_LINEAR:
+    return curve.minGain + span * clampf(velocity / curve.threshold, 0, 1);
+  case ACCEL_CURVE_POWER:
+    return curve.minGain + span * clampf(powf(velocity / curve.threshold, curve.param), 0, 1);
+  case ACCEL_CURVE_SIGMOID:
+    return curve.minGain + span / (1.0f + expf(-(velocity - curve.threshold) / curve.param));
+  case ACCEL_CURVE_POINTS:
+  {
+    const AccelCurvePoint *p = curve.points;
+    uint8_t n = curve.pointCount;
+    if (velocity <= p[0].velocity)
+      return p[0].gain;
+    for (uint8_t i = 1; i < n; i++)
+    {
+      if (velocity <= p[i].velocity)
+      {
+        float t = (velocity - p[i - 1].velocity) / (p[i].velocity - p[i - 1].velocity);
+        return p[i - 1].gain + (p[i].gain - p[i - 1].gain) * t;
+      }
+    }
+    return p[n - 1].gain;
+  }
+  }
+  return 1.0f;
+}
+
+bool accel_curve_sanitize(AccelCurveConfig &curve)
+{
+  if (curve.type >= ACCEL_CURVE_COUNT)
+    return false;
+  curve.minGain = clampf(curve.minGain, 0, ACCEL_GAIN_MAX);
+  curve.maxGain = clampf(curve.maxGain, 0, ACCEL_GAIN_MAX);
+  curve.threshold = clampf(curve.threshold, 0.01f, ACCEL_VELOCITY_MAX);
+  switch (curve.type)
+  {
+  case ACCEL_CURVE_STEP:
+    curve.param = clampf(curve.param, 0, curve.threshold);
+    break;
+  case ACCEL_CURVE_POWER:
+    curve.param = clampf(curve.param, 0.1f, 5.0f);
+    break;
+  case ACCEL_CURVE_SIGMOID:
+    curve.param = clampf(curve.param, 0.01f, ACCEL_VELOCITY_MAX);
+    break;
+  case ACCEL_CURVE_POINTS:
+    if (curve.pointCount < 1 || curve.pointCount > ACCEL_CURVE_MAX_POINTS)
+      return false;
+    for (uint8_t i = 0; i < curve.pointCount; i++)
+    {
+      curve.points[i].velocity = clampf(curve.points[i].velocity, 0, ACCEL_VELOCITY_MAX);
+      curve.points[i].gain = clampf(curve.points[i].gain, 0, ACCEL_GAIN_MAX);
+    }
+    // Сортировка вставками по скорости, совпадающие скорости убираем
+    for (uint8_t i = 1; i < curve.pointCount; i++)
+    {
+      AccelCurvePoint p = curve.points[i];
+      int8_t j = i - 1;
+      while (j >= 0 && curve.points[j].velocity > p.velocity)
+      {
+        curve.points[j + 1] = curve.points[j];
+        j--;
+      }
+      curve.points[j + 1] = p;
+    }
+    {
+      uint8_t n = 1;
+      for (uint8_t i = 1; i < curve.pointCount; i++)
+        if (curve.points[i].velocity > curve.points[n - 1].velocity)
+          curve.points[n++] = curve.points[i];
+      curve.pointCount = n;
+    }
+    break;
+  }
+  return true;
+}
+
+void accel_curve_build_lut(const AccelCurveConfig &curve, float sensitivity, float lut[ACCEL_LUT_SIZE])
+{
+  for (int i = 0; i < ACCEL_LUT_SIZE; i++)
+    lut[i] = sensitivity * accel_curve_eval(curve, (i + 0.5f) * ACCEL_LUT_STEP);
+}
+
+const char *accel_curve_name(uint8_t type)
+{
+  switch (type)
+  {
+  case ACCEL_CURVE_STEP:
+    return "step";
+  case ACCEL_CURVE_LINEAR:
+    return "linear";
+  case ACCEL_CURVE_POWER:
+    return "power";
+  case ACCEL_CURVE_SIGMOID:
+    return "sigmoid";
+  case ACCEL_CURVE_POINTS:
+    return "points";
+  }
+  return "unknown";
+}
@@ -0,0 +1,49 @@
+// accel_curve.h — кривые ускорения указателя и таблица усиления по скорости
+#pragma once
+
+#include <stdint.h>
+
+// Таблица усиления: индекс — квантованная скорость (градусы за опорный период 10 мс)
+#define ACCEL_LUT_SIZE 64
+#define ACCEL_LUT_STEP 0.125f // шаг таблицы: 1/8 градуса, таблица покрывает 0..8 градусов за 10 мс
+#define ACCEL_LUT_SHIFT 13    // Q16.16 -> индекс: v >> 13 = v / ACCEL_LUT_STEP
+#define ACCEL_CURVE_MAX_POINTS 8
+
+enum AccelCurveType : uint8_t
+{
+  ACCEL_CURVE_STEP = 0,    // прежние ступени: точность / 1.0 / ускорение
+  ACCEL_CURVE_LINEAR = 1,  // линейный рост от minGain до maxGain на скорости threshold
+  ACCEL_CURVE_POWER = 2,   // степенной рост (v / threshold)^param
+  ACCEL_CURVE_SIGMOID = 3, // плавная ступень с центром threshold и шириной param
+  ACCEL_CURVE_POINTS = 4,  // кусочно-линейная по точкам пользователя
+  ACCEL_CURVE_COUNT
+};
+
+struct AccelCurvePoint
+{
+  float velocity; // градусы за 10 мс
+  float gain;     // множитель чувствительности
+};
+
+// Параметры кривой. Хранятся в /mouse.bin
+struct AccelCurveConfig
+{
+  uint8_t type;       // AccelCurveType
+  uint8_t pointCount; // точек для ACCEL_CURVE_POINTS
+  float minGain;      // усиление на малой скорости
+  float maxGain;      // усиление на большой скорости
+  float threshold;    // скорость (градусы за 10 мс): порог ускорения / конец роста / центр сигмоиды
+  float param;        // STEP: порог точности; POWER: показатель степени; SIGMOID: ширина перехода
+  AccelCurvePoint points[ACCEL_CURVE_MAX_POINTS];
+};
+
+// Усиление кривой для скорости v (без чувствительности)
+float accel_curve_eval(const AccelCurveConfig &curve, float velocity);
+
+// Проверка и нормализация параметров (ограничения, сортировка точек). false — кривая непригодна
+bool accel_curve_sanitize(AccelCurveConfig &curve);
+
+// Таблица sensitivity * gain(v) по центрам интервалов скорости
+void accel_curve_build_lut(const AccelCurveConfig &curve, float sensitivity, float lut[ACCEL_LUT_SIZE]);
+
+const char *accel_curve_name(uint8_t type);
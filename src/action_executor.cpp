@@ -0,0 +1,119 @@
+// action_executor.cpp — задания действий: шаг, ожидание срока, следующий шаг; задачу между шагами не держат
+#include "action_executor.h"
+#include <string.h>
+
+void action_exec_init(ActionExecutor &e)
+{
+  memset(&e, 0, sizeof(e));
+}
+
+int8_t action_exec_find(const ActionExecutor &e, uint8_t script)
+{
+  for (uint8_t i = 0; i < e.active; i++)
+    if (e.jobs[i].script == script)
+      return i;
+  return -1;
+}
+
+bool action_exec_start(ActionExecutor &e, uint8_t script, const ActionStep *steps, uint8_t count, uint32_t nowUs)
+{
+  if (!count || e.active >= ACTION_EXEC_JOBS)
+  {
+    e.stats.rejected++;
+    return false;
+  }
+  if (count > ACTION_EXEC_MAX_STEPS)
+    count = ACTION_EXEC_MAX_STEPS;
+
+  ActionJob &j = e.jobs[e.active++];
+  j.script = script;
+  j.count = count;
+  j.pc = 0;
+  j.inStep = false;
+  j.startUs = nowUs;
+  j.wakeUs = nowUs;
+  memcpy(j.steps, steps, count * sizeof(ActionStep));
+
+  e.stats.started++;
+  if (e.active > e.stats.maxActive)
+    e.stats.maxActive = e.active;
+  return true;
+}
+
+// Последнее задание на место удаленного: порядок заданий не важен
+static void remove_job(ActionExecutor &e, uint8_t i)
+{
+  if (i != e.active - 1)
+    e.jobs[i] = e.jobs[e.active - 1];
+  e.active--;
+}
+
+bool action_exec_cancel(ActionExecutor &e, uint8_t script, ActionStepFn fn, void *ctx)
+{
+  int8_t i = action_exec_find(e, script);
+  if (i < 0)
+    return false;
+  ActionJob &j = e.jobs[i];
+  if (j.inStep)
+    fn(ctx, j.steps[j.pc], true);
+  remove_job(e, i);
+  e.stats.cancelled++;
+  return true;
+}
+
+// Шаги одного задания до паузы или до конца. true — задание закончено
+static bool run_job(ActionJob &j, uint32_t nowUs, ActionStepFn fn, void *ctx)
+{
+  for (uint8_t n = 0; n < ACTION_EXEC_STEPS_PER_POLL;)
+  {
+    if ((int32_t)(nowUs - j.wakeUs) < 0)
+      return false;
+    if (j.inStep)
+    {
+      fn(ctx, j.steps[j.pc], true);
+      j.inStep = false;
+      j.pc++;
+    }
+    if (j.pc >= j.count)
+      return true;
+
+    uint32_t waitUs = fn(ctx, j.steps[j.pc], false);
+    n++;
+    if (waitUs)
+    {
+      // Срок — от текущего прохода: опоздание прохода не сокращает паузы и нажатия
+      j.inStep = true;
+      j.wakeUs = nowUs + waitUs;
+    }
+    else
+    {
+      j.pc++;
+    }
+  }
+  return false; // лимит шагов: продолжение на следующем проходе
+}
+
+uint32_t action_exec_poll(ActionExecutor &e, uint32_t nowUs, ActionStepFn fn, void *ctx)
+{
+  uint32_t nextUs = ACTION_EXEC_IDLE;
+  for (uint8_t i = 0; i < e.active;)
+  {
+    ActionJob &j = e.jobs[i];
+    if (run_job(j, nowUs, fn, ctx))
+    {
+      uint32_t jobUs = nowUs - j.startUs;
+      e.stats.finished++;
+      e.stats.lastJobUs = jobUs;
+      if (jobUs > e.stats.maxJobUs)
+        e.stats.maxJobUs = jobUs;
+      remove_job(e, i); // на место i встало последнее задание — i не увеличиваем
+      continue;
+    }
+    int32_t waitUs = (int32_t)(j.wakeUs - nowUs);
+    uint32_t wait = waitUs > 0 ? (uint32_t)waitUs : 0;
+    if (wait < nextUs)
+      nextUs = wait;
+    i++;
+  }
+  return nextUs;
+}
@@ -0,0 +1,62 @@
+// action_executor.h — выполнение действий и скриптов без delay(): задания-автоматы, шаги по таймеру, отмена, статистика
+#pragma once
+
+#include <stdint.h>
+
+#define ACTION_EXEC_JOBS 4            // одновременно выполняемых заданий (скриптов и одиночных действий)
+#define ACTION_EXEC_MAX_STEPS 64      // шагов в скрипте
+#define ACTION_EXEC_SINGLE 0xFF       // задание из одного действия, а не скрипт
+#define ACTION_EXEC_STEPS_PER_POLL 16 // мгновенных шагов задания за проход: скрипт без пауз не занимает задачу надолго
+#define ACTION_EXEC_IDLE 0xFFFFFFFFu  // action_exec_poll: ждать нечего
+
+// Шаг скрипта (поля как у ButtonAction, в файле скрипта — 5 байт)
+struct ActionStep
+{
+  uint8_t type; // ButtonActionType
+  int16_t code;
+  int16_t subCode;
+};
+
+// Начало шага (release = false) и его окончание (release = true).
+// При начале возвращает, через сколько мкс закончить шаг (нажатие клавиши, пауза); 0 — шаг мгновенный, окончания не будет
+typedef uint32_t (*ActionStepFn)(void *ctx, const ActionStep &step, bool release);
+
+struct ActionJob
+{
+  uint8_t script;   // номер скрипта или ACTION_EXEC_SINGLE
+  uint8_t count;    // шагов
+  uint8_t pc;       // текущий шаг
+  bool inStep;      // шаг начат и ждет окончания в wakeUs
+  uint32_t startUs; // запуск задания
+  uint32_t wakeUs;  // когда продолжать
+  ActionStep steps[ACTION_EXEC_MAX_STEPS];
+};
+
+struct ActionExecStats
+{
+  uint32_t started;
+  uint32_t finished;
+  uint32_t cancelled;
+  uint32_t rejected;  // нет свободного задания или нет шагов
+  uint32_t lastJobUs; // от запуска до последнего шага
+  uint32_t maxJobUs;
+  uint8_t maxActive;  // наибольшее число одновременных заданий
+};
+
+struct ActionExecutor
+{
+  ActionJob jobs[ACTION_EXEC_JOBS]; // занятые — первые active
+  uint8_t active;
+  ActionExecStats stats;
+};
+
+void action_exec_init(ActionExecutor &e);
+// Индекс задания скрипта или -1
+int8_t action_exec_find(const ActionExecutor &e, uint8_t script);
+// Новое задание: первый шаг — на ближайшем action_exec_poll. false — мест нет или count == 0 (stats.rejected).
+// Шаги сверх ACTION_EXEC_MAX_STEPS отбрасываются
+bool action_exec_start(ActionExecutor &e, uint8_t script, const ActionStep *steps, uint8_t count, uint32_t nowUs);
+// Остановка скрипта: начатый шаг сразу заканчивается (отпускание клавиши). false — скрипт не выполняется
+bool action_exec_cancel(ActionExecutor &e, uint8_t script, ActionStepFn fn, void *ctx);
+// Шаги всех заданий, чей срок наступил, по очереди. Возвращает время до ближайшего срока (мкс) или ACTION_EXEC_IDLE
+uint32_t action_exec_poll(ActionExecutor &e, uint32_t nowUs, ActionStepFn fn, void *ctx);
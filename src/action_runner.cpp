@@ -14,6 +14,8 @@
 #include "helpers.h"
 #include <ESPAsyncWebServer.h>
 #include "sleep_manager.h"
+#include "action_executor.h"
+#include "spsc_queue.h"
 
 byte active_layer = 0; // активный слой (по умолчанию 0)
 
@@ -30,158 +32,345 @@ void init_action_runner()
     LittleFS.mkdir("/scripts");
   }
 }
-void run_script_binary(uint8_t script_id);
+// === Исполнитель действий ===
+// Вывод в HID и скрипты выполняет отдельная задача: нажатия клавиш и паузы скриптов идут по таймеру
+// и не задерживают опрос кнопок. Слой и встроенные действия меняют состояние сразу — в вызывающей задаче.
+// Задача спит до запроса (уведомление задачи) или до срока ближайшего шага; без заданий не просыпается
 
-void run_action(uint8_t type, int32_t code, int32_t sub_code, bool is_script = false)
+struct ActionRequest
 {
+  ActionStep step;
+  uint32_t queuedUs; // постановка в очередь: время ожидания исполнителя
+};
+
+static SpscQueue<ActionRequest, ACTION_QUEUE_SIZE> actionQueue; // писатель — task_app, читатель — задача исполнителя
+static ActionExecutor actionExecutor;
+static ActionStep scriptSteps[ACTION_EXEC_MAX_STEPS]; // буфер чтения скрипта
+static uint32_t actionQueueMax;                     // наибольшая глубина очереди
+static uint32_t actionWaitMaxUs;                    // наибольшее ожидание в очереди
+static volatile bool actionResetPending;            // сброс статистики из веб-задачи: выполняет исполнитель
+static volatile bool layerLedsPending;              // слой сменился: цвета применяет task_app
+static TaskHandle_t volatile actionTask = nullptr;  // задача исполнителя: будится уведомлением
+static const uint32_t actionTickUs = portTICK_PERIOD_MS * 1000UL;
+
+static void wake_executor()
+{
+  if (actionTask)
+    xTaskNotifyGive(actionTask);
+}
+
+static void switch_layer(int32_t code)
+{
+  if (code < 0 || code >= MAX_LAYERS)
+    return;
+  active_layer = code;
+  layerLedsPending = true;
 #if DEBUG
-  Serial.printf("[ACT] Exec: type=%d code=%d sub_code=%d\n", type, code, sub_code);
+  Serial.printf("[ACT] Layer switch: -> %d\n", code);
 #endif
+}
 
-  if (type == ACTION_NONE)
+void update_layer_leds()
+{
+  if (!layerLedsPending)
+    return;
+  layerLedsPending = false;
+  apply_led_layer_colors();
+}
+
+// Мгновенные действия без вывода в HID
+static void run_instant_action(uint8_t type, int32_t code)
+{
+  if (type == ACTION_IR)
   {
-    if (is_script && code >= 0)
-    {
-      delay(code);
-    }
+    // send_ir_code(code);
     return;
   }
 
-  if (type == ACTION_KEYBOARD && is_hid_connected())
+  if (type == ACTION_LAYER_SWITCH)
   {
-    Keyboard.press(code);
-    delay(5);
-    Keyboard.release(code);
+    switch_layer(code);
     return;
   }
-  if (type == ACTION_MEDIA && is_hid_connected())
+
+  if (type == ACTION_ACTION)
   {
-    // Media keys
     switch (code)
     {
     case 0:
-      Keyboard.write(KEY_MEDIA_NEXT_TRACK);
+      ModeManager::setMode(MODE_WIFI);
+      ESP.restart();
       break;
     case 1:
-      Keyboard.write(KEY_MEDIA_PREVIOUS_TRACK);
+      ModeManager::setMode(MODE_BLE);
+      ESP.restart();
       break;
     case 2:
-      Keyboard.write(KEY_MEDIA_STOP);
+      ModeManager::toggleMode();
+      ESP.restart();
       break;
     case 3:
-      Keyboard.write(KEY_MEDIA_PLAY_PAUSE);
+      // learn_ir_code();
       break;
     case 4:
-      Keyboard.write(KEY_MEDIA_MUTE);
+      mouse_control_enable();
       break;
     case 5:
-      Keyboard.write(KEY_MEDIA_VOLUME_UP);
+      mouse_control_disable();
       break;
     case 6:
-      Keyboard.write(KEY_MEDIA_VOLUME_DOWN);
+      mouse_control_toggle();
       break;
     case 7:
-      Keyboard.write(KEY_MEDIA_WWW_HOME);
+      mouse_control_set_scroll(true); // удержание: hold -> 7, holdRelease -> 8
       break;
     case 8:
-      Keyboard.write(KEY_MEDIA_LOCAL_MACHINE_BROWSER);
+      mouse_control_set_scroll(false);
       break;
     case 9:
-      Keyboard.write(KEY_MEDIA_CALCULATOR);
+      mouse_control_toggle_scroll();
       break;
     case 10:
-      Keyboard.write(KEY_MEDIA_WWW_BOOKMARKS);
+      mouse_control_set_pointer(true);
       break;
     case 11:
-      Keyboard.write(KEY_MEDIA_WWW_SEARCH);
+      mouse_control_set_pointer(false);
       break;
     case 12:
-      Keyboard.write(KEY_MEDIA_WWW_STOP);
+      mouse_control_toggle_pointer();
       break;
     case 13:
-      Keyboard.write(KEY_MEDIA_WWW_BACK);
+      mouse_control_pointer_calibrate();
       break;
     case 14:
-      Keyboard.write(KEY_MEDIA_CONSUMER_CONTROL_CONFIGURATION);
-      break;
-    case 15:
-      Keyboard.write(KEY_MEDIA_EMAIL_READER);
-      break;
-    default:
+      mouse_control_pointer_recenter();
       break;
     }
     return;
   }
+}
 
-  if (type == ACTION_MOUSE_CLICK && is_hid_connected())
+static void send_media_key(int16_t code)
+{
+  switch (code)
   {
-    Mouse.click(code);
-    return;
+  case 0:
+    Keyboard.write(KEY_MEDIA_NEXT_TRACK);
+    break;
+  case 1:
+    Keyboard.write(KEY_MEDIA_PREVIOUS_TRACK);
+    break;
+  case 2:
+    Keyboard.write(KEY_MEDIA_STOP);
+    break;
+  case 3:
+    Keyboard.write(KEY_MEDIA_PLAY_PAUSE);
+    break;
+  case 4:
+    Keyboard.write(KEY_MEDIA_MUTE);
+    break;
+  case 5:
+    Keyboard.write(KEY_MEDIA_VOLUME_UP);
+    break;
+  case 6:
+    Keyboard.write(KEY_MEDIA_VOLUME_DOWN);
+    break;
+  case 7:
+    Keyboard.write(KEY_MEDIA_WWW_HOME);
+    break;
+  case 8:
+    Keyboard.write(KEY_MEDIA_LOCAL_MACHINE_BROWSER);
+    break;
+  case 9:
+    Keyboard.write(KEY_MEDIA_CALCULATOR);
+    break;
+  case 10:
+    Keyboard.write(KEY_MEDIA_WWW_BOOKMARKS);
+    break;
+  case 11:
+    Keyboard.write(KEY_MEDIA_WWW_SEARCH);
+    break;
+  case 12:
+    Keyboard.write(KEY_MEDIA_WWW_STOP);
+    break;
+  case 13:
+    Keyboard.write(KEY_MEDIA_WWW_BACK);
+    break;
+  case 14:
+    Keyboard.write(KEY_MEDIA_CONSUMER_CONTROL_CONFIGURATION);
+    break;
+  case 15:
+    Keyboard.write(KEY_MEDIA_EMAIL_READER);
+    break;
+  default:
+    break;
   }
+}
 
-  if (type == ACTION_IR)
+// Шаг задания исполнителя. Нажатие клавиши и пауза скрипта — шаги с окончанием по таймеру вместо delay()
+static uint32_t exec_step(void *ctx, const ActionStep &step, bool release)
+{
+  switch (step.type)
   {
-    // send_ir_code(code);
-    return;
+  case ACTION_NONE:
+    // Пауза скрипта (одиночное ACTION_NONE в очередь не попадает)
+    return !release && step.code > 0 ? step.code * 1000UL : 0;
+  case ACTION_KEYBOARD:
+    if (release)
+    {
+      Keyboard.release(step.code);
+      return 0;
+    }
+    if (!is_hid_connected())
+      return 0;
+    Keyboard.press(step.code);
+    return ACTION_KEY_PRESS_MS * 1000UL;
+  case ACTION_MEDIA:
+    if (is_hid_connected())
+      send_media_key(step.code);
+    return 0;
+  case ACTION_MOUSE_CLICK:
+    if (is_hid_connected())
+      mouse_report_click(step.code);
+    return 0;
+  case ACTION_MOUSE_MOVE:
+    if (is_hid_connected())
+      mouse_report_move(step.code, step.subCode);
+    return 0;
+  case ACTION_SCRIPT:
+    return 0; // скрипт из скрипта не запускается
+  default:
+    run_instant_action(step.type, step.code);
+    return 0;
   }
+}
 
-  if (type == ACTION_LAYER_SWITCH)
+// Шаги скрипта из /scripts/{id}.bin: строка названия, затем по 5 байт (тип, код, доп. код). Возвращает число шагов
+static uint8_t load_script(uint8_t script_id, ActionStep *steps)
+{
+  String path = "/scripts/" + String(script_id) + ".bin";
+  File file = LittleFS.open(path, "r");
+  if (!file)
   {
-    if (code < MAX_LAYERS)
-    {
-      active_layer = code;
+    Serial.printf("[SCRIPT] Failed to open: %s\n", path.c_str());
+    return 0;
+  }
+
+  // читаем имя скрипта (до \n)
+  String script_name = file.readStringUntil('\n');
 #if DEBUG
-      Serial.printf("[ACT] Layer switch: -> %d\n", code);
+  Serial.printf("[SCRIPT] Name: %s\n", script_name.c_str());
 #endif
-      apply_led_layer_colors();
-    }
+
+  uint8_t count = 0;
+  while (count < ACTION_EXEC_MAX_STEPS && file.available() >= 5)
+  {
+    ActionStep &step = steps[count++];
+    step.type = file.read();
+    file.readBytes((char *)&step.code, sizeof(step.code));
+    file.readBytes((char *)&step.subCode, sizeof(step.subCode));
+  }
+  file.close();
+  return count;
+}
+
+// Запрос из очереди: скрипт запускается, а выполняющийся — останавливается; остальное — задание из одного шага
+static void start_request(const ActionRequest &req, uint32_t nowUs)
+{
+  if (req.step.type != ACTION_SCRIPT)
+  {
+    action_exec_start(actionExecutor, ACTION_EXEC_SINGLE, &req.step, 1, nowUs);
     return;
   }
-  uint8_t mode = ModeManager::getMode();
+  if (req.step.code < 0 || req.step.code >= ACTION_EXEC_SINGLE)
+    return;
+  uint8_t script_id = req.step.code;
+  if (action_exec_cancel(actionExecutor, script_id, exec_step, nullptr))
+  {
+#if DEBUG
+    Serial.printf("[SCRIPT] Stopped: %u\n", script_id);
+#endif
+    return;
+  }
+  uint8_t count = load_script(script_id, scriptSteps);
+  if (action_exec_start(actionExecutor, script_id, scriptSteps, count, nowUs))
+  {
+#if DEBUG
+    Serial.printf("[SCRIPT] Started: %u (%u steps)\n", script_id, count);
+#endif
+  }
+}
 
-  if (type == ACTION_ACTION)
+// Проход исполнителя: запросы из очереди, затем шаги заданий, чей срок наступил.
+// Возвращает время до ближайшего срока (мкс) или ACTION_EXEC_IDLE
+static uint32_t action_executor_loop()
+{
+  if (actionResetPending)
   {
-    switch (code)
+    actionResetPending = false;
+    memset(&actionExecutor.stats, 0, sizeof(actionExecutor.stats));
+    actionQueueMax = 0;
+    actionWaitMaxUs = 0;
+  }
+
+  uint32_t depth = spsc_size(actionQueue);
+  if (depth > actionQueueMax)
+    actionQueueMax = depth;
+
+  ActionRequest req;
+  while (spsc_pop(actionQueue, req))
+  {
+    uint32_t now = micros();
+    if (now - req.queuedUs > actionWaitMaxUs)
+      actionWaitMaxUs = now - req.queuedUs;
+    start_request(req, now);
+  }
+  return action_exec_poll(actionExecutor, micros(), exec_step, nullptr);
+}
+
+void action_executor_run()
+{
+  actionTask = xTaskGetCurrentTaskHandle();
+  for (;;)
+  {
+    uint32_t waitUs = action_executor_loop();
+    TickType_t ticks = portMAX_DELAY; // заданий нет — до следующего запроса
+    if (waitUs != ACTION_EXEC_IDLE)
     {
-    case 0:
-      ModeManager::setMode(MODE_WIFI);
-      ESP.restart();
-      break;
-    case 1:
-      ModeManager::setMode(MODE_BLE);
-      ESP.restart();
-      break;
-    case 2:
-      ModeManager::toggleMode();
-      ESP.restart();
-      break;
-    case 3:
-      // learn_ir_code();
-      break;
-    case 4:
-      mouse_control_enable();
-      break;
-    case 5:
-      mouse_control_disable();
-      break;
-    case 6:
-      mouse_control_toggle();
-      break;
+      ticks = (waitUs + actionTickUs - 1) / actionTickUs;
+      if (!ticks)
+        ticks = 1; // остались мгновенные шаги: продолжение через тик, task_app не голодает
     }
-    return;
+    // Запрос, пришедший после разбора очереди, оставляет уведомление — ожидание закончится сразу
+    ulTaskNotifyTake(pdTRUE, ticks);
   }
+}
 
-  if (type == ACTION_MOUSE_MOVE && is_hid_connected())
+void run_action(uint8_t type, int32_t code, int32_t sub_code)
+{
+#if DEBUG
+  Serial.printf("[ACT] Exec: type=%d code=%d sub_code=%d\n", type, code, sub_code);
+#endif
+
+  if (type == ACTION_NONE)
+    return;
+
+  if (type == ACTION_IR || type == ACTION_LAYER_SWITCH || type == ACTION_ACTION)
   {
-    Mouse.move(code, sub_code);
+    run_instant_action(type, code);
+    update_layer_leds();
     return;
   }
 
-  if (type == ACTION_SCRIPT && not is_script)
+  ActionRequest req = {{type, (int16_t)code, (int16_t)sub_code}, (uint32_t)micros()};
+  if (!spsc_push(actionQueue, req))
   {
-    run_script_binary(code);
+#if DEBUG
+    Serial.printf("[ACT] Queue full, dropped: type=%d code=%d\n", type, code);
+#endif
     return;
   }
+  wake_executor();
 }
 
 void run_button_action(uint8_t index, ButtonActionKind kind)
@@ -195,39 +384,54 @@ void run_button_action(uint8_t index, ButtonActionKind kind)
 #endif
 
   const ButtonAction &action = get_button_action(active_layer, index, kind);
-  run_action(action.type, action.code, action.sub_code, false);
+  run_action(action.type, action.code, action.sub_code);
 }
 
-void run_script_binary(uint8_t script_id)
+void run_tap_dance_action(uint8_t index, const TapDanceEntry &entry)
 {
-  String path = "/scripts/" + String(script_id) + ".bin";
-  File file = LittleFS.open(path, "r");
-  if (!file)
-  {
-    Serial.printf("[SCRIPT] Failed to open: %s\n", path.c_str());
+  if (index >= NUM_DEFAULT_KEYS)
     return;
-  }
+  resetSleepTimer();
 
-  // читаем имя скрипта (до \n)
-  String script_name = file.readStringUntil('\n');
-  Serial.printf("[SCRIPT] Name: %s\n", script_name.c_str());
+#if DEBUG
+  Serial.printf("[ACT] Tap dance action: index=%d taps=%d hold=%d\n", index, entry.taps, entry.hold);
+#endif
 
-  while (file.available() >= 3)
+  run_action(entry.type, entry.code, entry.subCode);
+}
+
+void run_combo_action(const ComboEntry &combo)
+{
+  resetSleepTimer();
+
+#if DEBUG
+  Serial.printf("[ACT] Combo action: keys=%u+%u type=%d\n", combo.keys[0], combo.keys[1], combo.type);
+#endif
+
+  run_action(combo.type, combo.code, combo.subCode);
+}
+
+void run_gesture_actions()
+{
+  uint8_t gestures = mouse_control_take_gestures();
+  for (uint8_t g = 0; gestures; g++, gestures >>= 1)
   {
-    // читаем действие
-    // 1 байт - тип действия
-    // 2 байта - код действия
-    // 2 байта - доп код действия
-    uint8_t action_id = file.read();
-    int16_t param = 0;
-    // читаем 2 байта
-    file.readBytes((char *)&param, sizeof(param));
-    // читаем 2 байта
-    int16_t param2 = 0;
-    run_action(action_id, param, param2, true);
+    if (!(gestures & 1))
+      continue;
+    const ButtonAction action = get_gesture_action(active_layer, g);
+    if (action.type == ACTION_NONE)
+      continue;
+    resetSleepTimer();
+#if DEBUG
+    Serial.printf("[ACT] Gesture action: %s\n", gesture_name(g));
+#endif
+    run_action(action.type, action.code, action.sub_code);
   }
+}
 
-  file.close();
+void run_script_binary(uint8_t script_id)
+{
+  run_action(ACTION_SCRIPT, script_id, 0);
 }
 
 String get_media_key_list()
@@ -262,7 +466,15 @@ String get_action_list()
   // json += "{\"id\":3,\"name\":\"IR learn\"},";
   json += "{\"id\":4,\"name\":\"Mouse control on\"},";
   json += "{\"id\":5,\"name\":\"Mouse control off\"},";
-  json += "{\"id\":6,\"name\":\"Mouse control toggle\"}";
+  json += "{\"id\":6,\"name\":\"Mouse control toggle\"},";
+  json += "{\"id\":7,\"name\":\"Tilt scroll on\"},";
+  json += "{\"id\":8,\"name\":\"Tilt scroll off\"},";
+  json += "{\"id\":9,\"name\":\"Tilt scroll toggle\"},";
+  json += "{\"id\":10,\"name\":\"Pointer mode on\"},";
+  json += "{\"id\":11,\"name\":\"Pointer mode off\"},";
+  json += "{\"id\":12,\"name\":\"Pointer mode toggle\"},";
+  json += "{\"id\":13,\"name\":\"Pointer calibrate corner\"},";
+  json += "{\"id\":14,\"name\":\"Pointer recenter\"}";
   json += "]";
   return json;
 }
@@ -358,8 +570,42 @@ bool delete_script(const String &filename)
   return LittleFS.remove(path);
 }
 
+// Статистику пишет задача исполнителя; для диагностики рваное чтение отдельных счетчиков допустимо
+static String action_executor_json()
+{
+  const ActionExecStats &s = actionExecutor.stats;
+  String json = "{";
+  json += "\"queue\":" + String(spsc_size(actionQueue)) + ",";
+  json += "\"queueSize\":" + String(ACTION_QUEUE_SIZE) + ",";
+  json += "\"queueMax\":" + String(actionQueueMax) + ",";
+  json += "\"dropped\":" + String(actionQueue.dropped) + ",";
+  json += "\"maxWaitUs\":" + String(actionWaitMaxUs) + ",";
+  json += "\"active\":" + String(actionExecutor.active) + ",";
+  json += "\"maxActive\":" + String(s.maxActive) + ",";
+  json += "\"started\":" + String(s.started) + ",";
+  json += "\"finished\":" + String(s.finished) + ",";
+  json += "\"cancelled\":" + String(s.cancelled) + ",";
+  json += "\"rejected\":" + String(s.rejected) + ",";
+  json += "\"lastJobUs\":" + String(s.lastJobUs) + ",";
+  json += "\"maxJobUs\":" + String(s.maxJobUs) + "}";
+  return json;
+}
+
 void register_action_api(AsyncWebServer &server)
 {
+  // GET — очередь и задания исполнителя; POST reset=1 — сброс статистики (dropped не сбрасывается)
+  server.on("/api/executor", HTTP_GET, [](AsyncWebServerRequest *request)
+            { request->send(200, "application/json", action_executor_json()); });
+
+  server.on("/api/executor", HTTP_POST, [](AsyncWebServerRequest *request)
+            {
+    if (request->hasParam("reset", true) && request->getParam("reset", true)->value().toInt())
+    {
+      actionResetPending = true;
+      wake_executor();
+    }
+    request->send(200, "application/json", action_executor_json()); });
+
   server.on("/api/scripts/delete", HTTP_POST, [](AsyncWebServerRequest *request)
             {
   if (!request->hasParam("name", true)) {
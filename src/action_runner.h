@@ -13,12 +13,29 @@ void init_action_runner();
 // Запуск действия по кнопке
 void run_button_action(uint8_t index, ButtonActionKind kind);
 
-// Запуск действия напрямую (для скриптов и других вызовов)
+// Запуск действия серии нажатий кнопки (запись уже найдена для активного слоя)
+void run_tap_dance_action(uint8_t index, const TapDanceEntry &entry);
+
+// Запуск действия сработавшего сочетания кнопок
+void run_combo_action(const ComboEntry &combo);
+
+// Запуск действий распознанных жестов (по активному слою)
+void run_gesture_actions();
+
+// Запуск действия напрямую. Слой и встроенные действия выполняются сразу, вывод в HID и скрипты —
+// через очередь в задаче исполнителя. Вызывать только из task_app (единственный писатель очереди)
 void run_action(uint8_t type, int32_t code, int32_t sub_code);
 
-// Выполнение бинарного скрипта из файла /scripts/{id}.bin
+// Запуск бинарного скрипта из файла /scripts/{id}.bin; повторный запуск выполняющегося скрипта его останавливает
 void run_script_binary(uint8_t script_id);
 
+// Бесконечный цикл задачи исполнителя: запросы из очереди и шаги заданий; между ними сон
+// до уведомления о запросе или до срока ближайшего шага
+void action_executor_run();
+
+// task_app: цвета слоя, смененного скриптом
+void update_layer_leds();
+
 // Получить текущий активный слой
 byte get_active_layer();
 
@@ -33,7 +33,7 @@ enum HardwareKeyIndex
 struct HardwareKeyConfig
 {
   HardwareKeyIndex source; // MCP, GPIO
-  uint8_t sourceIndex;     // Индекс MCP (0–1) или GPIO ()
+  uint8_t sourceIndex;     // Индекс MCP (0–7) или GPIO ()
   uint8_t pin;             // Номер пина (0–15 для MCP, или GPIO номер)
   Side side;               // SIDE_KEYBOARD / SIDE_MOUSE / SIDE_BOTH
   int8_t ledIndex;         // Индекс светодиода (или -1 если не используется)
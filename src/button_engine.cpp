@@ -0,0 +1,258 @@
+// button_engine.cpp — вертикальный антидребезг и автомат клик / двойной / удержание по слотам активных кнопок
+#include "button_engine.h"
+#include <string.h>
+
+#define BUTTON_SLOT_ONE_CLICK 0x01 // нажатие без удержания — при отпускании будет CLICK
+#define BUTTON_SLOT_HELD 0x02      // было HOLD_START
+#define BUTTON_SLOT_STEP 0x04      // идут шаги удержания
+
+// Отсчетов подряд до засчитанного нажатия: первый отсчет + debounceMs
+static uint8_t debounce_samples(const ButtonTiming &t, uint16_t debounceMs)
+{
+  uint16_t tick = t.tickMs ? t.tickMs : 1;
+  uint16_t samples = debounceMs / tick + 1;
+  return samples > BUTTON_ENGINE_MAX_DEBOUNCE ? BUTTON_ENGINE_MAX_DEBOUNCE : samples;
+}
+
+static uint16_t key_debounce_ms(const ButtonEngine &e, uint8_t key)
+{
+  return e.keyTiming && e.keyTiming[key].debounceMs ? e.keyTiming[key].debounceMs : e.timing.debounceMs;
+}
+
+static uint16_t key_hold_ms(const ButtonEngine &e, uint8_t key)
+{
+  return e.keyTiming && e.keyTiming[key].holdMs ? e.keyTiming[key].holdMs : e.timing.holdMs;
+}
+
+static uint16_t key_click_timeout_ms(const ButtonEngine &e, uint8_t key)
+{
+  return e.keyTiming && e.keyTiming[key].clickTimeoutMs ? e.keyTiming[key].clickTimeoutMs : e.timing.clickTimeoutMs;
+}
+
+void button_engine_init(ButtonEngine &e, const ButtonTiming &timing, uint8_t keys)
+{
+  memset(&e, 0, sizeof(e));
+  e.timing = timing;
+  e.keys = keys > KEY_SNAPSHOT_BITS ? KEY_SNAPSHOT_BITS : keys;
+  uint16_t words = (e.keys + 31) / 32;
+  e.words = words > KEY_SNAPSHOT_WORDS ? KEY_SNAPSHOT_WORDS : words;
+  button_engine_set_key_timing(e, nullptr);
+}
+
+void button_engine_set_key_timing(ButtonEngine &e, const ButtonKeyTiming *keyTiming)
+{
+  e.keyTiming = keyTiming;
+  for (uint8_t p = 0; p < 3; p++)
+    key_bits_clear(e.threshold[p]);
+  for (uint8_t key = 0; key < e.keys; key++)
+  {
+    uint8_t n = debounce_samples(e.timing, key_debounce_ms(e, key));
+    for (uint8_t p = 0; p < 3; p++)
+      if (n & (1 << p))
+        key_bits_set(e.threshold[p], key);
+  }
+}
+
+void button_engine_set_defer_click(ButtonEngine &e, const KeyBits &keys)
+{
+  e.deferClick = keys;
+}
+
+// Порог антидребезга кнопки из разрядов threshold
+static uint8_t key_samples(const ButtonEngine &e, uint8_t key)
+{
+  return key_bits_test(e.threshold[0], key) | key_bits_test(e.threshold[1], key) << 1 |
+         key_bits_test(e.threshold[2], key) << 2;
+}
+
+void button_engine_sync(ButtonEngine &e, const KeyBits &raw)
+{
+  e.state = raw;
+  for (uint8_t p = 0; p < 3; p++)
+    key_bits_clear(e.count[p]);
+  e.active = 0;
+}
+
+void button_engine_cancel(ButtonEngine &e, const KeyBits &keys)
+{
+  uint8_t kept = 0;
+  for (uint8_t i = 0; i < e.active; i++)
+    if (!key_bits_test(keys, e.slots[i].key))
+      e.slots[kept++] = e.slots[i];
+  e.active = kept;
+}
+
+static int8_t find_slot(const ButtonEngine &e, uint8_t key)
+{
+  for (uint8_t i = 0; i < e.active; i++)
+    if (e.slots[i].key == key)
+      return i;
+  return -1;
+}
+
+// Новый слот на своем месте по возрастанию key
+static ButtonSlot *insert_slot(ButtonEngine &e, uint8_t key)
+{
+  if (e.active >= BUTTON_ENGINE_SLOTS)
+    return nullptr;
+  uint8_t pos = e.active;
+  while (pos && e.slots[pos - 1].key > key)
+  {
+    e.slots[pos] = e.slots[pos - 1];
+    pos--;
+  }
+  e.active++;
+  ButtonSlot &s = e.slots[pos];
+  memset(&s, 0, sizeof(s));
+  s.key = key;
+  return &s;
+}
+
+static int lowest(const KeyBits &b)
+{
+  KeyBits copy = b;
+  return key_bits_pop(copy);
+}
+
+// Автомат одной кнопки за отсчет: порядок шагов и событий — как у GyverButton
+// (антидребезг -> отпускание -> удержание -> конец серии кликов; события CLICK, DOUBLE, HOLD_START, шаги, RELEASE).
+// Кнопка из deferClick получает CLICK не при отпускании, а по концу серии из одного клика.
+// Конец серии из 3+ кликов — TAPS, удержание после кликов — HOLD_START с их числом.
+// Возвращает false, когда кнопка отпущена и серия кликов закончена — слот больше не нужен
+static bool tick_slot(ButtonEngine &e, ButtonSlot &s, bool raw, bool started, bool confirmed, bool released,
+                      uint32_t now, ButtonEventFn emit, void *ctx)
+{
+  const ButtonTiming &t = e.timing;
+  uint8_t key = s.key;
+  bool defer = key_bits_test(e.deferClick, key);
+  if (started)
+    s.timerMs = now; // новое нажатие откладывает конец серии кликов
+  if (confirmed)
+    s.flags |= BUTTON_SLOT_ONE_CLICK;
+
+  bool wasHeld = false;
+  if (released)
+  {
+    wasHeld = s.flags & BUTTON_SLOT_HELD;
+    if (!wasHeld && s.clicks < 0xFF)
+      s.clicks++;
+    s.timerMs = now;
+    if (s.flags & BUTTON_SLOT_STEP)
+      s.clicks = 0; // серия закончилась удержанием
+    if ((s.flags & BUTTON_SLOT_ONE_CLICK) && !defer)
+      emit(ctx, key, BUTTON_EVENT_CLICK, s.clicks);
+    s.flags = 0;
+  }
+
+  bool pressed = raw && key_bits_test(e.state, key);
+  if (pressed && !(s.flags & BUTTON_SLOT_HELD) && now - s.timerMs >= key_hold_ms(e, key))
+  {
+    s.flags = BUTTON_SLOT_HELD | BUTTON_SLOT_STEP;
+    s.timerMs = now;
+    emit(ctx, key, BUTTON_EVENT_HOLD_START, s.clicks);
+  }
+
+  if (!raw && s.clicks && now - s.timerMs >= key_click_timeout_ms(e, key))
+  {
+    if (s.clicks == 1 && defer)
+      emit(ctx, key, BUTTON_EVENT_CLICK, s.clicks);
+    else if (s.clicks == 2)
+      emit(ctx, key, BUTTON_EVENT_DOUBLE, s.clicks);
+    else if (s.clicks >= 3)
+      emit(ctx, key, BUTTON_EVENT_TAPS, s.clicks);
+    s.clicks = 0;
+  }
+
+  if (raw && (s.flags & BUTTON_SLOT_STEP) && s.clicks <= 1 && now - s.timerMs >= t.stepMs)
+  {
+    s.timerMs = now;
+    emit(ctx, key, s.clicks ? BUTTON_EVENT_ONE_CLICK_HOLD : BUTTON_EVENT_HOLD_REPEAT, s.clicks);
+  }
+
+  if (released)
+    emit(ctx, key, wasHeld ? BUTTON_EVENT_HOLD_RELEASE : BUTTON_EVENT_RELEASE, s.clicks);
+
+  return pressed || s.clicks;
+}
+
+void button_engine_tick(ButtonEngine &e, const KeyBits &raw, uint32_t nowMs, ButtonEventFn emit, void *ctx)
+{
+  // === Антидребезг всех кнопок сразу ===
+  // Нажатие засчитывается, когда счетчик дошел до порога кнопки, отпускание — сразу
+  KeyBits started, confirmed, released;
+  uint32_t busy = 0, anyReleased = 0;
+  for (uint8_t w = 0; w < e.words; w++)
+  {
+    uint32_t c0 = e.count[0].w[w], c1 = e.count[1].w[w], c2 = e.count[2].w[w];
+    uint32_t cand = raw.w[w] & ~e.state.w[w];
+    started.w[w] = cand & ~(c0 | c1 | c2);
+
+    // +1 там, где нажатие продолжается, 0 — где прервалось
+    uint32_t carry0 = c0 & cand, carry1 = c1 & carry0;
+    c0 = ~c0 & cand;
+    c1 = (c1 ^ carry0) & cand;
+    c2 = (c2 ^ carry1) & cand;
+
+    uint32_t reached =
+        cand & ~((c0 ^ e.threshold[0].w[w]) | (c1 ^ e.threshold[1].w[w]) | (c2 ^ e.threshold[2].w[w]));
+    confirmed.w[w] = reached;
+    released.w[w] = e.state.w[w] & ~raw.w[w];
+    e.state.w[w] = (e.state.w[w] | reached) & raw.w[w];
+    e.count[0].w[w] = c0 & ~reached;
+    e.count[1].w[w] = c1 & ~reached;
+    e.count[2].w[w] = c2 & ~reached;
+    busy |= reached;
+    anyReleased |= released.w[w];
+  }
+  if (!busy && !anyReleased && !e.active)
+    return; // ничего не нажато и не ждет таймера
+  for (uint8_t w = e.words; w < KEY_SNAPSHOT_WORDS; w++)
+    started.w[w] = confirmed.w[w] = released.w[w] = 0;
+
+  // === Новые нажатия получают слот; время — с первого отсчета нажатия ===
+  int key;
+  if (busy)
+  {
+    KeyBits fresh = confirmed;
+    while ((key = key_bits_pop(fresh)) >= 0)
+    {
+      if (find_slot(e, key) >= 0)
+        continue;
+      ButtonSlot *s = insert_slot(e, key);
+      if (s)
+        s->timerMs = nowMs - (uint32_t)(key_samples(e, key) - 1) * e.timing.tickMs;
+      else
+        e.overflow++;
+    }
+  }
+
+  // Отпущенные без слота (нажаты до старта или слоты кончились) — только RELEASE
+  KeyBits loose = released;
+  bool anyLoose = false;
+  if (anyReleased)
+  {
+    for (uint8_t i = 0; i < e.active; i++)
+      key_bits_clear_bit(loose, e.slots[i].key);
+    anyLoose = key_bits_any(loose);
+  }
+
+  // === Таймеры только активных кнопок, по порядку кнопок ===
+  uint8_t kept = 0;
+  for (uint8_t i = 0; i < e.active; i++)
+  {
+    ButtonSlot s = e.slots[i];
+    uint8_t k = s.key, w = k >> 5;
+    uint32_t bit = 1u << (k & 31);
+    while (anyLoose && (key = lowest(loose)) >= 0 && key < k)
+    {
+      key_bits_clear_bit(loose, key);
+      emit(ctx, key, BUTTON_EVENT_RELEASE, 0);
+    }
+    if (tick_slot(e, s, raw.w[w] & bit, started.w[w] & bit, confirmed.w[w] & bit, released.w[w] & bit, nowMs, emit,
+                  ctx))
+      e.slots[kept++] = s;
+  }
+  e.active = kept;
+  while (anyLoose && (key = key_bits_pop(loose)) >= 0)
+    emit(ctx, key, BUTTON_EVENT_RELEASE, 0);
+}
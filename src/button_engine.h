@@ -0,0 +1,78 @@
+// button_engine.h — антидребезг и события кнопок сразу по всему снимку: вертикальные счетчики + таймеры только активных кнопок
+#pragma once
+
+#include <stdint.h>
+#include "key_snapshot.h"
+
+#define BUTTON_ENGINE_SLOTS 8           // одновременно активных кнопок (нажата или ждет двойного клика)
+#define BUTTON_ENGINE_MAX_DEBOUNCE 7    // отсчетов антидребезга (3-битный счетчик)
+
+// Коды 0..6 совпадают с ButtonActionKind
+enum ButtonEngineEvent : uint8_t
+{
+  BUTTON_EVENT_CLICK = 0,          // отпускание без удержания; у кнопок из deferClick — одиночный клик после паузы
+  BUTTON_EVENT_DOUBLE = 1,         // ровно два клика, после паузы clickTimeoutMs
+  BUTTON_EVENT_HOLD_START = 2,     // нажата дольше holdMs
+  BUTTON_EVENT_HOLD_REPEAT = 3,    // каждые stepMs удержания без предшествующего клика
+  BUTTON_EVENT_HOLD_RELEASE = 4,   // отпускание после удержания
+  BUTTON_EVENT_ONE_CLICK_HOLD = 5, // каждые stepMs удержания после одного клика
+  BUTTON_EVENT_RELEASE = 6,        // отпускание без удержания
+  BUTTON_EVENT_TAPS = 7            // серия из 3 и более кликов, после паузы clickTimeoutMs
+};
+
+struct ButtonTiming
+{
+  uint16_t debounceMs;     // нажатие засчитывается, если держится столько (отпускание — сразу)
+  uint16_t holdMs;         // от начала нажатия до HOLD_START
+  uint16_t clickTimeoutMs; // пауза после отпускания, завершающая серию кликов
+  uint16_t stepMs;         // период HOLD_REPEAT / ONE_CLICK_HOLD
+  uint16_t tickMs;         // период вызова button_engine_tick
+};
+
+// Времена отдельной кнопки; 0 — общее значение из ButtonTiming
+struct ButtonKeyTiming
+{
+  uint16_t debounceMs;
+  uint16_t holdMs;
+  uint16_t clickTimeoutMs;
+};
+
+// Таймер и счетчик кликов кнопки, пока она активна
+struct ButtonSlot
+{
+  uint8_t key;
+  uint8_t clicks;   // кликов в текущей серии
+  uint8_t flags;    // BUTTON_SLOT_*
+  uint32_t timerMs; // начало нажатия, отпускание, удержание или последний шаг
+};
+
+struct ButtonEngine
+{
+  ButtonTiming timing;
+  const ButtonKeyTiming *keyTiming; // по кнопке (nullptr — у всех общие)
+  uint8_t keys;
+  uint8_t words;              // слов снимка с кнопками
+  KeyBits state;              // нажатые после антидребезга
+  KeyBits count[3];           // вертикальный счетчик: разряды числа нажатых отсчетов подряд, пока нажатие не засчитано
+  KeyBits threshold[3];       // разряды порога антидребезга (отсчетов) по кнопкам
+  KeyBits deferClick;         // CLICK только после паузы серии: у кнопки есть двойной клик или клик+удержание
+  ButtonSlot slots[BUTTON_ENGINE_SLOTS]; // по возрастанию key: события идут в порядке кнопок
+  uint8_t active;             // занятых слотов (первые active)
+  uint32_t overflow;          // нажатий без свободного слота (только RELEASE)
+};
+
+// Событие кнопки key; taps — кликов в серии на момент события (у HOLD_START — кликов перед удержанием)
+typedef void (*ButtonEventFn)(void *ctx, uint8_t key, uint8_t event, uint8_t taps);
+
+// keys — число кнопок (биты 0..keys-1 снимка)
+void button_engine_init(ButtonEngine &e, const ButtonTiming &timing, uint8_t keys);
+// Свои времена кнопок: keyTiming — массив на keys кнопок, живет дольше движка (nullptr — общие)
+void button_engine_set_key_timing(ButtonEngine &e, const ButtonKeyTiming *keyTiming);
+// Кнопки с отложенным CLICK. Остальные получают CLICK сразу при отпускании, не дожидаясь возможного второго клика
+void button_engine_set_defer_click(ButtonEngine &e, const KeyBits &keys);
+// Забыть таймеры и серии кликов кнопок (их нажатие поглотило сочетание): до отпускания событий нет, при отпускании — только RELEASE
+void button_engine_cancel(ButtonEngine &e, const KeyBits &keys);
+// Принять текущее состояние без событий (старт): нажатые кнопки считаются давно нажатыми
+void button_engine_sync(ButtonEngine &e, const KeyBits &raw);
+// Один отсчет: raw — бит 1 — кнопка нажата (уже с маской стороны)
+void button_engine_tick(ButtonEngine &e, const KeyBits &raw, uint32_t nowMs, ButtonEventFn emit, void *ctx);
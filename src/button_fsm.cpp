@@ -4,91 +4,286 @@
 #include "config_storage.h"
 #include "button_service.h"
 #include "action_runner.h"
-#include <GyverButton.h>
+#include "button_engine.h"
+#include "tap_dance.h"
+#include "combo.h"
 
-GButton gbtn[NUM_DEFAULT_KEYS];
-bool onHold[NUM_DEFAULT_KEYS] = {false}; // массив для хранения состояния удержания кнопок
+// События движка передаются в run_button_action как есть
+static_assert((uint8_t)BUTTON_EVENT_CLICK == BUTTON_CLICK &&
+                  (uint8_t)BUTTON_EVENT_DOUBLE == BUTTON_DOUBLE &&
+                  (uint8_t)BUTTON_EVENT_HOLD_START == BUTTON_HOLD_START &&
+                  (uint8_t)BUTTON_EVENT_HOLD_REPEAT == BUTTON_HOLD_REPEAT &&
+                  (uint8_t)BUTTON_EVENT_HOLD_RELEASE == BUTTON_HOLD_RELEASE &&
+                  (uint8_t)BUTTON_EVENT_ONE_CLICK_HOLD == BUTTON_ONE_CLICK_HOLD &&
+                  (uint8_t)BUTTON_EVENT_RELEASE == BUTTON_RELEASE,
+              "События движка кнопок должны совпадать с ButtonActionKind");
+
+static const ButtonTiming buttonTiming = {BUTTON_DEBOUNCE_MS, BUTTON_HOLD_MS, BUTTON_CLICK_TIMEOUT_MS, BUTTON_STEP_MS,
+                                          SCHED_APP_PERIOD_US / 1000};
+static ButtonEngine buttonEngine;
+static ButtonKeyTiming engineKeyTiming[NUM_DEFAULT_KEYS]; // копия конфигурации: веб-задача пишет в свою
+static TapDanceState tapDanceState;
+static ComboTable comboTable; // скомпилирована из конфигурации при ее смене
+static ComboMatcher comboMatcher;
+static byte appliedLayer = 0xFF;
+static uint16_t appliedVersion = 0;
 
 byte not_active_counter = 30; // количество тиков, после которых кнопки активируются
 void setup_button_fsm()
 {
-  for (size_t i = 0; i < NUM_DEFAULT_KEYS; i++)
-  {
-    gbtn[i] = GButton();
-    gbtn[i].setDebounce(50);
-    gbtn[i].setTimeout(500);
-    gbtn[i].setClickTimeout(400);
-    gbtn[i].setStepTimeout(500);
-    gbtn[i].setType(HIGH_PULL);
-    gbtn[i].setDirection(NORM_OPEN);
-    gbtn[i].setTickMode(false);
-  }
+  button_engine_init(buttonEngine, buttonTiming, NUM_DEFAULT_KEYS);
+  tap_dance_state_init(tapDanceState);
+  combo_matcher_init(comboMatcher);
 #if DEBUG
   Serial.println("[FSM] FSM initialized for all buttons");
 #endif
 }
 
-void update_button_fsm(const uint8_t *pressedCodes)
+// Серии нажатий (3+ клика, клики + удержание) — из таблицы; удержание, ушедшее в серию, обычных действий не дает.
+// Кнопки сработавшего сочетания молчат до отпускания
+static void on_button_event(void *ctx, uint8_t key, uint8_t event, uint8_t taps)
+{
+  if (combo_consumed(comboMatcher, key))
+    return;
+  bool suppress = false;
+  TapDanceEntry action;
+  button_config_lock(); // таблицу серий может менять веб-задача — берем копию записи
+  const TapDanceEntry *entry = tap_dance_on_event(get_tap_dance(), tapDanceState, get_active_layer(), key, event, taps, suppress);
+  if (entry)
+    action = *entry;
+  button_config_unlock();
+  if (entry)
+    run_tap_dance_action(key, action);
+  if (!suppress && event <= BUTTON_EVENT_RELEASE)
+    run_button_action(key, (ButtonActionKind)event);
+}
+
+// Слой или конфигурация сменились: времена кнопок и какие кнопки ждут второго клика.
+// Без двойного клика, клик+удержания и серий на активном слое CLICK уходит сразу при отпускании.
+// Копии и таблица сочетаний собираются под мьютексом конфигурации: веб-задача не пишет ее наполовину
+static void apply_button_config()
 {
-  // const auto &keys = hardwareKeys;
-  // byte layer = get_active_layer();
+  byte layer = get_active_layer();
+  button_config_lock();
+  uint16_t version = get_button_config_version();
+  if (layer == appliedLayer && version == appliedVersion)
+  {
+    button_config_unlock();
+    return;
+  }
+  appliedLayer = layer;
+  appliedVersion = version;
 
+  memcpy(engineKeyTiming, get_key_timing(), sizeof(engineKeyTiming));
+  button_engine_set_key_timing(buttonEngine, engineKeyTiming);
+  combo_compile(get_combo_config(), comboTable);
+
+  KeyBits defer;
+  tap_dance_layer_keys(get_tap_dance(), layer, defer);
+  if (layer < MAX_LAYERS)
+  {
+    const ButtonLogic(&logic)[MAX_LAYERS][NUM_DEFAULT_KEYS] = get_button_logic();
+    for (uint8_t key = 0; key < NUM_DEFAULT_KEYS; key++)
+      if (logic[layer][key].dblclick.type != ACTION_NONE || logic[layer][key].oneClickHold.type != ACTION_NONE)
+        key_bits_set(defer, key);
+  }
+  button_config_unlock();
+  button_engine_set_defer_click(buttonEngine, defer);
+#if DEBUG
+  Serial.printf("[FSM] Layer %u: deferred click keys %08x%08x\n", layer, (unsigned)defer.w[1], (unsigned)defer.w[0]);
+#endif
+}
+
+void update_button_fsm(const KeyBits &pressed)
+{
   if (not_active_counter)
   {
     not_active_counter--;
+    // Старт: кнопки, нажатые при включении, не дают событий нажатия
+    button_engine_sync(buttonEngine, pressed);
+    comboMatcher.prev = pressed;
 #if DEBUG
     if (!not_active_counter)
     {
       Serial.println("[FSM] Starting button FSM");
     }
 #endif
+    return;
+  }
+
+  apply_button_config();
+  uint32_t now = millis();
+  button_engine_tick(buttonEngine, pressed, now, on_button_event, nullptr);
+
+  // Сочетания — по нажатым после антидребезга; до срабатывания (окно меньше удержания) кнопки событий не дают
+  const ComboEntry *combo = combo_tick(comboTable, comboMatcher, buttonEngine.state, get_active_layer(), now);
+  if (combo)
+  {
+    button_engine_cancel(buttonEngine, comboMatcher.consumed);
+    run_combo_action(*combo);
+  }
+}
+
+static String timing_json()
+{
+  const ButtonKeyTiming(&timing)[NUM_DEFAULT_KEYS] = get_key_timing();
+  String json = "{\"debounce\":" + String(BUTTON_DEBOUNCE_MS) + ",\"hold\":" + String(BUTTON_HOLD_MS) +
+                ",\"click\":" + String(BUTTON_CLICK_TIMEOUT_MS) + ",\"keys\":[";
+  for (uint8_t key = 0; key < NUM_DEFAULT_KEYS; key++)
+  {
+    if (key)
+      json += ",";
+    json += "{\"debounce\":" + String(timing[key].debounceMs) + ",\"hold\":" + String(timing[key].holdMs) +
+            ",\"click\":" + String(timing[key].clickTimeoutMs) + "}";
+  }
+  json += "]}";
+  return json;
+}
+
+static String combos_json()
+{
+  const ComboConfig &combos = get_combo_config();
+  String json = "{\"window\":" + String(combos.windowMs) + ",\"combos\":[";
+  for (uint8_t i = 0; i < combos.count; i++)
+  {
+    const ComboEntry &e = combos.entries[i];
+    if (i)
+      json += ",";
+    json += "{\"layer\":" + String(e.layer) + ",\"keys\":[";
+    bool first = true;
+    for (uint8_t k = 0; k < COMBO_MAX_KEYS; k++)
+    {
+      if (e.keys[k] == COMBO_NO_KEY)
+        continue;
+      if (!first)
+        json += ",";
+      json += String(e.keys[k]);
+      first = false;
+    }
+    json += "],\"type\":" + String(e.type) + ",\"code\":" + String(e.code) + ",\"sub_code\":" + String(e.subCode) + "}";
   }
+  json += "]}";
+  return json;
+}
 
-  for (size_t i = 0; i < NUM_DEFAULT_KEYS; i++)
+// "<слой>:<кнопка>+<кнопка>[+...]:<type>:<code>:<sub_code>"; слой 255 — все слои
+static bool parse_combo(const String &item, ComboEntry &e)
+{
+  int p1 = item.indexOf(':');
+  int p2 = item.indexOf(':', p1 + 1);
+  int p3 = item.indexOf(':', p2 + 1);
+  int p4 = item.indexOf(':', p3 + 1);
+  if (p1 < 0 || p2 < 0 || p3 < 0 || p4 < 0)
+    return false;
+  e.layer = item.substring(0, p1).toInt();
+  for (uint8_t k = 0; k < COMBO_MAX_KEYS; k++)
+    e.keys[k] = COMBO_NO_KEY;
+  String keys = item.substring(p1 + 1, p2);
+  int start = 0;
+  for (uint8_t k = 0; start <= (int)keys.length(); k++)
   {
-    gbtn[i].tick(pressedCodes[i]);
+    if (k >= COMBO_MAX_KEYS)
+      return false;
+    int end = keys.indexOf('+', start);
+    if (end == -1)
+      end = keys.length();
+    e.keys[k] = constrain(keys.substring(start, end).toInt(), 0, COMBO_NO_KEY);
+    start = end + 1;
+  }
+  e.type = item.substring(p2 + 1, p3).toInt();
+  e.code = item.substring(p3 + 1, p4).toInt();
+  e.subCode = item.substring(p4 + 1).toInt();
+  return true;
+}
+
+void register_button_api(AsyncWebServer &server)
+{
+  // API: сочетания кнопок
+  server.on("/api/combos", HTTP_GET, [](AsyncWebServerRequest *request)
+            { request->send(200, "application/json", combos_json()); });
 
-    if (not_active_counter)
+  // window — окно нажатия (мс); combos — весь список через ';'. Не переданные параметры остаются прежними
+  server.on("/api/combos", HTTP_POST, [](AsyncWebServerRequest *request)
+            {
+    ComboConfig combos = get_combo_config();
+    if (request->hasParam("window", true))
+      combos.windowMs = constrain(request->getParam("window", true)->value().toInt(), 0, 0xFFFF);
+    if (request->hasParam("combos", true))
     {
-      gbtn[i].resetStates();
-      continue;
+      String list = request->getParam("combos", true)->value();
+      combos.count = 0;
+      int start = 0;
+      while (start < (int)list.length())
+      {
+        int end = list.indexOf(';', start);
+        if (end == -1)
+          end = list.length();
+        String item = list.substring(start, end);
+        start = end + 1;
+        if (!item.length())
+          continue;
+        if (combos.count >= COMBO_MAX || !parse_combo(item, combos.entries[combos.count]))
+        {
+          request->send(400, "application/json", "{\"error\":\"Invalid combo\"}");
+          return;
+        }
+        combos.count++;
+      }
     }
 
-    if (gbtn[i].isClick())
+    if (!check_combo_config(combos))
     {
-      run_button_action(i, BUTTON_CLICK);
+      request->send(400, "application/json", "{\"error\":\"Invalid combos\"}");
+      return;
     }
-    if (gbtn[i].isDouble())
+    if (!set_combo_config(combos))
     {
-      run_button_action(i, BUTTON_DOUBLE);
+      request->send(500, "application/json", "{\"error\":\"Save failed\"}");
+      return;
     }
-    if (pressedCodes[i])
+#if DEBUG
+    Serial.printf("[FSM] Combos saved: %u, window %u ms\n", combos.count, combos.windowMs);
+#endif
+    request->send(200, "application/json", combos_json()); });
+
+  server.on("/api/buttons/timing", HTTP_GET, [](AsyncWebServerRequest *request)
+            { request->send(200, "application/json", timing_json()); });
+
+  // Не переданные параметры остаются прежними
+  server.on("/api/buttons/timing", HTTP_POST, [](AsyncWebServerRequest *request)
+            {
+    if (!request->hasParam("key", true))
     {
-      if (gbtn[i].isHolded())
-      {
-        run_button_action(i, BUTTON_HOLD_START);
-        onHold[i] = true;
-      }
-      if (gbtn[i].isStep())
-      {
-        run_button_action(i, BUTTON_HOLD_REPEAT);
-      }
-      if (gbtn[i].isStep(1))
-      {
-        run_button_action(i, BUTTON_ONE_CLICK_HOLD);
-      }
+      request->send(400, "application/json", "{\"error\":\"Missing key\"}");
+      return;
     }
-    if (gbtn[i].isRelease())
+    long key = request->getParam("key", true)->value().toInt();
+    if (key < 0 || key >= NUM_DEFAULT_KEYS)
     {
-      if (onHold[i])
-      {
-        onHold[i] = false;
-        run_button_action(i, BUTTON_HOLD_RELEASE);
-      }
-      else
-      {
-        run_button_action(i, BUTTON_RELEASE);
-      }
+      request->send(400, "application/json", "{\"error\":\"Invalid key\"}");
+      return;
     }
-  }
+    ButtonKeyTiming timing = get_key_timing()[key];
+    if (request->hasParam("debounce", true))
+      timing.debounceMs = constrain(request->getParam("debounce", true)->value().toInt(), 0, 0xFFFF);
+    if (request->hasParam("hold", true))
+      timing.holdMs = constrain(request->getParam("hold", true)->value().toInt(), 0, 0xFFFF);
+    if (request->hasParam("click", true))
+      timing.clickTimeoutMs = constrain(request->getParam("click", true)->value().toInt(), 0, 0xFFFF);
+
+    if (!check_key_timing(key, timing))
+    {
+      request->send(400, "application/json", "{\"error\":\"Invalid timing\"}");
+      return;
+    }
+    if (!set_key_timing(key, timing))
+    {
+      request->send(500, "application/json", "{\"error\":\"Save failed\"}");
+      return;
+    }
+#if DEBUG
+    Serial.printf("[FSM] Key %ld timing: debounce=%u, hold=%u, click=%u\n", key, timing.debounceMs, timing.holdMs,
+                  timing.clickTimeoutMs);
+#endif
+    request->send(200, "application/json", timing_json()); });
 }
@@ -2,6 +2,12 @@
 #pragma once
 
 #include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+#include "key_snapshot.h"
 
 void setup_button_fsm();
-void update_button_fsm(const uint8_t *pressedCodes);
+void update_button_fsm(const KeyBits &pressed); // снимок нажатых кнопок с маской стороны, раз в SCHED_APP_PERIOD_US
+
+// GET /api/buttons/timing — времена кнопок; POST (key, debounce, hold, click; 0 — общее) — сохранить.
+// GET /api/combos — сочетания кнопок; POST (window, combos) — сохранить в /combo.bin
+void register_button_api(AsyncWebServer &server);
@@ -5,9 +5,13 @@
 #include "led_service.h"
 #include "config_storage.h"
 #include "button_fsm.h"
+#include "key_snapshot.h"
 #include <BleCombo.h>
+#include <soc/gpio_reg.h>
 
-static uint8_t pressedCodes[NUM_DEFAULT_KEYS]; // буфер для нажатых кнопок
+static_assert(NUM_DEFAULT_KEYS <= KEY_SNAPSHOT_BITS, "Кнопок больше, чем бит в снимке");
+
+static KeyLayout keyLayout;   // кнопки по исходным словам MCP/GPIO и маски сторон
 static bool hidConnected = false;              // текущее состояние подключения HID
 
 // === Установить состояние HID-подключения ===
@@ -29,9 +33,18 @@ void setup_button_service()
   Serial.println("[BTN] GPIO buttons setup");
 #endif
   const auto &hw = get_keys_config();
+  key_layout_init(keyLayout);
   for (size_t i = 0; i < NUM_DEFAULT_KEYS; i++)
   {
-    pressedCodes[i] = 0; // сбрасываем состояние кнопки
+    // MCP n — слово n; GPIO — слова KEY_GPIO_WORD.. по 16 пинов
+    uint8_t word = hw[i].source == HARDWARE_KEY_SOURCE_MCP ? hw[i].sourceIndex : KEY_GPIO_WORD + hw[i].pin / 16;
+    uint8_t bit = hw[i].source == HARDWARE_KEY_SOURCE_MCP ? hw[i].pin : hw[i].pin % 16;
+    if (!key_layout_add(keyLayout, i, word, bit, hw[i].side != SIDE_MOUSE, hw[i].side != SIDE_KEYBOARD))
+    {
+#if DEBUG
+      Serial.printf("[BTN] Button %d: source out of range, ignored\n", i);
+#endif
+    }
 
     if (hw[i].source == HARDWARE_KEY_SOURCE_GPIO)
     {
@@ -61,46 +74,46 @@ void setup_button_service()
 #endif
 }
 
+// === Исходные слова снимка: все MCP и входы GPIO 0..39 за два чтения регистров ===
+static void read_key_words(uint16_t *words)
+{
+  for (uint8_t i = 0; i < KEY_MAX_MCP; i++)
+    words[i] = get_mcp_pins(i); // нет чипа — 0xFFFF, ничего не нажато
+  uint32_t in = REG_READ(GPIO_IN_REG);          // GPIO 0..31
+  uint32_t in1 = REG_READ(GPIO_IN1_REG) & 0xFF; // GPIO 32..39
+  words[KEY_GPIO_WORD] = in;
+  words[KEY_GPIO_WORD + 1] = in >> 16;
+  words[KEY_GPIO_WORD + 2] = in1 | 0xFF00;
+  words[KEY_GPIO_WORD + 3] = 0xFFFF;
+}
+
 // === Основной цикл проверки всех кнопок ===
 void update_buttons()
 {
-  // сбрасываем состояние нажатых кнопок
-  memset(pressedCodes, 0, sizeof(pressedCodes));
+  process_mcp_events(); // фронты и смена стороны с ядра 0
 
-  // считываем состояние кнопок MCP
+  // Один снимок на все кнопки, сторона — маской; фронты и антидребезг — в FSM по всему снимку
+  uint16_t words[KEY_SOURCE_WORDS];
+  read_key_words(words);
+  KeyBits pressed;
+  key_snapshot_build(keyLayout, words, pressed);
   Side side = get_mcp_active_side();
-  const auto &hw = get_keys_config();
+  pressed = key_bits_and(pressed, keyLayout.sideMask[side == SIDE_MOUSE ? 1 : 0]);
+
 #if DEBUG && DEBUG_BUTTON_STATE
   Serial.print("[BTN] State: ");
-#endif
+  const KeyBits &sideMask = keyLayout.sideMask[side == SIDE_MOUSE ? 1 : 0];
   for (size_t i = 0; i < NUM_DEFAULT_KEYS; i++)
   {
-    if (!(hw[i].side == side || hw[i].side == SIDE_BOTH))
-    {
-      pressedCodes[i] = 0;
-#if DEBUG && DEBUG_BUTTON_STATE
+    if (!key_bits_test(sideMask, i))
       Serial.print("x ");
-#endif
-      continue;
-    }
-
-    // GPIO кнопки
-    if (hw[i].source == HARDWARE_KEY_SOURCE_GPIO)
-      pressedCodes[i] = digitalRead(hw[i].pin) == LOW;
-
-    // MCP кнопки
-    if (hw[i].source == HARDWARE_KEY_SOURCE_MCP)
-      pressedCodes[i] = get_pin_state(hw[i].sourceIndex, hw[i].pin);
-
-#if DEBUG && DEBUG_BUTTON_STATE
-    Serial.print(pressedCodes[i] ? "1 " : "0 ");
-#endif
+    else
+      Serial.print(key_bits_test(pressed, i) ? "1 " : "0 ");
   }
-#if DEBUG && DEBUG_BUTTON_STATE
   Serial.println();
 #endif
 
-  update_button_fsm(pressedCodes);
+  update_button_fsm(pressed);
 }
 
 bool is_hid_connected()
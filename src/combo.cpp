@@ -0,0 +1,163 @@
+// combo.cpp — компиляция таблицы сочетаний и распознавание по снимку нажатых кнопок
+#include "combo.h"
+#include <string.h>
+
+static int lowest_key(const KeyBits &b)
+{
+  KeyBits copy = b;
+  return key_bits_pop(copy);
+}
+
+KeyBits combo_entry_mask(const ComboEntry &e)
+{
+  KeyBits mask;
+  key_bits_clear(mask);
+  for (uint8_t i = 0; i < COMBO_MAX_KEYS; i++)
+    if (e.keys[i] != COMBO_NO_KEY && e.keys[i] < KEY_SNAPSHOT_BITS)
+      key_bits_set(mask, e.keys[i]);
+  return mask;
+}
+
+bool combo_entry_valid(const ComboEntry &e, uint8_t keyCount)
+{
+  if (!e.type)
+    return false;
+  uint8_t used = 0;
+  for (uint8_t i = 0; i < COMBO_MAX_KEYS; i++)
+  {
+    if (e.keys[i] == COMBO_NO_KEY)
+      continue;
+    if (e.keys[i] >= keyCount)
+      return false;
+    for (uint8_t j = 0; j < i; j++)
+      if (e.keys[j] == e.keys[i])
+        return false;
+    used++;
+  }
+  return used >= 2;
+}
+
+bool combo_config_valid(const ComboConfig &cfg, uint8_t keyCount)
+{
+  if (cfg.windowMs < COMBO_WINDOW_MIN_MS || cfg.windowMs > COMBO_WINDOW_MAX_MS || cfg.count > COMBO_MAX)
+    return false;
+  for (uint8_t i = 0; i < cfg.count; i++)
+    if (!combo_entry_valid(cfg.entries[i], keyCount))
+      return false;
+  return true;
+}
+
+bool combo_window_fits_hold(const ComboConfig &cfg, const ButtonKeyTiming *keyTiming, uint16_t defaultHoldMs,
+                            uint16_t defaultDebounceMs)
+{
+  for (uint8_t i = 0; i < cfg.count && i < COMBO_MAX; i++)
+    for (uint8_t j = 0; j < COMBO_MAX_KEYS; j++)
+    {
+      uint8_t key = cfg.entries[i].keys[j];
+      if (key == COMBO_NO_KEY)
+        continue;
+      uint16_t hold = keyTiming[key].holdMs ? keyTiming[key].holdMs : defaultHoldMs;
+      uint16_t debounce = keyTiming[key].debounceMs ? keyTiming[key].debounceMs : defaultDebounceMs;
+      if (cfg.windowMs + debounce >= hold)
+        return false;
+    }
+  return true;
+}
+
+void combo_compile(const ComboConfig &cfg, ComboTable &t)
+{
+  memset(&t, 0, sizeof(t));
+  t.windowMs = cfg.windowMs;
+  uint8_t count = cfg.count > COMBO_MAX ? COMBO_MAX : cfg.count;
+
+  // Число сочетаний на младшую кнопку -> начала групп
+  uint8_t low[COMBO_MAX];
+  uint8_t perKey[KEY_SNAPSHOT_BITS] = {};
+  for (uint8_t i = 0; i < count; i++)
+  {
+    int k = lowest_key(combo_entry_mask(cfg.entries[i]));
+    low[i] = k < 0 ? 0 : k;
+    perKey[low[i]]++;
+  }
+  for (uint16_t k = 0; k < KEY_SNAPSHOT_BITS; k++)
+    t.first[k + 1] = t.first[k] + perKey[k];
+
+  // Раскладка по группам: сочетания конкретного слоя раньше общих
+  uint8_t fill[KEY_SNAPSHOT_BITS];
+  memcpy(fill, t.first, sizeof(fill));
+  for (uint8_t pass = 0; pass < 2; pass++)
+  {
+    for (uint8_t i = 0; i < count; i++)
+    {
+      bool any = cfg.entries[i].layer == COMBO_ANY_LAYER;
+      if (any != (pass == 1))
+        continue;
+      uint8_t pos = fill[low[i]]++;
+      t.entries[pos] = cfg.entries[i];
+      t.masks[pos] = combo_entry_mask(cfg.entries[i]);
+      for (uint8_t w = 0; w < KEY_SNAPSHOT_WORDS; w++)
+        t.members.w[w] |= t.masks[pos].w[w];
+    }
+  }
+  t.count = count;
+}
+
+uint8_t combo_candidates(const ComboTable &t, uint8_t key, uint8_t &count)
+{
+  if (key >= KEY_SNAPSHOT_BITS)
+  {
+    count = 0;
+    return 0;
+  }
+  count = t.first[key + 1] - t.first[key];
+  return t.first[key];
+}
+
+void combo_matcher_init(ComboMatcher &m)
+{
+  memset(&m, 0, sizeof(m));
+}
+
+const ComboEntry *combo_tick(const ComboTable &t, ComboMatcher &m, const KeyBits &pressed, uint8_t layer,
+                             uint32_t nowMs)
+{
+  // Отпущенные выходят из окна и перестают быть поглощенными
+  KeyBits down;
+  uint32_t anyDown = 0;
+  for (uint8_t w = 0; w < KEY_SNAPSHOT_WORDS; w++)
+  {
+    down.w[w] = pressed.w[w] & ~m.prev.w[w] & t.members.w[w];
+    anyDown |= down.w[w];
+    m.chord.w[w] &= pressed.w[w];
+    m.consumed.w[w] &= pressed.w[w];
+  }
+  m.prev = pressed;
+  if (!anyDown)
+    return nullptr;
+
+  // Новое нажатие после окна начинает новый набор
+  if (!key_bits_any(m.chord) || nowMs - m.chordMs > t.windowMs)
+  {
+    key_bits_clear(m.chord);
+    m.chordMs = nowMs;
+  }
+  for (uint8_t w = 0; w < KEY_SNAPSHOT_WORDS; w++)
+    m.chord.w[w] |= down.w[w];
+
+  // Только сочетания с той же младшей кнопкой; срабатывает первое совпавшее целиком
+  uint8_t n;
+  uint8_t i = combo_candidates(t, lowest_key(m.chord), n);
+  for (; n; n--, i++)
+  {
+    if (t.entries[i].layer != COMBO_ANY_LAYER && t.entries[i].layer != layer)
+      continue;
+    if (memcmp(&t.masks[i], &m.chord, sizeof(KeyBits)) != 0)
+      continue;
+    for (uint8_t w = 0; w < KEY_SNAPSHOT_WORDS; w++)
+      m.consumed.w[w] |= m.chord.w[w];
+    key_bits_clear(m.chord);
+    m.fired++;
+    return &t.entries[i];
+  }
+  return nullptr;
+}
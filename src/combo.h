@@ -0,0 +1,78 @@
+// combo.h — сочетания кнопок (аккорды): нажатые вместе в пределах окна -> одно действие вместо действий кнопок
+#pragma once
+
+#include <stdint.h>
+#include "key_snapshot.h"
+#include "button_engine.h"
+
+#define COMBO_MAX 16         // сочетаний на все слои
+#define COMBO_MAX_KEYS 4     // кнопок в сочетании
+#define COMBO_NO_KEY 0xFF    // пустое место в keys
+#define COMBO_ANY_LAYER 0xFF // сочетание работает на всех слоях
+#define COMBO_WINDOW_MIN_MS 10
+#define COMBO_WINDOW_MAX_MS 200 // и меньше удержания кнопок сочетаний минус антидребезг (combo_window_fits_hold)
+
+// Одно сочетание (поля действия как у ButtonAction)
+struct ComboEntry
+{
+  uint8_t layer;               // слой или COMBO_ANY_LAYER
+  uint8_t keys[COMBO_MAX_KEYS]; // 2..COMBO_MAX_KEYS разных кнопок, остальные COMBO_NO_KEY
+  uint8_t type;                // ButtonActionType
+  int16_t code;
+  int16_t subCode;
+};
+
+// Хранимая конфигурация
+struct ComboConfig
+{
+  uint16_t windowMs; // все кнопки сочетания должны быть нажаты за это время
+  uint8_t count;
+  ComboEntry entries[COMBO_MAX];
+};
+
+// Скомпилированная таблица: маски сочетаний, сгруппированные по младшей кнопке.
+// Поиск перебирает только сочетания с той же младшей кнопкой, что у нажатого набора
+struct ComboTable
+{
+  uint16_t windowMs;
+  uint8_t count;
+  ComboEntry entries[COMBO_MAX]; // по возрастанию младшей кнопки; внутри — сначала сочетания конкретного слоя
+  KeyBits masks[COMBO_MAX];
+  uint8_t first[KEY_SNAPSHOT_BITS + 1]; // сочетания с младшей кнопкой k: entries[first[k]..first[k + 1])
+  KeyBits members;                      // кнопки, входящие хоть в одно сочетание
+};
+
+// Состояние распознавания
+struct ComboMatcher
+{
+  KeyBits prev;     // нажатые на прошлом отсчете
+  KeyBits chord;    // нажатые в текущем окне кнопки сочетаний
+  uint32_t chordMs; // начало окна
+  KeyBits consumed; // кнопки сработавшего сочетания: их события не выполняются до отпускания
+  uint32_t fired;   // сработавших сочетаний
+};
+
+bool combo_entry_valid(const ComboEntry &e, uint8_t keyCount);
+KeyBits combo_entry_mask(const ComboEntry &e);
+// false — неверная запись или окно
+bool combo_config_valid(const ComboConfig &cfg, uint8_t keyCount);
+// Окно короче удержания каждой кнопки сочетаний за вычетом ее антидребезга (удержание считается от первого касания,
+// окно — от засчитанного нажатия): иначе кнопка даст HOLD_START раньше, чем сочетание соберется.
+// Нули в keyTiming — общие defaultHoldMs и defaultDebounceMs
+bool combo_window_fits_hold(const ComboConfig &cfg, const ButtonKeyTiming *keyTiming, uint16_t defaultHoldMs,
+                            uint16_t defaultDebounceMs);
+void combo_compile(const ComboConfig &cfg, ComboTable &t);
+// Сочетания с младшей кнопкой key: индекс первого в entries, count — сколько
+uint8_t combo_candidates(const ComboTable &t, uint8_t key, uint8_t &count);
+
+void combo_matcher_init(ComboMatcher &m);
+// Отсчет по нажатым кнопкам (после антидребезга). Возвращает сработавшее сочетание или nullptr;
+// его кнопки добавляются в m.consumed, пока не будут отпущены
+const ComboEntry *combo_tick(const ComboTable &t, ComboMatcher &m, const KeyBits &pressed, uint8_t layer,
+                             uint32_t nowMs);
+
+// Событие кнопки поглощено сочетанием
+inline bool combo_consumed(const ComboMatcher &m, uint8_t key)
+{
+  return key < KEY_SNAPSHOT_BITS && key_bits_test(m.consumed, key);
+}
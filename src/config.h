@@ -23,6 +23,9 @@
 // === I2C ===
 #define I2C_SDA_PIN 5
 #define I2C_SCL_PIN 4
+#define I2C_CLOCK_HZ 400000         // частота шины (MPU6050, MCP23017 и IP5306 поддерживают Fast-mode)
+#define I2C_RETRIES 2               // повторов транзакции после NACK
+#define I2C_SERVICE_BUDGET_US 1000  // время на фоновые транзакции (IP5306) за проход task_io; статистика — /api/i2c
 
 // === params ===
 #define MAX_LAYERS 4 // Максимальное число слоев для кнопок + подсветки
@@ -31,7 +34,17 @@
 #define PIN_WS_LED 12 // WS2812 лента
 
 // === MCP ===
-#define MCP_ADDR {0x21, 0x20} // MCP23017
+#define MCP_ADDR {0x21, 0x20}   // MCP23017 (до 8 адресов, 0x20..0x27)
+#define MCP_INT_PIN -1          // GPIO пин общей линии INT всех MCP (INTA/INTB зеркальные, открытый сток; -1 — опрос каждый тик)
+#define MCP_INT_RESYNC_MS 1000  // контрольное полное чтение при работе по INT (на случай потерянного прерывания)
+
+// === Кнопки ===
+// Общие времена; у отдельной кнопки свои — /api/buttons/timing
+#define BUTTON_DEBOUNCE_MS 50       // нажатие засчитывается, если держится столько (до 60 мс при опросе раз в 10 мс)
+#define BUTTON_HOLD_MS 500          // от начала нажатия до удержания
+#define BUTTON_CLICK_TIMEOUT_MS 400 // ожидание второго клика; кнопки без двойного клика и клик+удержания его не ждут
+#define BUTTON_STEP_MS 500          // период повтора при удержании
+#define COMBO_WINDOW_MS 50          // кнопки сочетания должны быть нажаты за это время (/api/combos)
 
 // === LED ===
 #define NUM_WS_LEDS 31             // Общее число светодиодов в ленте
@@ -79,6 +92,22 @@
 #define IP5306_AUTO_POWER_ON 1        // Автоматическое включение питания при подключении USB (0 - выключено, 1 - включено)
 #define IP5306_AUTO_CHARGE_CONTROL 1  // Автоматическое управление зарядкой (0 - выключено, 1 - включено)
 
+// === Планировщик задач (периоды в мкс; статистика — /api/scheduler) ===
+#define SCHED_IMU_PERIOD_US (1000000UL / IMU_SAMPLE_RATE_HZ)    // Core 0: чтение IMU и отправка движения
+#if MCP_INT_PIN >= 0
+#define SCHED_MCP_PERIOD_US 1000                                 // Core 0: проверка линии INT MCP23017 (1 кГц, I2C — только по прерыванию)
+#else
+#define SCHED_MCP_PERIOD_US 2000                                 // Core 0: опрос MCP23017 (500 Гц)
+#endif
+#define SCHED_POWER_PERIOD_US (IP5306_POLL_INTERVAL * 1000UL)    // Core 0: опрос IP5306 (постановка чтений в очередь I2C)
+#define SCHED_I2C_PERIOD_US (1000000UL / IMU_SAMPLE_RATE_HZ)    // Core 0: фоновые транзакции I2C в остатке прохода
+#define SCHED_LED_PERIOD_US 16667                                // Core 1: LED (60 Гц)
+#define SCHED_APP_PERIOD_US 10000                                // Core 1: сон, BLE, кнопки, жесты, статус питания (100 Гц)
+
+// === Исполнитель действий (статистика — /api/executor) ===
+#define ACTION_QUEUE_SIZE 16  // запросов от task_app к исполнителю (степень двойки)
+#define ACTION_KEY_PRESS_MS 5 // сколько держится нажатие клавиши из действия
+
 #define NUM_DEFAULT_KEYS 30
 extern const UserKeyConfig defaultUserKeys[NUM_DEFAULT_KEYS];
 // extern const HardwareKeyConfig hardwareKeys[NUM_DEFAULT_KEYS];
@@ -120,21 +149,78 @@ const HardwareKeyConfig hardwareKeys[NUM_DEFAULT_KEYS] = {
     {HARDWARE_KEY_SOURCE_GPIO, 0, 0, SIDE_BOTH, 29}       // Fn (особый)
 };
 
-// === Параметры управления мышью ===
+// === IMU (MPU6050) ===
+#define IMU_USE_FIFO 1          // 1 - FIFO MPU6050 с метками времени, 0 - одно чтение за тик
+#define IMU_SAMPLE_RATE_HZ 200  // частота отсчетов в режиме FIFO
+#define IMU_INT_PIN -1          // GPIO пин INT (data-ready) MPU6050 (-1 если не подключен — время по micros())
+#define IMU_FIFO_MAX_SAMPLES 16 // максимум кадров FIFO за один тик
+#define IMU_STILL_SAMPLE_RATE_HZ 25 // частота отсчетов IMU в покое
+#define STILL_ACC_VAR 0.0004        // порог дисперсии модуля ускорения для покоя (g², СКО 0.02 g)
+#define STILL_GYRO_RMS 1.0          // порог СКО гироскопа для покоя (град/с)
+#define STILL_ENTER_MS 1500         // время неподвижности до перехода в покой (мс)
+#define STILL_WINDOW_MS 200         // окно усреднения детектора покоя (мс)
+#define GESTURE_BURST_RATE 250.0     // порог всплеска рыскания для взмаха и тряски (град/с)
+#define GESTURE_FLICK_MAX_MS 150     // максимальная длительность всплеска взмаха (мс)
+#define GESTURE_SERIES_GAP_MS 250    // пауза, завершающая серию всплесков (мс)
+#define GESTURE_SHAKE_PEAKS 4        // всплесков туда-обратно для тряски
+#define GESTURE_SHAKE_WINDOW_MS 1200 // окно серии тряски (мс)
+#define GESTURE_TWIST_RATE 120.0     // минимальная скорость поворота вокруг продольной оси (град/с)
+#define GESTURE_TWIST_ANGLE 60.0     // угол поворота для жеста (градусы)
+#define GESTURE_TWIST_WINDOW_MS 600  // время на поворот (мс)
+#define GESTURE_RAISE_STILL_MS 1000  // пульт лежал не меньше (мс)
+#define GESTURE_RAISE_ANGLE 25.0     // подъем носа после начала движения (градусы)
+#define GESTURE_RAISE_WINDOW_MS 1500 // время на подъем (мс)
+#define GESTURE_REFRACTORY_MS 400    // пауза после жеста (мс)
+#define IMU_TRACE_CAPACITY 8192            // записей в двух сегментах трассы IMU (20 байт, 20..40 с при 200 Гц)
+#define GYRO_CAL_SAVE_INTERVAL_MS 600000UL // минимальный интервал сохранения калибровки в NVS (в мс)
+#define GYRO_CAL_SAVE_DELTA 0.05f          // порог изменения смещения для сохранения (град/с)
+
+// === Параметры управления мышью (по умолчанию; на лету меняются через /api/mouse и хранятся в /mouse.bin) ===
 #define MOUSE_DEADZONE 0.5            // мертвая зона (от 0 до 1)
 #define MOUSE_SENSITIVITY 2.5         // чувствительность (от 0 до 5)
 #define MOUSE_ACCEL_THRESHOLD 1.2     // порог ускорения (от 0 до 1)
 #define MOUSE_ACCEL_MULTIPLIER 2.0    // коэффициент ускорения (от 0 до 1)
 #define MOUSE_PRECISION_THRESHOLD 0.6 // порог точности (от 0 до 1)
 #define MOUSE_PRECISION_SCALE 0.4     // коэффициент точности (от 0 до 1)
+#define MOUSE_ACCEL_CURVE 3           // кривая ускорения по умолчанию: 0 - ступени, 1 - линейная, 2 - степенная, 3 - сигмоида, 4 - по точкам
+#define MOUSE_ACCEL_CURVE_CENTER 0.9  // центр сигмоиды (градусы за 10 мс)
+#define MOUSE_ACCEL_CURVE_WIDTH 0.15  // ширина перехода сигмоиды (градусы за 10 мс)
+#define MOUSE_ACCEL_CURVE_POWER 2.0   // показатель степенной кривой
+#define MOUSE_FILTER_ENABLE 0         // адаптивный фильтр дрожания One-Euro: 1 - включен, 0 - выключен
+#define MOUSE_FILTER_MIN_CUTOFF 1.0   // частота среза в покое (Гц)
+#define MOUSE_FILTER_BETA 16.0        // прирост частоты среза со скоростью (Гц на градус/10 мс)
+#define MOUSE_FILTER_D_CUTOFF 10.0    // частота среза оценки скорости (Гц)
 #define MOUSE_SIDE_ZONE 0.8           // мертвая зона по оси Z (от 0 до 1)
+#define MOUSE_SIDE_SWITCH_THRESHOLD 5 // отсчетов подряд за порогом для смены стороны
+#define MOUSE_FIXED_POINT 1           // 1 - целочисленная обработка движения (Q16.16), 0 - float
+#define MOUSE_SCROLL_SENSITIVITY 0.3  // прокрутка наклоном: щелчков колеса на градус
+#define MOUSE_SCROLL_DEADZONE 0.1     // мертвая зона прокрутки (градусы за 10 мс)
+#define MOUSE_SCROLL_MIN_GAIN 0.5     // усиление прокрутки при медленном наклоне
+#define MOUSE_SCROLL_MAX_GAIN 4.0     // усиление прокрутки при резком наклоне
+#define MOUSE_SCROLL_CENTER 0.8       // центр сигмоиды прокрутки (градусы за 10 мс)
+#define MOUSE_SCROLL_WIDTH 0.2        // ширина перехода сигмоиды прокрутки (градусы за 10 мс)
+#define MOUSE_SCROLL_INVERT 0         // 1 - наклон вверх прокручивает вниз
+#define MOUSE_SCROLL_LAYERS 0x00      // бит на слой: на этих слоях наклон всегда прокручивает
+#define HID_REPORT_INTERVAL_US 7500   // минимальный интервал HID-отчетов мыши (мкс), кратен интервалу BLE-соединения 7.5 мс
+#define HID_REPORT_BACKLOG 8          // предел накопленного движения, в отчетах по 127 (лишнее сжимается)
+#define MOUSE_PREVIEW_INTERVAL_MS 50  // период рассылки предпросмотра движения в /ws/mouse (мс)
+#define MOUSE_ABSOLUTE_WIDTH 1920     // режим указки: ширина экрана в отсчетах HID (ускорение указателя хоста выключено)
+#define MOUSE_ABSOLUTE_HEIGHT 1080    // режим указки: высота экрана
+#define MOUSE_ABSOLUTE_SPAN_X 40.0    // поворот пульта от левого до правого края (градусы), до калибровки
+#define MOUSE_ABSOLUTE_SPAN_Y 22.5    // наклон пульта от верхнего до нижнего края (градусы), до калибровки
+#define MOUSE_ABSOLUTE_MIN_CUTOFF 0.5 // фильтр указки: частота среза в покое (Гц)
+#define MOUSE_ABSOLUTE_BETA 8.0       // фильтр указки: прирост частоты среза со скоростью
 // #define MOUSE_SIDE_INVERT             // инвертировать ось Z (если включено, то при наклоне вниз будет работать мышь, а при наклоне вверх — клавиатура)
 
 // === Настройка ориентации датчика ===
-#define MOUSE_INVERT_X 0           // инвертировать ось X
-#define MOUSE_INVERT_Y 0           // инвертировать ось Y
-#define MOUSE_INVERT_Z 0           // инвертировать ось Z (для определения стороны)
-#define MOUSE_SENSOR_ROTATION 0    // поворот датчика: 0, 90, 180 или 270 градусов
+// Поворот и переворот задают матрицу установки по умолчанию; на лету меняется через /api/mouse/mount
+#define MOUSE_INVERT_X 0           // инвертировать курсор по оси X
+#define MOUSE_INVERT_Y 0           // инвертировать курсор по оси Y
+#define MOUSE_INVERT_Z 1           // датчик перевернут: Z смотрит от стороны мыши (180° вокруг Y)
+#define MOUSE_SENSOR_ROTATION 0    // поворот датчика вокруг Z: 0, 90, 180 или 270 градусов
+#define MOUSE_ORIENTATION_QUAT 1   // 1 - кватернион (рыскание и тангаж), 0 - комплементарный фильтр (наклоны по X и Y)
+#define ORIENTATION_KP 1.0         // вес коррекции горизонта по акселерометру
+#define ORIENTATION_KI 0.0         // вес интегральной коррекции (смещение гироскопа уже отслеживает gyro_bias)
 
 #if DEBUG
 #pragma message("[DEBUG ENABLED] config.h loaded with HID + mouse + LED + power")
@@ -7,11 +7,23 @@
 #define CONFIG_PATH "/config.bin"
 #define CONFIG_WIFI_PATH "/wifi.bin"
 #define CONFIG_COLOR_PATH "/color.bin"
+#define CONFIG_MOUSE_PATH "/mouse.bin"
+#define CONFIG_GESTURE_PATH "/gesture.bin"
+#define CONFIG_TIMING_PATH "/timing.bin"
+#define CONFIG_TAP_DANCE_PATH "/tapdance.bin"
+#define CONFIG_COMBO_PATH "/combo.bin"
 
 ButtonLogic buttonLogic[MAX_LAYERS][NUM_DEFAULT_KEYS];
+ButtonAction gestureLogic[MAX_LAYERS][GESTURE_COUNT];
+ButtonKeyTiming keyTiming[NUM_DEFAULT_KEYS];
+TapDanceTable tapDance;
+ComboConfig comboConfig;
+static uint16_t buttonConfigVersion = 0;
+static SemaphoreHandle_t buttonConfigMutex = nullptr;
 uint32_t buttonColors[MAX_LAYERS][NUM_DEFAULT_KEYS];
 bool configLoaded = false;
 WiFiConfig wifiConfig;
+MouseSettings mouseSettings;
 
 
 void clear_config()
@@ -19,6 +31,7 @@ void clear_config()
 #if DEBUG
   Serial.println("[CFG] Config cleared");
 #endif
+  buttonConfigVersion++;
   for (size_t i = 0; i < MAX_LAYERS; i++)
   {
     for (size_t j = 0; j < NUM_DEFAULT_KEYS; j++)
@@ -44,6 +57,7 @@ void load_default_config()
       buttonLogic[i][j].hold.type = ACTION_NONE;
       buttonLogic[i][j].holdRepeat.type = ACTION_NONE;
       buttonLogic[i][j].holdRelease.type = ACTION_NONE;
+      buttonLogic[i][j].oneClickHold.type = ACTION_NONE;
       buttonLogic[i][j].release.type = ACTION_NONE;
 
       buttonColors[i][j] = LED_COLOR_DEFAULT;
@@ -85,6 +99,7 @@ bool load_button()
 
   file.read((uint8_t *)buttonLogic, sizeof(buttonLogic));
   file.close();
+  buttonConfigVersion++;
 
   configLoaded = true;
 #if DEBUG
@@ -189,11 +204,588 @@ bool load_wifi_config()
   return true;
 }
 
+// Ограничения параметров фильтра; false — непригодные значения
+static bool sanitize_filter(OneEuroConfig &filter)
+{
+  if (!(filter.minCutoff > 0 && filter.minCutoff <= 100) || !(filter.dCutoff > 0 && filter.dCutoff <= 100))
+    return false;
+  if (!(filter.beta >= 0 && filter.beta <= 1000))
+    return false;
+  return true;
+}
+
+static bool sanitize_mouse_settings(MouseSettings &settings)
+{
+  if (!(settings.deadzone >= 0 && settings.deadzone <= 5) || !(settings.sensitivity > 0 && settings.sensitivity <= 20))
+    return false;
+  if (!(settings.sideZone >= 0 && settings.sideZone < 1) || settings.sideSwitchThreshold < 1)
+    return false;
+  return accel_curve_sanitize(settings.curve) && sanitize_filter(settings.filter) && mount_matrix_valid(settings.mount) &&
+         scroll_settings_sanitize(settings.scroll) && absolute_pointer_config_valid(settings.pointer) &&
+         sanitize_filter(settings.pointer.filter);
+}
+
+void load_default_mouse_config()
+{
+  mouseSettings = {};
+  mouseSettings.deadzone = MOUSE_DEADZONE;
+  mouseSettings.sensitivity = MOUSE_SENSITIVITY;
+  mouseSettings.sideZone = MOUSE_SIDE_ZONE;
+  mouseSettings.sideSwitchThreshold = MOUSE_SIDE_SWITCH_THRESHOLD;
+  OneEuroConfig &filter = mouseSettings.filter;
+  filter.enabled = MOUSE_FILTER_ENABLE;
+  filter.minCutoff = MOUSE_FILTER_MIN_CUTOFF;
+  filter.beta = MOUSE_FILTER_BETA;
+  filter.dCutoff = MOUSE_FILTER_D_CUTOFF;
+
+#if MOUSE_INVERT_Z || defined(MOUSE_SIDE_INVERT)
+  mount_matrix_default(mouseSettings.mount, MOUSE_SENSOR_ROTATION, true);
+#else
+  mount_matrix_default(mouseSettings.mount, MOUSE_SENSOR_ROTATION, false);
+#endif
+
+  AccelCurveConfig &accelCurve = mouseSettings.curve;
+  accelCurve.type = MOUSE_ACCEL_CURVE;
+  accelCurve.minGain = MOUSE_PRECISION_SCALE;
+  accelCurve.maxGain = MOUSE_ACCEL_MULTIPLIER;
+  switch (accelCurve.type)
+  {
+  case ACCEL_CURVE_STEP:
+    accelCurve.threshold = MOUSE_ACCEL_THRESHOLD;
+    accelCurve.param = MOUSE_PRECISION_THRESHOLD;
+    break;
+  case ACCEL_CURVE_POWER:
+    accelCurve.threshold = MOUSE_ACCEL_THRESHOLD;
+    accelCurve.param = MOUSE_ACCEL_CURVE_POWER;
+    break;
+  case ACCEL_CURVE_SIGMOID:
+    accelCurve.threshold = MOUSE_ACCEL_CURVE_CENTER;
+    accelCurve.param = MOUSE_ACCEL_CURVE_WIDTH;
+    break;
+  default:
+    accelCurve.threshold = MOUSE_ACCEL_THRESHOLD;
+    break;
+  }
+  // Точки по умолчанию повторяют сигмоиду: точность -> 1.0 -> ускорение
+  accelCurve.pointCount = 3;
+  accelCurve.points[0] = {(float)MOUSE_PRECISION_THRESHOLD, (float)MOUSE_PRECISION_SCALE};
+  accelCurve.points[1] = {(float)MOUSE_ACCEL_CURVE_CENTER, 1.0f};
+  accelCurve.points[2] = {(float)MOUSE_ACCEL_THRESHOLD, (float)MOUSE_ACCEL_MULTIPLIER};
+
+  ScrollSettings &scroll = mouseSettings.scroll;
+  scroll.curve.type = ACCEL_CURVE_SIGMOID;
+  scroll.curve.minGain = MOUSE_SCROLL_MIN_GAIN;
+  scroll.curve.maxGain = MOUSE_SCROLL_MAX_GAIN;
+  scroll.curve.threshold = MOUSE_SCROLL_CENTER;
+  scroll.curve.param = MOUSE_SCROLL_WIDTH;
+  scroll.curve.pointCount = 2;
+  scroll.curve.points[0] = {(float)MOUSE_SCROLL_CENTER - (float)MOUSE_SCROLL_WIDTH, (float)MOUSE_SCROLL_MIN_GAIN};
+  scroll.curve.points[1] = {(float)MOUSE_SCROLL_CENTER + (float)MOUSE_SCROLL_WIDTH, (float)MOUSE_SCROLL_MAX_GAIN};
+  scroll.sensitivity = MOUSE_SCROLL_SENSITIVITY;
+  scroll.deadzone = MOUSE_SCROLL_DEADZONE;
+  scroll.invert = MOUSE_SCROLL_INVERT;
+  scroll.layers = MOUSE_SCROLL_LAYERS;
+
+  // Указка: прямоугольник вокруг направления при включении, до калибровки
+  AbsolutePointerConfig &pointer = mouseSettings.pointer;
+  pointer.left = -MOUSE_ABSOLUTE_SPAN_X / 2;
+  pointer.right = MOUSE_ABSOLUTE_SPAN_X / 2;
+  pointer.top = -MOUSE_ABSOLUTE_SPAN_Y / 2;
+  pointer.bottom = MOUSE_ABSOLUTE_SPAN_Y / 2;
+  pointer.width = MOUSE_ABSOLUTE_WIDTH;
+  pointer.height = MOUSE_ABSOLUTE_HEIGHT;
+  pointer.filter.enabled = true;
+  pointer.filter.minCutoff = MOUSE_ABSOLUTE_MIN_CUTOFF;
+  pointer.filter.beta = MOUSE_ABSOLUTE_BETA;
+  pointer.filter.dCutoff = MOUSE_FILTER_D_CUTOFF;
+  sanitize_mouse_settings(mouseSettings);
+}
+
+bool load_mouse_config()
+{
+  load_default_mouse_config();
+  if (!LittleFS.begin(true))
+  {
+#if DEBUG
+    Serial.println("[CFG] Mount LittleFS failed");
+#endif
+    return false;
+  }
+
+  File file = LittleFS.open(CONFIG_MOUSE_PATH, FILE_READ);
+  if (!file)
+  {
+#if DEBUG
+    Serial.println("[CFG] Mouse config not found, using default");
+#endif
+    return false;
+  }
+
+  MouseSettings settings;
+  if (file.size() != sizeof(settings))
+  {
+#if DEBUG
+    Serial.printf("[CFG] Wrong file size: %d, expected: %d\n", (int)file.size(), (int)sizeof(settings));
+#endif
+    file.close();
+    return false;
+  }
+
+  file.read((uint8_t *)&settings, sizeof(settings));
+  file.close();
+  if (!sanitize_mouse_settings(settings))
+  {
+#if DEBUG
+    Serial.println("[CFG] Invalid mouse config, using default");
+#endif
+    return false;
+  }
+  mouseSettings = settings;
+#if DEBUG
+  Serial.printf("[CFG] Mouse config loaded: curve %s, filter %s\n", accel_curve_name(mouseSettings.curve.type), mouseSettings.filter.enabled ? "on" : "off");
+#endif
+  return true;
+}
+
+const MouseSettings &get_mouse_settings()
+{
+  return mouseSettings;
+}
+
+bool set_mouse_settings(const MouseSettings &settings)
+{
+  MouseSettings checked = settings;
+  if (!sanitize_mouse_settings(checked))
+    return false;
+
+  if (!LittleFS.begin(true))
+  {
+#if DEBUG
+    Serial.println("[CFG] Mount LittleFS failed");
+#endif
+    return false;
+  }
+
+  File file = LittleFS.open(CONFIG_MOUSE_PATH, FILE_WRITE);
+  if (!file)
+  {
+#if DEBUG
+    Serial.println("[CFG] File open failed");
+#endif
+    return false;
+  }
+
+  size_t written = file.write((const uint8_t *)&checked, sizeof(checked));
+  file.close();
+#if DEBUG
+  Serial.printf("[CFG] Mouse config saved (%d bytes)\n", (int)written);
+#endif
+  if (written != sizeof(checked))
+    return false;
+  mouseSettings = checked; // только записанное: при сбое остаются прежние настройки
+  return true;
+}
+
+// === Жесты: по умолчанию действий нет ===
+bool load_gesture_config()
+{
+  for (size_t i = 0; i < MAX_LAYERS; i++)
+    for (size_t j = 0; j < GESTURE_COUNT; j++)
+      gestureLogic[i][j] = {ACTION_NONE, 0, 0};
+
+  if (!LittleFS.begin(true))
+  {
+#if DEBUG
+    Serial.println("[CFG] Mount LittleFS failed");
+#endif
+    return false;
+  }
+
+  File file = LittleFS.open(CONFIG_GESTURE_PATH, FILE_READ);
+  if (!file)
+  {
+#if DEBUG
+    Serial.println("[CFG] Gesture config not found, using default");
+#endif
+    return false;
+  }
+
+  if (file.size() != sizeof(gestureLogic))
+  {
+#if DEBUG
+    Serial.printf("[CFG] Wrong file size: %d, expected: %d\n", (int)file.size(), (int)sizeof(gestureLogic));
+#endif
+    file.close();
+    return false;
+  }
+
+  file.read((uint8_t *)gestureLogic, sizeof(gestureLogic));
+  file.close();
+#if DEBUG
+  Serial.println("[CFG] Gesture config loaded");
+#endif
+  return true;
+}
+
+const ButtonAction get_gesture_action(byte layer, uint8_t gesture)
+{
+  if (layer >= MAX_LAYERS || gesture >= GESTURE_COUNT)
+    return {ACTION_NONE, 0};
+  return gestureLogic[layer][gesture];
+}
+
+void set_gesture_action(uint8_t layer, uint8_t gesture, ButtonActionType type, int16_t code, int16_t sub_code)
+{
+  if (layer >= MAX_LAYERS || gesture >= GESTURE_COUNT)
+    return;
+  gestureLogic[layer][gesture] = {type, code, sub_code};
+}
+
+bool save_gesture_config()
+{
+  if (!LittleFS.begin(true))
+  {
+#if DEBUG
+    Serial.println("[CFG] Mount LittleFS failed");
+#endif
+    return false;
+  }
+
+  File file = LittleFS.open(CONFIG_GESTURE_PATH, FILE_WRITE);
+  if (!file)
+  {
+#if DEBUG
+    Serial.println("[CFG] File open failed");
+#endif
+    return false;
+  }
+
+  size_t written = file.write((uint8_t *)gestureLogic, sizeof(gestureLogic));
+  file.close();
+#if DEBUG
+  Serial.printf("[CFG] Saved gesture logic (%d bytes)\n", (int)written);
+#endif
+  return written == sizeof(gestureLogic);
+}
+
+// === Серии нажатий: по умолчанию нет ===
+bool load_tap_dance_config()
+{
+  tap_dance_init(tapDance);
+  buttonConfigVersion++;
+
+  if (!LittleFS.begin(true))
+  {
+#if DEBUG
+    Serial.println("[CFG] Mount LittleFS failed");
+#endif
+    return false;
+  }
+
+  File file = LittleFS.open(CONFIG_TAP_DANCE_PATH, FILE_READ);
+  if (!file)
+  {
+#if DEBUG
+    Serial.println("[CFG] Tap dance config not found, using default");
+#endif
+    return false;
+  }
+
+  if (file.size() != sizeof(tapDance))
+  {
+#if DEBUG
+    Serial.printf("[CFG] Wrong file size: %d, expected: %d\n", (int)file.size(), (int)sizeof(tapDance));
+#endif
+    file.close();
+    return false;
+  }
+
+  file.read((uint8_t *)&tapDance, sizeof(tapDance));
+  file.close();
+  if (tapDance.count > TAP_DANCE_MAX)
+    tap_dance_init(tapDance);
+#if DEBUG
+  Serial.printf("[CFG] Tap dance config loaded (%u entries)\n", tapDance.count);
+#endif
+  return true;
+}
+
+const TapDanceTable &get_tap_dance()
+{
+  return tapDance;
+}
+
+bool set_tap_dance_action(uint8_t layer, uint8_t key, uint8_t taps, bool hold, ButtonActionType type, int16_t code, int16_t sub_code)
+{
+  if (layer >= MAX_LAYERS || key >= NUM_DEFAULT_KEYS)
+    return false;
+  TapDanceEntry e = {layer, key, taps, hold, type, code, sub_code};
+  button_config_lock();
+  bool ok = tap_dance_set(tapDance, e);
+  if (ok)
+    buttonConfigVersion++;
+  button_config_unlock();
+  return ok;
+}
+
+bool save_tap_dance_config()
+{
+  if (!LittleFS.begin(true))
+  {
+#if DEBUG
+    Serial.println("[CFG] Mount LittleFS failed");
+#endif
+    return false;
+  }
+
+  File file = LittleFS.open(CONFIG_TAP_DANCE_PATH, FILE_WRITE);
+  if (!file)
+  {
+#if DEBUG
+    Serial.println("[CFG] File open failed");
+#endif
+    return false;
+  }
+
+  size_t written = file.write((uint8_t *)&tapDance, sizeof(tapDance));
+  file.close();
+#if DEBUG
+  Serial.printf("[CFG] Saved tap dance (%d bytes)\n", (int)written);
+#endif
+  return written == sizeof(tapDance);
+}
+
+// === Сочетания: по умолчанию нет ===
+bool load_combo_config()
+{
+  memset(&comboConfig, 0, sizeof(comboConfig));
+  comboConfig.windowMs = COMBO_WINDOW_MS;
+  buttonConfigVersion++;
+
+  if (!LittleFS.begin(true))
+  {
+#if DEBUG
+    Serial.println("[CFG] Mount LittleFS failed");
+#endif
+    return false;
+  }
+
+  File file = LittleFS.open(CONFIG_COMBO_PATH, FILE_READ);
+  if (!file)
+  {
+#if DEBUG
+    Serial.println("[CFG] Combo config not found, using default");
+#endif
+    return false;
+  }
+
+  if (file.size() != sizeof(comboConfig))
+  {
+#if DEBUG
+    Serial.printf("[CFG] Wrong file size: %d, expected: %d\n", (int)file.size(), (int)sizeof(comboConfig));
+#endif
+    file.close();
+    return false;
+  }
+
+  ComboConfig loaded;
+  file.read((uint8_t *)&loaded, sizeof(loaded));
+  file.close();
+  if (!combo_config_valid(loaded, NUM_DEFAULT_KEYS))
+  {
+#if DEBUG
+    Serial.println("[CFG] Combo config invalid, using default");
+#endif
+    return false;
+  }
+  comboConfig = loaded;
+#if DEBUG
+  Serial.printf("[CFG] Combo config loaded (%u combos)\n", comboConfig.count);
+#endif
+  return true;
+}
+
+const ComboConfig &get_combo_config()
+{
+  return comboConfig;
+}
+
+bool check_combo_config(const ComboConfig &combos)
+{
+  if (!combo_config_valid(combos, NUM_DEFAULT_KEYS))
+    return false;
+  for (uint8_t i = 0; i < combos.count; i++)
+    if (combos.entries[i].layer != COMBO_ANY_LAYER && combos.entries[i].layer >= MAX_LAYERS)
+      return false;
+  return combo_window_fits_hold(combos, keyTiming, BUTTON_HOLD_MS, BUTTON_DEBOUNCE_MS);
+}
+
+// Сначала файл, потом публикация: при сбое записи движок остается на прежних сочетаниях
+bool set_combo_config(const ComboConfig &combos)
+{
+  if (!check_combo_config(combos))
+    return false;
+
+  if (!LittleFS.begin(true))
+  {
+#if DEBUG
+    Serial.println("[CFG] Mount LittleFS failed");
+#endif
+    return false;
+  }
+
+  File file = LittleFS.open(CONFIG_COMBO_PATH, FILE_WRITE);
+  if (!file)
+  {
+#if DEBUG
+    Serial.println("[CFG] File open failed");
+#endif
+    return false;
+  }
+
+  size_t written = file.write((const uint8_t *)&combos, sizeof(combos));
+  file.close();
+#if DEBUG
+  Serial.printf("[CFG] Saved combos (%d bytes)\n", (int)written);
+#endif
+  if (written != sizeof(combos))
+    return false;
+
+  button_config_lock();
+  comboConfig = combos;
+  buttonConfigVersion++;
+  button_config_unlock();
+  return true;
+}
+
+// === Времена кнопок: по умолчанию у всех общие ===
+bool load_key_timing_config()
+{
+  memset(keyTiming, 0, sizeof(keyTiming));
+  buttonConfigVersion++;
+
+  if (!LittleFS.begin(true))
+  {
+#if DEBUG
+    Serial.println("[CFG] Mount LittleFS failed");
+#endif
+    return false;
+  }
+
+  File file = LittleFS.open(CONFIG_TIMING_PATH, FILE_READ);
+  if (!file)
+  {
+#if DEBUG
+    Serial.println("[CFG] Timing config not found, using default");
+#endif
+    return false;
+  }
+
+  if (file.size() != sizeof(keyTiming))
+  {
+#if DEBUG
+    Serial.printf("[CFG] Wrong file size: %d, expected: %d\n", (int)file.size(), (int)sizeof(keyTiming));
+#endif
+    file.close();
+    return false;
+  }
+
+  file.read((uint8_t *)keyTiming, sizeof(keyTiming));
+  file.close();
+#if DEBUG
+  Serial.println("[CFG] Timing config loaded");
+#endif
+  return true;
+}
+
+const ButtonKeyTiming (&get_key_timing())[NUM_DEFAULT_KEYS]
+{
+  return keyTiming;
+}
+
+// 0 — общее значение; антидребезг ограничен счетчиком движка кнопок
+static bool key_timing_valid(const ButtonKeyTiming &timing)
+{
+  if (timing.debounceMs > (BUTTON_ENGINE_MAX_DEBOUNCE - 1) * (SCHED_APP_PERIOD_US / 1000))
+    return false;
+  if (timing.holdMs && (timing.holdMs < 100 || timing.holdMs > 5000))
+    return false;
+  if (timing.clickTimeoutMs && (timing.clickTimeoutMs < 50 || timing.clickTimeoutMs > 2000))
+    return false;
+  return true;
+}
+
+bool check_key_timing(uint8_t key, const ButtonKeyTiming &timing)
+{
+  if (key >= NUM_DEFAULT_KEYS || !key_timing_valid(timing))
+    return false;
+  // Удержание кнопки сочетания не короче окна сочетаний
+  ButtonKeyTiming next[NUM_DEFAULT_KEYS];
+  memcpy(next, keyTiming, sizeof(next));
+  next[key] = timing;
+  return combo_window_fits_hold(comboConfig, next, BUTTON_HOLD_MS, BUTTON_DEBOUNCE_MS);
+}
+
+// Сначала файл, потом публикация: при сбое записи движок остается на прежних временах
+bool set_key_timing(uint8_t key, const ButtonKeyTiming &timing)
+{
+  if (!check_key_timing(key, timing))
+    return false;
+  ButtonKeyTiming next[NUM_DEFAULT_KEYS];
+  memcpy(next, keyTiming, sizeof(next));
+  next[key] = timing;
+
+  if (!LittleFS.begin(true))
+  {
+#if DEBUG
+    Serial.println("[CFG] Mount LittleFS failed");
+#endif
+    return false;
+  }
+
+  File file = LittleFS.open(CONFIG_TIMING_PATH, FILE_WRITE);
+  if (!file)
+  {
+#if DEBUG
+    Serial.println("[CFG] File open failed");
+#endif
+    return false;
+  }
+
+  size_t written = file.write((const uint8_t *)next, sizeof(next));
+  file.close();
+#if DEBUG
+  Serial.printf("[CFG] Saved key timing (%d bytes)\n", (int)written);
+#endif
+  if (written != sizeof(next))
+    return false;
+
+  button_config_lock();
+  keyTiming[key] = timing;
+  buttonConfigVersion++;
+  button_config_unlock();
+  return true;
+}
+
+uint16_t get_button_config_version()
+{
+  return buttonConfigVersion;
+}
+
+void button_config_lock() { xSemaphoreTake(buttonConfigMutex, portMAX_DELAY); }
+void button_config_unlock() { xSemaphoreGive(buttonConfigMutex); }
+
 bool load_config()
 {
+  buttonConfigMutex = xSemaphoreCreateMutex(); // до запуска задач: загрузка ниже идет без блокировки
   load_button();
   load_color();
   load_wifi_config();
+  load_mouse_config();
+  load_gesture_config();
+  load_key_timing_config();
+  load_tap_dance_config();
+  load_combo_config();
   return configLoaded;
 }
 
@@ -218,6 +810,8 @@ const ButtonAction get_button_action(byte layer, byte key, ButtonActionKind kind
     return buttonLogic[layer][key].holdRepeat;
   case BUTTON_HOLD_RELEASE:
     return buttonLogic[layer][key].holdRelease;
+  case BUTTON_ONE_CLICK_HOLD:
+    return buttonLogic[layer][key].oneClickHold;
   case BUTTON_RELEASE:
     return buttonLogic[layer][key].release;
   }
@@ -226,6 +820,7 @@ const ButtonAction get_button_action(byte layer, byte key, ButtonActionKind kind
 
 void set_button_logic(const ButtonLogic (&newLogic)[MAX_LAYERS][NUM_DEFAULT_KEYS])
 {
+  button_config_lock();
   for (size_t i = 0; i < MAX_LAYERS; i++)
   {
     for (size_t j = 0; j < NUM_DEFAULT_KEYS; j++)
@@ -233,12 +828,15 @@ void set_button_logic(const ButtonLogic (&newLogic)[MAX_LAYERS][NUM_DEFAULT_KEYS
       buttonLogic[i][j] = newLogic[i][j];
     }
   }
+  buttonConfigVersion++;
+  button_config_unlock();
 }
 
 void set_button_action(uint8_t layer, uint8_t key, ButtonActionType type, int16_t code, int16_t sub_code, ButtonActionKind kind)
 {
   if (layer >= MAX_LAYERS || key >= NUM_DEFAULT_KEYS)
     return;
+  button_config_lock();
   switch (kind)
   {
   case BUTTON_CLICK:
@@ -256,10 +854,15 @@ void set_button_action(uint8_t layer, uint8_t key, ButtonActionType type, int16_
   case BUTTON_HOLD_RELEASE:
     buttonLogic[layer][key].holdRelease = {type, code, sub_code};
     break;
+  case BUTTON_ONE_CLICK_HOLD:
+    buttonLogic[layer][key].oneClickHold = {type, code, sub_code};
+    break;
   case BUTTON_RELEASE:
     buttonLogic[layer][key].release = {type, code, sub_code};
     break;
   }
+  buttonConfigVersion++;
+  button_config_unlock();
 }
 
 void set_button_color(uint8_t layer, uint8_t key, uint32_t color)
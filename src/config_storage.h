@@ -3,6 +3,15 @@
 
 #include <Arduino.h>
 #include "config.h"
+#include "accel_curve.h"
+#include "one_euro.h"
+#include "orientation.h"
+#include "gesture.h"
+#include "scroll.h"
+#include "absolute_pointer.h"
+#include "button_engine.h"
+#include "tap_dance.h"
+#include "combo.h"
 
 // Структура действия кнопки
 struct ButtonAction
@@ -62,9 +71,53 @@ void set_button_action(uint8_t layer, uint8_t key, ButtonActionType type, int16_
 void set_button_color(uint8_t layer, uint8_t key, uint32_t color);
 bool save_full_button_config();
 bool save_color_config();
+uint16_t get_button_config_version(); // меняется при каждой смене логики или времен кнопок
+// Логика, времена, серии и сочетания кнопок: веб-задача меняет их, task_app читает — обе стороны под этим мьютексом
+void button_config_lock();
+void button_config_unlock();
+
+// === Серии нажатий по слоям (/tapdance.bin): тройной, четверной клик, N кликов + удержание ===
+const TapDanceTable &get_tap_dance();
+// type ACTION_NONE — удалить; false — неверная серия или таблица заполнена
+bool set_tap_dance_action(uint8_t layer, uint8_t key, uint8_t taps, bool hold, ButtonActionType type, int16_t code, int16_t sub_code);
+bool save_tap_dance_config();
+
+// === Сочетания кнопок (/combo.bin) ===
+const ComboConfig &get_combo_config();
+bool check_combo_config(const ComboConfig &combos); // формат, слои и окно короче удержания кнопок
+bool set_combo_config(const ComboConfig &combos);   // проверка и сохранение в /combo.bin
+
+// === Времена кнопок (/timing.bin): 0 — общее значение из config.h ===
+const ButtonKeyTiming (&get_key_timing())[NUM_DEFAULT_KEYS];
+bool check_key_timing(uint8_t key, const ButtonKeyTiming &timing); // пределы и удержание длиннее окна сочетаний
+bool set_key_timing(uint8_t key, const ButtonKeyTiming &timing);   // проверка и сохранение в /timing.bin
+
+// === Действия жестов по слоям (/gesture.bin) ===
+extern ButtonAction gestureLogic[MAX_LAYERS][GESTURE_COUNT];
+const ButtonAction get_gesture_action(byte layer, uint8_t gesture);
+void set_gesture_action(uint8_t layer, uint8_t gesture, ButtonActionType type, int16_t code, int16_t sub_code);
+bool save_gesture_config();
 
 // === Wi-Fi конфигурация ===
 String get_wifi_ssid();
 String get_wifi_password();
 bool get_wifi_mode();
-bool save_wifi_config(const String &ssid, const String &password, bool mode);
\ No newline at end of file
+bool save_wifi_config(const String &ssid, const String &password, bool mode);
+
+// === Настройки мыши (/mouse.bin) ===
+struct MouseSettings
+{
+  float deadzone;                  // мертвая зона (градусы за 10 мс)
+  float sensitivity;               // чувствительность
+  float sideZone;                  // порог accZ для смены стороны (g)
+  uint8_t sideSwitchThreshold;     // отсчетов подряд за порогом для смены стороны
+  AccelCurveConfig curve;          // кривая ускорения
+  OneEuroConfig filter;            // фильтр дрожания
+  int8_t mount[MOUNT_MATRIX_SIZE]; // матрица установки датчика: оси датчика -> оси пульта
+  ScrollSettings scroll;           // прокрутка наклоном
+  AbsolutePointerConfig pointer;   // режим указки: прямоугольник экрана
+};
+
+void load_default_mouse_config();
+const MouseSettings &get_mouse_settings();
+bool set_mouse_settings(const MouseSettings &settings); // проверка и сохранение в /mouse.bin
@@ -0,0 +1,27 @@
+// fixed_point.h — арифметика Q16.16 для целочисленной обработки движения
+#pragma once
+
+#include <stdint.h>
+
+// === Фиксированная точка Q16.16 ===
+typedef int32_t q16_t;
+
+#define Q16_SHIFT 16
+#define Q16_ONE (1 << Q16_SHIFT)
+
+inline q16_t q16_from_float(float v)
+{
+  return (q16_t)(v >= 0 ? v * Q16_ONE + 0.5f : v * Q16_ONE - 0.5f);
+}
+
+inline float q16_to_float(q16_t v)
+{
+  return (float)v / Q16_ONE;
+}
+
+// Умножение Q16.16 x Q16.16 с усечением к нулю (как приведение float -> int)
+inline q16_t q16_mul(q16_t a, q16_t b)
+{
+  int64_t p = (int64_t)a * b;
+  return (q16_t)(p >= 0 ? p >> Q16_SHIFT : -((-p) >> Q16_SHIFT));
+}
@@ -0,0 +1,183 @@
+// gesture.cpp — распознавание взмахов, тряски, поворота и подъема по потоку скоростей
+#include "gesture.h"
+#include <math.h>
+#include <string.h>
+
+#define GESTURE_BURST_RELEASE 0.5f // всплеск заканчивается ниже половины порога
+#define GESTURE_TWIST_DOMINANCE 2.0f // крен должен быть больше рыскания и тангажа во столько раз
+
+void gesture_init(GestureRecognizer &g, const GestureConfig &cfg)
+{
+  memset(&g, 0, sizeof(g));
+  g.cfg = cfg;
+}
+
+static void reset_series(GestureRecognizer &g)
+{
+  g.burstSign = 0;
+  g.burstUs = 0;
+  g.firstSign = 0;
+  g.lastSign = 0;
+  g.peaks = 0;
+  g.firstShort = false;
+  g.seriesUs = 0;
+  g.gapUs = 0;
+}
+
+static uint8_t emit(GestureRecognizer &g, uint8_t gesture)
+{
+  reset_series(g);
+  g.twist = 0;
+  g.twistUs = 0;
+  g.raiseArmed = false;
+  g.refractoryUs = g.cfg.refractoryUs;
+  g.detected[gesture]++;
+  return gesture;
+}
+
+// Серия всплесков рыскания: тряска — сразу по числу всплесков, взмах — после паузы, если всплеск был один короткий
+static uint8_t update_bursts(GestureRecognizer &g, float yawRate, uint32_t dtUs)
+{
+  float a = fabsf(yawRate);
+  int8_t sign = yawRate > 0 ? 1 : -1;
+  if (g.peaks || g.burstSign)
+    g.seriesUs += dtUs;
+
+  if (g.burstSign && (a < g.cfg.burstRate * GESTURE_BURST_RELEASE || sign != g.burstSign))
+  {
+    // Всплеск закончился
+    if (g.peaks == 0)
+    {
+      g.firstSign = g.burstSign;
+      g.firstShort = g.burstUs <= g.cfg.flickMaxUs;
+    }
+    if (g.burstSign != g.lastSign)
+    {
+      g.peaks++;
+      g.lastSign = g.burstSign;
+    }
+    g.burstSign = 0;
+    g.burstUs = 0;
+    g.gapUs = 0;
+    if (g.peaks >= g.cfg.shakePeaks)
+      return emit(g, GESTURE_SHAKE);
+  }
+
+  if (a >= g.cfg.burstRate)
+  {
+    if (!g.burstSign)
+      g.burstSign = sign;
+    g.burstUs += dtUs;
+    return GESTURE_NONE;
+  }
+
+  if (g.peaks && !g.burstSign)
+  {
+    g.gapUs += dtUs;
+    if (g.gapUs >= g.cfg.seriesGapUs || g.seriesUs >= g.cfg.shakeWindowUs)
+    {
+      // Взмах с возвратом дает два всплеска; три и больше без тряски — просто размахивание
+      bool flick = g.firstShort && g.peaks <= 2;
+      int8_t dir = g.firstSign;
+      reset_series(g);
+      if (flick)
+        return emit(g, dir > 0 ? GESTURE_FLICK_LEFT : GESTURE_FLICK_RIGHT);
+    }
+  }
+  return GESTURE_NONE;
+}
+
+static uint8_t update_twist(GestureRecognizer &g, const GestureInput &in, uint32_t dtUs)
+{
+  float r = fabsf(in.rollRate);
+  float other = fmaxf(fabsf(in.yawRate), fabsf(in.pitchRate));
+  if (r >= g.cfg.twistRate && r >= other * GESTURE_TWIST_DOMINANCE)
+  {
+    if ((g.twist > 0) != (in.rollRate > 0))
+    {
+      g.twist = 0;
+      g.twistUs = 0;
+    }
+    g.twist += in.rollRate * dtUs * 1e-6f;
+    g.twistUs += dtUs;
+    if (g.twistUs > g.cfg.twistWindowUs)
+    {
+      g.twist = 0;
+      g.twistUs = 0;
+    }
+    else if (fabsf(g.twist) >= g.cfg.twistAngle)
+      return emit(g, GESTURE_TWIST);
+  }
+  else
+  {
+    g.twist = 0;
+    g.twistUs = 0;
+  }
+  return GESTURE_NONE;
+}
+
+static uint8_t update_raise(GestureRecognizer &g, const GestureInput &in, uint32_t dtUs)
+{
+  if (in.still)
+  {
+    g.raiseArmed = false;
+    if (g.stillUs < g.cfg.raiseStillUs)
+      g.stillUs += dtUs;
+    return GESTURE_NONE;
+  }
+  if (g.stillUs >= g.cfg.raiseStillUs)
+  {
+    g.raiseArmed = true;
+    g.raisePitch = 0;
+    g.raiseUs = 0;
+  }
+  g.stillUs = 0;
+  if (!g.raiseArmed)
+    return GESTURE_NONE;
+  g.raisePitch += in.pitchRate * dtUs * 1e-6f;
+  g.raiseUs += dtUs;
+  if (g.raisePitch >= g.cfg.raiseAngle)
+    return emit(g, GESTURE_RAISE);
+  if (g.raiseUs > g.cfg.raiseWindowUs)
+    g.raiseArmed = false;
+  return GESTURE_NONE;
+}
+
+uint8_t gesture_update(GestureRecognizer &g, const GestureInput &in, uint32_t dtUs)
+{
+  if (g.refractoryUs)
+  {
+    g.refractoryUs = g.refractoryUs > dtUs ? g.refractoryUs - dtUs : 0;
+    // Покой считается и в паузе: пульт могли положить сразу после жеста
+    if (!in.still)
+      g.stillUs = 0;
+    else if (g.stillUs < g.cfg.raiseStillUs)
+      g.stillUs += dtUs;
+    return GESTURE_NONE;
+  }
+  uint8_t gesture = update_raise(g, in, dtUs);
+  if (gesture != GESTURE_NONE)
+    return gesture;
+  gesture = update_bursts(g, in.yawRate, dtUs);
+  if (gesture != GESTURE_NONE)
+    return gesture;
+  return update_twist(g, in, dtUs);
+}
+
+const char *gesture_name(uint8_t gesture)
+{
+  switch (gesture)
+  {
+  case GESTURE_FLICK_LEFT:
+    return "flick_left";
+  case GESTURE_FLICK_RIGHT:
+    return "flick_right";
+  case GESTURE_SHAKE:
+    return "shake";
+  case GESTURE_TWIST:
+    return "twist";
+  case GESTURE_RAISE:
+    return "raise";
+  }
+  return "none";
+}
@@ -0,0 +1,72 @@
+// gesture.h — потоковое распознавание жестов по скоростям поворота: O(1) на отсчет, без буферов
+#pragma once
+
+#include <stdint.h>
+
+enum GestureType : uint8_t
+{
+  GESTURE_FLICK_LEFT = 0,  // короткий резкий поворот влево
+  GESTURE_FLICK_RIGHT = 1, // короткий резкий поворот вправо
+  GESTURE_SHAKE = 2,       // несколько быстрых поворотов туда-обратно
+  GESTURE_TWIST = 3,       // поворот вокруг продольной оси пульта
+  GESTURE_RAISE = 4,       // пульт подняли со стола и направили вверх
+  GESTURE_COUNT
+};
+
+#define GESTURE_NONE 0xFF
+
+struct GestureConfig
+{
+  float burstRate;        // порог всплеска скорости рыскания для взмаха и тряски (град/с)
+  uint32_t flickMaxUs;    // максимальная длительность всплеска взмаха
+  uint32_t seriesGapUs;   // пауза после всплеска, завершающая серию (решение: взмах или ничего)
+  uint8_t shakePeaks;     // всплесков с чередованием знака для тряски
+  uint32_t shakeWindowUs; // окно серии тряски
+  float twistRate;        // минимальная скорость поворота вокруг продольной оси (град/с)
+  float twistAngle;       // угол поворота для жеста (градусы)
+  uint32_t twistWindowUs; // за сколько нужно повернуть
+  uint32_t raiseStillUs;  // сколько пульт должен пролежать перед подъемом
+  float raiseAngle;       // подъем носа после начала движения (градусы)
+  uint32_t raiseWindowUs; // время на подъем после начала движения
+  uint32_t refractoryUs;  // пауза после жеста
+};
+
+// Скорости в осях пульта (град/с): рыскание влево, тангаж вверх, крен вокруг оси Y — плюс
+struct GestureInput
+{
+  float yawRate;
+  float pitchRate;
+  float rollRate;
+  bool still; // детектор покоя
+};
+
+struct GestureRecognizer
+{
+  GestureConfig cfg;
+  // Всплески рыскания: взмах и тряска
+  int8_t burstSign;    // знак текущего всплеска, 0 — всплеска нет
+  uint32_t burstUs;    // длительность текущего всплеска
+  int8_t firstSign;    // знак первого всплеска серии
+  int8_t lastSign;     // знак последнего всплеска серии
+  uint8_t peaks;       // всплески с чередованием знака в серии
+  bool firstShort;     // первый всплеск серии достаточно короткий для взмаха
+  uint32_t seriesUs;   // время с начала серии
+  uint32_t gapUs;      // время с конца последнего всплеска
+  // Поворот вокруг продольной оси
+  float twist;         // накопленный угол (градусы)
+  uint32_t twistUs;
+  // Подъем со стола
+  uint32_t stillUs;    // сколько пульт лежит
+  bool raiseArmed;
+  float raisePitch;
+  uint32_t raiseUs;
+  uint32_t refractoryUs; // остаток паузы после жеста
+  uint32_t detected[GESTURE_COUNT];
+};
+
+void gesture_init(GestureRecognizer &g, const GestureConfig &cfg);
+
+// Возвращает распознанный жест или GESTURE_NONE
+uint8_t gesture_update(GestureRecognizer &g, const GestureInput &in, uint32_t dtUs);
+
+const char *gesture_name(uint8_t gesture);
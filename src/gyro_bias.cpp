@@ -0,0 +1,112 @@
+// gyro_bias.cpp — фоновое уточнение смещения гироскопа
+#include "gyro_bias.h"
+#include <math.h>
+#include <string.h>
+
+static void reset_block(GyroBiasTracker &t)
+{
+  t.n = 0;
+  t.sumTemp = 0;
+  for (int i = 0; i < 3; i++)
+  {
+    t.sum[i] = 0;
+    t.sum2[i] = 0;
+  }
+}
+
+void gyro_bias_init(GyroBiasTracker &t, const GyroBiasModel &model)
+{
+  memset(&t, 0, sizeof(t));
+  t.model = model;
+}
+
+void gyro_bias_get(const GyroBiasTracker &t, float temp, float out[3])
+{
+  float dT = temp - t.model.tempRef;
+  for (int i = 0; i < 3; i++)
+    out[i] = t.model.bias[i] + t.model.slope[i] * dT;
+}
+
+bool gyro_bias_update(GyroBiasTracker &t, const float gyroRaw[3], float temp)
+{
+  for (int i = 0; i < 3; i++)
+  {
+    t.sum[i] += gyroRaw[i];
+    t.sum2[i] += gyroRaw[i] * gyroRaw[i];
+  }
+  t.sumTemp += temp;
+  if (++t.n < GYRO_BIAS_BLOCK)
+    return false;
+
+  float mean[3];
+  float blockTemp = t.sumTemp / t.n;
+  float predicted[3];
+  gyro_bias_get(t, blockTemp, predicted);
+  for (int i = 0; i < 3; i++)
+  {
+    mean[i] = t.sum[i] / t.n;
+    float var = t.sum2[i] / t.n - mean[i] * mean[i];
+    // Дрожание руки или медленный поворот — блок не годится
+    if (var > GYRO_BIAS_STILL_VAR || fabsf(mean[i] - predicted[i]) > GYRO_BIAS_MAX_STEP)
+    {
+      reset_block(t);
+      return false;
+    }
+  }
+  reset_block(t);
+
+  // Быстрая подстройка смещения по остатку относительно модели
+  GyroBiasModel &m = t.model;
+  for (int i = 0; i < 3; i++)
+    m.bias[i] += GYRO_BIAS_ALPHA * (mean[i] - predicted[i]);
+
+  // Медленная регрессия смещения по температуре
+  const float a = GYRO_BIAS_SLOPE_ALPHA;
+  if (!t.regPrimed)
+  {
+    t.regPrimed = true;
+    t.regTemp = blockTemp;
+    for (int i = 0; i < 3; i++)
+      t.regMean[i] = mean[i];
+  }
+  float dT = blockTemp - t.regTemp;
+  t.regTemp += a * dT;
+  t.tempVar = (1 - a) * (t.tempVar + a * dT * dT);
+  for (int i = 0; i < 3; i++)
+  {
+    float dy = mean[i] - t.regMean[i];
+    t.regMean[i] += a * dy;
+    t.cov[i] = (1 - a) * (t.cov[i] + a * dT * dy);
+  }
+
+  // Наклон оцениваем, только если температура заметно менялась
+  if (t.tempVar > GYRO_BIAS_TEMP_MIN_SPAN * GYRO_BIAS_TEMP_MIN_SPAN / 4)
+  {
+    for (int i = 0; i < 3; i++)
+    {
+      float slope = t.cov[i] / t.tempVar;
+      if (slope > GYRO_BIAS_MAX_SLOPE)
+        slope = GYRO_BIAS_MAX_SLOPE;
+      if (slope < -GYRO_BIAS_MAX_SLOPE)
+        slope = -GYRO_BIAS_MAX_SLOPE;
+      // Сохраняем текущее смещение при температуре последнего блока — меняется только наклон
+      m.bias[i] += (m.slope[i] - slope) * (blockTemp - m.tempRef);
+      m.slope[i] = slope;
+    }
+  }
+  t.acceptedBlocks++;
+  return true;
+}
+
+bool gyro_bias_changed(const GyroBiasModel &a, const GyroBiasModel &b, float delta)
+{
+  for (int i = 0; i < 3; i++)
+  {
+    if (fabsf(a.bias[i] - b.bias[i]) > delta)
+      return true;
+    // Расхождение наклона на 10 °C
+    if (fabsf(a.slope[i] - b.slope[i]) * 10.0f > delta)
+      return true;
+  }
+  return false;
+}
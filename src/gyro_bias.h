@@ -0,0 +1,51 @@
+// gyro_bias.h — фоновое уточнение смещения гироскопа в покое с учетом температурного дрейфа
+#pragma once
+
+#include <stdint.h>
+
+#define GYRO_BIAS_BLOCK 100            // отсчетов в блоке проверки покоя (0.5 с при 200 Гц)
+#define GYRO_BIAS_STILL_VAR 0.02f      // максимальная дисперсия гироскопа в покое ((град/с)²)
+#define GYRO_BIAS_MAX_STEP 1.0f        // максимальное отличие среднего блока от текущего смещения (град/с)
+#define GYRO_BIAS_ALPHA 0.1f           // вес нового блока для смещения
+#define GYRO_BIAS_SLOPE_ALPHA 0.01f    // вес нового блока для регрессии по температуре (окно ~50 с покоя)
+#define GYRO_BIAS_TEMP_MIN_SPAN 1.5f   // минимальный разброс температуры для оценки наклона (°C)
+#define GYRO_BIAS_MAX_SLOPE 0.2f       // ограничение температурного коэффициента (град/с на °C)
+
+// Модель смещения: bias(T) = bias + slope * (T - tempRef). Хранится в NVS
+struct GyroBiasModel
+{
+  float bias[3];  // град/с при tempRef
+  float tempRef;  // °C
+  float slope[3]; // град/с на °C
+};
+
+struct GyroBiasTracker
+{
+  GyroBiasModel model;
+
+  // Текущий блок
+  uint16_t n;
+  float sum[3];
+  float sum2[3];
+  float sumTemp;
+
+  // Экспоненциально взвешенная регрессия смещения по температуре
+  bool regPrimed;
+  float regTemp;
+  float regMean[3];
+  float tempVar;
+  float cov[3];
+
+  uint32_t acceptedBlocks; // блоков покоя, принятых в модель
+};
+
+void gyro_bias_init(GyroBiasTracker &t, const GyroBiasModel &model);
+
+// gyroRaw — показания гироскопа без коррекции (град/с). Возвращает true, если блок покоя принят
+bool gyro_bias_update(GyroBiasTracker &t, const float gyroRaw[3], float temp);
+
+// Смещение для текущей температуры
+void gyro_bias_get(const GyroBiasTracker &t, float temp, float out[3]);
+
+// Модели отличаются больше чем на delta (град/с в опорной точке)
+bool gyro_bias_changed(const GyroBiasModel &a, const GyroBiasModel &b, float delta);
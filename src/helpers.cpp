@@ -1,5 +1,5 @@
 #include "helpers.h"
-#include "config.h"
+#include <stdio.h>
 
 #ifndef HEPLPERS_CPP
 #define HEPLPERS_CPP
@@ -0,0 +1,26 @@
+// i2c_bus.cpp — реализация I2cBus поверх Wire
+#include "i2c_bus.h"
+#include <Wire.h>
+
+static bool wire_read(uint8_t addr, uint8_t reg, uint8_t *buf, uint8_t len)
+{
+  Wire.beginTransmission(addr);
+  Wire.write(reg);
+  if (Wire.endTransmission(false) != 0)
+    return false;
+  if (Wire.requestFrom(addr, len) != len)
+    return false;
+  for (uint8_t i = 0; i < len; i++)
+    buf[i] = Wire.read();
+  return true;
+}
+
+static bool wire_write(uint8_t addr, uint8_t reg, uint8_t val)
+{
+  Wire.beginTransmission(addr);
+  Wire.write(reg);
+  Wire.write(val);
+  return Wire.endTransmission() == 0;
+}
+
+const I2cBus i2c_wire_bus = {wire_read, wire_write};
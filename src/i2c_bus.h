@@ -0,0 +1,15 @@
+// i2c_bus.h — абстракция шины I2C (Wire на ESP32, фейковая шина в native-тестах)
+#pragma once
+
+#include <stdint.h>
+
+struct I2cBus
+{
+  // Чтение len байт начиная с регистра reg (автоинкремент адреса регистра)
+  bool (*read)(uint8_t addr, uint8_t reg, uint8_t *buf, uint8_t len);
+  // Запись одного байта в регистр
+  bool (*write)(uint8_t addr, uint8_t reg, uint8_t val);
+};
+
+// Шина на базе Wire (i2c_bus.cpp, только для прошивки)
+extern const I2cBus i2c_wire_bus;
@@ -0,0 +1,250 @@
+// i2c_manager.cpp — очередь транзакций I2C, объединение чтений, повторы и статистика (без привязки к Wire)
+#include "i2c_manager.h"
+#include <string.h>
+
+static inline void lock(I2cManager &m)
+{
+  if (m.lock)
+    m.lock();
+}
+
+static inline void unlock(I2cManager &m)
+{
+  if (m.unlock)
+    m.unlock();
+}
+
+void i2c_manager_init(I2cManager &m, const I2cBus *bus, uint32_t (*clock)())
+{
+  memset(&m, 0, sizeof(m));
+  m.bus = bus;
+  m.clock = clock;
+  m.retries = I2C_DEFAULT_RETRIES;
+}
+
+int8_t i2c_manager_add_device(I2cManager &m, uint8_t addr, bool autoIncrement, const char *name)
+{
+  int8_t found = i2c_manager_find(m, addr);
+  if (found >= 0)
+    return found;
+  if (m.deviceCount >= I2C_MAX_DEVICES)
+    return -1;
+  I2cDevice &d = m.devices[m.deviceCount];
+  memset(&d, 0, sizeof(d));
+  d.addr = addr;
+  d.autoIncrement = autoIncrement;
+  d.name = name;
+  return m.deviceCount++;
+}
+
+int8_t i2c_manager_find(const I2cManager &m, uint8_t addr)
+{
+  for (uint8_t i = 0; i < m.deviceCount; i++)
+    if (m.devices[i].addr == addr)
+      return i;
+  return -1;
+}
+
+void i2c_manager_reset_stats(I2cManager &m)
+{
+  lock(m);
+  for (uint8_t i = 0; i < m.deviceCount; i++)
+    memset(&m.devices[i].stats, 0, sizeof(I2cDeviceStats));
+  m.queueFull = 0;
+  unlock(m);
+}
+
+// Одна транзакция с повторами. len == 0 — запись val
+static bool transact(I2cManager &m, uint8_t device, uint8_t reg, uint8_t *buf, uint8_t len, uint8_t val)
+{
+  I2cDevice &d = m.devices[device];
+  lock(m);
+  uint32_t start = m.clock();
+  bool ok = false;
+  for (uint8_t attempt = 0; attempt <= m.retries && !ok; attempt++)
+  {
+    if (attempt)
+      d.stats.retries++;
+    ok = len ? m.bus->read(d.addr, reg, buf, len) : m.bus->write(d.addr, reg, val);
+    if (!ok)
+      d.stats.nacks++;
+  }
+  uint32_t latency = m.clock() - start;
+
+  if (len)
+    d.stats.reads++;
+  else
+    d.stats.writes++;
+  if (ok)
+    d.stats.bytes += len ? len : 1;
+  else
+    d.stats.failures++;
+  d.stats.totalLatencyUs += latency;
+  if (latency > d.stats.maxLatencyUs)
+    d.stats.maxLatencyUs = latency;
+  unlock(m);
+  return ok;
+}
+
+bool i2c_read(I2cManager &m, uint8_t device, uint8_t reg, uint8_t *buf, uint8_t len)
+{
+  if (device >= m.deviceCount || !len)
+    return false;
+  return transact(m, device, reg, buf, len, 0);
+}
+
+bool i2c_write(I2cManager &m, uint8_t device, uint8_t reg, uint8_t val)
+{
+  if (device >= m.deviceCount)
+    return false;
+  return transact(m, device, reg, nullptr, 0, val);
+}
+
+static bool submit(I2cManager &m, uint8_t device, uint8_t reg, uint8_t len, uint8_t val, I2cDoneFn done, void *ctx)
+{
+  if (device >= m.deviceCount || len > I2C_MAX_BATCH)
+    return false;
+  lock(m);
+  bool ok = m.queued < I2C_QUEUE_SIZE;
+  if (ok)
+  {
+    I2cRequest &r = m.queue[m.queued++];
+    r.device = device;
+    r.reg = reg;
+    r.len = len;
+    r.val = val;
+    r.seq = m.nextSeq++;
+    r.submittedUs = m.clock();
+    r.done = done;
+    r.ctx = ctx;
+  }
+  else
+    m.queueFull++;
+  unlock(m);
+  return ok;
+}
+
+bool i2c_submit_read(I2cManager &m, uint8_t device, uint8_t reg, uint8_t len, I2cDoneFn done, void *ctx)
+{
+  return len && submit(m, device, reg, len, 0, done, ctx);
+}
+
+bool i2c_submit_write(I2cManager &m, uint8_t device, uint8_t reg, uint8_t val, I2cDoneFn done, void *ctx)
+{
+  return submit(m, device, reg, 0, val, done, ctx);
+}
+
+// Следующий запрос — самый ранний (remove_at переставляет хвост, поэтому по seq, а не по индексу)
+static int8_t pick_next(const I2cManager &m)
+{
+  int8_t best = -1;
+  for (uint8_t i = 0; i < m.queued; i++)
+    if (best < 0 || (int32_t)(m.queue[i].seq - m.queue[best].seq) < 0)
+      best = i;
+  return best;
+}
+
+// Чтение можно добавить в пакет: то же устройство, нет более ранней записи в него, общий диапазон в пределах пакета
+static bool can_merge(const I2cManager &m, const I2cRequest &c, uint8_t device, uint16_t lo, uint16_t hi)
+{
+  if (c.device != device || !c.len)
+    return false;
+  if (c.reg > hi || c.reg + c.len < lo)
+    return false; // не соседние: между ними регистры, которые никто не просил
+  uint16_t from = c.reg < lo ? c.reg : lo;
+  uint16_t to = c.reg + c.len > hi ? c.reg + c.len : hi;
+  if (to - from > I2C_MAX_BATCH)
+    return false;
+  for (uint8_t i = 0; i < m.queued; i++)
+  {
+    const I2cRequest &w = m.queue[i];
+    if (w.device == device && !w.len && (int32_t)(w.seq - c.seq) < 0)
+      return false;
+  }
+  return true;
+}
+
+static inline void remove_at(I2cManager &m, uint8_t i)
+{
+  m.queue[i] = m.queue[--m.queued];
+}
+
+static uint32_t estimate_us(const I2cDevice &d)
+{
+  uint32_t n = d.stats.reads + d.stats.writes;
+  return n ? (uint32_t)(d.stats.totalLatencyUs / n) : I2C_DEFAULT_COST_US;
+}
+
+uint8_t i2c_manager_service(I2cManager &m, uint32_t budgetUs)
+{
+  uint32_t start = m.clock();
+  uint8_t executed = 0;
+  for (;;)
+  {
+    I2cRequest batch[I2C_QUEUE_SIZE];
+    uint8_t count = 0;
+    uint16_t lo = 0, hi = 0; // диапазон регистров пакета [lo, hi)
+
+    lock(m);
+    int8_t first = pick_next(m);
+    if (first < 0)
+    {
+      unlock(m);
+      break;
+    }
+    I2cRequest head = m.queue[first];
+    const I2cDevice &d = m.devices[head.device];
+    if (executed && m.clock() - start + estimate_us(d) > budgetUs)
+    {
+      unlock(m);
+      break; // остаток очереди подождет следующего вызова
+    }
+    remove_at(m, first);
+    batch[count++] = head;
+    lo = head.reg;
+    hi = head.reg + head.len;
+    if (head.len && d.autoIncrement)
+    {
+      // Добираем соседние чтения, пока диапазон растет
+      bool grown = true;
+      while (grown)
+      {
+        grown = false;
+        for (uint8_t i = 0; i < m.queued; i++)
+        {
+          const I2cRequest &c = m.queue[i];
+          if (!can_merge(m, c, head.device, lo, hi))
+            continue;
+          if (c.reg < lo)
+            lo = c.reg;
+          if (c.reg + c.len > hi)
+            hi = c.reg + c.len;
+          batch[count++] = c;
+          remove_at(m, i);
+          grown = true;
+          break;
+        }
+      }
+      m.devices[head.device].stats.merged += count - 1;
+    }
+    uint32_t now = m.clock();
+    for (uint8_t i = 0; i < count; i++)
+    {
+      uint32_t wait = now - batch[i].submittedUs;
+      if (wait > m.devices[head.device].stats.maxWaitUs)
+        m.devices[head.device].stats.maxWaitUs = wait;
+    }
+    unlock(m);
+
+    uint8_t data[I2C_MAX_BATCH];
+    bool ok = transact(m, head.device, lo, head.len ? data : nullptr, head.len ? hi - lo : 0, head.val);
+    executed++;
+    for (uint8_t i = 0; i < count; i++)
+    {
+      const I2cRequest &r = batch[i];
+      if (r.done)
+        r.done(r.ctx, ok, r.len ? data + (r.reg - lo) : nullptr, r.len);
+    }
+  }
+  return executed;
+}
@@ -0,0 +1,83 @@
+// i2c_manager.h — владелец шины I2C: очередь отложенных транзакций, пакетное чтение регистров, статистика по устройствам
+#pragma once
+
+#include <stdint.h>
+#include "i2c_bus.h"
+
+#define I2C_MAX_DEVICES 8
+#define I2C_QUEUE_SIZE 16        // отложенных транзакций
+#define I2C_MAX_BATCH 16         // байт в одном пакетном чтении
+#define I2C_DEFAULT_RETRIES 2    // повторов после неудачной попытки
+#define I2C_DEFAULT_COST_US 200  // оценка длительности транзакции, пока нет статистики устройства
+
+struct I2cDeviceStats
+{
+  uint32_t reads;          // транзакций чтения (пакет — одна)
+  uint32_t writes;
+  uint32_t bytes;          // прочитано и записано байт
+  uint32_t nacks;          // неудачных попыток: NACK или неполное чтение
+  uint32_t retries;        // повторов после неудачи
+  uint32_t failures;       // транзакций, не прошедших и после повторов
+  uint32_t merged;         // запросов, объединенных в чужой пакет
+  uint32_t maxLatencyUs;   // наибольшее время транзакции (с повторами)
+  uint64_t totalLatencyUs;
+  uint32_t maxWaitUs;      // наибольшее ожидание в очереди до начала транзакции
+};
+
+struct I2cDevice
+{
+  uint8_t addr;
+  bool autoIncrement;    // соседние регистры читаются одним пакетом
+  const char *name;
+  I2cDeviceStats stats;
+};
+
+// Результат отложенной транзакции. data — прочитанные байты (для записи — nullptr)
+typedef void (*I2cDoneFn)(void *ctx, bool ok, const uint8_t *data, uint8_t len);
+
+struct I2cRequest
+{
+  uint8_t device;
+  uint8_t reg;
+  uint8_t len;   // 0 — запись val
+  uint8_t val;
+  uint32_t seq;  // порядок постановки: очередь — FIFO
+  uint32_t submittedUs;
+  I2cDoneFn done;
+  void *ctx;
+};
+
+struct I2cManager
+{
+  const I2cBus *bus;       // Wire на устройстве, фейковая шина в тестах
+  uint32_t (*clock)();     // мкс
+  void (*lock)();          // владение шиной и очередью между задачами (nullptr — одна задача)
+  void (*unlock)();
+  uint8_t retries;
+  I2cDevice devices[I2C_MAX_DEVICES];
+  uint8_t deviceCount;
+  I2cRequest queue[I2C_QUEUE_SIZE];
+  uint8_t queued;
+  uint32_t nextSeq;
+  uint32_t queueFull;      // отказов в постановке
+};
+
+void i2c_manager_init(I2cManager &m, const I2cBus *bus, uint32_t (*clock)());
+// Номер устройства или -1. Повторная регистрация адреса возвращает прежний номер
+int8_t i2c_manager_add_device(I2cManager &m, uint8_t addr, bool autoIncrement, const char *name);
+int8_t i2c_manager_find(const I2cManager &m, uint8_t addr);
+void i2c_manager_reset_stats(I2cManager &m);
+
+// Транзакция сразу, в вызывающей задаче (для тех, кто сам работает по расписанию: IMU, кнопки)
+bool i2c_read(I2cManager &m, uint8_t device, uint8_t reg, uint8_t *buf, uint8_t len);
+bool i2c_write(I2cManager &m, uint8_t device, uint8_t reg, uint8_t val);
+
+// Отложенная транзакция: выполнится в i2c_manager_service, результат — в done (может быть nullptr).
+// false — очередь полна
+bool i2c_submit_read(I2cManager &m, uint8_t device, uint8_t reg, uint8_t len, I2cDoneFn done, void *ctx);
+bool i2c_submit_write(I2cManager &m, uint8_t device, uint8_t reg, uint8_t val, I2cDoneFn done, void *ctx);
+
+// Выполнение очереди по порядку постановки. Соседние чтения одного устройства с автоинкрементом объединяются в пакет.
+// Транзакция начинается, только если ее оценка укладывается в остаток budgetUs
+// (первая за вызов — всегда, чтобы очередь не голодала). Возвращает число выполненных транзакций
+uint8_t i2c_manager_service(I2cManager &m, uint32_t budgetUs);
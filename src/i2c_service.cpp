@@ -0,0 +1,101 @@
+// i2c_service.cpp — менеджер I2C поверх Wire: владение шиной между задачами и выдача статистики
+#include "i2c_service.h"
+#include "config.h"
+
+I2cManager i2cManager;
+static SemaphoreHandle_t i2cMutex = nullptr;
+
+static uint32_t i2c_clock() { return micros(); }
+
+// Мьютекс с наследованием приоритета: шина и очередь менеджера доступны из любой задачи
+static void i2c_lock() { xSemaphoreTake(i2cMutex, portMAX_DELAY); }
+static void i2c_unlock() { xSemaphoreGive(i2cMutex); }
+
+static bool managed_read(uint8_t addr, uint8_t reg, uint8_t *buf, uint8_t len)
+{
+  int8_t device = i2c_manager_find(i2cManager, addr);
+  return device >= 0 && i2c_read(i2cManager, device, reg, buf, len);
+}
+
+static bool managed_write(uint8_t addr, uint8_t reg, uint8_t val)
+{
+  int8_t device = i2c_manager_find(i2cManager, addr);
+  return device >= 0 && i2c_write(i2cManager, device, reg, val);
+}
+
+const I2cBus i2c_managed_bus = {managed_read, managed_write};
+
+void setup_i2c_service()
+{
+  i2cMutex = xSemaphoreCreateMutex();
+  i2c_manager_init(i2cManager, &i2c_wire_bus, i2c_clock);
+  i2cManager.lock = i2c_lock;
+  i2cManager.unlock = i2c_unlock;
+  i2cManager.retries = I2C_RETRIES;
+#if DEBUG
+  Serial.println("[I2C] Bus manager initialized");
+#endif
+}
+
+void i2c_service_loop()
+{
+  i2c_manager_service(i2cManager, I2C_SERVICE_BUDGET_US);
+}
+
+// === API ===
+
+static String device_json(const I2cDevice &d)
+{
+  const I2cDeviceStats &s = d.stats;
+  uint32_t n = s.reads + s.writes;
+  String json = "{";
+  json += "\"name\":\"" + String(d.name) + "\",";
+  json += "\"addr\":\"0x" + String(d.addr, HEX) + "\",";
+  json += "\"reads\":" + String(s.reads) + ",";
+  json += "\"writes\":" + String(s.writes) + ",";
+  json += "\"bytes\":" + String(s.bytes) + ",";
+  json += "\"nacks\":" + String(s.nacks) + ",";
+  json += "\"retries\":" + String(s.retries) + ",";
+  json += "\"failures\":" + String(s.failures) + ",";
+  json += "\"merged\":" + String(s.merged) + ",";
+  json += "\"avgLatencyUs\":" + String(n ? (uint32_t)(s.totalLatencyUs / n) : 0) + ",";
+  json += "\"maxLatencyUs\":" + String(s.maxLatencyUs) + ",";
+  json += "\"maxWaitUs\":" + String(s.maxWaitUs);
+  json += "}";
+  return json;
+}
+
+static String i2c_json()
+{
+  String json = "{";
+  json += "\"clockHz\":" + String(I2C_CLOCK_HZ) + ",";
+  json += "\"budgetUs\":" + String(I2C_SERVICE_BUDGET_US) + ",";
+  json += "\"queued\":" + String(i2cManager.queued) + ",";
+  json += "\"queueFull\":" + String(i2cManager.queueFull) + ",";
+  json += "\"devices\":[";
+  for (uint8_t i = 0; i < i2cManager.deviceCount; i++)
+  {
+    if (i)
+      json += ",";
+    json += device_json(i2cManager.devices[i]);
+  }
+  json += "]}";
+  return json;
+}
+
+void register_i2c_api(AsyncWebServer &server)
+{
+  server.on("/api/i2c", HTTP_GET, [](AsyncWebServerRequest *request)
+            { request->send(200, "application/json", i2c_json()); });
+
+  server.on("/api/i2c", HTTP_POST, [](AsyncWebServerRequest *request)
+            {
+    if (request->hasParam("reset", true) && request->getParam("reset", true)->value().toInt())
+    {
+      i2c_manager_reset_stats(i2cManager);
+#if DEBUG
+      Serial.println("[I2C] Statistics reset");
+#endif
+    }
+    request->send(200, "application/json", i2c_json()); });
+}
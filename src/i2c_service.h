@@ -0,0 +1,21 @@
+// i2c_service.h — менеджер шины I2C на устройстве: Wire, мьютекс между задачами, статистика по HTTP
+#pragma once
+
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+#include "i2c_manager.h"
+
+extern I2cManager i2cManager;
+// I2cBus поверх менеджера — для драйверов, написанных под I2cBus (MPU6050). Устройство должно быть добавлено в менеджер
+extern const I2cBus i2c_managed_bus;
+
+// Инициализация менеджера (после Wire.begin, до модулей с устройствами на шине)
+void setup_i2c_service();
+
+// Отложенные транзакции по порядку постановки в пределах I2C_SERVICE_BUDGET_US (ядро 0, задача планировщика).
+// В очередь ставит чтения только IP5306; MPU6050 и MCP23017 читают синхронно, мимо очереди —
+// по своему расписанию, с общим мьютексом и статистикой
+void i2c_service_loop();
+
+// GET /api/i2c — статистика по устройствам; POST /api/i2c (reset=1) — сброс
+void register_i2c_api(AsyncWebServer &server);
@@ -0,0 +1,50 @@
+#pragma once
+#include <Preferences.h>
+#include "gyro_bias.h"
+
+// Калибровка гироскопа в NVS: не нужно держать пульт неподвижно при каждом включении
+namespace ImuCalibration
+{
+
+  inline const char *NAMESPACE = "imu_cal";
+  inline const char *KEY = "gyro";
+  inline const uint32_t VERSION = 1;
+
+  struct Record
+  {
+    uint32_t version;
+    GyroBiasModel model;
+  };
+
+  inline bool load(GyroBiasModel &model)
+  {
+    Preferences prefs;
+    prefs.begin(NAMESPACE, true);
+    Record rec;
+    bool ok = prefs.getBytesLength(KEY) == sizeof(rec) &&
+              prefs.getBytes(KEY, &rec, sizeof(rec)) == sizeof(rec) &&
+              rec.version == VERSION;
+    prefs.end();
+    if (ok)
+      model = rec.model;
+    return ok;
+  }
+
+  inline void save(const GyroBiasModel &model)
+  {
+    Record rec = {VERSION, model};
+    Preferences prefs;
+    prefs.begin(NAMESPACE, false);
+    prefs.putBytes(KEY, &rec, sizeof(rec));
+    prefs.end();
+  }
+
+  inline void clear()
+  {
+    Preferences prefs;
+    prefs.begin(NAMESPACE, false);
+    prefs.remove(KEY);
+    prefs.end();
+  }
+
+} // namespace ImuCalibration
@@ -0,0 +1,44 @@
+// imu_filter.cpp — комплементарный фильтр углов наклона
+#include "imu_filter.h"
+#include <math.h>
+
+#define RAD_2_DEG 57.29578f
+
+static inline float wrap(float angle, float limit)
+{
+  while (angle > limit)
+    angle -= 2 * limit;
+  while (angle < -limit)
+    angle += 2 * limit;
+  return angle;
+}
+
+void imu_filter_reset(ImuFilter &f, float gyroCoef)
+{
+  f.angleX = 0;
+  f.angleY = 0;
+  f.accZ = 0;
+  f.gyroCoef = gyroCoef;
+  f.primed = false;
+}
+
+void imu_filter_update(ImuFilter &f, const ImuSample &s, float dt)
+{
+  // Знак Z позволяет углу X проходить весь диапазон -180..180
+  float sgZ = s.accZ < 0 ? -1.0f : 1.0f;
+  float angleAccX = atan2f(s.accY, sgZ * sqrtf(s.accZ * s.accZ + s.accX * s.accX)) * RAD_2_DEG;
+  float angleAccY = -atan2f(s.accX, sqrtf(s.accZ * s.accZ + s.accY * s.accY)) * RAD_2_DEG;
+
+  f.accZ = s.accZ;
+  if (!f.primed)
+  {
+    f.angleX = angleAccX;
+    f.angleY = angleAccY;
+    f.primed = true;
+    return;
+  }
+
+  float k = f.gyroCoef;
+  f.angleX = wrap(k * (angleAccX + wrap(f.angleX + s.gyroX * dt - angleAccX, 180)) + (1.0f - k) * angleAccX, 180);
+  f.angleY = wrap(k * (angleAccY + wrap(f.angleY + sgZ * s.gyroY * dt - angleAccY, 90)) + (1.0f - k) * angleAccY, 90);
+}
@@ -0,0 +1,28 @@
+// imu_filter.h — комплементарный фильтр: только то, что нужно processMouseMove (angleX, angleY, accZ)
+#pragma once
+
+#include <stdint.h>
+
+#define IMU_FILTER_GYRO_COEF 0.98f // вес гироскопа в комплементарном фильтре
+
+// Отсчет IMU в физических единицах
+struct ImuSample
+{
+  float accX, accY, accZ;    // g
+  float gyroX, gyroY, gyroZ; // градусы/с
+  float temp;                // °C
+};
+
+struct ImuFilter
+{
+  float angleX; // [-180, 180] градусов
+  float angleY; // [-90, 90] градусов
+  float accZ;   // g
+  float gyroCoef;
+  bool primed; // первый отсчет берется из акселерометра без интегрирования
+};
+
+void imu_filter_reset(ImuFilter &f, float gyroCoef = IMU_FILTER_GYRO_COEF);
+
+// dt — время с предыдущего отсчета в секундах
+void imu_filter_update(ImuFilter &f, const ImuSample &s, float dt);
@@ -0,0 +1,69 @@
+// imu_pipeline.cpp — цепочка обработки отсчета IMU без привязки к железу
+#include "imu_pipeline.h"
+
+void imu_pipeline_reset_orientation(ImuPipeline &p, float kp, float ki)
+{
+  orientation_reset(p.orientation, kp, ki);
+  imu_filter_reset(p.tilt);
+  motion_state_reset(p.motion);
+  p.angleX = 0;
+  p.angleY = 0;
+}
+
+uint8_t imu_pipeline_step(ImuPipeline &p, const ImuPipelineConfig &cfg, const MpuRawSample &raw, uint32_t dtUs, MouseDelta &out)
+{
+  uint8_t flags = 0;
+  float gyroRaw[3] = {raw.gyroX / MPU6050_GYRO_LSB, raw.gyroY / MPU6050_GYRO_LSB, raw.gyroZ / MPU6050_GYRO_LSB};
+  float temp = raw.temp / 340.0f + 36.53f;
+  if (gyro_bias_update(p.bias, gyroRaw, temp))
+    flags |= IMU_STEP_BIAS_UPDATED;
+  float bias[3];
+  gyro_bias_get(p.bias, temp, bias);
+  p.mpu->gyroOffsetX = bias[0];
+  p.mpu->gyroOffsetY = bias[1];
+  p.mpu->gyroOffsetZ = bias[2];
+
+  ImuSample &sample = p.sample;
+  mpu6050_scale(*p.mpu, raw, sample);
+  if (stillness_update(p.stillness, sample, dtUs))
+  {
+    flags |= IMU_STEP_STILL_CHANGED;
+    if (p.stillness.still)
+      motion_state_settle(p.motion); // остатки движения не должны выстрелить при следующем касании
+  }
+
+  // Оси датчика -> оси пульта: смещение гироскопа выше считается в осях датчика
+  mount_apply(cfg.mount, sample);
+  GestureInput gestureInput;
+  gestureInput.rollRate = sample.gyroY;
+  gestureInput.still = p.stillness.still;
+  if (p.quaternion)
+  {
+    orientation_update(p.orientation, sample, dtUs * 1e-6f);
+    // Поворот влево и наклон вверх ведут курсор влево и вверх
+    p.angleX = -p.orientation.yaw;
+    p.angleY = -p.orientation.pitch;
+    gestureInput.yawRate = p.orientation.yawRate;
+    gestureInput.pitchRate = p.orientation.pitchRate;
+  }
+  else
+  {
+    imu_filter_update(p.tilt, sample, dtUs * 1e-6f);
+    p.angleX = p.tilt.angleX;
+    p.angleY = p.tilt.angleY;
+    gestureInput.yawRate = sample.gyroZ;
+    gestureInput.pitchRate = sample.gyroX;
+  }
+  p.gesture = gesture_update(p.gestures, gestureInput, dtUs);
+  if (p.gesture != GESTURE_NONE)
+    flags |= IMU_STEP_GESTURE;
+
+  bool moved;
+  if (cfg.motionFixed)
+    moved = motion_process_fixed(p.motion, *cfg.motionFixed, q16_from_float(p.angleX), q16_from_float(p.angleY), dtUs, out);
+  else
+    moved = motion_process_float(p.motion, *cfg.motion, p.angleX, p.angleY, dtUs, out);
+  if (moved && !p.stillness.still)
+    flags |= IMU_STEP_MOVED;
+  return flags;
+}
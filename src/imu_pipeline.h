@@ -0,0 +1,46 @@
+// imu_pipeline.h — обработка одного сырого отсчета IMU до смещения курсора (общая для прошивки и воспроизведения трасс)
+#pragma once
+
+#include <stdint.h>
+#include "mpu6050_driver.h"
+#include "gyro_bias.h"
+#include "stillness.h"
+#include "orientation.h"
+#include "motion_pipeline.h"
+#include "gesture.h"
+
+// Что произошло при обработке отсчета
+#define IMU_STEP_MOVED 0x01        // есть целое смещение курсора
+#define IMU_STEP_STILL_CHANGED 0x02 // детектор покоя сменил состояние
+#define IMU_STEP_BIAS_UPDATED 0x04  // модель смещения гироскопа обновлена
+#define IMU_STEP_GESTURE 0x08       // распознан жест (ImuPipeline::gesture)
+
+struct ImuPipeline
+{
+  Mpu6050 *mpu;                  // масштаб отсчета; смещение гироскопа пишется в mpu->gyroOffset*
+  GyroBiasTracker bias;          // в осях датчика
+  StillnessDetector stillness;
+  bool quaternion;               // 1 - кватернион (рыскание/тангаж), 0 - комплементарный фильтр (наклоны)
+  OrientationFilter orientation;
+  ImuFilter tilt;
+  MotionState motion;
+  GestureRecognizer gestures;
+  uint8_t gesture;               // последний распознанный жест
+  ImuSample sample;              // последний отсчет в осях пульта
+  float angleX, angleY;          // углы, поданные в motion_pipeline
+};
+
+// Параметры, которые могут меняться на лету (двойной буфер в mouse_control)
+struct ImuPipelineConfig
+{
+  const int8_t *mount;                // матрица установки, MOUNT_MATRIX_SIZE
+  const MotionConfig *motion;
+  const MotionFixedConfig *motionFixed; // не nullptr — целочисленный путь
+};
+
+// Сброс ориентации и углов движения: смещение и детектор покоя сохраняются
+void imu_pipeline_reset_orientation(ImuPipeline &p, float kp, float ki);
+
+// Отсчет -> смещение гироскопа -> масштаб -> детектор покоя -> оси пульта -> ориентация -> жесты, движение.
+// В покое движение не выдается. Возвращает флаги IMU_STEP_*
+uint8_t imu_pipeline_step(ImuPipeline &p, const ImuPipelineConfig &cfg, const MpuRawSample &raw, uint32_t dtUs, MouseDelta &out);
@@ -0,0 +1,137 @@
+// imu_trace.cpp — трасса IMU: упаковка отсчетов, сегменты записей, восстановление цепочки
+#include "imu_trace.h"
+#include <string.h>
+
+static_assert(sizeof(ImuTraceRecord) == 20, "ImuTraceRecord layout");
+
+void imu_trace_buffer_reset(ImuTraceBuffer &b)
+{
+  spsc_reset(b);
+}
+
+bool imu_trace_push(ImuTraceBuffer &b, const ImuTraceRecord &r)
+{
+  return spsc_push(b, r);
+}
+
+bool imu_trace_pop(ImuTraceBuffer &b, ImuTraceRecord &r)
+{
+  return spsc_pop(b, r);
+}
+
+void imu_trace_pack(const MpuRawSample &raw, uint32_t dtUs, bool moved, const MouseDelta &delta, ImuTraceRecord &r)
+{
+  r.dtUs = dtUs > 0xFFFF ? 0xFFFF : dtUs;
+  r.acc[0] = raw.accX;
+  r.acc[1] = raw.accY;
+  r.acc[2] = raw.accZ;
+  r.gyro[0] = raw.gyroX;
+  r.gyro[1] = raw.gyroY;
+  r.gyro[2] = raw.gyroZ;
+  r.temp = raw.temp;
+  r.dx = moved ? delta.x : 0;
+  r.dy = moved ? delta.y : 0;
+}
+
+void imu_trace_unpack(const ImuTraceRecord &r, MpuRawSample &raw)
+{
+  raw.accX = r.acc[0];
+  raw.accY = r.acc[1];
+  raw.accZ = r.acc[2];
+  raw.gyroX = r.gyro[0];
+  raw.gyroY = r.gyro[1];
+  raw.gyroZ = r.gyro[2];
+  raw.temp = r.temp;
+}
+
+void imu_trace_header_init(ImuTraceHeader &h, uint32_t capacity, const ImuPipeline &p, const ImuPipelineConfig &cfg, float kp, float ki)
+{
+  memset(&h, 0, sizeof(h));
+  h.magic = IMU_TRACE_MAGIC;
+  h.version = IMU_TRACE_VERSION;
+  h.recordSize = sizeof(ImuTraceRecord);
+  h.capacity = capacity;
+  h.bias = p.bias;
+  h.stillness = p.stillness;
+  h.gestures = p.gestures;
+  h.motion = *cfg.motion;
+  memcpy(h.mount, cfg.mount, MOUNT_MATRIX_SIZE);
+  h.quaternion = p.quaternion;
+  h.fixedPoint = cfg.motionFixed != nullptr;
+  h.orientationKp = kp;
+  h.orientationKi = ki;
+}
+
+bool imu_trace_header_valid(const ImuTraceHeader &h)
+{
+  return h.magic == IMU_TRACE_MAGIC && h.version == IMU_TRACE_VERSION && h.recordSize == sizeof(ImuTraceRecord) &&
+         h.capacity >= 2 && mount_matrix_valid(h.mount);
+}
+
+uint32_t imu_trace_segment_size(const ImuTraceHeader &h)
+{
+  return h.capacity / 2;
+}
+
+uint8_t imu_trace_segment(const ImuTraceHeader &h, uint32_t index)
+{
+  return (index / imu_trace_segment_size(h)) & 1;
+}
+
+uint32_t imu_trace_segment_offset(const ImuTraceHeader &h, uint32_t index)
+{
+  return (index % imu_trace_segment_size(h)) * sizeof(ImuTraceRecord);
+}
+
+// Сохранены текущий сегмент и предыдущий целиком
+uint32_t imu_trace_first(const ImuTraceHeader &h)
+{
+  uint32_t size = imu_trace_segment_size(h);
+  if (!h.count || !size)
+    return 0;
+  uint32_t current = (h.count - 1) / size;
+  return current > 1 ? (current - 1) * size : 0;
+}
+
+uint32_t imu_trace_offset(const ImuTraceHeader &h, uint32_t index)
+{
+  return sizeof(ImuTraceHeader) + (index - imu_trace_first(h)) * sizeof(ImuTraceRecord);
+}
+
+uint32_t imu_trace_locate(const ImuTraceHeader &h, uint32_t pos, uint8_t &segment, uint32_t &segmentOffset)
+{
+  uint32_t size = imu_trace_segment_size(h);
+  uint32_t index = imu_trace_first(h) + pos / sizeof(ImuTraceRecord);
+  if (!size || index >= h.count)
+    return 0;
+  uint32_t end = (index / size + 1) * size; // первая запись следующего сегмента
+  if (end > h.count)
+    end = h.count;
+  segment = imu_trace_segment(h, index);
+  segmentOffset = imu_trace_segment_offset(h, index) + pos % sizeof(ImuTraceRecord);
+  return (end - index) * sizeof(ImuTraceRecord) - pos % sizeof(ImuTraceRecord);
+}
+
+bool imu_trace_exact(const ImuTraceHeader &h)
+{
+  return imu_trace_first(h) == 0 && h.dropped == 0;
+}
+
+void imu_trace_replay_init(const ImuTraceHeader &h, ImuPipeline &p, Mpu6050 &mpu, MotionFixedConfig &fixedCfg, ImuPipelineConfig &cfg)
+{
+  memset(&mpu, 0, sizeof(mpu));
+  p.mpu = &mpu;
+  p.bias = h.bias;
+  p.stillness = h.stillness;
+  p.gestures = h.gestures;
+  p.quaternion = h.quaternion;
+  imu_pipeline_reset_orientation(p, h.orientationKp, h.orientationKi);
+  cfg.mount = h.mount;
+  cfg.motion = &h.motion;
+  cfg.motionFixed = nullptr;
+  if (h.fixedPoint)
+  {
+    motion_fixed_config_init(h.motion, fixedCfg);
+    cfg.motionFixed = &fixedCfg;
+  }
+}
@@ -0,0 +1,73 @@
+// imu_trace.h — трасса сырых отсчетов IMU и смещений курсора: формат файлов, буфер между ядрами, воспроизведение
+#pragma once
+
+#include <stdint.h>
+#include "imu_pipeline.h"
+#include "spsc_queue.h"
+
+#define IMU_TRACE_MAGIC 0x52544D49 // "IMTR"
+#define IMU_TRACE_VERSION 4
+#define IMU_TRACE_BUFFER 256       // записей в буфере между ядрами (1.3 с при 200 Гц)
+
+// Один отсчет, 20 байт
+struct ImuTraceRecord
+{
+  uint16_t dtUs;   // время с предыдущего отсчета (мкс), до 65 мс
+  int16_t acc[3];  // сырые значения MPU6050
+  int16_t gyro[3];
+  int16_t temp;
+  int16_t dx, dy;  // смещение курсора на выходе цепочки (0 — не было)
+};
+
+// Заголовок: состояние цепочки на момент старта записи — воспроизведение повторяет его.
+// На устройстве записи идут только дописыванием в два файла-сегмента по capacity / 2 записей: заполнился
+// сегмент — другой открывается заново (старые записи в нем пропадают). Заголовок лежит в отдельном маленьком файле.
+// Скачиваемый файл — заголовок, затем сохраненные записи по порядку, начиная с imu_trace_first
+struct ImuTraceHeader
+{
+  uint32_t magic;
+  uint16_t version;
+  uint16_t recordSize;
+  uint32_t capacity;             // записей в двух сегментах
+  uint32_t count;                // всего записано; старше imu_trace_first — затерты
+  uint32_t dropped;              // потеряно из-за переполнения буфера между ядрами
+  GyroBiasTracker bias;
+  StillnessDetector stillness;
+  GestureRecognizer gestures;
+  MotionConfig motion;
+  int8_t mount[MOUNT_MATRIX_SIZE];
+  uint8_t quaternion;
+  uint8_t fixedPoint;
+  float orientationKp;
+  float orientationKi;
+};
+
+// Буфер ядро 0 -> ядро 1: один писатель, один читатель
+typedef SpscQueue<ImuTraceRecord, IMU_TRACE_BUFFER> ImuTraceBuffer;
+
+void imu_trace_buffer_reset(ImuTraceBuffer &b);
+bool imu_trace_push(ImuTraceBuffer &b, const ImuTraceRecord &r); // false — буфер полон, запись потеряна
+bool imu_trace_pop(ImuTraceBuffer &b, ImuTraceRecord &r);
+
+void imu_trace_pack(const MpuRawSample &raw, uint32_t dtUs, bool moved, const MouseDelta &delta, ImuTraceRecord &r);
+void imu_trace_unpack(const ImuTraceRecord &r, MpuRawSample &raw);
+
+// Заголовок со снимком цепочки. Ориентацию и углы движения перед записью нужно сбросить
+void imu_trace_header_init(ImuTraceHeader &h, uint32_t capacity, const ImuPipeline &p, const ImuPipelineConfig &cfg, float kp, float ki);
+bool imu_trace_header_valid(const ImuTraceHeader &h);
+
+// Сегменты на устройстве: записей в сегменте, сегмент записи index и ее смещение в нем
+uint32_t imu_trace_segment_size(const ImuTraceHeader &h);
+uint8_t imu_trace_segment(const ImuTraceHeader &h, uint32_t index);
+uint32_t imu_trace_segment_offset(const ImuTraceHeader &h, uint32_t index);
+// Номер самой старой сохраненной записи и положение записи в скачиваемом файле
+uint32_t imu_trace_first(const ImuTraceHeader &h);
+uint32_t imu_trace_offset(const ImuTraceHeader &h, uint32_t index);
+// Байт pos скачиваемого файла после заголовка: сегмент и смещение в нем.
+// Возвращает, сколько байт идут подряд до конца сегмента (0 — трасса кончилась)
+uint32_t imu_trace_locate(const ImuTraceHeader &h, uint32_t pos, uint8_t &segment, uint32_t &segmentOffset);
+// Сегменты не перезаписывались — воспроизведение повторит запись в точности
+bool imu_trace_exact(const ImuTraceHeader &h);
+
+// Восстановление цепочки из заголовка для воспроизведения. mpu и fixedCfg должны жить дольше p и cfg
+void imu_trace_replay_init(const ImuTraceHeader &h, ImuPipeline &p, Mpu6050 &mpu, MotionFixedConfig &fixedCfg, ImuPipelineConfig &cfg);
@@ -0,0 +1,28 @@
+// input_events.h — события ввода с меткой времени: ядро 0 (I2C, IMU) -> ядро 1 (кнопки, LED, предпросмотр)
+#pragma once
+
+#include <stdint.h>
+#include "spsc_queue.h"
+
+#define INPUT_EVENT_QUEUE 64  // событий кнопок и стороны в очереди (меняются редко, только по фронтам)
+#define MOTION_EVENT_QUEUE 64 // отсчетов движения для предпросмотра (0.3 с при 200 Гц)
+
+enum InputEventType : uint8_t
+{
+  INPUT_EVENT_KEYS = 0,  // новое состояние пинов MCP23017 (хотя бы один фронт)
+  INPUT_EVENT_SIDE = 1,  // смена активной стороны пульта
+  INPUT_EVENT_MOTION = 2 // смещение за один отсчет IMU
+};
+
+struct InputEvent
+{
+  uint32_t tUs;   // micros() на ядре 0
+  uint8_t type;   // InputEventType
+  uint8_t index;  // KEYS: номер MCP; SIDE: новая сторона (Side)
+  uint16_t pins;  // KEYS: GPIOA | GPIOB << 8 (0 — кнопка нажата)
+  int16_t dx, dy; // MOTION: смещение курсора
+  int16_t wheel;  // MOTION: прокрутка
+};
+
+typedef SpscQueue<InputEvent, INPUT_EVENT_QUEUE> InputEventQueue;
+typedef SpscQueue<InputEvent, MOTION_EVENT_QUEUE> MotionEventQueue;
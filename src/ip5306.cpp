@@ -3,7 +3,7 @@
 #include "config.h"
 #include <Arduino.h>
 #include "led_service.h"
-#include <Wire.h>
+#include "i2c_service.h"
 #include "ble.h"
 
 // ================== Регистры IP5306 ==================
@@ -17,38 +17,30 @@
 
 // ================== Локальные переменные ==================
 static bool ip5306_available = false;
+static int8_t ip5306_device = -1; // номер устройства в менеджере I2C
 static uint8_t battery_level = 100;
-static unsigned long last_poll_time = 0;
 static bool has_charging_data = false; // Флаг для наличия свежих данных
 
 static bool was_charging = false;
 static bool needs_charge_called = false;
 
 // ================== I2C ==================
+// Сразу, в вызывающей задаче — для инициализации и выключения
 static void i2c_write_byte(uint8_t reg, uint8_t data)
 {
-  Wire.beginTransmission(IP5306_ADDR);
-  Wire.write(reg);
-  Wire.write(data);
-  Wire.endTransmission();
+  i2c_write(i2cManager, ip5306_device, reg, data);
 }
 
 static bool i2c_read_byte(uint8_t reg, uint8_t *data)
 {
-  Wire.beginTransmission(IP5306_ADDR);
-  Wire.write(reg);
-  if (Wire.endTransmission(false) != 0)
-    return false;
-
-  if (Wire.requestFrom(IP5306_ADDR, 1) != 1)
-    return false;
-  *data = Wire.read();
-  return true;
+  return i2c_read(i2cManager, ip5306_device, reg, data, 1);
 }
 
 // ================== Инициализация ==================
 void ip5306_init()
 {
+  // Фоновое устройство: опрос уступает шину IMU и кнопкам
+  ip5306_device = i2c_manager_add_device(i2cManager, IP5306_ADDR, false, "ip5306");
   uint8_t dummy;
   ip5306_available = i2c_read_byte(IP5306_SYS_CTL0, &dummy);
   if (!ip5306_available)
@@ -136,52 +128,59 @@ void ip5306_init()
 }
 
 // ================== Опрос чипа (I2C-only) ==================
-void ip5306_poll()
-{
-  if (!ip5306_available)
-    return;
+// Чтения стоят в отложенной очереди менеджера I2C и обрабатываются по порядку в обратных вызовах
+static bool poll_level_ok = false; // уровень заряда прочитан в текущем опросе
 
-  unsigned long now = millis();
-  if (now - last_poll_time < IP5306_POLL_INTERVAL)
-    return;
-  last_poll_time = now;
+static void on_battery_level(void *ctx, bool ok, const uint8_t *data, uint8_t len)
+{
+  poll_level_ok = ok;
+  if (ok)
+    battery_level = (data[0] & 0x0F) * 25;
+}
 
-  // Чтение уровня заряда
-  uint8_t level_raw;
-  if (!i2c_read_byte(IP5306_READ_BATTERY_LEVEL, &level_raw))
+static void on_chg_ctl1(void *ctx, bool ok, const uint8_t *data, uint8_t len)
+{
+  if (!poll_level_ok || !ok)
     return;
-  battery_level = (level_raw & 0x0F) * 25;
 
   // Управление зарядкой
-  uint8_t chg_ctl1;
-  if (i2c_read_byte(IP5306_CHG_CTL1, &chg_ctl1))
-  {
+  uint8_t chg_ctl1 = data[0];
 #if IP5306_AUTO_CHARGE_CONTROL
-    if (battery_level >= 100)
-    {
-      chg_ctl1 &= ~(1 << 4);
-    }
-    else if (battery_level <= 98)
-    {
-      chg_ctl1 |= (1 << 4);
-    }
-#else
-    chg_ctl1 |= (1 << 4);
-#endif
-    i2c_write_byte(IP5306_CHG_CTL1, chg_ctl1);
+  if (battery_level >= 100)
+  {
+    chg_ctl1 &= ~(1 << 4);
   }
-
-  // Проверяем зарядку
-  uint8_t chg_ctl0;
-  was_charging = false;
-  if (i2c_read_byte(IP5306_CHG_CTL0, &chg_ctl0) && (chg_ctl0 & (1 << 4)))
+  else if (battery_level <= 98)
   {
-    was_charging = true;
+    chg_ctl1 |= (1 << 4);
   }
+#else
+  chg_ctl1 |= (1 << 4);
+#endif
+  i2c_submit_write(i2cManager, ip5306_device, IP5306_CHG_CTL1, chg_ctl1, nullptr, nullptr);
+}
 
+static void on_chg_ctl0(void *ctx, bool ok, const uint8_t *data, uint8_t len)
+{
+  if (!poll_level_ok)
+    return;
+
+  // Проверяем зарядку
+  was_charging = ok && (data[0] & (1 << 4));
   has_charging_data = true; // Отмечаем, что данные опроса обновлены
 }
 
+// Вызывается планировщиком task_io раз в IP5306_POLL_INTERVAL
+void ip5306_poll()
+{
+  if (!ip5306_available)
+    return;
+
+  i2c_submit_read(i2cManager, ip5306_device, IP5306_READ_BATTERY_LEVEL, 1, on_battery_level, nullptr);
+  i2c_submit_read(i2cManager, ip5306_device, IP5306_CHG_CTL1, 1, on_chg_ctl1, nullptr);
+  i2c_submit_read(i2cManager, ip5306_device, IP5306_CHG_CTL0, 1, on_chg_ctl0, nullptr);
+}
+
 // ================== Обновление статуса LED (НЕ I2C) ==================
 void ip5306_update_status()
 {
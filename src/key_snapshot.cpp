@@ -0,0 +1,56 @@
+// key_snapshot.cpp — раскладка кнопок по полубайтам исходных слов и сбор снимка
+#include "key_snapshot.h"
+#include <string.h>
+
+void key_layout_init(KeyLayout &l)
+{
+  memset(&l, 0, sizeof(l));
+}
+
+static KeyNibbleMap *find_nibble(KeyLayout &l, uint8_t word, uint8_t shift)
+{
+  for (uint8_t i = 0; i < l.nibbleCount; i++)
+    if (l.nibbles[i].word == word && l.nibbles[i].shift == shift)
+      return &l.nibbles[i];
+  if (l.nibbleCount >= KEY_SOURCE_WORDS * 4)
+    return nullptr;
+  KeyNibbleMap &n = l.nibbles[l.nibbleCount++];
+  memset(&n, 0, sizeof(n));
+  n.word = word;
+  n.shift = shift;
+  return &n;
+}
+
+bool key_layout_add(KeyLayout &l, uint8_t key, uint8_t word, uint8_t bit, bool onKeyboard, bool onMouse)
+{
+  if (key >= KEY_SNAPSHOT_BITS || word >= KEY_SOURCE_WORDS || bit >= 16)
+    return false;
+  KeyNibbleMap *n = find_nibble(l, word, bit & ~3);
+  if (!n)
+    return false;
+  // Кнопка попадает во все значения полубайта, где ее бит нажат
+  uint8_t mask = 1 << (bit & 3);
+  for (uint8_t v = 0; v < 16; v++)
+    if (v & mask)
+      key_bits_set(n->bits[v], key);
+
+  if (onKeyboard)
+    key_bits_set(l.sideMask[0], key);
+  if (onMouse)
+    key_bits_set(l.sideMask[1], key);
+  if (key >= l.keyCount)
+    l.keyCount = key + 1;
+  return true;
+}
+
+void key_snapshot_build(const KeyLayout &l, const uint16_t *words, KeyBits &out)
+{
+  key_bits_clear(out);
+  for (uint8_t i = 0; i < l.nibbleCount; i++)
+  {
+    const KeyNibbleMap &n = l.nibbles[i];
+    const KeyBits &b = n.bits[(~words[n.word] >> n.shift) & 0x0F];
+    for (uint8_t w = 0; w < KEY_SNAPSHOT_WORDS; w++)
+      out.w[w] |= b.w[w];
+  }
+}
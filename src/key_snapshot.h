@@ -0,0 +1,111 @@
+// key_snapshot.h — снимок всех кнопок одним 128-битным набором: сбор из слов MCP/GPIO, фронты через XOR, маски сторон
+#pragma once
+
+#include <stdint.h>
+
+#define KEY_SNAPSHOT_BITS 128  // кнопок в снимке (бит = индекс кнопки в конфигурации)
+#define KEY_SNAPSHOT_WORDS (KEY_SNAPSHOT_BITS / 32)
+#define KEY_MAX_MCP 8          // MCP23017 на шине (адреса 0x20..0x27)
+#define KEY_GPIO_WORD KEY_MAX_MCP // первое слово GPIO: GPIO n — слово KEY_GPIO_WORD + n / 16, бит n % 16
+#define KEY_SOURCE_WORDS (KEY_MAX_MCP + 4) // 8 MCP по 16 пинов + GPIO 0..63
+
+struct KeyBits
+{
+  uint32_t w[KEY_SNAPSHOT_WORDS];
+};
+
+inline void key_bits_clear(KeyBits &b)
+{
+  for (uint8_t i = 0; i < KEY_SNAPSHOT_WORDS; i++)
+    b.w[i] = 0;
+}
+
+inline void key_bits_set(KeyBits &b, uint8_t bit)
+{
+  b.w[bit >> 5] |= 1u << (bit & 31);
+}
+
+inline void key_bits_clear_bit(KeyBits &b, uint8_t bit)
+{
+  b.w[bit >> 5] &= ~(1u << (bit & 31));
+}
+
+inline bool key_bits_test(const KeyBits &b, uint8_t bit)
+{
+  return (b.w[bit >> 5] >> (bit & 31)) & 1;
+}
+
+inline bool key_bits_any(const KeyBits &b)
+{
+  uint32_t any = 0;
+  for (uint8_t i = 0; i < KEY_SNAPSHOT_WORDS; i++)
+    any |= b.w[i];
+  return any != 0;
+}
+
+inline KeyBits key_bits_and(const KeyBits &a, const KeyBits &b)
+{
+  KeyBits r;
+  for (uint8_t i = 0; i < KEY_SNAPSHOT_WORDS; i++)
+    r.w[i] = a.w[i] & b.w[i];
+  return r;
+}
+
+inline KeyBits key_bits_xor(const KeyBits &a, const KeyBits &b)
+{
+  KeyBits r;
+  for (uint8_t i = 0; i < KEY_SNAPSHOT_WORDS; i++)
+    r.w[i] = a.w[i] ^ b.w[i];
+  return r;
+}
+
+// Младший установленный бит с удалением из набора; -1 — набор пуст. Обход только изменившихся кнопок
+inline int key_bits_pop(KeyBits &b)
+{
+  for (uint8_t i = 0; i < KEY_SNAPSHOT_WORDS; i++)
+  {
+    if (b.w[i])
+    {
+      int bit = __builtin_ctz(b.w[i]);
+      b.w[i] &= b.w[i] - 1;
+      return i * 32 + bit;
+    }
+  }
+  return -1;
+}
+
+// Полубайт исходного слова -> кнопки, которые он включает (16 вариантов, заранее посчитано)
+struct KeyNibbleMap
+{
+  uint8_t word;   // номер исходного слова
+  uint8_t shift;  // 0, 4, 8, 12
+  KeyBits bits[16];
+};
+
+// Раскладка кнопок по исходным словам, строится один раз из конфигурации.
+// Сбор снимка — только по полубайтам, где есть кнопки: время не зависит от числа кнопок
+struct KeyLayout
+{
+  KeyNibbleMap nibbles[KEY_SOURCE_WORDS * 4];
+  uint8_t nibbleCount;
+  uint8_t keyCount;    // наибольший индекс кнопки + 1
+  KeyBits sideMask[2]; // кнопки, активные на стороне: [0] — клавиатура, [1] — мышь (как Side)
+};
+
+void key_layout_init(KeyLayout &l);
+// Кнопка key = бит bit слова word (активный ноль). false — индекс или источник вне диапазона
+bool key_layout_add(KeyLayout &l, uint8_t key, uint8_t word, uint8_t bit, bool onKeyboard, bool onMouse);
+
+// words — исходные слова (0 — нажато, как у MCP23017 и GPIO с подтяжкой); out — бит 1 — кнопка нажата
+void key_snapshot_build(const KeyLayout &l, const uint16_t *words, KeyBits &out);
+
+// Фронты относительно прошлого снимка: pressed — нажатые, released — отпущенные
+inline void key_snapshot_edges(const KeyBits &prev, const KeyBits &cur, KeyBits &pressed, KeyBits &released)
+{
+  for (uint8_t i = 0; i < KEY_SNAPSHOT_WORDS; i++)
+  {
+    uint32_t changed = prev.w[i] ^ cur.w[i];
+    pressed.w[i] = changed & cur.w[i];
+    released.w[i] = changed & prev.w[i];
+  }
+}
@@ -15,9 +15,12 @@
 #include "mode_manager.h"
 #include "sleep_manager.h"
 #include "ip5306.h"
+#include "task_scheduler.h"
+#include "i2c_service.h"
 
 TaskHandle_t TaskIOHandle;
 TaskHandle_t TaskAppHandle;
+TaskHandle_t TaskActionHandle;
 
 #if DEBUG
 // === Отладка ===
@@ -89,13 +92,7 @@ void task_io(void *param)
   Serial.print("[MAIN] Starting IO task on core ");
   Serial.println(xPortGetCoreID());
 #endif
-  for (;;)
-  {
-    update_mouse_control();  // гироскоп
-    read_mcp_buttons_tick(); // кешируем нажатия MCP
-    ip5306_poll();           // опрос IP5306
-    delay(10);
-  }
+  task_scheduler_loop(ioScheduler);
 }
 
 // Core 1: логика, GPIO, BLE HID
@@ -105,15 +102,36 @@ void task_app(void *param)
   Serial.print("[MAIN] Starting App task on core ");
   Serial.println(xPortGetCoreID());
 #endif
-  for (;;)
-  {
-    led_service_loop(); // обработка LED
-    sleepManagerLoop(); // обработка сна
-    ble_loop();
-    update_buttons();       // использует кеш MCP + GPIO
-    ip5306_update_status(); // обновление статуса питания
-    delay(10);
-  }
+  task_scheduler_loop(appScheduler);
+}
+
+// Core 1: исполнитель действий — нажатия клавиш и паузы скриптов по таймеру, без delay() в task_app
+void task_action(void *param)
+{
+#if DEBUG
+  Serial.print("[MAIN] Starting Action task on core ");
+  Serial.println(xPortGetCoreID());
+#endif
+  action_executor_run();
+}
+
+// Задачи ядер с периодами; порядок добавления — порядок выполнения в проходе
+static void setup_schedulers()
+{
+  sched_init(ioScheduler, "io");
+  sched_add(ioScheduler, "imu", update_mouse_control, SCHED_IMU_PERIOD_US);  // гироскоп
+  sched_add(ioScheduler, "mcp", read_mcp_buttons_tick, SCHED_MCP_PERIOD_US); // кешируем нажатия MCP
+  sched_add(ioScheduler, "power", ip5306_poll, SCHED_POWER_PERIOD_US);       // опрос IP5306
+  sched_add(ioScheduler, "i2c", i2c_service_loop, SCHED_I2C_PERIOD_US);      // фоновые транзакции I2C
+
+  sched_init(appScheduler, "app");
+  sched_add(appScheduler, "led", led_service_loop, SCHED_LED_PERIOD_US);         // обработка LED
+  sched_add(appScheduler, "sleep", sleepManagerLoop, SCHED_APP_PERIOD_US);       // обработка сна
+  sched_add(appScheduler, "ble", ble_loop, SCHED_APP_PERIOD_US);
+  sched_add(appScheduler, "buttons", update_buttons, SCHED_APP_PERIOD_US);       // использует кеш MCP + GPIO
+  sched_add(appScheduler, "gestures", run_gesture_actions, SCHED_APP_PERIOD_US); // жесты с гироскопа
+  sched_add(appScheduler, "power", ip5306_update_status, SCHED_APP_PERIOD_US);   // обновление статуса питания
+  sched_add(appScheduler, "layer", update_layer_leds, SCHED_APP_PERIOD_US);      // цвета слоя, смененного скриптом
 }
 
 void setup()
@@ -122,7 +140,9 @@ void setup()
   Serial.println("[MAIN] Starting setup...");
 
   Wire.begin(I2C_SDA_PIN, I2C_SCL_PIN);
+  Wire.setClock(I2C_CLOCK_HZ);
   delay(20);
+  setup_i2c_service(); // все модули ходят на шину через менеджер
 #if DEBUG
   Serial.println("[MAIN] I2C initialized");
   Serial.println("[MAIN] I2C SDA: " + String(I2C_SDA_PIN));
@@ -178,14 +198,20 @@ void setup()
 #endif
 
   // === Задачи по ядрам ===
+  setup_schedulers();
   xTaskCreatePinnedToCore(task_io, "IO_Task", 4096, NULL, 1, &TaskIOHandle, 0); // ядро 0
   delay(100);
   xTaskCreatePinnedToCore(task_app, "App_Task", 4096, NULL, 1, &TaskAppHandle, 1); // ядро 1
+  // Приоритет выше task_app: отпускание клавиши и конец паузы не ждут конца прохода кнопок. Без заданий задача спит
+  xTaskCreatePinnedToCore(task_action, "Action_Task", 4096, NULL, 2, &TaskActionHandle, 1); // ядро 1
 }
 
 void loop()
 {
-  web_loop(); // обработка веб-интерфейса
-  ir_loop();  // обработка IR. Обучение, сохранение
+  web_loop();                       // обработка веб-интерфейса
+  ir_loop();                        // обработка IR. Обучение, сохранение
+  mouse_control_save_calibration(); // сохранение калибровки гироскопа и указки
+  mouse_control_trace_flush();      // запись трассы IMU
+  mouse_control_preview_loop();     // предпросмотр движения для веб-интерфейса
   delay(10);
 }
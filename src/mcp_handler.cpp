@@ -2,23 +2,48 @@
 #include "mcp_handler.h"
 #include "config.h"
 #include "config_storage.h"
-#include <Wire.h>
+#include "input_events.h"
+#include "i2c_service.h"
+#include "key_snapshot.h"
 
 #define MCP_IODIRA 0x00
 #define MCP_IODIRB 0x01
+#define MCP_GPINTENA 0x04
+#define MCP_GPINTENB 0x05
+#define MCP_INTCONA 0x08
+#define MCP_INTCONB 0x09
+#define MCP_IOCON 0x0A
 #define MCP_GPPUA 0x0C
 #define MCP_GPPUB 0x0D
+#define MCP_INTFA 0x0E
+#define MCP_INTCAPA 0x10
 #define MCP_GPIOA 0x12
 #define MCP_GPIOB 0x13
 
-static Side activeSide = SIDE_KEYBOARD;
+#define MCP_IOCON_MIRROR 0x40 // INTA и INTB — одна линия на оба порта
+#define MCP_IOCON_ODR 0x04    // INT — открытый сток: линии нескольких MCP объединяются
+
 static const uint8_t MCP[] = MCP_ADDR;
 static const size_t MCP_COUNT = sizeof(MCP) / sizeof(MCP[0]);
+static_assert(MCP_COUNT <= KEY_MAX_MCP, "MCP23017: не больше 8 адресов на шине");
 
-static bool *mcp_active;
 static bool *mcp_initialized;
-static uint8_t *mcp_gpioa;
-static uint8_t *mcp_gpiob;
+static int8_t *mcp_device; // номер устройства в менеджере I2C
+
+// === Состояние ядра 0: опрос по I2C ===
+static Side activeSide = SIDE_KEYBOARD;
+static bool *mcp_active;
+static uint16_t *mcp_pins;      // GPIOA | GPIOB << 8 с последнего опроса
+static bool *mcp_dirty;         // нужно полное чтение независимо от INT (старт, смена стороны)
+#if MCP_INT_PIN >= 0
+static uint32_t lastResyncUs = 0;
+#endif
+static bool mcpResync = false; // очередь переполнялась — сторона и все пины отправляются заново
+
+// === Состояние ядра 1: собирается только из событий очереди ===
+static InputEventQueue mcpEvents;
+static Side appSide = SIDE_KEYBOARD;
+static uint16_t *app_pins;
 
 // static uint8_t cachedStates[32];
 static size_t cachedCount = 0;
@@ -41,21 +66,19 @@ uint8_t get_mcp_initialized(uint8_t chipIndex)
   return 0; // неверный индекс
 }
 
-void mcp_write_reg(uint8_t addr, uint8_t reg, uint8_t val)
+static bool mcp_write_reg(uint8_t chipIndex, uint8_t reg, uint8_t val)
 {
-  Wire.beginTransmission(addr);
-  Wire.write(reg);
-  Wire.write(val);
-  Wire.endTransmission();
+  return i2c_write(i2cManager, mcp_device[chipIndex], reg, val);
 }
 
-uint8_t mcp_read_reg(uint8_t addr, uint8_t reg)
+// Прерывание по изменению: любой фронт любого пина относительно прошлого значения (INTCON = 0).
+// Неактивные MCP не тянут линию INT, чтобы не будить опрос впустую
+static void mcp_set_interrupts(uint8_t chipIndex, bool enable)
 {
-  Wire.beginTransmission(addr);
-  Wire.write(reg);
-  Wire.endTransmission(false);
-  Wire.requestFrom(addr, (uint8_t)1);
-  return Wire.available() ? Wire.read() : 0xFF;
+#if MCP_INT_PIN >= 0
+  mcp_write_reg(chipIndex, MCP_GPINTENA, enable ? 0xFF : 0x00);
+  mcp_write_reg(chipIndex, MCP_GPINTENB, enable ? 0xFF : 0x00);
+#endif
 }
 
 void setup_mcp_handler()
@@ -65,20 +88,33 @@ void setup_mcp_handler()
 #endif
   mcp_active = new bool[MCP_COUNT]();
   mcp_initialized = new bool[MCP_COUNT]();
-  mcp_gpioa = new uint8_t[MCP_COUNT];
-  mcp_gpiob = new uint8_t[MCP_COUNT];
+  mcp_device = new int8_t[MCP_COUNT];
+  mcp_pins = new uint16_t[MCP_COUNT];
+  mcp_dirty = new bool[MCP_COUNT];
+  app_pins = new uint16_t[MCP_COUNT];
+  for (size_t i = 0; i < MCP_COUNT; i++)
+  {
+    mcp_pins[i] = app_pins[i] = 0xFFFF;
+    mcp_dirty[i] = true;
+  }
 
   for (size_t i = 0; i < MCP_COUNT; i++)
   {
-    Wire.beginTransmission(MCP[i]);
-    if (Wire.endTransmission() == 0)
+    // Опрос кнопок — сразу после IMU; GPIOA и GPIOB читаются одним пакетом (BANK=0, автоинкремент)
+    mcp_device[i] = i2c_manager_add_device(i2cManager, MCP[i], true, "mcp23017");
+    if (mcp_device[i] >= 0 && mcp_write_reg(i, MCP_IODIRA, 0xFF)) // первая запись — заодно проверка наличия
     {
-      mcp_write_reg(MCP[i], MCP_IODIRA, 0xFF);
-      mcp_write_reg(MCP[i], MCP_IODIRB, 0xFF);
-      mcp_write_reg(MCP[i], MCP_GPPUA, 0xFF);
-      mcp_write_reg(MCP[i], MCP_GPPUB, 0xFF);
-      mcp_write_reg(MCP[i], MCP_GPIOA, 0xFF);
-      mcp_write_reg(MCP[i], MCP_GPIOB, 0xFF);
+      mcp_write_reg(i, MCP_IODIRB, 0xFF);
+      mcp_write_reg(i, MCP_GPPUA, 0xFF);
+      mcp_write_reg(i, MCP_GPPUB, 0xFF);
+      mcp_write_reg(i, MCP_GPIOA, 0xFF);
+      mcp_write_reg(i, MCP_GPIOB, 0xFF);
+#if MCP_INT_PIN >= 0
+      mcp_write_reg(i, MCP_IOCON, MCP_IOCON_MIRROR | MCP_IOCON_ODR);
+      mcp_write_reg(i, MCP_INTCONA, 0x00);
+      mcp_write_reg(i, MCP_INTCONB, 0x00);
+      mcp_set_interrupts(i, mcp_active[i]);
+#endif
       mcp_initialized[i] = true;
 #if DEBUG
       Serial.printf("[MCP] MCP23017 addr=0x%02X index=%d initialized\n", MCP[i], i);
@@ -91,11 +127,31 @@ void setup_mcp_handler()
 #endif
     }
   }
+#if MCP_INT_PIN >= 0
+  pinMode(MCP_INT_PIN, INPUT_PULLUP);
+  lastResyncUs = micros();
+#if DEBUG
+  Serial.printf("[MCP] Interrupt-on-change, INT on GPIO %d\n", MCP_INT_PIN);
+#endif
+#endif
+}
+
+// Событие для ядра 1. Если очередь полна — полное состояние уйдет на следующем опросе
+static void push_mcp_event(uint8_t type, uint8_t index, uint16_t pins, uint32_t now)
+{
+  InputEvent e = {};
+  e.tUs = now;
+  e.type = type;
+  e.index = index;
+  e.pins = pins;
+  if (!spsc_push(mcpEvents, e))
+    mcpResync = true;
 }
 
 void set_mcp_active_side(Side side)
 {
   activeSide = side;
+  push_mcp_event(INPUT_EVENT_SIDE, side, 0, micros());
   for (size_t i = 0; i < MCP_COUNT; i++)
     mcp_active[i] = false;
 
@@ -109,6 +165,13 @@ void set_mcp_active_side(Side side)
     if (hw[i].sourceIndex < MCP_COUNT)
       mcp_active[hw[i].sourceIndex] = true;
   }
+  // Каждый MCP перечитывается: активный — за начальным состоянием, неактивный — чтобы снять висящее INT
+  for (size_t i = 0; i < MCP_COUNT; i++)
+  {
+    if (mcp_initialized[i])
+      mcp_set_interrupts(i, mcp_active[i]);
+    mcp_dirty[i] = true;
+  }
 #if DEBUG
   Serial.printf("[MCP] Active side: %s\n", side == SIDE_MOUSE ? "MOUSE" : "KEYBOARD");
   for (size_t i = 0; i < MCP_COUNT; i++)
@@ -116,46 +179,109 @@ void set_mcp_active_side(Side side)
 #endif
 }
 
+// Состояние пинов MCP. По INT читаются INTF, INTCAP и GPIO одним пакетом (0x0E..0x13):
+// INTCAP хранит пины на момент первого фронта, и короткое нажатие, уже отпущенное к чтению, не теряется.
+// INTF != 0 — прерывание от этого MCP (линия общая), иначе INTCAP остался от прошлого раза.
+// Чтение GPIO снимает прерывание
+static void mcp_read_chip(uint8_t chipIndex, bool interrupted, bool resync, uint32_t now)
+{
+  uint16_t pins = 0xFFFF;
+  if (mcp_active[chipIndex] && mcp_initialized[chipIndex])
+  {
+    uint8_t regs[6] = {}; // INTFA, INTFB, INTCAPA, INTCAPB, GPIOA, GPIOB
+    bool ok = interrupted ? i2c_read(i2cManager, mcp_device[chipIndex], MCP_INTFA, regs, 6)
+                          : i2c_read(i2cManager, mcp_device[chipIndex], MCP_GPIOA, regs + 4, 2);
+    if (ok)
+    {
+      pins = regs[4] | (regs[5] << 8);
+      uint16_t captured = regs[2] | (regs[3] << 8);
+      if ((regs[0] | regs[1]) && captured != pins && captured != mcp_pins[chipIndex])
+      {
+        mcp_pins[chipIndex] = captured;
+        push_mcp_event(INPUT_EVENT_KEYS, chipIndex, captured, now);
+      }
+    }
+  }
+  else if (mcp_initialized[chipIndex] && interrupted)
+  {
+    uint8_t gpio[2];
+    i2c_read(i2cManager, mcp_device[chipIndex], MCP_GPIOA, gpio, 2); // только снять INT
+  }
+  // Ядру 1 уходят только фронты
+  if (pins != mcp_pins[chipIndex] || resync)
+  {
+    mcp_pins[chipIndex] = pins;
+    push_mcp_event(INPUT_EVENT_KEYS, chipIndex, pins, now);
+  }
+}
+
 void read_mcp_buttons_tick()
 {
   cachedCount = 0;
+  uint32_t now = micros();
+  bool resync = mcpResync;
+  mcpResync = false;
+  if (resync)
+    push_mcp_event(INPUT_EVENT_SIDE, activeSide, 0, now);
+
+#if MCP_INT_PIN >= 0
+  // Линия INT держится, пока MCP не прочитан: проверка уровня не пропускает фронты между тиками
+  bool interrupted = digitalRead(MCP_INT_PIN) == LOW;
+  bool periodic = now - lastResyncUs >= MCP_INT_RESYNC_MS * 1000UL;
+  if (periodic)
+    lastResyncUs = now;
   for (size_t i = 0; i < MCP_COUNT; i++)
   {
-    if (mcp_active[i] && mcp_initialized[i])
-    {
-      mcp_gpioa[i] = mcp_read_reg(MCP[i], MCP_GPIOA);
-      mcp_gpiob[i] = mcp_read_reg(MCP[i], MCP_GPIOB);
-    }
-    else
-    {
-      mcp_gpioa[i] = 0xFF;
-      mcp_gpiob[i] = 0xFF;
-    }
+    if (!interrupted && !periodic && !mcp_dirty[i] && !resync)
+      continue; // ничего не менялось — шина не нужна
+    mcp_dirty[i] = false;
+    mcp_read_chip(i, interrupted, resync, now);
   }
+#else
+  for (size_t i = 0; i < MCP_COUNT; i++)
+  {
+    mcp_dirty[i] = false;
+    mcp_read_chip(i, false, resync, now);
+  }
+#endif
 #if DEBUG && DEBUG_MCP_STATE
   Serial.print("[MCP] State: ");
   for (size_t i = 0; i < MCP_COUNT; i++)
   {
-    Serial.printf("%02X ", mcp_gpioa[i]);
-    Serial.printf("%02X ", mcp_gpiob[i]);
+    Serial.printf("%02X ", mcp_pins[i] & 0xFF);
+    Serial.printf("%02X ", mcp_pins[i] >> 8);
   }
   Serial.println();
 #endif
 }
 
+void process_mcp_events()
+{
+  InputEvent e;
+  while (spsc_pop(mcpEvents, e))
+  {
+    if (e.type == INPUT_EVENT_KEYS && e.index < MCP_COUNT)
+      app_pins[e.index] = e.pins;
+    else if (e.type == INPUT_EVENT_SIDE)
+      appSide = (Side)e.index;
+  }
+}
+
 bool get_pin_state(uint8_t chipIndex, uint8_t pin)
 {
-  if (chipIndex >= MCP_COUNT || !mcp_initialized[chipIndex])
+  if (chipIndex >= MCP_COUNT || !mcp_initialized[chipIndex] || pin >= 16)
     return false;
+  return !(app_pins[chipIndex] & (1 << pin));
+}
 
-  if (pin < 8)
-    return !(mcp_gpioa[chipIndex] & (1 << pin));
-  else if (pin < 16)
-    return !(mcp_gpiob[chipIndex] & (1 << (pin - 8)));
-  return false;
+uint16_t get_mcp_pins(uint8_t chipIndex)
+{
+  if (chipIndex >= MCP_COUNT || !mcp_initialized[chipIndex])
+    return 0xFFFF;
+  return app_pins[chipIndex];
 }
 
 Side get_mcp_active_side()
 {
-  return activeSide;
+  return appSide;
 }
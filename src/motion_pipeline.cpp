@@ -0,0 +1,187 @@
+// motion_pipeline.cpp — цепочка обработки движения: мертвая зона, кривая ускорения, ограничение
+#include "motion_pipeline.h"
+#include <math.h>
+
+#define MOTION_DELTA_MAX 32767
+
+static inline int32_t clamp_delta(int32_t v)
+{
+  if (v > MOTION_DELTA_MAX)
+    return MOTION_DELTA_MAX;
+  if (v < -MOTION_DELTA_MAX)
+    return -MOTION_DELTA_MAX;
+  return v;
+}
+
+// Целая часть Q16.16 с усечением к нулю
+static inline int32_t q16_trunc(q16_t v)
+{
+  return v >= 0 ? v >> Q16_SHIFT : -((-v) >> Q16_SHIFT);
+}
+
+void motion_state_reset(MotionState &state)
+{
+  state.lastX = 0;
+  state.lastY = 0;
+  state.lastXq = 0;
+  state.lastYq = 0;
+  state.dtUs = MOTION_REF_PERIOD_US;
+  state.dtScale = Q16_ONE;
+  state.remX = 0;
+  state.remY = 0;
+  state.remXq = 0;
+  state.remYq = 0;
+  one_euro_reset(state.filter);
+}
+
+void motion_state_settle(MotionState &state)
+{
+  state.remX = 0;
+  state.remY = 0;
+  state.remXq = 0;
+  state.remYq = 0;
+  one_euro_reset(state.filter);
+}
+
+void motion_config_build(MotionConfig &cfg)
+{
+  accel_curve_build_lut(cfg.curve, cfg.sensitivity, cfg.gain);
+}
+
+void motion_fixed_config_init(const MotionConfig &cfg, MotionFixedConfig &out)
+{
+  out.deadzone = q16_from_float(cfg.deadzone);
+  one_euro_fixed_config_init(cfg.filter, out.filter);
+  for (int i = 0; i < ACCEL_LUT_SIZE; i++)
+    out.gain[i] = q16_from_float(cfg.gain[i]);
+}
+
+// Углы свернуты в [-180, 180): переход через границу — малое смещение, а не скачок на 360
+static inline float wrap_delta(float d)
+{
+  if (d >= 180.0f)
+    return d - 360.0f;
+  if (d < -180.0f)
+    return d + 360.0f;
+  return d;
+}
+
+static inline q16_t wrap_delta(q16_t d)
+{
+  if (d >= (180 << Q16_SHIFT))
+    return d - (360 << Q16_SHIFT);
+  if (d < -(180 << Q16_SHIFT))
+    return d + (360 << Q16_SHIFT);
+  return d;
+}
+
+// Оценка модуля скорости без sqrt: max + 3/8 min (ошибка до ~7%), одинаково в обоих путях
+static inline float approx_magnitude(float x, float y)
+{
+  float ax = fabsf(x), ay = fabsf(y);
+  return ax > ay ? ax + ay * 0.375f : ay + ax * 0.375f;
+}
+
+static inline q16_t approx_magnitude(q16_t x, q16_t y)
+{
+  q16_t ax = x < 0 ? -x : x;
+  q16_t ay = y < 0 ? -y : y;
+  return ax > ay ? ax + ((ay * 3) >> 3) : ay + ((ax * 3) >> 3);
+}
+
+bool motion_process_float(MotionState &state, const MotionConfig &cfg, float angleX, float angleY, uint32_t dtUs, MouseDelta &out)
+{
+  float dx = wrap_delta(angleX - state.lastX);
+  float dy = wrap_delta(angleY - state.lastY);
+  state.lastX = angleX;
+  state.lastY = angleY;
+
+  // Приводим смещение к опорному периоду для порогов
+  float scale = dtUs ? (float)MOTION_REF_PERIOD_US / dtUs : 1.0f;
+  if (cfg.filter.enabled)
+    one_euro_float(state.filter, cfg.filter, dx, dy, approx_magnitude(dx * scale, dy * scale), dtUs);
+  float nx = dx * scale;
+  float ny = dy * scale;
+  if (fabsf(nx) < cfg.deadzone && fabsf(ny) < cfg.deadzone)
+    return false;
+
+  float velocity = approx_magnitude(nx, ny);
+  int index = (int)(velocity * (1.0f / ACCEL_LUT_STEP));
+  float gain = cfg.gain[index < ACCEL_LUT_SIZE ? index : ACCEL_LUT_SIZE - 1];
+
+  // Целую часть отдаем, дробную переносим
+  float fx = dx * gain + state.remX;
+  float fy = dy * gain + state.remY;
+  int32_t moveX = (int32_t)fx;
+  int32_t moveY = (int32_t)fy;
+  state.remX = fx - moveX;
+  state.remY = fy - moveY;
+  if (moveX == 0 && moveY == 0)
+    return false;
+
+  out.x = clamp_delta(moveX);
+  out.y = clamp_delta(moveY);
+  return true;
+}
+
+bool motion_process_fixed(MotionState &state, const MotionFixedConfig &cfg, q16_t angleX, q16_t angleY, uint32_t dtUs, MouseDelta &out)
+{
+  q16_t dx = wrap_delta(angleX - state.lastXq);
+  q16_t dy = wrap_delta(angleY - state.lastYq);
+  state.lastXq = angleX;
+  state.lastYq = angleY;
+
+  // Приводим смещение к опорному периоду для порогов
+  if (dtUs && dtUs != state.dtUs)
+  {
+    state.dtUs = dtUs;
+    state.dtScale = (q16_t)(((int64_t)MOTION_REF_PERIOD_US << Q16_SHIFT) / dtUs);
+  }
+  q16_t nx = q16_mul(dx, state.dtScale);
+  q16_t ny = q16_mul(dy, state.dtScale);
+  if (cfg.filter.enabled)
+  {
+    one_euro_fixed(state.filter, cfg.filter, dx, dy, approx_magnitude(nx, ny), dtUs);
+    nx = q16_mul(dx, state.dtScale);
+    ny = q16_mul(dy, state.dtScale);
+  }
+  q16_t anx = nx < 0 ? -nx : nx;
+  q16_t any = ny < 0 ? -ny : ny;
+  if (anx < cfg.deadzone && any < cfg.deadzone)
+    return false;
+
+  // Одно чтение таблицы и одно умножение на ось
+  q16_t velocity = approx_magnitude(nx, ny);
+  uint32_t index = (uint32_t)velocity >> ACCEL_LUT_SHIFT;
+  q16_t gain = cfg.gain[index < ACCEL_LUT_SIZE ? index : ACCEL_LUT_SIZE - 1];
+
+  // Целую часть отдаем, дробную переносим
+  q16_t fx = q16_mul(dx, gain) + state.remXq;
+  q16_t fy = q16_mul(dy, gain) + state.remYq;
+  int32_t moveX = q16_trunc(fx);
+  int32_t moveY = q16_trunc(fy);
+  state.remXq = fx - (moveX << Q16_SHIFT);
+  state.remYq = fy - (moveY << Q16_SHIFT);
+  if (moveX == 0 && moveY == 0)
+    return false;
+
+  out.x = clamp_delta(moveX);
+  out.y = clamp_delta(moveY);
+  return true;
+}
+
+bool motion_take_report(int32_t &pendingX, int32_t &pendingY, int8_t &outX, int8_t &outY)
+{
+  if (pendingX == 0 && pendingY == 0)
+    return false;
+  int32_t ax = pendingX < 0 ? -pendingX : pendingX;
+  int32_t ay = pendingY < 0 ? -pendingY : pendingY;
+  int32_t maxAbs = ax > ay ? ax : ay;
+  // Число отчетов для оставшегося смещения; делим поровну, чтобы не искажать направление
+  int32_t reports = (maxAbs + HID_DELTA_MAX - 1) / HID_DELTA_MAX;
+  outX = (int8_t)(pendingX / reports);
+  outY = (int8_t)(pendingY / reports);
+  pendingX -= outX;
+  pendingY -= outY;
+  return true;
+}
@@ -0,0 +1,70 @@
+// motion_pipeline.h — преобразование углов гироскопа в смещения HID-мыши (float или Q16.16)
+#pragma once
+
+#include <stdint.h>
+#include "fixed_point.h"
+#include "accel_curve.h"
+#include "one_euro.h"
+
+// Опорный период отсчетов: пороги мертвой зоны и ускорения заданы в градусах за 10 мс
+#define MOTION_REF_PERIOD_US 10000
+
+// === Параметры обработки движения ===
+struct MotionConfig
+{
+  float deadzone;             // мертвая зона (градусы за отсчет)
+  float sensitivity;          // чувствительность
+  AccelCurveConfig curve;     // кривая ускорения
+  OneEuroConfig filter;       // адаптивный фильтр дрожания
+  float gain[ACCEL_LUT_SIZE]; // sensitivity * curve(v), заполняется motion_config_build
+};
+
+// Предрасчитанные параметры для целочисленного пути
+struct MotionFixedConfig
+{
+  q16_t deadzone;
+  q16_t gain[ACCEL_LUT_SIZE]; // таблица усиления по скорости
+  OneEuroFixedConfig filter;
+};
+
+// Состояние между отсчетами (последние углы)
+struct MotionState
+{
+  float lastX;
+  float lastY;
+  q16_t lastXq;
+  q16_t lastYq;
+  uint32_t dtUs;  // последний период отсчета
+  q16_t dtScale;  // MOTION_REF_PERIOD_US / dtUs — кеш, чтобы не делить на каждом отсчете
+  float remX;     // дробный остаток движения (float путь), переносится в следующий отсчет
+  float remY;
+  q16_t remXq;    // дробный остаток движения (Q16.16 путь)
+  q16_t remYq;
+  OneEuroState filter;
+};
+
+// Смещение курсора в отсчетах HID (может превышать диапазон одного отчета)
+struct MouseDelta
+{
+  int16_t x;
+  int16_t y;
+};
+
+// Максимальное смещение в одном HID-отчете мыши
+#define HID_DELTA_MAX 127
+
+void motion_state_reset(MotionState &state);
+// Сброс дробных остатков и отставания фильтра (углы сохраняются) — при переходе в покой
+void motion_state_settle(MotionState &state);
+// Пересчет таблицы усиления после изменения чувствительности или кривой
+void motion_config_build(MotionConfig &cfg);
+void motion_fixed_config_init(const MotionConfig &cfg, MotionFixedConfig &out);
+
+// Обработка одного отсчета. dtUs — время с предыдущего отсчета (скорость считается по реальному времени).
+// Дробная часть движения копится в state. Возвращает true, если набралось целое смещение
+bool motion_process_float(MotionState &state, const MotionConfig &cfg, float angleX, float angleY, uint32_t dtUs, MouseDelta &out);
+bool motion_process_fixed(MotionState &state, const MotionFixedConfig &cfg, q16_t angleX, q16_t angleY, uint32_t dtUs, MouseDelta &out);
+
+// Следующий HID-отчет из накопленного смещения. Большое смещение делится на несколько отчетов
+// с сохранением направления; отданное вычитается из pending. Возвращает false, если отправлять нечего
+bool motion_take_report(int32_t &pendingX, int32_t &pendingY, int8_t &outX, int8_t &outY);
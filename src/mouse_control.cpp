@@ -1,32 +1,270 @@
 #include "mouse_control.h"
 #include "config.h"
+#include "action_runner.h"
 #include "button_service.h"
-#include <MPU6050_light.h>
 #include <BleMouse.h>
 #include "mcp_handler.h"
+#include "imu_pipeline.h"
+#include "scroll.h"
+#include "absolute_pointer.h"
+#include "imu_trace.h"
+#include "imu_calibration.h"
+#include "config_storage.h"
+#include "report_scheduler.h"
+#include "sleep_manager.h"
+#include "input_events.h"
+#include "i2c_service.h"
+#include "LittleFS.h"
 
-MPU6050 mpu(Wire);
+static Mpu6050 mpu;
+// Смещение гироскопа, детектор покоя, ориентация и движение — в одной цепочке (ядро 0)
+static ImuPipeline imu;
+static unsigned long lastSampleUs = 0;
 
-static float lastAngleX = 0;
-static float lastAngleY = 0;
-static float lastAngleZ = 0;
+// === Планировщик HID-отчетов: движение и кнопки с обоих ядер, отправка с ядра 0 ===
+static ReportScheduler reportScheduler;
+static portMUX_TYPE reportMux = portMUX_INITIALIZER_UNLOCKED;
+static uint8_t hostButtons = 0; // кнопки, уже переданные BleMouse
+
+#if IMU_USE_FIFO
+static ImuTimedSample fifoSamples[IMU_FIFO_MAX_SAMPLES];
+static ImuTimestamper imuTimestamper;
+#if IMU_INT_PIN >= 0
+static volatile uint32_t imuDataReadyUs = 0; // время последнего data-ready
+
+static void IRAM_ATTR imu_data_ready_isr()
+{
+  imuDataReadyUs = micros();
+}
+#endif
+#endif
+
+// === Калибровка гироскопа ===
+static GyroBiasModel savedBiasModel;      // последняя сохраненная в NVS модель
+static GyroBiasModel pendingBiasModel;    // снимок для сохранения (ядро 0 -> ядро 1)
+static volatile bool biasSavePending = false;
+static unsigned long lastBiasSaveMs = 0;
+static bool calibrationFromNvs = false;
+static portMUX_TYPE biasMux = portMUX_INITIALIZER_UNLOCKED;
+
+// === Детектор покоя: пульт лежит — нет HID-трафика, реже опрос IMU, сон разрешен ===
+static bool imuRateChangePending = false;
+
+// === Жесты: распознаются на ядре 0, действия выполняются на ядре 1 ===
+static volatile uint8_t pendingGestures = 0; // бит на жест
+static portMUX_TYPE gestureMux = portMUX_INITIALIZER_UNLOCKED;
+
+// === Запись трассы IMU: ядро 0 кладет отсчеты в буфер, ядро 1 дописывает их в сегменты LittleFS ===
+// Файлы только дописываются: запись в начало файла LittleFS переписала бы все блоки после нее
+#define IMU_TRACE_HEADER_PATH "/imu_trace.hdr"
+static const char *const traceSegmentPaths[2] = {"/imu_trace0.bin", "/imu_trace1.bin"};
+
+// Веб, ядро 0 и ядро 1 меняют состояние каждый со своей стороны — только сравнением с обменом
+enum TraceState : uint8_t
+{
+  TRACE_IDLE,      // файлы закрыты
+  TRACE_OPENING,   // веб -> ядро 1: сбросить буфер, создать файлы
+  TRACE_ARMED,     // ядро 1 -> ядро 0: снять заголовок и начать запись
+  TRACE_RECORDING, // ядро 0 кладет отсчеты в буфер
+  TRACE_STOPPING,  // веб -> ядро 0: перестать класть отсчеты
+  TRACE_STOPPED    // ядро 0 -> ядро 1: буфер больше не пополняется — дописать остаток и закрыть файлы
+};
+static std::atomic<uint8_t> traceState(TRACE_IDLE);
+static ImuTraceBuffer traceBuffer;
+static ImuTraceHeader traceHeader;    // заполняет ядро 0 в TRACE_ARMED, дальше ведет ядро 1
+static File traceFile;                // текущий сегмент (ядро 1)
+static bool traceHeaderSaved = false; // ядро 1: заголовок этой записи уже в файле
+static ImuTraceHeader traceDownloadHeader; // скачивание (веб)
+static File traceDownload[2];
+
+// === Время загрузки ===
+static unsigned long imuReadyMs = 0;  // IMU готов (мс с момента включения)
+static unsigned long firstMoveMs = 0; // первое движение курсора
+
+// Параметры указателя, прочитанные ядром 0 на каждом отсчете
+struct MouseRuntimeConfig
+{
+  MotionConfig motion;
+#if MOUSE_FIXED_POINT
+  MotionFixedConfig motionFixed;
+#endif
+  int8_t mount[MOUNT_MATRIX_SIZE]; // матрица установки датчика
+  ScrollConfig scroll;             // прокрутка наклоном
+  AbsolutePointerConfig pointer;   // режим указки
+  uint8_t scrollLayers;            // маска слоев, на которых наклон прокручивает
+  float sideZone;                  // порог accZ для смены стороны
+  uint8_t sideSwitchThreshold;     // отсчетов подряд для смены стороны
+};
+
+// Двойной буфер: писатель собирает новый блок в неактивной копии, ядро 0 читает активную без блокировок.
+// Ядро 0 объявляет копию, которую читает (readingMouseConfig); писатель не пересобирает ее, пока отсчет не обработан
+#define MOUSE_CONFIG_NONE 0xFF
+static MouseRuntimeConfig mouseConfigs[2];
+static std::atomic<uint8_t> activeMouseConfig(0);
+static std::atomic<uint8_t> readingMouseConfig(MOUSE_CONFIG_NONE);
+static const MouseRuntimeConfig *sampleConfig = &mouseConfigs[0]; // копия текущего отсчета (ядро 0)
+// Писатели настроек (веб-сервер, калибровка указки) — по одному: чтение, правка, сохранение и сборка копии
+static SemaphoreHandle_t settingsMutex = nullptr;
+static volatile bool mountChanged = false;
+// Прокрутка наклоном: состояние ведет ядро 0
+static ScrollState scrollState;
+static volatile bool scrollHeld = false; // включена действием (ядро 1)
+static bool scrollActive = false;        // режим, в котором обработан прошлый отсчет
+// Режим указки: ядро 0 ведет положение курсора хоста, действия с ядра 1 — через флаги
+static AbsolutePointer pointer;
+static AbsoluteCalibration pointerCalibration;      // только loop() (ядро 1)
+static volatile bool pointerCalibratePending = false; // снятие угла запрошено действием, выполняет loop()
+static volatile bool pointerRequested = false;      // включен действием
+static volatile bool pointerRecenterPending = false;
+static volatile bool pointerRestartPending = false; // калибровка сменилась — заново упереть курсор в угол
+static bool pointerActive = false;
+static uint32_t pointerLostMotion = 0; // сжатия и сбросы планировщика отчетов на прошлом шаге указки
 static bool initialized = false;
 bool enabled = false;
-byte currentSide = 255;
+static byte currentSide = 255; // сторона по акселерометру (ядро 0); ядро 1 узнает о смене из очереди событий MCP
 
-// === Порог сработок для фильтрации переключения стороны ===
-#define SIDE_SWITCH_THRESHOLD 5
+// === Счетчики сработок для фильтрации переключения стороны ===
 static uint8_t mouseSwitchCounter = 0;
 static uint8_t keyboardSwitchCounter = 0;
 
+// === Предпросмотр для веб-интерфейса: ядро 0 кладет смещение каждого отсчета в очередь, ядро 1 суммирует и рассылает ===
+static AsyncWebSocket previewSocket("/ws/mouse");
+static MotionEventQueue previewEvents; // смещения от цепочки (в том числе при выключенной мыши)
+static unsigned long lastPreviewMs = 0;
+
+// Сборка блока параметров из настроек (без обращения к активной копии)
+static void build_runtime_config(MouseRuntimeConfig &cfg, const MouseSettings &settings)
+{
+  MotionConfig &motion = cfg.motion;
+  motion.deadzone = settings.deadzone;
+  motion.sensitivity = settings.sensitivity;
+  motion.curve = settings.curve;
+  motion.filter = settings.filter;
+  motion_config_build(motion);
+#if MOUSE_FIXED_POINT
+  motion_fixed_config_init(motion, cfg.motionFixed);
+#endif
+  memcpy(cfg.mount, settings.mount, MOUNT_MATRIX_SIZE);
+  scroll_config_build(settings.scroll, cfg.scroll);
+  cfg.scrollLayers = settings.scroll.layers;
+  cfg.pointer = settings.pointer;
+  cfg.sideZone = settings.sideZone;
+  cfg.sideSwitchThreshold = settings.sideSwitchThreshold;
+}
+
+// === Параметры обработки движения из /mouse.bin ===
+static void init_motion_config()
+{
+  build_runtime_config(mouseConfigs[0], get_mouse_settings());
+  activeMouseConfig.store(0);
+  sampleConfig = &mouseConfigs[0];
+  imu.quaternion = MOUSE_ORIENTATION_QUAT;
+  imu_pipeline_reset_orientation(imu, ORIENTATION_KP, ORIENTATION_KI);
+}
+
+// Ядро 0: занять активную копию на время отсчета
+static void acquire_sample_config()
+{
+  uint8_t slot;
+  do
+  {
+    slot = activeMouseConfig.load();
+    readingMouseConfig.store(slot);
+  } while (activeMouseConfig.load() != slot); // копию успели переключить — объявляем новую
+  sampleConfig = &mouseConfigs[slot];
+}
+
+static void release_sample_config()
+{
+  readingMouseConfig.store(MOUSE_CONFIG_NONE);
+}
+
+static ImuPipelineConfig active_pipeline_config()
+{
+  const MouseRuntimeConfig &active = *sampleConfig;
+  ImuPipelineConfig cfg;
+  cfg.mount = active.mount;
+  cfg.motion = &active.motion;
+#if MOUSE_FIXED_POINT
+  cfg.motionFixed = &active.motionFixed;
+#else
+  cfg.motionFixed = nullptr;
+#endif
+  return cfg;
+}
+
+// === Смена параметров на лету ===
+static void settings_lock() { xSemaphoreTake(settingsMutex, portMAX_DELAY); }
+static void settings_unlock() { xSemaphoreGive(settingsMutex); }
+
+// Под settingsMutex
+static void apply_settings_locked(const MouseSettings &settings)
+{
+  uint8_t active = activeMouseConfig.load();
+  uint8_t next = active ^ 1;
+  while (readingMouseConfig.load() == next)
+    vTaskDelay(1); // ядро 0 еще обрабатывает отсчет с копией до прошлого переключения
+  build_runtime_config(mouseConfigs[next], settings);
+  if (memcmp(mouseConfigs[next].mount, mouseConfigs[active].mount, MOUNT_MATRIX_SIZE))
+    mountChanged = true; // оси сменились — ориентацию нужно оценить заново
+  activeMouseConfig.store(next); // переключение одной записью — ядро 0 не видит частично собранный блок
+#if DEBUG
+  Serial.printf("[MOUSE] Settings applied: sensitivity %.2f, deadzone %.2f, curve %s, filter %s\n", settings.sensitivity, settings.deadzone,
+                accel_curve_name(settings.curve.type), settings.filter.enabled ? "on" : "off");
+#endif
+}
+
+void mouse_control_apply_settings(const MouseSettings &settings)
+{
+  settings_lock();
+  apply_settings_locked(settings);
+  settings_unlock();
+}
+
+// Правка настроек: settings_begin берет мьютекс и копию, settings_commit проверяет, сохраняет, применяет и отпускает
+static void settings_begin(MouseSettings &settings)
+{
+  settings_lock();
+  settings = get_mouse_settings();
+}
+
+// Копия для чтения: веб-задача не застает настройки посреди settings_commit
+static MouseSettings settings_snapshot()
+{
+  settings_lock();
+  MouseSettings settings = get_mouse_settings();
+  settings_unlock();
+  return settings;
+}
+
+static bool settings_commit(const MouseSettings &settings)
+{
+  bool ok = set_mouse_settings(settings);
+  if (ok)
+    apply_settings_locked(get_mouse_settings());
+  settings_unlock();
+  return ok;
+}
+
 // === Настройка гироскопа ===
 void setup_mouse_control()
 {
+  report_scheduler_init(reportScheduler, HID_REPORT_INTERVAL_US, HID_REPORT_BACKLOG);
 #if DEBUG
   Serial.println("[MOUSE] Initializing MPU6050...");
 #endif
-  Wire.begin(I2C_SDA_PIN, I2C_SCL_PIN);
-  byte status = mpu.begin();
+  imu.mpu = &mpu;
+  settingsMutex = xSemaphoreCreateMutex();
+  init_motion_config();
+  StillnessConfig stillCfg = {STILL_ACC_VAR, STILL_GYRO_RMS, STILL_ENTER_MS * 1000UL, STILL_WINDOW_MS * 1000UL};
+  stillness_init(imu.stillness, stillCfg);
+  GestureConfig gestureCfg = {GESTURE_BURST_RATE, GESTURE_FLICK_MAX_MS * 1000UL, GESTURE_SERIES_GAP_MS * 1000UL, GESTURE_SHAKE_PEAKS,
+                              GESTURE_SHAKE_WINDOW_MS * 1000UL, GESTURE_TWIST_RATE, GESTURE_TWIST_ANGLE, GESTURE_TWIST_WINDOW_MS * 1000UL,
+                              GESTURE_RAISE_STILL_MS * 1000UL, GESTURE_RAISE_ANGLE, GESTURE_RAISE_WINDOW_MS * 1000UL, GESTURE_REFRACTORY_MS * 1000UL};
+  gesture_init(imu.gestures, gestureCfg);
+  // Отсчеты IMU — высший приоритет на шине; пакеты FIFO драйвер собирает сам
+  i2c_manager_add_device(i2cManager, MPU6050_ADDR, false, "mpu6050");
+  byte status = mpu6050_begin(mpu, &i2c_managed_bus);
   if (status != 0)
   {
 #if DEBUG
@@ -34,44 +272,449 @@ void setup_mouse_control()
 #endif
     return;
   }
-  delay(500);
-  mpu.calcGyroOffsets();
+
+  // Калибровка из NVS — без ожидания и без требования держать пульт неподвижно
+  GyroBiasModel model;
+  calibrationFromNvs = ImuCalibration::load(model);
+  if (!calibrationFromNvs)
+  {
+    delay(500);
+    mpu6050_calc_gyro_offsets(mpu);
+    ImuSample sample;
+    mpu6050_read(mpu, sample);
+    model.bias[0] = mpu.gyroOffsetX;
+    model.bias[1] = mpu.gyroOffsetY;
+    model.bias[2] = mpu.gyroOffsetZ;
+    model.tempRef = sample.temp;
+    model.slope[0] = model.slope[1] = model.slope[2] = 0;
+    ImuCalibration::save(model);
+  }
+  gyro_bias_init(imu.bias, model);
+  savedBiasModel = model;
+  lastBiasSaveMs = millis();
+#if IMU_USE_FIFO
+  if (!mpu6050_fifo_begin(mpu, IMU_SAMPLE_RATE_HZ))
+  {
+#if DEBUG
+    Serial.println("[MOUSE] Error MPU6050 FIFO setup");
+#endif
+    return;
+  }
+  imu_timestamper_reset(imuTimestamper, mpu.samplePeriodUs);
+#if IMU_INT_PIN >= 0
+  pinMode(IMU_INT_PIN, INPUT);
+  attachInterrupt(digitalPinToInterrupt(IMU_INT_PIN), imu_data_ready_isr, RISING);
+#endif
+#endif
+  lastSampleUs = micros();
   initialized = true;
   enabled = true;
+  // До первой оценки покоя считаем, что пульт в руке. Без IMU флаг не ставится — иначе сон не наступил бы никогда
+  sleepManagerSetMotionActive(true);
+  imuReadyMs = millis();
 #if DEBUG
-  Serial.println("[MOUSE] MPU6050 initialized");
+  Serial.printf("[MOUSE] MPU6050 initialized at %lu ms (calibration: %s)\n", imuReadyMs, calibrationFromNvs ? "nvs" : "boot");
 #endif
 }
 
-// === Обновление положения курсора (вызов из loop/core) ===
-void update_mouse_control()
+static ImuPipelineConfig active_pipeline_config();
+
+static bool trace_transition(uint8_t from, uint8_t to)
 {
-  if (!initialized)
+  return traceState.compare_exchange_strong(from, to);
+}
+
+// Ядро 0. Старт: сброс ориентации и снимок цепочки — трасса воспроизводится с того же состояния.
+// Стоп: подтверждение, что отсчеты в буфер больше не кладутся
+static void trace_update_state()
+{
+  uint8_t state = traceState.load();
+  if (state == TRACE_ARMED)
+  {
+    imu_pipeline_reset_orientation(imu, ORIENTATION_KP, ORIENTATION_KI);
+    imu_trace_header_init(traceHeader, IMU_TRACE_CAPACITY, imu, active_pipeline_config(), ORIENTATION_KP, ORIENTATION_KI);
+    trace_transition(TRACE_ARMED, TRACE_RECORDING); // не вышло — уже остановлена, подтверждение на следующем отсчете
+  }
+  else if (state == TRACE_STOPPING)
+  {
+    trace_transition(TRACE_STOPPING, TRACE_STOPPED);
+  }
+}
+
+// === Обработка одного сырого отсчета: цепочка IMU, реакция на покой и калибровку, курсор ===
+static void process_raw_sample(const MpuRawSample &raw, uint32_t dtUs)
+{
+  acquire_sample_config();
+  if (mountChanged)
+  {
+    mountChanged = false; // оси сменились — ориентацию нужно оценить заново
+    imu_pipeline_reset_orientation(imu, ORIENTATION_KP, ORIENTATION_KI);
+  }
+  trace_update_state();
+
+  MouseDelta delta;
+  uint8_t flags = imu_pipeline_step(imu, active_pipeline_config(), raw, dtUs, delta);
+  if (flags & IMU_STEP_BIAS_UPDATED)
+  {
+    // Сохраняем не чаще GYRO_CAL_SAVE_INTERVAL_MS и только при заметном изменении
+    if (!biasSavePending && millis() - lastBiasSaveMs > GYRO_CAL_SAVE_INTERVAL_MS &&
+        gyro_bias_changed(imu.bias.model, savedBiasModel, GYRO_CAL_SAVE_DELTA))
+    {
+      portENTER_CRITICAL(&biasMux);
+      pendingBiasModel = imu.bias.model;
+      portEXIT_CRITICAL(&biasMux);
+      biasSavePending = true;
+    }
+  }
+  if (flags & IMU_STEP_STILL_CHANGED)
+  {
+    sleepManagerSetMotionActive(!imu.stillness.still);
+    imuRateChangePending = true;
+#if DEBUG
+    Serial.printf("[MOUSE] %s\n", imu.stillness.still ? "Still" : "Moving");
+#endif
+  }
+  if (flags & IMU_STEP_GESTURE)
+  {
+    portENTER_CRITICAL(&gestureMux);
+    pendingGestures |= 1 << imu.gesture;
+    portEXIT_CRITICAL(&gestureMux);
+#if DEBUG
+    Serial.printf("[MOUSE] Gesture: %s\n", gesture_name(imu.gesture));
+#endif
+  }
+  if (traceState.load() == TRACE_RECORDING)
+  {
+    ImuTraceRecord record;
+    imu_trace_pack(raw, dtUs, flags & IMU_STEP_MOVED, delta, record);
+    imu_trace_push(traceBuffer, record);
+  }
+  processMouseMove(flags & IMU_STEP_MOVED, delta, dtUs);
+  release_sample_config();
+}
+
+// Угол экрана по запросу действия; готовый прямоугольник — в настройки тем же путем, что и из веб-интерфейса
+static void capture_pointer_corner()
+{
+  pointerCalibratePending = false;
+  MouseSettings settings;
+  settings_begin(settings);
+  bool done = absolute_calibration_capture(pointerCalibration, settings.pointer, imu.angleX, imu.angleY);
+#if DEBUG
+  Serial.printf("[MOUSE] Pointer calibration: %s\n", done ? "done" : pointerCalibration.step ? "top-left captured" : "invalid, restart");
+#endif
+  if (!done)
+  {
+    settings_unlock();
+    return;
+  }
+  if (settings_commit(settings))
+    pointerRestartPending = true;
+}
+
+// === Сохранение уточненной калибровки (ядро 1: запись NVS и flash блокирует на время стирания) ===
+void mouse_control_save_calibration()
+{
+  if (pointerCalibratePending)
+    capture_pointer_corner();
+  if (!biasSavePending)
     return;
-  mpu.update();
-  processMouseMove();
+  GyroBiasModel model;
+  portENTER_CRITICAL(&biasMux);
+  model = pendingBiasModel;
+  portEXIT_CRITICAL(&biasMux);
+  ImuCalibration::save(model);
+  savedBiasModel = model;
+  lastBiasSaveMs = millis();
+  biasSavePending = false;
+#if DEBUG
+  Serial.printf("[MOUSE] Gyro calibration saved: %.3f %.3f %.3f @ %.1f C\n", model.bias[0], model.bias[1], model.bias[2], model.tempRef);
+#endif
+}
+
+// === Запись трассы в сегменты (ядро 1: запись flash блокирует) ===
+static bool trace_open_segment(uint8_t segment)
+{
+  if (traceFile)
+    traceFile.close();
+  traceFile = LittleFS.open(traceSegmentPaths[segment], FILE_WRITE); // сегмент начинается пустым
+  return traceFile;
+}
+
+// Заголовок — маленький отдельный файл: при старте, при смене сегмента и при остановке
+static void trace_save_header()
+{
+  traceHeader.dropped = traceBuffer.dropped;
+  File file = LittleFS.open(IMU_TRACE_HEADER_PATH, FILE_WRITE);
+  if (!file)
+    return;
+  file.write((uint8_t *)&traceHeader, sizeof(traceHeader));
+  file.close();
+  traceHeaderSaved = true;
 }
 
-// === Обработка движения мыши на основе углов ===
-void processMouseMove()
+// Записи из буфера — в конец текущего сегмента; заполненный сегмент сменяется другим
+static void trace_drain()
+{
+  ImuTraceRecord record;
+  while (imu_trace_pop(traceBuffer, record))
+  {
+    if (!traceHeaderSaved)
+      continue; // файлы не открылись
+    if (traceHeader.count && imu_trace_segment_offset(traceHeader, traceHeader.count) == 0)
+    {
+      trace_save_header();
+      if (!trace_open_segment(imu_trace_segment(traceHeader, traceHeader.count)))
+      {
+        traceHeaderSaved = false;
+        continue;
+      }
+    }
+    traceFile.write((uint8_t *)&record, sizeof(record));
+    traceHeader.count++;
+  }
+}
+
+void mouse_control_trace_flush()
+{
+  switch (traceState.load())
+  {
+  case TRACE_OPENING:
+    // Ядро 0 в буфер не пишет (запись не идет) — сброс на стороне читателя
+    imu_trace_buffer_reset(traceBuffer);
+    memset(&traceHeader, 0, sizeof(traceHeader));
+    traceHeaderSaved = false;
+    LittleFS.remove(IMU_TRACE_HEADER_PATH);
+    LittleFS.remove(traceSegmentPaths[1]);
+    if (!trace_open_segment(0))
+    {
+#if DEBUG
+      Serial.println("[MOUSE] Trace file open failed");
+#endif
+      trace_transition(TRACE_OPENING, TRACE_IDLE);
+      return;
+    }
+    trace_transition(TRACE_OPENING, TRACE_ARMED);
+    return;
+  case TRACE_RECORDING:
+    if (!traceHeaderSaved)
+    {
+      trace_save_header(); // ядро 0 заполнило заголовок до перехода в TRACE_RECORDING
+#if DEBUG
+      Serial.printf("[MOUSE] Trace recording started (%u records)\n", (unsigned)traceHeader.capacity);
+#endif
+    }
+    trace_drain();
+    return;
+  case TRACE_STOPPED:
+    // Ядро 0 подтвердило остановку: заголовок и буфер больше не меняются
+    if (!traceHeaderSaved && traceFile && traceHeader.magic == IMU_TRACE_MAGIC)
+      trace_save_header();
+    trace_drain();
+    if (traceHeaderSaved)
+      trace_save_header();
+    if (traceFile)
+      traceFile.close();
+#if DEBUG
+    Serial.printf("[MOUSE] Trace recording stopped: %u records, %u dropped\n", (unsigned)traceHeader.count, (unsigned)traceHeader.dropped);
+#endif
+    traceState.store(TRACE_IDLE); // только после закрытия: новая запись не начнется поверх
+    return;
+  }
+}
+
+// === Предпросмотр: суммы смещений из очереди, не чаще MOUSE_PREVIEW_INTERVAL_MS (ядро 1) ===
+static void preview_send(int32_t x, int32_t y, int32_t wheel, uint32_t samples)
+{
+  String json = "{";
+  json += "\"dx\":" + String(x) + ",";
+  json += "\"dy\":" + String(y) + ",";
+  json += "\"wheel\":" + String(wheel) + ",";
+  json += "\"samples\":" + String(samples) + ",";
+  json += "\"angleX\":" + String(imu.angleX, 2) + ",";
+  json += "\"angleY\":" + String(imu.angleY, 2) + ",";
+  json += "\"accZ\":" + String(imu.sample.accZ, 2) + ",";
+  json += "\"still\":" + String(imu.stillness.still ? "true" : "false") + ",";
+  json += "\"scroll\":" + String(scrollActive ? "true" : "false") + ",";
+  json += "\"pointer\":" + String(pointerActive ? "true" : "false") + ",";
+  json += "\"enabled\":" + String(enabled ? "true" : "false");
+  json += "}";
+  previewSocket.textAll(json);
+}
+
+void mouse_control_preview_loop()
+{
+  static int32_t x = 0, y = 0, wheel = 0;
+  static uint32_t samples = 0;
+  // Очередь разбирается при каждом вызове, чтобы не переполнялась между кадрами
+  InputEvent e;
+  while (spsc_pop(previewEvents, e))
+  {
+    x += e.dx;
+    y += e.dy;
+    wheel += e.wheel;
+    samples++;
+  }
+  if (millis() - lastPreviewMs < MOUSE_PREVIEW_INTERVAL_MS)
+    return;
+  lastPreviewMs = millis();
+  previewSocket.cleanupClients();
+
+  if (previewSocket.count() && previewSocket.availableForWriteAll())
+    preview_send(x, y, wheel, samples);
+  x = y = wheel = 0;
+  samples = 0;
+}
+
+// === Распознанные жесты для выполнения действий (ядро 1) ===
+uint8_t mouse_control_take_gestures()
+{
+  portENTER_CRITICAL(&gestureMux);
+  uint8_t gestures = pendingGestures;
+  pendingGestures = 0;
+  portEXIT_CRITICAL(&gestureMux);
+  return gestures;
+}
+
+// === HID-отчеты мыши через планировщик ===
+void mouse_report_move(int32_t dx, int32_t dy)
+{
+  portENTER_CRITICAL(&reportMux);
+  report_scheduler_add_motion(reportScheduler, dx, dy);
+  portEXIT_CRITICAL(&reportMux);
+}
+
+void mouse_report_wheel(int32_t wheel)
+{
+  portENTER_CRITICAL(&reportMux);
+  report_scheduler_add_wheel(reportScheduler, wheel);
+  portEXIT_CRITICAL(&reportMux);
+}
+
+void mouse_report_press(uint8_t buttons)
+{
+  portENTER_CRITICAL(&reportMux);
+  report_scheduler_press(reportScheduler, buttons);
+  portEXIT_CRITICAL(&reportMux);
+}
+
+void mouse_report_release(uint8_t buttons)
+{
+  portENTER_CRITICAL(&reportMux);
+  report_scheduler_release(reportScheduler, buttons);
+  portEXIT_CRITICAL(&reportMux);
+}
+
+void mouse_report_click(uint8_t buttons)
+{
+  portENTER_CRITICAL(&reportMux);
+  report_scheduler_press(reportScheduler, buttons);
+  report_scheduler_release(reportScheduler, buttons);
+  portEXIT_CRITICAL(&reportMux);
+}
+
+// Не больше одного отчета за HID_REPORT_INTERVAL_US; пока хост не подключен, движение и клики не копятся
+static void flush_mouse_reports()
+{
+  HidMouseReport report;
+  bool connected = is_hid_connected();
+  portENTER_CRITICAL(&reportMux);
+  bool send = report_scheduler_poll(reportScheduler, micros(), connected ? REPORT_LINK_READY : REPORT_LINK_DISCONNECTED, report);
+  portEXIT_CRITICAL(&reportMux);
+  if (!connected && hostButtons)
+  {
+    // Хост забыл нажатые кнопки: BleMouse тоже отпускает их у себя, после подключения они уйдут заново
+    Mouse.release(hostButtons);
+    hostButtons = 0;
+  }
+  if (!send)
+    return;
+
+  // BleMouse не умеет менять кнопки без отдельного отчета: press/release отправляют кнопки, move — движение
+  uint8_t pressed = report.buttons & ~hostButtons;
+  uint8_t released = hostButtons & ~report.buttons;
+  if (pressed)
+    Mouse.press(pressed);
+  if (released)
+    Mouse.release(released);
+  hostButtons = report.buttons;
+  if (report.x || report.y || report.wheel)
+  {
+    if (!firstMoveMs)
+    {
+      firstMoveMs = millis();
+#if DEBUG
+      Serial.printf("[MOUSE] First cursor move at %lu ms after power-on\n", firstMoveMs);
+#endif
+    }
+    Mouse.move(report.x, report.y, report.wheel);
+  }
+}
+
+// === Обновление положения курсора (вызов из loop/core) ===
+void update_mouse_control()
 {
   if (!initialized)
+  {
+    flush_mouse_reports(); // клики от кнопок уходят и без гироскопа
     return;
+  }
 
-  float accZ = mpu.getAccZ();
-#ifdef MOUSE_INVERT_Z
-  accZ = -accZ;
-#elif defined(MOUSE_SIDE_INVERT)
-  // Для обратной совместимости
-  accZ = -accZ;
+#if IMU_USE_FIFO
+  // Выбираем все накопленные кадры FIFO, каждый — со своим временем
+#if IMU_INT_PIN >= 0
+  uint32_t lastReadyUs = imuDataReadyUs;
+#else
+  uint32_t lastReadyUs = micros();
 #endif
+  uint8_t n = mpu6050_fifo_drain(mpu, fifoSamples, IMU_FIFO_MAX_SAMPLES);
+  if (n)
+  {
+    imu_timestamper_apply(imuTimestamper, fifoSamples, n, lastReadyUs);
+    for (uint8_t i = 0; i < n; i++)
+      process_raw_sample(fifoSamples[i].raw, fifoSamples[i].dtUs);
+    lastSampleUs = fifoSamples[n - 1].tUs;
+  }
+  // В покое MPU6050 выдает отсчеты реже — меньше чтений I2C
+  if (imuRateChangePending)
+  {
+    imuRateChangePending = false;
+    mpu6050_set_sample_rate(mpu, imu.stillness.still ? IMU_STILL_SAMPLE_RATE_HZ : IMU_SAMPLE_RATE_HZ);
+    imu_timestamper_reset(imuTimestamper, mpu.samplePeriodUs);
+  }
+#else
+  // Один пакет accel+temp+gyro; в покое — не чаще IMU_STILL_SAMPLE_RATE_HZ
+  MpuRawSample raw;
+  imuRateChangePending = false;
+  if ((!imu.stillness.still || micros() - lastSampleUs >= 1000000UL / IMU_STILL_SAMPLE_RATE_HZ) && mpu6050_read_raw(mpu, raw))
+  {
+    unsigned long now = micros();
+    uint32_t dtUs = now - lastSampleUs;
+    lastSampleUs = now;
+    process_raw_sample(raw, dtUs);
+  }
+#endif
+
+  flush_mouse_reports();
+}
+
+static inline int16_t clamp_int16(int32_t v)
+{
+  return v > INT16_MAX ? INT16_MAX : (v < INT16_MIN ? INT16_MIN : (int16_t)v);
+}
+
+// === Определение стороны и отправка смещения курсора; отправленное записывается в preview ===
+static void route_motion(bool moved, const MouseDelta &delta, uint32_t dtUs, InputEvent &preview)
+{
+  const MouseRuntimeConfig &cfg = *sampleConfig;
+  float accZ = imu.sample.accZ;
 
   // === Фильтр шумов при переключении стороны ===
-  if (accZ > MOUSE_SIDE_ZONE)
+  if (accZ > cfg.sideZone)
   {
     mouseSwitchCounter++;
     keyboardSwitchCounter = 0;
-    if (mouseSwitchCounter >= SIDE_SWITCH_THRESHOLD && currentSide != SIDE_MOUSE)
+    if (mouseSwitchCounter >= cfg.sideSwitchThreshold && currentSide != SIDE_MOUSE)
     {
 #if DEBUG && DEBUG_MOUSE_STATE
       Serial.println("SWITCH TO MOUSE");
@@ -81,11 +724,11 @@ void processMouseMove()
       set_mcp_active_side(SIDE_MOUSE);
     }
   }
-  else if (accZ < -MOUSE_SIDE_ZONE)
+  else if (accZ < -cfg.sideZone)
   {
     keyboardSwitchCounter++;
     mouseSwitchCounter = 0;
-    if (keyboardSwitchCounter >= SIDE_SWITCH_THRESHOLD && currentSide != SIDE_KEYBOARD)
+    if (keyboardSwitchCounter >= cfg.sideSwitchThreshold && currentSide != SIDE_KEYBOARD)
     {
 #if DEBUG && DEBUG_MOUSE_STATE
       Serial.println("SWITCH TO KEYBOARD");
@@ -105,76 +748,104 @@ void processMouseMove()
 #endif
   }
 
-  // === Получаем углы наклона по осям X и Y ===
-  float angleX = mpu.getAngleX();
-  float angleY = mpu.getAngleY();
-
-  // Поворот датчика относительно оси устройства
-#if MOUSE_SENSOR_ROTATION == 90
-  {
-    float t = angleX;
-    angleX = -angleY;
-    angleY = t;
-  }
-#elif MOUSE_SENSOR_ROTATION == 180
-  angleX = -angleX;
-  angleY = -angleY;
-#elif MOUSE_SENSOR_ROTATION == 270
-  {
-    float t = angleX;
-    angleX = angleY;
-    angleY = -t;
-  }
-#endif
-
-  // Инверсия осей
-#ifdef MOUSE_INVERT_X
-  angleX = -angleX;
-#endif
-#ifdef MOUSE_INVERT_Y
-  angleY = -angleY;
-#endif
-
-  float dx = angleX - lastAngleX;
-  float dy = angleY - lastAngleY;
-
 #if DEBUG && DEBUG_MOUSE_STATE
   Serial.print("[MOUSE] ");
   Serial.print("X: ");
-  Serial.print(angleX);
+  Serial.print(imu.angleX);
   Serial.print(" Y: ");
-  Serial.print(angleY);
-  Serial.print(" dX: ");
-  Serial.print(dx);
-  Serial.print(" dY: ");
-  Serial.println(dy);
+  Serial.print(imu.angleY);
+  Serial.print(" mX: ");
+  Serial.print(moved ? delta.x : 0);
+  Serial.print(" mY: ");
+  Serial.println(moved ? delta.y : 0);
 #endif
 
-  lastAngleX = angleX;
-  lastAngleY = angleY;
-
   if (!is_hid_connected() && !enabled && currentSide == SIDE_MOUSE)
     return;
 
-  if (fabs(dx) < MOUSE_DEADZONE && fabs(dy) < MOUSE_DEADZONE)
+  // Прокрутка: кнопкой или на слоях из настроек
+  bool scroll = scrollHeld || (cfg.scrollLayers >> get_active_layer()) & 1;
+  if (scroll != scrollActive)
+  {
+    scrollActive = scroll;
+    scroll_state_reset(scrollState);
+    motion_state_settle(imu.motion); // остаток курсора не выстреливает после смены режима
+  }
+  if (scrollActive)
+  {
+    int32_t wheel;
+    if (imu.stillness.still)
+      scroll_state_reset(scrollState); // в покое отсчет начнется заново, дрейф не копится
+    else if (scroll_process(scrollState, cfg.scroll, imu.angleY, dtUs, wheel))
+    {
+      preview.wheel = clamp_int16(wheel);
+      if (enabled)
+        mouse_report_wheel(wheel);
+    }
     return;
+  }
 
-  float velocity = sqrt(dx * dx + dy * dy);
-  float accFactor = velocity > MOUSE_ACCEL_THRESHOLD ? MOUSE_ACCEL_MULTIPLIER : 1.0;
-  float precision = (velocity < MOUSE_PRECISION_THRESHOLD) ? MOUSE_PRECISION_SCALE : 1.0;
-
-  int moveX = dx * MOUSE_SENSITIVITY * accFactor * precision;
-  int moveY = dy * MOUSE_SENSITIVITY * accFactor * precision;
-
-  if (moveX != 0 || moveY != 0)
+  // Указка: пока мышь выключена, курсор хоста стоит — после включения упираем его в угол заново
+  if (pointerRestartPending)
+  {
+    pointerRestartPending = false;
+    pointerActive = false;
+  }
+  bool absolute = pointerRequested && enabled;
+  if (absolute != pointerActive)
   {
-    if (enabled)
+    pointerActive = absolute;
+    if (absolute)
     {
-      moveX = constrain(moveX, -127, 127);
-      moveY = constrain(moveY, -127, 127);
-      Mouse.move(moveX, moveY);
+      absolute_pointer_begin(pointer, cfg.pointer, HID_REPORT_INTERVAL_US);
+      pointerLostMotion = reportScheduler.clippedMotion + reportScheduler.disconnects;
     }
+    motion_state_settle(imu.motion);
   }
+  if (pointerActive)
+  {
+    // Часть движения не дошла до хоста — оценка положения курсора разошлась с ним, упираем в угол заново
+    uint32_t lost = reportScheduler.clippedMotion + reportScheduler.disconnects;
+    if (lost != pointerLostMotion)
+    {
+      pointerLostMotion = lost;
+      absolute_pointer_home(pointer, cfg.pointer);
+    }
+    if (pointerRecenterPending)
+    {
+      pointerRecenterPending = false;
+      absolute_pointer_recenter(pointer, cfg.pointer, pointer.angleX, pointer.angleY);
+    }
+    int32_t dx, dy;
+    if (absolute_pointer_step(pointer, cfg.pointer, imu.angleX, imu.angleY, dtUs, dx, dy))
+    {
+      preview.dx = clamp_int16(dx);
+      preview.dy = clamp_int16(dy);
+      mouse_report_move(dx, dy);
+    }
+    return;
+  }
+
+  if (!moved)
+    return;
+  // Инверсия курсора — знак готового смещения: зеркало не поворот, в матрицу установки его не заложить
+  int32_t dx = MOUSE_INVERT_X ? -delta.x : delta.x;
+  int32_t dy = MOUSE_INVERT_Y ? -delta.y : delta.y;
+  preview.dx = clamp_int16(dx);
+  preview.dy = clamp_int16(dy);
+  if (enabled)
+    mouse_report_move(dx, dy);
+}
+
+void processMouseMove(bool moved, const MouseDelta &delta, uint32_t dtUs)
+{
+  if (!initialized)
+    return;
+  InputEvent preview = {};
+  preview.tUs = micros();
+  preview.type = INPUT_EVENT_MOTION;
+  route_motion(moved, delta, dtUs, preview);
+  spsc_push(previewEvents, preview); // очередь полна — в предпросмотре пропадет один отсчет, на курсор не влияет
 }
 
 void mouse_control_enable()
@@ -202,3 +873,564 @@ void mouse_control_toggle()
     return;
   enabled = !enabled;
 }
+
+void mouse_control_set_scroll(bool on)
+{
+  scrollHeld = on;
+#if DEBUG
+  Serial.printf("[MOUSE] Tilt scroll %s\n", on ? "on" : "off");
+#endif
+}
+
+void mouse_control_toggle_scroll()
+{
+  mouse_control_set_scroll(!scrollHeld);
+}
+
+void mouse_control_set_pointer(bool on)
+{
+  pointerRequested = on;
+#if DEBUG
+  Serial.printf("[MOUSE] Pointer mode %s\n", on ? "on" : "off");
+#endif
+}
+
+void mouse_control_toggle_pointer()
+{
+  mouse_control_set_pointer(!pointerRequested);
+}
+
+void mouse_control_pointer_recenter()
+{
+  pointerRecenterPending = true;
+}
+
+// Снятие угла экрана: направление пульта сейчас — левый верхний, при следующем вызове — правый нижний.
+// Действие только ставит запрос: снимает, сохраняет /mouse.bin и применяет один владелец — mouse_control_save_calibration
+void mouse_control_pointer_calibrate()
+{
+  pointerCalibratePending = true;
+}
+
+String mouse_control_state()
+{
+  float bias[3];
+  gyro_bias_get(imu.bias, imu.bias.model.tempRef, bias);
+  String json = "\"imu_initialized\":" + String(initialized ? "true" : "false") + ",";
+  json += "\"imu_ready_ms\":" + String(imuReadyMs) + ",";
+  json += "\"first_move_ms\":" + String(firstMoveMs) + ",";
+  json += "\"gyro_calibration\":\"" + String(calibrationFromNvs ? "nvs" : "boot") + "\",";
+  json += "\"gyro_bias\":[" + String(bias[0], 3) + "," + String(bias[1], 3) + "," + String(bias[2], 3) + "],";
+  json += "\"gyro_bias_temp\":" + String(imu.bias.model.tempRef, 1) + ",";
+  json += "\"gyro_bias_blocks\":" + String(imu.bias.acceptedBlocks) + ",";
+  json += "\"still\":" + String(imu.stillness.still ? "true" : "false") + ",";
+  json += "\"still_transitions\":" + String(imu.stillness.transitions) + ",";
+  json += "\"imu_period_us\":" + String(mpu.samplePeriodUs) + ",";
+  json += "\"scroll\":" + String(scrollActive ? "true" : "false") + ",";
+  json += "\"gestures\":{";
+  for (uint8_t g = 0; g < GESTURE_COUNT; g++)
+  {
+    json += "\"" + String(gesture_name(g)) + "\":" + String(imu.gestures.detected[g]);
+    if (g + 1 < GESTURE_COUNT)
+      json += ",";
+  }
+  json += "},";
+  json += "\"hid_reports\":" + String(reportScheduler.reports) + ",";
+  json += "\"hid_merged\":" + String(reportScheduler.mergedEvents) + ",";
+  json += "\"hid_congested\":" + String(reportScheduler.congestedPolls) + ",";
+  json += "\"hid_disconnect_drops\":" + String(reportScheduler.disconnects);
+  return json;
+}
+
+// === API кривой ускорения ===
+static String accel_curve_json()
+{
+  settings_lock(); // настройки и копия не меняются, пока их читаем
+  AccelCurveConfig curve = get_mouse_settings().curve;
+  MotionConfig cfg = mouseConfigs[activeMouseConfig].motion;
+  settings_unlock();
+  String json = "{";
+  json += "\"type\":" + String(curve.type) + ",";
+  json += "\"name\":\"" + String(accel_curve_name(curve.type)) + "\",";
+  json += "\"minGain\":" + String(curve.minGain, 3) + ",";
+  json += "\"maxGain\":" + String(curve.maxGain, 3) + ",";
+  json += "\"threshold\":" + String(curve.threshold, 3) + ",";
+  json += "\"param\":" + String(curve.param, 3) + ",";
+  json += "\"points\":[";
+  for (uint8_t i = 0; i < curve.pointCount; i++)
+  {
+    json += "[" + String(curve.points[i].velocity, 3) + "," + String(curve.points[i].gain, 3) + "]";
+    if (i + 1 < curve.pointCount)
+      json += ",";
+  }
+  json += "],";
+  // Таблица с учетом чувствительности — для графика в интерфейсе
+  json += "\"lutStep\":" + String(ACCEL_LUT_STEP, 3) + ",";
+  json += "\"lut\":[";
+  for (int i = 0; i < ACCEL_LUT_SIZE; i++)
+  {
+    json += String(cfg.gain[i], 3);
+    if (i + 1 < ACCEL_LUT_SIZE)
+      json += ",";
+  }
+  json += "]}";
+  return json;
+}
+
+static String filter_json()
+{
+  OneEuroConfig filter = settings_snapshot().filter;
+  String json = "{";
+  json += "\"enabled\":" + String(filter.enabled ? "true" : "false") + ",";
+  json += "\"minCutoff\":" + String(filter.minCutoff, 3) + ",";
+  json += "\"beta\":" + String(filter.beta, 3) + ",";
+  json += "\"dCutoff\":" + String(filter.dCutoff, 3);
+  json += "}";
+  return json;
+}
+
+static String mount_json()
+{
+  MouseSettings settings = settings_snapshot();
+  const int8_t *m = settings.mount;
+  String json = "{\"matrix\":[";
+  for (int i = 0; i < MOUNT_MATRIX_SIZE; i++)
+  {
+    json += String(m[i]);
+    if (i + 1 < MOUNT_MATRIX_SIZE)
+      json += ",";
+  }
+  json += "]}";
+  return json;
+}
+
+static String scroll_json()
+{
+  settings_lock();
+  ScrollSettings scroll = get_mouse_settings().scroll;
+  ScrollConfig cfg = mouseConfigs[activeMouseConfig].scroll;
+  settings_unlock();
+  String json = "{";
+  json += "\"active\":" + String(scrollActive ? "true" : "false") + ",";
+  json += "\"held\":" + String(scrollHeld ? "true" : "false") + ",";
+  json += "\"layers\":" + String(scroll.layers) + ",";
+  json += "\"sensitivity\":" + String(scroll.sensitivity, 3) + ",";
+  json += "\"deadzone\":" + String(scroll.deadzone, 3) + ",";
+  json += "\"invert\":" + String(scroll.invert ? "true" : "false") + ",";
+  json += "\"type\":" + String(scroll.curve.type) + ",";
+  json += "\"name\":\"" + String(accel_curve_name(scroll.curve.type)) + "\",";
+  json += "\"minGain\":" + String(scroll.curve.minGain, 3) + ",";
+  json += "\"maxGain\":" + String(scroll.curve.maxGain, 3) + ",";
+  json += "\"threshold\":" + String(scroll.curve.threshold, 3) + ",";
+  json += "\"param\":" + String(scroll.curve.param, 3) + ",";
+  // Щелчков на градус с учетом кривой — для графика в интерфейсе
+  json += "\"lutStep\":" + String(ACCEL_LUT_STEP, 3) + ",";
+  json += "\"lut\":[";
+  for (int i = 0; i < ACCEL_LUT_SIZE; i++)
+  {
+    json += String(cfg.gain[i], 3);
+    if (i + 1 < ACCEL_LUT_SIZE)
+      json += ",";
+  }
+  json += "]}";
+  return json;
+}
+
+static String trace_json()
+{
+  String json = "{";
+  json += "\"recording\":" + String(traceState.load() != TRACE_IDLE ? "true" : "false") + ",";
+  json += "\"count\":" + String(traceHeader.count) + ",";
+  json += "\"capacity\":" + String((uint32_t)IMU_TRACE_CAPACITY) + ",";
+  json += "\"dropped\":" + String(traceBuffer.dropped) + ",";
+  json += "\"record_size\":" + String((uint32_t)sizeof(ImuTraceRecord));
+  json += "}";
+  return json;
+}
+
+// === Скачивание трассы: заголовок, затем записи из сегментов по порядку ===
+static void trace_download_close()
+{
+  for (File &file : traceDownload)
+    if (file)
+      file.close();
+}
+
+// Заголовок и сегменты на месте и содержат все сохраненные записи
+static bool trace_download_open()
+{
+  trace_download_close();
+  File file = LittleFS.open(IMU_TRACE_HEADER_PATH, FILE_READ);
+  if (!file)
+    return false;
+  bool ok = file.read((uint8_t *)&traceDownloadHeader, sizeof(traceDownloadHeader)) == sizeof(traceDownloadHeader) &&
+            imu_trace_header_valid(traceDownloadHeader);
+  file.close();
+  if (!ok)
+    return false;
+
+  uint8_t segment;
+  uint32_t offset;
+  for (uint32_t pos = 0, n; (n = imu_trace_locate(traceDownloadHeader, pos, segment, offset)) != 0; pos += n)
+  {
+    File &f = traceDownload[segment];
+    if (!f)
+      f = LittleFS.open(traceSegmentPaths[segment], FILE_READ);
+    if (!f || f.size() < offset + n)
+    {
+      trace_download_close();
+      return false;
+    }
+  }
+  return true;
+}
+
+static size_t trace_download_fill(uint8_t *buffer, size_t maxLen, size_t index)
+{
+  const size_t headerSize = sizeof(traceDownloadHeader);
+  size_t n = 0;
+  if (index < headerSize)
+  {
+    n = headerSize - index < maxLen ? headerSize - index : maxLen;
+    memcpy(buffer, (const uint8_t *)&traceDownloadHeader + index, n);
+  }
+  else
+  {
+    uint8_t segment;
+    uint32_t offset;
+    uint32_t left = imu_trace_locate(traceDownloadHeader, index - headerSize, segment, offset);
+    if (left && traceDownload[segment] && traceDownload[segment].seek(offset))
+      n = traceDownload[segment].read(buffer, left < maxLen ? left : maxLen);
+  }
+  if (!n || index + n >= imu_trace_offset(traceDownloadHeader, traceDownloadHeader.count))
+    trace_download_close();
+  return n;
+}
+
+// Параметры кривой из формы; не переданные остаются прежними
+static void read_curve_params(AsyncWebServerRequest *request, AccelCurveConfig &curve)
+{
+  if (request->hasParam("type", true))
+    curve.type = request->getParam("type", true)->value().toInt();
+  if (request->hasParam("minGain", true))
+    curve.minGain = request->getParam("minGain", true)->value().toFloat();
+  if (request->hasParam("maxGain", true))
+    curve.maxGain = request->getParam("maxGain", true)->value().toFloat();
+  if (request->hasParam("threshold", true))
+    curve.threshold = request->getParam("threshold", true)->value().toFloat();
+  if (request->hasParam("param", true))
+    curve.param = request->getParam("param", true)->value().toFloat();
+}
+
+static String pointer_json()
+{
+  AbsolutePointerConfig cfg = settings_snapshot().pointer;
+  String json = "{";
+  json += "\"active\":" + String(pointerActive ? "true" : "false") + ",";
+  json += "\"requested\":" + String(pointerRequested ? "true" : "false") + ",";
+  json += "\"calibrationStep\":" + String(pointerCalibration.step) + ",";
+  json += "\"left\":" + String(cfg.left, 2) + ",";
+  json += "\"top\":" + String(cfg.top, 2) + ",";
+  json += "\"right\":" + String(cfg.right, 2) + ",";
+  json += "\"bottom\":" + String(cfg.bottom, 2) + ",";
+  json += "\"width\":" + String(cfg.width) + ",";
+  json += "\"height\":" + String(cfg.height) + ",";
+  json += "\"x\":" + String(pointer.x) + ",";
+  json += "\"y\":" + String(pointer.y) + ",";
+  json += "\"filter\":{";
+  json += "\"enabled\":" + String(cfg.filter.enabled ? "true" : "false") + ",";
+  json += "\"minCutoff\":" + String(cfg.filter.minCutoff, 3) + ",";
+  json += "\"beta\":" + String(cfg.filter.beta, 3) + ",";
+  json += "\"dCutoff\":" + String(cfg.filter.dCutoff, 3);
+  json += "}}";
+  return json;
+}
+
+// Все параметры указателя одним объектом
+static String mouse_json()
+{
+  MouseSettings settings = settings_snapshot();
+  String json = "{";
+  json += "\"deadzone\":" + String(settings.deadzone, 3) + ",";
+  json += "\"sensitivity\":" + String(settings.sensitivity, 3) + ",";
+  json += "\"sideZone\":" + String(settings.sideZone, 3) + ",";
+  json += "\"sideSwitchThreshold\":" + String(settings.sideSwitchThreshold) + ",";
+  json += "\"previewIntervalMs\":" + String(MOUSE_PREVIEW_INTERVAL_MS) + ",";
+  json += "\"curve\":" + accel_curve_json() + ",";
+  json += "\"filter\":" + filter_json() + ",";
+  json += "\"mount\":" + mount_json() + ",";
+  json += "\"scroll\":" + scroll_json() + ",";
+  json += "\"pointer\":" + pointer_json();
+  json += "}";
+  return json;
+}
+
+void register_mouse_api(AsyncWebServer &server)
+{
+  // Предпросмотр: клиент только слушает, кадры рассылает mouse_control_preview_loop
+  previewSocket.onEvent([](AsyncWebSocket *socket, AsyncWebSocketClient *client, AwsEventType type, void *arg, uint8_t *data, size_t len)
+                        {
+#if DEBUG
+    if (type == WS_EVT_CONNECT)
+      Serial.printf("[MOUSE] Preview client %u connected\n", (unsigned)client->id());
+    else if (type == WS_EVT_DISCONNECT)
+      Serial.printf("[MOUSE] Preview client %u disconnected\n", (unsigned)client->id());
+#endif
+                        });
+  server.addHandler(&previewSocket);
+
+  // API: получить кривую ускорения
+  server.on("/api/mouse/curve", HTTP_GET, [](AsyncWebServerRequest *request)
+            { request->send(200, "application/json", accel_curve_json()); });
+
+  // API: сохранить кривую ускорения. Не переданные параметры остаются прежними
+  // points: "<скорость>:<усиление>;<скорость>:<усиление>..."
+  server.on("/api/mouse/curve", HTTP_POST, [](AsyncWebServerRequest *request)
+            {
+    MouseSettings settings;
+    settings_begin(settings);
+    AccelCurveConfig &curve = settings.curve;
+    read_curve_params(request, curve);
+    if (request->hasParam("points", true))
+    {
+      String points = request->getParam("points", true)->value();
+      curve.pointCount = 0;
+      int start = 0;
+      while (start < (int)points.length() && curve.pointCount < ACCEL_CURVE_MAX_POINTS)
+      {
+        int end = points.indexOf(';', start);
+        if (end == -1)
+          end = points.length();
+        String item = points.substring(start, end);
+        int sep = item.indexOf(':');
+        if (sep != -1)
+        {
+          curve.points[curve.pointCount].velocity = item.substring(0, sep).toFloat();
+          curve.points[curve.pointCount].gain = item.substring(sep + 1).toFloat();
+          curve.pointCount++;
+        }
+        start = end + 1;
+      }
+    }
+
+    if (!settings_commit(settings))
+    {
+      request->send(400, "application/json", "{\"error\":\"Invalid curve\"}");
+      return;
+    }
+    request->send(200, "application/json", accel_curve_json()); });
+
+  // API: параметры фильтра дрожания
+  server.on("/api/mouse/filter", HTTP_GET, [](AsyncWebServerRequest *request)
+            { request->send(200, "application/json", filter_json()); });
+
+  // API: сохранить параметры фильтра. Не переданные параметры остаются прежними
+  server.on("/api/mouse/filter", HTTP_POST, [](AsyncWebServerRequest *request)
+            {
+    MouseSettings settings;
+    settings_begin(settings);
+    OneEuroConfig &filter = settings.filter;
+    if (request->hasParam("enabled", true))
+      filter.enabled = request->getParam("enabled", true)->value().toInt();
+    if (request->hasParam("minCutoff", true))
+      filter.minCutoff = request->getParam("minCutoff", true)->value().toFloat();
+    if (request->hasParam("beta", true))
+      filter.beta = request->getParam("beta", true)->value().toFloat();
+    if (request->hasParam("dCutoff", true))
+      filter.dCutoff = request->getParam("dCutoff", true)->value().toFloat();
+
+    if (!settings_commit(settings))
+    {
+      request->send(400, "application/json", "{\"error\":\"Invalid filter\"}");
+      return;
+    }
+    request->send(200, "application/json", filter_json()); });
+
+  // API: матрица установки датчика
+  server.on("/api/mouse/mount", HTTP_GET, [](AsyncWebServerRequest *request)
+            { request->send(200, "application/json", mount_json()); });
+
+  // API: сохранить матрицу установки. matrix: 9 чисел -1/0/1 по строкам через запятую
+  server.on("/api/mouse/mount", HTTP_POST, [](AsyncWebServerRequest *request)
+            {
+    if (!request->hasParam("matrix", true))
+    {
+      request->send(400, "application/json", "{\"error\":\"Missing matrix\"}");
+      return;
+    }
+    MouseSettings settings;
+    settings_begin(settings);
+    String matrix = request->getParam("matrix", true)->value();
+    int start = 0;
+    for (int i = 0; i < MOUNT_MATRIX_SIZE; i++)
+    {
+      int end = matrix.indexOf(',', start);
+      if (end == -1)
+        end = matrix.length();
+      settings.mount[i] = matrix.substring(start, end).toInt();
+      start = end + 1;
+    }
+
+    if (!settings_commit(settings))
+    {
+      request->send(400, "application/json", "{\"error\":\"Invalid matrix\"}");
+      return;
+    }
+    request->send(200, "application/json", mount_json()); });
+
+  // API: параметры прокрутки наклоном
+  server.on("/api/mouse/scroll", HTTP_GET, [](AsyncWebServerRequest *request)
+            { request->send(200, "application/json", scroll_json()); });
+
+  // API: сохранить параметры прокрутки. Не переданные параметры остаются прежними
+  // layers — маска слоев, на которых наклон всегда прокручивает
+  server.on("/api/mouse/scroll", HTTP_POST, [](AsyncWebServerRequest *request)
+            {
+    MouseSettings settings;
+    settings_begin(settings);
+    ScrollSettings &scroll = settings.scroll;
+    if (request->hasParam("sensitivity", true))
+      scroll.sensitivity = request->getParam("sensitivity", true)->value().toFloat();
+    if (request->hasParam("deadzone", true))
+      scroll.deadzone = request->getParam("deadzone", true)->value().toFloat();
+    if (request->hasParam("invert", true))
+      scroll.invert = request->getParam("invert", true)->value().toInt();
+    if (request->hasParam("layers", true))
+      scroll.layers = request->getParam("layers", true)->value().toInt() & ((1 << MAX_LAYERS) - 1);
+    read_curve_params(request, scroll.curve);
+
+    if (!settings_commit(settings))
+    {
+      request->send(400, "application/json", "{\"error\":\"Invalid scroll settings\"}");
+      return;
+    }
+    request->send(200, "application/json", scroll_json()); });
+
+  // API: состояние записи трассы IMU
+  server.on("/api/mouse/trace", HTTP_GET, [](AsyncWebServerRequest *request)
+            { request->send(200, "application/json", trace_json()); });
+
+  // API: record=1 — начать запись (старая трасса удаляется), record=0 — остановить
+  server.on("/api/mouse/trace", HTTP_POST, [](AsyncWebServerRequest *request)
+            {
+    if (!request->hasParam("record", true))
+    {
+      request->send(400, "application/json", "{\"error\":\"Missing record\"}");
+      return;
+    }
+    bool record = request->getParam("record", true)->value().toInt();
+    if (record && !initialized)
+    {
+      request->send(409, "application/json", "{\"error\":\"IMU not initialized\"}");
+      return;
+    }
+    if (record)
+    {
+      // Прошлая запись еще закрывается или трассу скачивают — новая не начинается поверх
+      uint8_t state = traceState.load();
+      if (state == TRACE_STOPPING || state == TRACE_STOPPED || traceDownload[0] || traceDownload[1])
+      {
+        request->send(409, "application/json", "{\"error\":\"Trace busy\"}");
+        return;
+      }
+      trace_transition(TRACE_IDLE, TRACE_OPENING);
+    }
+    else if (!trace_transition(TRACE_RECORDING, TRACE_STOPPING) && !trace_transition(TRACE_ARMED, TRACE_STOPPING))
+    {
+      trace_transition(TRACE_OPENING, TRACE_STOPPING);
+    }
+    request->send(200, "application/json", trace_json()); });
+
+  // API: скачать трассу (заголовок ImuTraceHeader + сохраненные записи ImuTraceRecord по порядку)
+  server.on("/api/mouse/trace.bin", HTTP_GET, [](AsyncWebServerRequest *request)
+            {
+    if (traceState.load() != TRACE_IDLE)
+    {
+      request->send(409, "application/json", "{\"error\":\"Recording in progress\"}");
+      return;
+    }
+    if (!trace_download_open())
+    {
+      request->send(404, "application/json", "{\"error\":\"No trace\"}");
+      return;
+    }
+    AsyncWebServerResponse *response = request->beginResponse("application/octet-stream", imu_trace_offset(traceDownloadHeader, traceDownloadHeader.count), trace_download_fill);
+    response->addHeader("Content-Disposition", "attachment; filename=\"imu_trace.bin\"");
+    request->onDisconnect(trace_download_close);
+    request->send(response); });
+
+  // API: режим указки — прямоугольник экрана и фильтр
+  server.on("/api/mouse/pointer", HTTP_GET, [](AsyncWebServerRequest *request)
+            { request->send(200, "application/json", pointer_json()); });
+
+  // API: сохранить параметры указки. Не переданные параметры остаются прежними.
+  // active=1/0 включает режим, recenter=1 — текущее направление в центр экрана
+  server.on("/api/mouse/pointer", HTTP_POST, [](AsyncWebServerRequest *request)
+            {
+    MouseSettings settings;
+    settings_begin(settings);
+    AbsolutePointerConfig &cfg = settings.pointer;
+    if (request->hasParam("left", true))
+      cfg.left = request->getParam("left", true)->value().toFloat();
+    if (request->hasParam("top", true))
+      cfg.top = request->getParam("top", true)->value().toFloat();
+    if (request->hasParam("right", true))
+      cfg.right = request->getParam("right", true)->value().toFloat();
+    if (request->hasParam("bottom", true))
+      cfg.bottom = request->getParam("bottom", true)->value().toFloat();
+    if (request->hasParam("width", true))
+      cfg.width = constrain(request->getParam("width", true)->value().toInt(), 0, UINT16_MAX);
+    if (request->hasParam("height", true))
+      cfg.height = constrain(request->getParam("height", true)->value().toInt(), 0, UINT16_MAX);
+    if (request->hasParam("filter", true))
+      cfg.filter.enabled = request->getParam("filter", true)->value().toInt();
+    if (request->hasParam("minCutoff", true))
+      cfg.filter.minCutoff = request->getParam("minCutoff", true)->value().toFloat();
+    if (request->hasParam("beta", true))
+      cfg.filter.beta = request->getParam("beta", true)->value().toFloat();
+
+    if (!memcmp(&settings.pointer, &get_mouse_settings().pointer, sizeof(settings.pointer)))
+    {
+      settings_unlock();
+    }
+    else
+    {
+      if (!settings_commit(settings))
+      {
+        request->send(400, "application/json", "{\"error\":\"Invalid pointer settings\"}");
+        return;
+      }
+      pointerRestartPending = true;
+    }
+    if (request->hasParam("active", true))
+      mouse_control_set_pointer(request->getParam("active", true)->value().toInt());
+    if (request->hasParam("recenter", true))
+      mouse_control_pointer_recenter();
+    request->send(200, "application/json", pointer_json()); });
+
+  // API: все параметры указателя. Регистрируется последним: обработчик "/api/mouse" совпадает и с "/api/mouse/..."
+  server.on("/api/mouse", HTTP_GET, [](AsyncWebServerRequest *request)
+            { request->send(200, "application/json", mouse_json()); });
+
+  // API: сохранить параметры указателя и кривой ускорения. Не переданные параметры остаются прежними
+  server.on("/api/mouse", HTTP_POST, [](AsyncWebServerRequest *request)
+            {
+    MouseSettings settings;
+    settings_begin(settings);
+    if (request->hasParam("deadzone", true))
+      settings.deadzone = request->getParam("deadzone", true)->value().toFloat();
+    if (request->hasParam("sensitivity", true))
+      settings.sensitivity = request->getParam("sensitivity", true)->value().toFloat();
+    if (request->hasParam("sideZone", true))
+      settings.sideZone = request->getParam("sideZone", true)->value().toFloat();
+    if (request->hasParam("sideSwitchThreshold", true))
+      settings.sideSwitchThreshold = constrain(request->getParam("sideSwitchThreshold", true)->value().toInt(), 0, 255);
+    read_curve_params(request, settings.curve);
+
+    if (!settings_commit(settings))
+    {
+      request->send(400, "application/json", "{\"error\":\"Invalid mouse settings\"}");
+      return;
+    }
+    request->send(200, "application/json", mouse_json()); });
+}
@@ -1,15 +1,59 @@
 // mouse_control.h — заголовок для гироскопического управления
 #pragma once
 
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+#include "config_storage.h"
+#include "motion_pipeline.h"
+
 // Инициализация MPU6050 и подготовка к управлению мышью
 void setup_mouse_control();
 
 // Вызов при каждом цикле — обновление движения мыши
 void update_mouse_control();
 
-// Отдельная функция обработки движения на основе углов
-void processMouseMove();
+// Определение стороны и отправка смещения, посчитанного цепочкой IMU (moved — смещение есть).
+// В режиме прокрутки тангаж уходит в колесо, курсор стоит
+void processMouseMove(bool moved, const MouseDelta &delta, uint32_t dtUs);
 
 void mouse_control_enable();
 void mouse_control_disable();
-void mouse_control_toggle();
\ No newline at end of file
+void mouse_control_toggle();
+
+// Прокрутка наклоном: пока включена (или на слоях из настроек) тангаж крутит колесо
+void mouse_control_set_scroll(bool on);
+void mouse_control_toggle_scroll();
+
+// Режим указки: ориентация -> точка экрана (прямоугольник из /api/mouse/pointer), курсор ведется относительными отчетами
+void mouse_control_set_pointer(bool on);
+void mouse_control_toggle_pointer();
+void mouse_control_pointer_recenter();  // текущее направление — центр экрана
+void mouse_control_pointer_calibrate(); // снятие угла: первый вызов — левый верхний, второй — правый нижний
+
+// HID-отчеты мыши: движение и кнопки объединяются и отправляются не чаще HID_REPORT_INTERVAL_US
+void mouse_report_move(int32_t dx, int32_t dy);
+void mouse_report_wheel(int32_t wheel);
+void mouse_report_press(uint8_t buttons);
+void mouse_report_release(uint8_t buttons);
+void mouse_report_click(uint8_t buttons);
+
+// Сохранение уточненной калибровки гироскопа в NVS и снятого угла указки в /mouse.bin (вызов из loop())
+void mouse_control_save_calibration();
+
+// Жесты, распознанные с прошлого вызова: бит (1 << GestureType). Вызов с ядра 1
+uint8_t mouse_control_take_gestures();
+
+// Запись трассы IMU в сегменты /imu_trace0.bin, /imu_trace1.bin и заголовок /imu_trace.hdr (вызов с ядра 1)
+void mouse_control_trace_flush();
+
+// Рассылка обработанных смещений подписчикам /ws/mouse (вызов с ядра 1)
+void mouse_control_preview_loop();
+
+// Состояние IMU для /api/info: время загрузки, калибровка
+String mouse_control_state();
+
+// Смена параметров указателя без остановки обработки (двойной буфер)
+void mouse_control_apply_settings(const MouseSettings &settings);
+
+// API: /api/mouse, /api/mouse/curve, /api/mouse/filter, /api/mouse/mount, /api/mouse/scroll, /api/mouse/pointer, /api/mouse/trace; WebSocket /ws/mouse
+void register_mouse_api(AsyncWebServer &server);
@@ -0,0 +1,192 @@
+// mpu6050_driver.cpp — драйвер MPU6050 поверх I2cBus
+#include "mpu6050_driver.h"
+
+uint8_t mpu6050_begin(Mpu6050 &dev, const I2cBus *bus, uint8_t addr)
+{
+  dev.bus = bus;
+  dev.addr = addr;
+  dev.gyroOffsetX = 0;
+  dev.gyroOffsetY = 0;
+  dev.gyroOffsetZ = 0;
+  dev.samplePeriodUs = 0;
+  dev.fifoOverflows = 0;
+
+  if (!bus->write(addr, MPU6050_PWR_MGMT_1, 0x01)) // выход из сна, тактирование от PLL гироскопа X
+    return 1;
+  if (!bus->write(addr, MPU6050_SMPLRT_DIV, 0x00))
+    return 2;
+  if (!bus->write(addr, MPU6050_CONFIG, 0x00))
+    return 3;
+  if (!bus->write(addr, MPU6050_GYRO_CONFIG, 0x08)) // ±500 град/с
+    return 4;
+  if (!bus->write(addr, MPU6050_ACCEL_CONFIG, 0x00)) // ±2g
+    return 5;
+  return 0;
+}
+
+void mpu6050_parse(const uint8_t *buf, MpuRawSample &raw)
+{
+  raw.accX = (int16_t)(buf[0] << 8 | buf[1]);
+  raw.accY = (int16_t)(buf[2] << 8 | buf[3]);
+  raw.accZ = (int16_t)(buf[4] << 8 | buf[5]);
+  raw.temp = (int16_t)(buf[6] << 8 | buf[7]);
+  raw.gyroX = (int16_t)(buf[8] << 8 | buf[9]);
+  raw.gyroY = (int16_t)(buf[10] << 8 | buf[11]);
+  raw.gyroZ = (int16_t)(buf[12] << 8 | buf[13]);
+}
+
+void mpu6050_scale(const Mpu6050 &dev, const MpuRawSample &raw, ImuSample &out)
+{
+  out.accX = raw.accX / MPU6050_ACC_LSB;
+  out.accY = raw.accY / MPU6050_ACC_LSB;
+  out.accZ = raw.accZ / MPU6050_ACC_LSB;
+  out.temp = raw.temp / 340.0f + 36.53f;
+  out.gyroX = raw.gyroX / MPU6050_GYRO_LSB - dev.gyroOffsetX;
+  out.gyroY = raw.gyroY / MPU6050_GYRO_LSB - dev.gyroOffsetY;
+  out.gyroZ = raw.gyroZ / MPU6050_GYRO_LSB - dev.gyroOffsetZ;
+}
+
+bool mpu6050_read_raw(Mpu6050 &dev, MpuRawSample &raw)
+{
+  uint8_t buf[MPU6050_BURST_LEN];
+  if (!dev.bus->read(dev.addr, MPU6050_ACCEL_XOUT_H, buf, MPU6050_BURST_LEN))
+    return false;
+  mpu6050_parse(buf, raw);
+  return true;
+}
+
+bool mpu6050_read(Mpu6050 &dev, ImuSample &out)
+{
+  MpuRawSample raw;
+  if (!mpu6050_read_raw(dev, raw))
+    return false;
+  mpu6050_scale(dev, raw, out);
+  return true;
+}
+
+bool mpu6050_calc_gyro_offsets(Mpu6050 &dev, uint16_t samples)
+{
+  int32_t sumX = 0, sumY = 0, sumZ = 0;
+  uint16_t count = 0;
+  for (uint16_t i = 0; i < samples; i++)
+  {
+    MpuRawSample raw;
+    if (!mpu6050_read_raw(dev, raw))
+      continue;
+    sumX += raw.gyroX;
+    sumY += raw.gyroY;
+    sumZ += raw.gyroZ;
+    count++;
+  }
+  if (!count)
+    return false;
+  dev.gyroOffsetX = sumX / (count * MPU6050_GYRO_LSB);
+  dev.gyroOffsetY = sumY / (count * MPU6050_GYRO_LSB);
+  dev.gyroOffsetZ = sumZ / (count * MPU6050_GYRO_LSB);
+  return true;
+}
+
+bool mpu6050_fifo_reset(Mpu6050 &dev)
+{
+  if (!dev.bus->write(dev.addr, MPU6050_USER_CTRL, 0x04)) // FIFO_RESET
+    return false;
+  return dev.bus->write(dev.addr, MPU6050_USER_CTRL, 0x40); // FIFO_EN
+}
+
+bool mpu6050_set_sample_rate(Mpu6050 &dev, uint16_t sampleRateHz)
+{
+  if (sampleRateHz < 4)
+    sampleRateHz = 4;
+  if (sampleRateHz > 1000)
+    sampleRateHz = 1000;
+  // DLPF 188 Гц -> внутренняя частота 1 кГц, делитель задает частоту отсчетов
+  uint8_t div = 1000 / sampleRateHz - 1;
+  if (!dev.bus->write(dev.addr, MPU6050_SMPLRT_DIV, div))
+    return false;
+  dev.samplePeriodUs = 1000000UL * (div + 1) / 1000;
+  // Кадры со старым периодом в FIFO испортили бы метки времени
+  return mpu6050_fifo_reset(dev);
+}
+
+bool mpu6050_fifo_begin(Mpu6050 &dev, uint16_t sampleRateHz)
+{
+  if (!dev.bus->write(dev.addr, MPU6050_CONFIG, 0x01))
+    return false;
+  if (!dev.bus->write(dev.addr, MPU6050_FIFO_EN, 0xF8)) // TEMP, XG, YG, ZG, ACCEL
+    return false;
+  if (!dev.bus->write(dev.addr, MPU6050_INT_PIN_CFG, 0x10)) // активный высокий, импульс, сброс любым чтением
+    return false;
+  if (!dev.bus->write(dev.addr, MPU6050_INT_ENABLE, 0x01)) // DATA_RDY
+    return false;
+  return mpu6050_set_sample_rate(dev, sampleRateHz);
+}
+
+uint8_t mpu6050_fifo_drain(Mpu6050 &dev, ImuTimedSample *out, uint8_t maxSamples)
+{
+  uint8_t cnt[2];
+  if (!dev.bus->read(dev.addr, MPU6050_FIFO_COUNTH, cnt, 2))
+    return 0;
+  uint16_t count = cnt[0] << 8 | cnt[1];
+
+  // Переполнение или потеря выравнивания кадров — начинаем заново
+  if (count >= MPU6050_FIFO_SIZE || count % MPU6050_FIFO_FRAME)
+  {
+    dev.fifoOverflows++;
+    mpu6050_fifo_reset(dev);
+    return 0;
+  }
+
+  uint16_t frames = count / MPU6050_FIFO_FRAME;
+  // Если кадров больше, чем влезает — отбрасываем самые старые
+  uint16_t skip = frames > maxSamples ? frames - maxSamples : 0;
+  uint8_t n = 0;
+  uint8_t buf[MPU6050_FIFO_FRAME * MPU6050_FIFO_MAX_BURST];
+  while (frames)
+  {
+    uint8_t burst = frames > MPU6050_FIFO_MAX_BURST ? MPU6050_FIFO_MAX_BURST : frames;
+    if (!dev.bus->read(dev.addr, MPU6050_FIFO_R_W, buf, burst * MPU6050_FIFO_FRAME))
+      return n;
+    for (uint8_t i = 0; i < burst; i++)
+    {
+      if (skip)
+      {
+        skip--;
+        continue;
+      }
+      mpu6050_parse(buf + i * MPU6050_FIFO_FRAME, out[n++].raw);
+    }
+    frames -= burst;
+  }
+  return n;
+}
+
+void imu_timestamper_reset(ImuTimestamper &ts, uint32_t periodUs)
+{
+  ts.periodUs = periodUs;
+  ts.lastUs = 0;
+  ts.hasLast = false;
+}
+
+void imu_timestamper_apply(ImuTimestamper &ts, ImuTimedSample *samples, uint8_t n, uint32_t lastSampleUs)
+{
+  for (uint8_t i = 0; i < n; i++)
+  {
+    uint32_t t = lastSampleUs - (uint32_t)(n - 1 - i) * ts.periodUs;
+    int32_t dt = (int32_t)(t - ts.lastUs);
+    // Отметка прерывания могла задублироваться — сдвигаем кадр на период вперед.
+    // После долгой паузы время сохраняем, а интегрируем за один период
+    if (ts.hasLast && dt <= 0)
+    {
+      dt = ts.periodUs;
+      t = ts.lastUs + dt;
+    }
+    else if (!ts.hasLast || dt > (int32_t)(ts.periodUs * 10))
+    {
+      dt = ts.periodUs;
+    }
+    samples[i].tUs = t;
+    samples[i].dtUs = dt;
+    ts.lastUs = t;
+    ts.hasLast = true;
+  }
+}
@@ -0,0 +1,95 @@
+// mpu6050_driver.h — драйвер MPU6050: чтение accel+temp+gyro одним пакетом из 14 байт
+#pragma once
+
+#include <stdint.h>
+#include "i2c_bus.h"
+#include "imu_filter.h"
+
+#define MPU6050_ADDR 0x68
+
+// === Регистры ===
+#define MPU6050_SMPLRT_DIV 0x19
+#define MPU6050_CONFIG 0x1A
+#define MPU6050_GYRO_CONFIG 0x1B
+#define MPU6050_ACCEL_CONFIG 0x1C
+#define MPU6050_FIFO_EN 0x23
+#define MPU6050_INT_PIN_CFG 0x37
+#define MPU6050_INT_ENABLE 0x38
+#define MPU6050_INT_STATUS 0x3A
+#define MPU6050_ACCEL_XOUT_H 0x3B
+#define MPU6050_USER_CTRL 0x6A
+#define MPU6050_PWR_MGMT_1 0x6B
+#define MPU6050_FIFO_COUNTH 0x72
+#define MPU6050_FIFO_R_W 0x74
+#define MPU6050_WHO_AM_I 0x75
+
+#define MPU6050_BURST_LEN 14       // accel(6) + temp(2) + gyro(6)
+#define MPU6050_GYRO_LSB 65.5f     // LSB на град/с при ±500 град/с
+#define MPU6050_ACC_LSB 16384.0f   // LSB на g при ±2g
+#define MPU6050_CALIB_SAMPLES 500  // число отсчетов для калибровки гироскопа
+
+// === FIFO ===
+#define MPU6050_FIFO_SIZE 1024                    // размер FIFO в байтах
+#define MPU6050_FIFO_FRAME MPU6050_BURST_LEN      // accel+temp+gyro — тот же формат, что и пакетное чтение
+#define MPU6050_FIFO_MAX_BURST 9                  // кадров за одно чтение (буфер Wire — 128 байт)
+
+struct MpuRawSample
+{
+  int16_t accX, accY, accZ;
+  int16_t temp;
+  int16_t gyroX, gyroY, gyroZ;
+};
+
+struct Mpu6050
+{
+  const I2cBus *bus;
+  uint8_t addr;
+  float gyroOffsetX, gyroOffsetY, gyroOffsetZ; // градусы/с
+  uint32_t samplePeriodUs;                     // период отсчетов в режиме FIFO
+  uint32_t fifoOverflows;                      // число сбросов FIFO из-за переполнения
+};
+
+// Отсчет из FIFO с отметкой времени
+struct ImuTimedSample
+{
+  MpuRawSample raw;
+  uint32_t tUs;  // время отсчета (micros)
+  uint32_t dtUs; // время с предыдущего отсчета
+};
+
+// Восстановление времени отсчетов, выбранных из FIFO пачкой
+struct ImuTimestamper
+{
+  uint32_t periodUs;
+  uint32_t lastUs;
+  bool hasLast;
+};
+
+// 0 — успех, иначе код ошибки шины
+uint8_t mpu6050_begin(Mpu6050 &dev, const I2cBus *bus, uint8_t addr = MPU6050_ADDR);
+
+// Разбор пакета из 14 байт (big-endian)
+void mpu6050_parse(const uint8_t *buf, MpuRawSample &raw);
+
+// Перевод в физические единицы с учетом смещений гироскопа
+void mpu6050_scale(const Mpu6050 &dev, const MpuRawSample &raw, ImuSample &out);
+
+bool mpu6050_read_raw(Mpu6050 &dev, MpuRawSample &raw);
+bool mpu6050_read(Mpu6050 &dev, ImuSample &out);
+
+// Усреднение смещений гироскопа (устройство должно быть неподвижно)
+bool mpu6050_calc_gyro_offsets(Mpu6050 &dev, uint16_t samples = MPU6050_CALIB_SAMPLES);
+
+// Включить FIFO (accel+temp+gyro) и прерывание data-ready с заданной частотой отсчетов
+bool mpu6050_fifo_begin(Mpu6050 &dev, uint16_t sampleRateHz);
+bool mpu6050_fifo_reset(Mpu6050 &dev);
+
+// Смена частоты отсчетов на ходу (со сбросом FIFO)
+bool mpu6050_set_sample_rate(Mpu6050 &dev, uint16_t sampleRateHz);
+
+// Выбрать до maxSamples кадров из FIFO. Возвращает число кадров
+uint8_t mpu6050_fifo_drain(Mpu6050 &dev, ImuTimedSample *out, uint8_t maxSamples);
+
+// Расставить время n кадрам: последний кадр получен в lastSampleUs, шаг — periodUs
+void imu_timestamper_reset(ImuTimestamper &ts, uint32_t periodUs);
+void imu_timestamper_apply(ImuTimestamper &ts, ImuTimedSample *samples, uint8_t n, uint32_t lastSampleUs);
@@ -0,0 +1,78 @@
+// one_euro.cpp — фильтр One-Euro (Casiez et al.) в float и Q16.16
+#include "one_euro.h"
+
+#define ONE_EURO_2PI 6.2831853f
+
+void one_euro_reset(OneEuroState &st)
+{
+  st = {};
+}
+
+void one_euro_fixed_config_init(const OneEuroConfig &cfg, OneEuroFixedConfig &out)
+{
+  out.enabled = cfg.enabled;
+  out.minCutoff = q16_from_float(cfg.minCutoff);
+  out.beta = q16_from_float(cfg.beta);
+  out.dCutoff = q16_from_float(cfg.dCutoff);
+}
+
+// α = r / (1 + r), r = 2π·fc·dt
+static inline float alpha_float(float cutoff, float dt)
+{
+  float r = ONE_EURO_2PI * cutoff * dt;
+  return r / (1.0f + r);
+}
+
+// То же в Q16.16 через одно 32-битное деление: α = 1 - 1 / (1 + r)
+static inline q16_t alpha_fixed(q16_t r)
+{
+  if (r <= 0)
+    return 0;
+  uint32_t inv = ((uint32_t)1 << 31) / (uint32_t)(r + Q16_ONE);
+  return Q16_ONE - (q16_t)(inv << 1);
+}
+
+// Фильтруется положение (накопленный путь), а хранится только отставание от него: lag = P - P̂.
+// Выход o = α·(lag + dx), lag += dx - o. Отставание ограничено, весь путь рано или поздно выдается
+void one_euro_float(OneEuroState &st, const OneEuroConfig &cfg, float &dx, float &dy, float speed, uint32_t dtUs)
+{
+  if (!st.primed)
+  {
+    st.speed = speed;
+    st.primed = true;
+  }
+  float dt = dtUs * 1e-6f;
+  st.speed += alpha_float(cfg.dCutoff, dt) * (speed - st.speed);
+  float a = alpha_float(cfg.minCutoff + cfg.beta * st.speed, dt);
+  float ox = a * (st.x + dx);
+  float oy = a * (st.y + dy);
+  st.x += dx - ox;
+  st.y += dy - oy;
+  dx = ox;
+  dy = oy;
+}
+
+void one_euro_fixed(OneEuroState &st, const OneEuroFixedConfig &cfg, q16_t &dx, q16_t &dy, q16_t speed, uint32_t dtUs)
+{
+  if (!st.primed)
+  {
+    st.speedq = speed;
+    st.primed = true;
+  }
+  // 2π·dt и сглаживание скорости зависят только от периода и dCutoff — пересчет при их смене
+  if (dtUs != st.dtUs || cfg.dCutoff != st.dCutoff)
+  {
+    st.dtUs = dtUs;
+    st.dCutoff = cfg.dCutoff;
+    st.k = (q16_t)((uint64_t)dtUs * (uint64_t)(ONE_EURO_2PI * Q16_ONE) / 1000000u);
+    st.alphaD = alpha_fixed(q16_mul(st.k, cfg.dCutoff));
+  }
+  st.speedq += q16_mul(st.alphaD, speed - st.speedq);
+  q16_t a = alpha_fixed(q16_mul(st.k, cfg.minCutoff + q16_mul(cfg.beta, st.speedq)));
+  q16_t ox = q16_mul(a, st.xq + dx);
+  q16_t oy = q16_mul(a, st.yq + dy);
+  st.xq += dx - ox;
+  st.yq += dy - oy;
+  dx = ox;
+  dy = oy;
+}
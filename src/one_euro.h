@@ -0,0 +1,41 @@
+// one_euro.h — адаптивный фильтр One-Euro для смещений курсора: частота среза растет со скоростью
+#pragma once
+
+#include <stdint.h>
+#include "fixed_point.h"
+
+// Параметры фильтра. Скорость — градусы за опорный период 10 мс
+struct OneEuroConfig
+{
+  bool enabled;
+  float minCutoff; // частота среза в покое (Гц): меньше — меньше дрожание
+  float beta;      // прирост частоты среза на единицу скорости (Гц на градус/10 мс): больше — меньше задержка
+  float dCutoff;   // частота среза для оценки скорости (Гц)
+};
+
+// Те же параметры в Q16.16
+struct OneEuroFixedConfig
+{
+  bool enabled;
+  q16_t minCutoff;
+  q16_t beta;
+  q16_t dCutoff;
+};
+
+struct OneEuroState
+{
+  bool primed;
+  float x, y, speed;     // float путь: отставание выхода от входа по осям и сглаженная скорость
+  q16_t xq, yq, speedq;  // Q16.16 путь
+  uint32_t dtUs;         // период и частота, для которых посчитан кеш
+  q16_t dCutoff;
+  q16_t k;               // 2π·dt — кеш
+  q16_t alphaD;          // коэффициент сглаживания скорости — кеш
+};
+
+void one_euro_reset(OneEuroState &st);
+void one_euro_fixed_config_init(const OneEuroConfig &cfg, OneEuroFixedConfig &out);
+
+// Фильтрация смещения за отсчет (dx, dy на месте). speed — модуль скорости до фильтра
+void one_euro_float(OneEuroState &st, const OneEuroConfig &cfg, float &dx, float &dy, float speed, uint32_t dtUs);
+void one_euro_fixed(OneEuroState &st, const OneEuroFixedConfig &cfg, q16_t &dx, q16_t &dy, q16_t speed, uint32_t dtUs);
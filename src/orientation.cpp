@@ -0,0 +1,178 @@
+// orientation.cpp — фильтр Mahony: рыскание и тангаж без связи углов Эйлера при больших наклонах
+#include "orientation.h"
+#include <math.h>
+
+#define DEG_2_RAD 0.017453293f
+#define RAD_2_DEG 57.29578f
+
+static inline float wrap180(float angle)
+{
+  if (angle >= 180.0f)
+    angle -= 360.0f;
+  else if (angle < -180.0f)
+    angle += 360.0f;
+  return angle;
+}
+
+void orientation_reset(OrientationFilter &f, float kp, float ki)
+{
+  f.q0 = 1;
+  f.q1 = f.q2 = f.q3 = 0;
+  f.ix = f.iy = f.iz = 0;
+  f.kp = kp;
+  f.ki = ki;
+  f.primed = false;
+  f.yawRate = 0;
+  f.pitchRate = 0;
+  f.yaw = 0;
+  f.pitch = 0;
+}
+
+// Начальный наклон из акселерометра, рыскание — 0
+static void prime_from_accel(OrientationFilter &f, const ImuSample &s)
+{
+  float roll = atan2f(s.accY, s.accZ);
+  float pitch = atan2f(-s.accX, sqrtf(s.accY * s.accY + s.accZ * s.accZ));
+  float cr = cosf(roll * 0.5f), sr = sinf(roll * 0.5f);
+  float cp = cosf(pitch * 0.5f), sp = sinf(pitch * 0.5f);
+  f.q0 = cr * cp;
+  f.q1 = sr * cp;
+  f.q2 = cr * sp;
+  f.q3 = -sr * sp;
+  f.primed = true;
+}
+
+void orientation_update(OrientationFilter &f, const ImuSample &s, float dt)
+{
+  float accNorm = s.accX * s.accX + s.accY * s.accY + s.accZ * s.accZ;
+  if (!f.primed)
+  {
+    if (accNorm > 0)
+      prime_from_accel(f, s);
+    return;
+  }
+
+  float gx = s.gyroX * DEG_2_RAD;
+  float gy = s.gyroY * DEG_2_RAD;
+  float gz = s.gyroZ * DEG_2_RAD;
+  float q0 = f.q0, q1 = f.q1, q2 = f.q2, q3 = f.q3;
+
+  // Вертикаль в осях устройства — третья строка матрицы поворота
+  float vx = 2.0f * (q1 * q3 - q0 * q2);
+  float vy = 2.0f * (q0 * q1 + q2 * q3);
+  float vz = q0 * q0 - q1 * q1 - q2 * q2 + q3 * q3;
+
+  // Коррекция только при ускорении, близком к 1g: рывки рукой не тянут горизонт
+  float ex = 0, ey = 0, ez = 0;
+  if (accNorm > 0.5f * 0.5f && accNorm < 1.5f * 1.5f)
+  {
+    float r = 1.0f / sqrtf(accNorm);
+    float ax = s.accX * r, ay = s.accY * r, az = s.accZ * r;
+    ex = ay * vz - az * vy;
+    ey = az * vx - ax * vz;
+    ez = ax * vy - ay * vx;
+    if (f.ki > 0)
+    {
+      f.ix += f.ki * ex * dt;
+      f.iy += f.ki * ey * dt;
+      f.iz += f.ki * ez * dt;
+    }
+  }
+
+  // Скорость поворота без пропорциональной коррекции — в выход, с коррекцией — в интегрирование
+  float wx = gx + f.ix, wy = gy + f.iy, wz = gz + f.iz;
+  float cx = wx + f.kp * ex, cy = wy + f.kp * ey, cz = wz + f.kp * ez;
+
+  float h = 0.5f * dt;
+  f.q0 = q0 + (-q1 * cx - q2 * cy - q3 * cz) * h;
+  f.q1 = q1 + (q0 * cx + q2 * cz - q3 * cy) * h;
+  f.q2 = q2 + (q0 * cy - q1 * cz + q3 * cx) * h;
+  f.q3 = q3 + (q0 * cz + q1 * cy - q2 * cx) * h;
+  float n = 1.0f / sqrtf(f.q0 * f.q0 + f.q1 * f.q1 + f.q2 * f.q2 + f.q3 * f.q3);
+  f.q0 *= n;
+  f.q1 *= n;
+  f.q2 *= n;
+  f.q3 *= n;
+
+  // Рыскание — проекция скорости на вертикаль
+  f.yawRate = (vx * wx + vy * wy + vz * wz) * RAD_2_DEG;
+
+  // Тангаж — проекция на горизонтальную ось, перпендикулярную направлению пульта (Y устройства)
+  float fx = 2.0f * (q1 * q2 - q0 * q3);
+  float fy = 1.0f - 2.0f * (q1 * q1 + q3 * q3);
+  float fh = sqrtf(fx * fx + fy * fy);
+  if (fh > 0.1f) // пульт направлен почти вертикально — тангаж не определен, держим прежний
+  {
+    float lx = fy / fh, ly = -fx / fh;
+    // Первые две строки матрицы поворота: скорость в осях мира
+    float worldX = (1.0f - 2.0f * (q2 * q2 + q3 * q3)) * wx + fx * wy + 2.0f * (q1 * q3 + q0 * q2) * wz;
+    float worldY = 2.0f * (q1 * q2 + q0 * q3) * wx + fy * wy + 2.0f * (q2 * q3 - q0 * q1) * wz;
+    f.pitchRate = (lx * worldX + ly * worldY) * RAD_2_DEG;
+  }
+
+  f.yaw = wrap180(f.yaw + f.yawRate * dt);
+  f.pitch = wrap180(f.pitch + f.pitchRate * dt);
+}
+
+void mount_matrix_default(int8_t m[MOUNT_MATRIX_SIZE], int16_t rotation, bool flip)
+{
+  // Поворот вокруг Z
+  int8_t c = 1, s = 0;
+  switch (rotation)
+  {
+  case 90:
+    c = 0;
+    s = 1;
+    break;
+  case 180:
+    c = -1;
+    break;
+  case 270:
+    c = 0;
+    s = -1;
+    break;
+  }
+  int8_t f = flip ? -1 : 1; // 180° вокруг Y: X и Z меняют знак
+  m[0] = f * c;
+  m[1] = f * -s;
+  m[2] = 0;
+  m[3] = s;
+  m[4] = c;
+  m[5] = 0;
+  m[6] = 0;
+  m[7] = 0;
+  m[8] = f;
+}
+
+bool mount_matrix_valid(const int8_t m[MOUNT_MATRIX_SIZE])
+{
+  for (int i = 0; i < 3; i++)
+  {
+    int rowCount = 0, colCount = 0;
+    for (int j = 0; j < 3; j++)
+    {
+      if (m[i * 3 + j] < -1 || m[i * 3 + j] > 1)
+        return false;
+      rowCount += m[i * 3 + j] != 0;
+      colCount += m[j * 3 + i] != 0;
+    }
+    if (rowCount != 1 || colCount != 1)
+      return false;
+  }
+  int det = m[0] * (m[4] * m[8] - m[5] * m[7]) - m[1] * (m[3] * m[8] - m[5] * m[6]) + m[2] * (m[3] * m[7] - m[4] * m[6]);
+  return det == 1;
+}
+
+static inline void mount_vector(const int8_t m[MOUNT_MATRIX_SIZE], float &x, float &y, float &z)
+{
+  float sx = x, sy = y, sz = z;
+  x = m[0] * sx + m[1] * sy + m[2] * sz;
+  y = m[3] * sx + m[4] * sy + m[5] * sz;
+  z = m[6] * sx + m[7] * sy + m[8] * sz;
+}
+
+void mount_apply(const int8_t m[MOUNT_MATRIX_SIZE], ImuSample &s)
+{
+  mount_vector(m, s.accX, s.accY, s.accZ);
+  mount_vector(m, s.gyroX, s.gyroY, s.gyroZ);
+}
@@ -0,0 +1,34 @@
+// orientation.h — ориентация пульта кватернионом (фильтр Mahony) и матрица установки датчика
+#pragma once
+
+#include <stdint.h>
+#include "imu_filter.h"
+
+// Оси устройства после матрицы установки: X — вправо, Y — вперед (куда направлен пульт), Z — вверх со стороны мыши
+#define MOUNT_MATRIX_SIZE 9
+
+struct OrientationFilter
+{
+  float q0, q1, q2, q3;    // кватернион устройство -> мир (Z мира — вверх)
+  float ix, iy, iz;        // интегральная поправка гироскопа (рад/с)
+  float kp;                // вес коррекции по акселерометру
+  float ki;                // вес интегральной коррекции (остаточное смещение гироскопа)
+  bool primed;             // первый отсчет задает наклон по акселерометру
+  float yawRate;           // поворот вокруг вертикали (град/с), влево — плюс
+  float pitchRate;         // поворот вокруг горизонтальной поперечной оси (град/с), вверх — плюс
+  float yaw;               // накопленные углы для motion_pipeline, [-180, 180) градусов
+  float pitch;
+};
+
+void orientation_reset(OrientationFilter &f, float kp, float ki);
+
+// dt — время с предыдущего отсчета в секундах. Отсчет — уже в осях устройства
+void orientation_update(OrientationFilter &f, const ImuSample &s, float dt);
+
+// === Матрица установки: целая 3x3 по строкам, элементы -1/0/1 ===
+// Единичная матрица, повернутая на rotation градусов вокруг Z и, если flip, перевернутая (180° вокруг Y)
+void mount_matrix_default(int8_t m[MOUNT_MATRIX_SIZE], int16_t rotation, bool flip);
+// Допустимы только повороты: ровно один ненулевой элемент в строке и столбце, определитель +1
+bool mount_matrix_valid(const int8_t m[MOUNT_MATRIX_SIZE]);
+// Перевод отсчета из осей датчика в оси устройства (ускорение и гироскоп)
+void mount_apply(const int8_t m[MOUNT_MATRIX_SIZE], ImuSample &s);
@@ -0,0 +1,101 @@
+// period_scheduler.cpp — решения планировщика без привязки к FreeRTOS (проверяются с виртуальными часами)
+#include "period_scheduler.h"
+#include <string.h>
+
+const uint32_t sched_hist_limits_us[SCHED_HIST_BUCKETS - 1] = {50, 100, 200, 500, 1000, 2000, 5000};
+
+void sched_init(PeriodScheduler &s, const char *name)
+{
+  memset(&s, 0, sizeof(s));
+  s.name = name;
+}
+
+int8_t sched_add(PeriodScheduler &s, const char *name, SchedJobFn fn, uint32_t periodUs)
+{
+  if (s.count >= SCHED_MAX_JOBS || !fn || !periodUs)
+    return -1;
+  SchedJob &j = s.jobs[s.count];
+  memset(&j, 0, sizeof(j));
+  j.name = name;
+  j.fn = fn;
+  j.periodUs = periodUs;
+  return s.count++;
+}
+
+void sched_start(PeriodScheduler &s, uint32_t nowUs)
+{
+  for (uint8_t i = 0; i < s.count; i++)
+    s.jobs[i].releaseUs = nowUs;
+  sched_reset_stats(s, nowUs);
+}
+
+void sched_reset_stats(PeriodScheduler &s, uint32_t nowUs)
+{
+  for (uint8_t i = 0; i < s.count; i++)
+  {
+    SchedJob &j = s.jobs[i];
+    j.runs = 0;
+    j.misses = 0;
+    j.maxLateUs = 0;
+    j.maxRunUs = 0;
+    j.totalRunUs = 0;
+    memset(j.hist, 0, sizeof(j.hist));
+  }
+  s.startUs = nowUs;
+}
+
+static void record_run(SchedJob &j, uint32_t runUs)
+{
+  j.runs++;
+  j.totalRunUs += runUs;
+  if (runUs > j.maxRunUs)
+    j.maxRunUs = runUs;
+  uint8_t b = 0;
+  while (b < SCHED_HIST_BUCKETS - 1 && runUs >= sched_hist_limits_us[b])
+    b++;
+  j.hist[b]++;
+}
+
+uint32_t sched_run_due(PeriodScheduler &s, SchedClockFn clock)
+{
+  uint32_t now = clock();
+  if (s.resetPending)
+  {
+    sched_reset_stats(s, now);
+    s.resetPending = false;
+  }
+  for (uint8_t i = 0; i < s.count; i++)
+  {
+    SchedJob &j = s.jobs[i];
+    int32_t late = (int32_t)(now - j.releaseUs);
+    if (late < 0)
+      continue;
+    if ((uint32_t)late > j.maxLateUs)
+      j.maxLateUs = late;
+    // Старт после конца периода — период пропущен; сетка переносится на текущий период без догоняющих запусков
+    if ((uint32_t)late >= j.periodUs)
+    {
+      uint32_t skipped = (uint32_t)late / j.periodUs;
+      j.misses += skipped;
+      j.releaseUs += skipped * j.periodUs;
+    }
+    j.releaseUs += j.periodUs;
+
+    uint32_t t0 = clock();
+    j.fn();
+    now = clock();
+    record_run(j, now - t0);
+  }
+
+  // Время до ближайшего начала периода
+  uint32_t wait = UINT32_MAX;
+  for (uint8_t i = 0; i < s.count; i++)
+  {
+    int32_t left = (int32_t)(s.jobs[i].releaseUs - now);
+    if (left <= 0)
+      return 0;
+    if ((uint32_t)left < wait)
+      wait = left;
+  }
+  return s.count ? wait : 0;
+}
@@ -0,0 +1,50 @@
+// period_scheduler.h — периодические задачи с фиксированной сеткой времени, учетом пропусков и гистограммой времени работы
+#pragma once
+
+#include <stdint.h>
+
+#define SCHED_MAX_JOBS 8
+#define SCHED_HIST_BUCKETS 8
+
+// Верхние границы корзин гистограммы времени работы (мкс); последняя корзина — все, что дольше
+extern const uint32_t sched_hist_limits_us[SCHED_HIST_BUCKETS - 1];
+
+typedef void (*SchedJobFn)();
+typedef uint32_t (*SchedClockFn)(); // текущее время в мкс (micros() на устройстве, виртуальные часы в тестах)
+
+struct SchedJob
+{
+  const char *name;
+  SchedJobFn fn;
+  uint32_t periodUs;
+  uint32_t releaseUs; // начало текущего периода: задача должна стартовать не раньше и до releaseUs + periodUs
+
+  // Статистика
+  uint32_t runs;
+  uint32_t misses;     // пропущенных периодов: старт позже конца своего периода
+  uint32_t maxLateUs;  // наибольшая задержка старта от начала периода
+  uint32_t maxRunUs;   // наибольшее время работы
+  uint64_t totalRunUs; // суммарное время работы (для загрузки)
+  uint32_t hist[SCHED_HIST_BUCKETS];
+};
+
+struct PeriodScheduler
+{
+  const char *name;
+  SchedJob jobs[SCHED_MAX_JOBS];
+  uint8_t count;
+  uint32_t startUs; // время sched_start: основа для загрузки
+  volatile bool resetPending; // сброс статистики из другого потока: выполняется в начале sched_run_due
+};
+
+void sched_init(PeriodScheduler &s, const char *name);
+// Задачи выполняются в порядке добавления (раньше добавлена — выше приоритет). -1, если мест нет
+int8_t sched_add(PeriodScheduler &s, const char *name, SchedJobFn fn, uint32_t periodUs);
+// Все задачи готовы сразу; дальше — по сетке от nowUs
+void sched_start(PeriodScheduler &s, uint32_t nowUs);
+void sched_reset_stats(PeriodScheduler &s, uint32_t nowUs);
+
+// Выполнение всех задач, чей период начался. Сетка не сдвигается от времени работы;
+// пропущенные периоды не догоняются пачкой, а считаются в misses.
+// Возвращает время до начала следующего периода (мкс) — сколько можно спать
+uint32_t sched_run_due(PeriodScheduler &s, SchedClockFn clock);
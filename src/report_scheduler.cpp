@@ -0,0 +1,138 @@
+// report_scheduler.cpp — объединение движения и кнопок в отчеты с фиксированным интервалом
+#include "report_scheduler.h"
+#include "motion_pipeline.h"
+#include "scroll.h"
+
+void report_scheduler_init(ReportScheduler &s, uint32_t intervalUs, uint8_t backlogReports)
+{
+  s = {};
+  s.intervalUs = intervalUs;
+  s.backlogMax = (int32_t)backlogReports * HID_DELTA_MAX;
+}
+
+void report_scheduler_set_interval(ReportScheduler &s, uint32_t intervalUs)
+{
+  s.intervalUs = intervalUs;
+  s.started = false; // новая фаза с ближайшего опроса
+}
+
+// Ограничение накопленного движения с сохранением направления
+static void limit_backlog(ReportScheduler &s)
+{
+  int32_t ax = s.pendingX < 0 ? -s.pendingX : s.pendingX;
+  int32_t ay = s.pendingY < 0 ? -s.pendingY : s.pendingY;
+  int32_t maxAbs = ax > ay ? ax : ay;
+  if (maxAbs <= s.backlogMax)
+    return;
+  s.pendingX = (int32_t)((int64_t)s.pendingX * s.backlogMax / maxAbs);
+  s.pendingY = (int32_t)((int64_t)s.pendingY * s.backlogMax / maxAbs);
+  s.clippedMotion++;
+}
+
+void report_scheduler_add_motion(ReportScheduler &s, int32_t dx, int32_t dy)
+{
+  if (dx == 0 && dy == 0)
+    return;
+  if (s.pendingX || s.pendingY)
+    s.mergedEvents++;
+  s.motionEvents++;
+  s.pendingX += dx;
+  s.pendingY += dy;
+  limit_backlog(s);
+}
+
+void report_scheduler_add_wheel(ReportScheduler &s, int32_t wheel)
+{
+  if (wheel == 0)
+    return;
+  if (s.pendingWheel)
+    s.mergedEvents++;
+  s.motionEvents++;
+  s.pendingWheel += wheel;
+  if (s.pendingWheel > s.backlogMax || s.pendingWheel < -s.backlogMax)
+  {
+    s.pendingWheel = s.pendingWheel > 0 ? s.backlogMax : -s.backlogMax;
+    s.clippedMotion++;
+  }
+}
+
+void report_scheduler_press(ReportScheduler &s, uint8_t mask)
+{
+  s.buttons |= mask;
+  s.deferredRelease &= ~mask;
+}
+
+void report_scheduler_release(ReportScheduler &s, uint8_t mask)
+{
+  // Нажатие еще не ушло хосту — отпускание откладываем, иначе клик потеряется
+  uint8_t unsent = mask & s.buttons & ~s.sentButtons;
+  s.deferredRelease |= unsent;
+  s.buttons &= ~(mask & ~unsent);
+}
+
+bool report_scheduler_pending(const ReportScheduler &s)
+{
+  return s.pendingX || s.pendingY || s.pendingWheel || s.buttons != s.sentButtons || s.deferredRelease;
+}
+
+// Хост отключен: он забыл нажатые кнопки, а накопленное движение и клики к подключению устареют
+static void drop_disconnected(ReportScheduler &s)
+{
+  if (s.pendingX || s.pendingY || s.pendingWheel || s.deferredRelease)
+    s.disconnects++;
+  s.pendingX = 0;
+  s.pendingY = 0;
+  s.pendingWheel = 0;
+  s.buttons &= ~s.deferredRelease;
+  s.deferredRelease = 0;
+  s.sentButtons = 0;
+  s.started = false; // после подключения первый отчет — сразу
+}
+
+bool report_scheduler_poll(ReportScheduler &s, uint32_t nowUs, ReportLink link, HidMouseReport &out)
+{
+  if (link == REPORT_LINK_DISCONNECTED)
+  {
+    drop_disconnected(s);
+    return false;
+  }
+  if (!report_scheduler_pending(s))
+    return false;
+  if (s.started && (int32_t)(nowUs - s.nextUs) < 0)
+    return false;
+  if (link == REPORT_LINK_BUSY)
+  {
+    s.congestedPolls++;
+    return false;
+  }
+
+  // Кнопки: если нажатие уже отправлено, применяем отложенное отпускание
+  if (s.buttons == s.sentButtons && s.deferredRelease)
+  {
+    s.buttons &= ~s.deferredRelease;
+    s.deferredRelease = 0;
+  }
+  out.buttons = s.buttons;
+  out.x = 0;
+  out.y = 0;
+  int32_t px = s.pendingX, py = s.pendingY;
+  motion_take_report(px, py, out.x, out.y);
+  s.pendingX = px;
+  s.pendingY = py;
+  int32_t wheel = s.pendingWheel;
+  if (wheel > HID_WHEEL_MAX)
+    wheel = HID_WHEEL_MAX;
+  else if (wheel < -HID_WHEEL_MAX)
+    wheel = -HID_WHEEL_MAX;
+  out.wheel = (int8_t)wheel;
+  s.pendingWheel -= wheel;
+  s.sentButtons = s.buttons;
+
+  // Сетка интервалов сохраняет фазу; после простоя начинаем новую с текущего момента
+  if (!s.started || (int32_t)(nowUs - s.nextUs) >= (int32_t)s.intervalUs)
+    s.nextUs = nowUs;
+  s.nextUs += s.intervalUs;
+  s.started = true;
+  s.reports++;
+  return true;
+}
@@ -0,0 +1,60 @@
+// report_scheduler.h — планировщик HID-отчетов мыши: не больше одного отчета за интервал, движение суммируется
+#pragma once
+
+#include <stdint.h>
+
+// Один отчет мыши: кнопки + смещение + колесо
+struct HidMouseReport
+{
+  uint8_t buttons;
+  int8_t x;
+  int8_t y;
+  int8_t wheel;
+};
+
+// Состояние канала к хосту при опросе
+enum ReportLink : uint8_t
+{
+  REPORT_LINK_DISCONNECTED, // хоста нет: накопленное устарело и сбрасывается
+  REPORT_LINK_BUSY,         // хост подключен, канал занят: движение сливается и ждет
+  REPORT_LINK_READY
+};
+
+struct ReportScheduler
+{
+  uint32_t intervalUs;     // минимальный интервал между отчетами
+  uint32_t nextUs;         // время следующего разрешенного отчета
+  bool started;
+  int32_t pendingX;        // движение, накопленное с прошлого отчета
+  int32_t pendingY;
+  int32_t pendingWheel;    // щелчки колеса, накопленные с прошлого отчета
+  int32_t backlogMax;      // предел накопленного движения (отчеты по 127), лишнее сжимается с сохранением направления
+  uint8_t buttons;         // текущее состояние кнопок
+  uint8_t sentButtons;     // состояние, отправленное хосту
+  uint8_t deferredRelease; // отпускания кнопок, нажатых в том же интервале (уйдут следующим отчетом)
+
+  // Статистика
+  uint32_t reports;        // отправлено отчетов
+  uint32_t motionEvents;   // добавлено смещений
+  uint32_t mergedEvents;   // смещений, слитых в уже ожидающий отчет
+  uint32_t congestedPolls; // опросов, пропущенных из-за занятого канала
+  uint32_t clippedMotion;  // сжатий накопленного движения
+  uint32_t disconnects;    // сбросов накопленного из-за отключения хоста
+};
+
+void report_scheduler_init(ReportScheduler &s, uint32_t intervalUs, uint8_t backlogReports);
+void report_scheduler_set_interval(ReportScheduler &s, uint32_t intervalUs);
+
+void report_scheduler_add_motion(ReportScheduler &s, int32_t dx, int32_t dy);
+// Щелчки колеса: больше 127 за интервал — уходят следующими отчетами
+void report_scheduler_add_wheel(ReportScheduler &s, int32_t wheel);
+void report_scheduler_press(ReportScheduler &s, uint8_t mask);
+void report_scheduler_release(ReportScheduler &s, uint8_t mask);
+
+// Есть что отправлять
+bool report_scheduler_pending(const ReportScheduler &s);
+
+// Опрос с периодом не больше интервала. Возвращает true и отчет, если пора отправлять.
+// Без хоста движение и колесо сбрасываются, клики отбрасываются, а удерживаемые кнопки после подключения
+// отправляются заново — хост не получит ни скачка курсора, ни устаревшего клика
+bool report_scheduler_poll(ReportScheduler &s, uint32_t nowUs, ReportLink link, HidMouseReport &out);
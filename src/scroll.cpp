@@ -0,0 +1,63 @@
+// scroll.cpp — прокрутка наклоном: скорость тангажа, кривая ускорения, дробный остаток
+#include "scroll.h"
+#include "motion_pipeline.h"
+#include <math.h>
+
+bool scroll_settings_sanitize(ScrollSettings &settings)
+{
+  if (!accel_curve_sanitize(settings.curve))
+    return false;
+  if (!(settings.sensitivity > 0 && settings.sensitivity <= 10))
+    return false;
+  if (!(settings.deadzone >= 0 && settings.deadzone <= 5))
+    return false;
+  settings.invert = settings.invert ? 1 : 0;
+  return true;
+}
+
+void scroll_config_build(const ScrollSettings &settings, ScrollConfig &cfg)
+{
+  cfg.deadzone = settings.deadzone;
+  cfg.invert = settings.invert;
+  accel_curve_build_lut(settings.curve, settings.sensitivity, cfg.gain);
+}
+
+void scroll_state_reset(ScrollState &state)
+{
+  state.primed = false;
+  state.lastAngle = 0;
+  state.rem = 0;
+}
+
+bool scroll_process(ScrollState &state, const ScrollConfig &cfg, float angle, uint32_t dtUs, int32_t &wheel)
+{
+  if (!state.primed)
+  {
+    state.primed = true;
+    state.lastAngle = angle;
+    return false;
+  }
+  float d = angle - state.lastAngle;
+  state.lastAngle = angle;
+  // Углы свернуты в [-180, 180)
+  if (d >= 180.0f)
+    d -= 360.0f;
+  else if (d < -180.0f)
+    d += 360.0f;
+
+  // Скорость приводим к опорному периоду, как у курсора
+  float v = fabsf(d) * (dtUs ? (float)MOTION_REF_PERIOD_US / dtUs : 1.0f);
+  if (v < cfg.deadzone)
+    return false;
+  int index = (int)(v * (1.0f / ACCEL_LUT_STEP));
+  float gain = cfg.gain[index < ACCEL_LUT_SIZE ? index : ACCEL_LUT_SIZE - 1];
+
+  // Нос вверх уменьшает angle — колесо вверх (положительное)
+  float f = (cfg.invert ? d : -d) * gain + state.rem;
+  int32_t detents = (int32_t)f;
+  state.rem = f - detents;
+  if (detents == 0)
+    return false;
+  wheel = detents;
+  return true;
+}
@@ -0,0 +1,43 @@
+// scroll.h — прокрутка наклоном: тангаж превращается в щелчки колеса с дробным накоплением
+#pragma once
+
+#include <stdint.h>
+#include "accel_curve.h"
+
+// Максимальная прокрутка в одном HID-отчете (колесо — 8 бит со знаком)
+#define HID_WHEEL_MAX 127
+
+// Параметры прокрутки. Хранятся в /mouse.bin
+struct ScrollSettings
+{
+  AccelCurveConfig curve; // своя кривая ускорения: медленный наклон — по строке, быстрый — страницами
+  float sensitivity;      // щелчков колеса на градус наклона при усилении 1
+  float deadzone;         // мертвая зона (градусы за 10 мс)
+  uint8_t invert;         // 1 - наклон вверх прокручивает вниз
+  uint8_t layers;         // бит на слой: на этих слоях наклон всегда прокручивает
+};
+
+// Рабочие параметры с таблицей усиления
+struct ScrollConfig
+{
+  float deadzone;
+  bool invert;
+  float gain[ACCEL_LUT_SIZE]; // sensitivity * curve(v), заполняется scroll_config_build
+};
+
+struct ScrollState
+{
+  bool primed;     // последний угол известен
+  float lastAngle; // тангаж прошлого отсчета (градусы)
+  float rem;       // дробный остаток щелчков, переносится в следующий отсчет
+};
+
+bool scroll_settings_sanitize(ScrollSettings &settings);
+void scroll_config_build(const ScrollSettings &settings, ScrollConfig &cfg);
+
+// Вход в режим прокрутки: отсчет идет от текущего угла, остаток сброшен
+void scroll_state_reset(ScrollState &state);
+
+// Обработка отсчета тангажа. angle растет при наклоне носа вниз (как смещение курсора по Y).
+// Наклон вверх дает положительное колесо (прокрутка вверх). Возвращает true, если набрался целый щелчок
+bool scroll_process(ScrollState &state, const ScrollConfig &cfg, float angle, uint32_t dtUs, int32_t &wheel);
@@ -8,6 +8,7 @@ static bool backlightOffDone = false;
 static bool statusLedOffDone = false;
 static bool sleepEntered = false;
 static bool sleepEnabled = true; // если false — отключаем sleep (например, при питании от сети)
+static volatile bool motionActive = false; // пульт движется (детектор покоя IMU, ядро 0)
 
 static byte wakePinState = 0;
 
@@ -50,9 +51,14 @@ void setSleepEnabled(bool enabled)
   }
 }
 
+void sleepManagerSetMotionActive(bool active)
+{
+  motionActive = active;
+}
+
 void sleepManagerLoop()
 {
-  if (!sleepEnabled)
+  if (!sleepEnabled || motionActive)
   {
     resetSleepTimer();
     return;
@@ -26,4 +26,10 @@ void sleepManagerLoop();
  */
 void setSleepEnabled(bool enabled);
 
+/**
+ * @brief Состояние движения от детектора покоя IMU: пока пульт в руке, таймеры сна не идут.
+ * @param active true — пульт движется, false — лежит неподвижно.
+ */
+void sleepManagerSetMotionActive(bool active);
+
 #endif
@@ -0,0 +1,74 @@
+// spsc_queue.h — кольцевая очередь без блокировок: один писатель и один читатель (обычно на разных ядрах)
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+
+// Индексы растут без ограничения и переполняются естественно; размер — степень двойки, слот = индекс & (N - 1).
+// Каждая сторона помнит последний увиденный индекс другой стороны и перечитывает его (с барьером) только когда
+// по старому значению очередь выглядит полной или пустой
+template <typename T, uint32_t N>
+struct SpscQueue
+{
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscQueue: N must be a power of two");
+
+  T items[N];
+  std::atomic<uint32_t> head; // следующий слот записи — меняет только писатель
+  std::atomic<uint32_t> tail; // следующий слот чтения — меняет только читатель
+  uint32_t tailSeen;          // копия tail у писателя
+  uint32_t headSeen;          // копия head у читателя
+  uint32_t dropped;           // отказов из-за переполнения — меняет только писатель
+};
+
+// Сброс. Только пока ни писатель, ни читатель не работают с очередью
+template <typename T, uint32_t N>
+inline void spsc_reset(SpscQueue<T, N> &q)
+{
+  q.head.store(0, std::memory_order_relaxed);
+  q.tail.store(0, std::memory_order_relaxed);
+  q.tailSeen = 0;
+  q.headSeen = 0;
+  q.dropped = 0;
+}
+
+// Писатель. false — очередь полна, элемент не записан (счетчик dropped)
+template <typename T, uint32_t N>
+inline bool spsc_push(SpscQueue<T, N> &q, const T &item)
+{
+  uint32_t head = q.head.load(std::memory_order_relaxed);
+  if (head - q.tailSeen >= N)
+  {
+    q.tailSeen = q.tail.load(std::memory_order_acquire); // слот читатель освободил после чтения
+    if (head - q.tailSeen >= N)
+    {
+      q.dropped++;
+      return false;
+    }
+  }
+  q.items[head & (N - 1)] = item;
+  q.head.store(head + 1, std::memory_order_release); // элемент виден читателю раньше нового head
+  return true;
+}
+
+// Читатель. false — очередь пуста
+template <typename T, uint32_t N>
+inline bool spsc_pop(SpscQueue<T, N> &q, T &item)
+{
+  uint32_t tail = q.tail.load(std::memory_order_relaxed);
+  if (tail == q.headSeen)
+  {
+    q.headSeen = q.head.load(std::memory_order_acquire);
+    if (tail == q.headSeen)
+      return false;
+  }
+  item = q.items[tail & (N - 1)];
+  q.tail.store(tail + 1, std::memory_order_release); // слот освобождается только после чтения
+  return true;
+}
+
+// Число элементов — приблизительно, если вызывается не писателем и не читателем
+template <typename T, uint32_t N>
+inline uint32_t spsc_size(const SpscQueue<T, N> &q)
+{
+  return q.head.load(std::memory_order_acquire) - q.tail.load(std::memory_order_acquire);
+}
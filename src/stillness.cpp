@@ -0,0 +1,64 @@
+// stillness.cpp — детектор покоя: выход из покоя сразу, вход — после enterUs тишины
+#include "stillness.h"
+#include <math.h>
+
+// Порог выхода из покоя выше порога входа — без дребезга на границе
+#define STILLNESS_HYSTERESIS 2.0f
+
+void stillness_init(StillnessDetector &d, const StillnessConfig &cfg)
+{
+  d = {};
+  d.cfg = cfg;
+}
+
+bool stillness_update(StillnessDetector &d, const ImuSample &s, uint32_t dtUs)
+{
+  float acc = sqrtf(s.accX * s.accX + s.accY * s.accY + s.accZ * s.accZ);
+  float gyro2 = s.gyroX * s.gyroX + s.gyroY * s.gyroY + s.gyroZ * s.gyroZ;
+  if (!d.primed)
+  {
+    d.accMean = acc;
+    d.accVar = 0;
+    d.gyroEnergy = gyro2;
+    d.primed = true;
+    return false;
+  }
+
+  // Экспоненциальные оценки с постоянной времени windowUs: вес не зависит от частоты отсчетов
+  float a = (float)dtUs / (d.cfg.windowUs + dtUs);
+  float delta = acc - d.accMean;
+  d.accMean += a * delta;
+  d.accVar = (1 - a) * (d.accVar + a * delta * delta);
+  d.gyroEnergy += a * (gyro2 - d.gyroEnergy);
+
+  float gyroThreshold2 = d.cfg.gyroRms * d.cfg.gyroRms;
+  if (d.still)
+  {
+    // Один резкий отсчет выводит из покоя без ожидания усреднения
+    float h = STILLNESS_HYSTERESIS;
+    if (d.accVar > d.cfg.accVar * h * h || d.gyroEnergy > gyroThreshold2 * h * h || gyro2 > gyroThreshold2 * h * h * 4)
+    {
+      d.still = false;
+      d.quietUs = 0;
+      d.transitions++;
+      return true;
+    }
+    return false;
+  }
+
+  if (d.accVar < d.cfg.accVar && d.gyroEnergy < gyroThreshold2)
+  {
+    d.quietUs += dtUs;
+    if (d.quietUs >= d.cfg.enterUs)
+    {
+      d.still = true;
+      d.transitions++;
+      return true;
+    }
+  }
+  else
+  {
+    d.quietUs = 0;
+  }
+  return false;
+}
@@ -0,0 +1,30 @@
+// stillness.h — детектор покоя по дисперсии акселерометра и энергии гироскопа
+#pragma once
+
+#include <stdint.h>
+#include "imu_filter.h"
+
+struct StillnessConfig
+{
+  float accVar;      // порог дисперсии модуля ускорения (g²)
+  float gyroRms;     // порог СКО гироскопа после компенсации смещения (град/с)
+  uint32_t enterUs;  // сколько держаться ниже порогов до перехода в покой
+  uint32_t windowUs; // постоянная времени скользящих оценок
+};
+
+struct StillnessDetector
+{
+  StillnessConfig cfg;
+  bool primed;
+  bool still;
+  float accMean;        // скользящее среднее модуля ускорения (g)
+  float accVar;         // скользящая дисперсия модуля ускорения (g²)
+  float gyroEnergy;     // скользящий средний квадрат гироскопа ((град/с)²)
+  uint32_t quietUs;     // время ниже порогов подряд
+  uint32_t transitions; // число переходов покой <-> движение
+};
+
+void stillness_init(StillnessDetector &d, const StillnessConfig &cfg);
+
+// Обработка отсчета (гироскоп — с учетом смещения). Возвращает true, если состояние сменилось
+bool stillness_update(StillnessDetector &d, const ImuSample &s, uint32_t dtUs);
@@ -0,0 +1,99 @@
+// tap_dance.cpp — таблица серий нажатий и разбор событий движка кнопок
+#include "tap_dance.h"
+#include "button_engine.h"
+#include <string.h>
+
+void tap_dance_init(TapDanceTable &t)
+{
+  memset(&t, 0, sizeof(t));
+}
+
+bool tap_dance_entry_valid(const TapDanceEntry &e)
+{
+  if (e.key >= KEY_SNAPSHOT_BITS || e.hold > 1 || e.taps > TAP_DANCE_MAX_TAPS)
+    return false;
+  return e.hold ? e.taps >= 1 : e.taps >= 3;
+}
+
+static int find_index(const TapDanceTable &t, uint8_t layer, uint8_t key, uint8_t taps, bool hold)
+{
+  for (uint8_t i = 0; i < t.count; i++)
+  {
+    const TapDanceEntry &e = t.entries[i];
+    if (e.key == key && e.layer == layer && e.taps == taps && e.hold == hold)
+      return i;
+  }
+  return -1;
+}
+
+const TapDanceEntry *tap_dance_find(const TapDanceTable &t, uint8_t layer, uint8_t key, uint8_t taps, bool hold)
+{
+  int i = find_index(t, layer, key, taps, hold);
+  return i >= 0 ? &t.entries[i] : nullptr;
+}
+
+bool tap_dance_set(TapDanceTable &t, const TapDanceEntry &e)
+{
+  if (!tap_dance_entry_valid(e))
+    return false;
+  int i = find_index(t, e.layer, e.key, e.taps, e.hold);
+  if (!e.type)
+  {
+    // Удаление: последняя запись на место удаленной
+    if (i >= 0)
+      t.entries[i] = t.entries[--t.count];
+    return true;
+  }
+  if (i < 0)
+  {
+    if (t.count >= TAP_DANCE_MAX)
+      return false;
+    i = t.count++;
+  }
+  t.entries[i] = e;
+  return true;
+}
+
+void tap_dance_layer_keys(const TapDanceTable &t, uint8_t layer, KeyBits &out)
+{
+  key_bits_clear(out);
+  for (uint8_t i = 0; i < t.count; i++)
+    if (t.entries[i].layer == layer)
+      key_bits_set(out, t.entries[i].key);
+}
+
+void tap_dance_state_init(TapDanceState &s)
+{
+  key_bits_clear(s.holding);
+}
+
+const TapDanceEntry *tap_dance_on_event(const TapDanceTable &t, TapDanceState &s, uint8_t layer, uint8_t key,
+                                        uint8_t event, uint8_t taps, bool &suppress)
+{
+  suppress = false;
+  switch (event)
+  {
+  case BUTTON_EVENT_TAPS:
+    return tap_dance_find(t, layer, key, taps, false);
+  case BUTTON_EVENT_HOLD_START:
+  {
+    const TapDanceEntry *e = taps ? tap_dance_find(t, layer, key, taps, true) : nullptr;
+    if (e)
+    {
+      key_bits_set(s.holding, key);
+      suppress = true;
+    }
+    return e;
+  }
+  case BUTTON_EVENT_HOLD_REPEAT:
+  case BUTTON_EVENT_ONE_CLICK_HOLD:
+    suppress = key < KEY_SNAPSHOT_BITS && key_bits_test(s.holding, key);
+    return nullptr;
+  case BUTTON_EVENT_HOLD_RELEASE:
+    suppress = key < KEY_SNAPSHOT_BITS && key_bits_test(s.holding, key);
+    if (suppress)
+      key_bits_clear_bit(s.holding, key);
+    return nullptr;
+  }
+  return nullptr;
+}
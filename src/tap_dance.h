@@ -0,0 +1,46 @@
+// tap_dance.h — действия серий нажатий: N кликов и N кликов + удержание. Таблица только для задействованных кнопок
+#pragma once
+
+#include <stdint.h>
+#include "key_snapshot.h"
+
+#define TAP_DANCE_MAX 32     // записей на все слои и кнопки
+#define TAP_DANCE_MAX_TAPS 8 // кликов в серии
+
+// Одна запись: слой, кнопка, серия и действие (поля как у ButtonAction)
+struct TapDanceEntry
+{
+  uint8_t layer;
+  uint8_t key;
+  uint8_t taps;     // кликов: 3..TAP_DANCE_MAX_TAPS без удержания (1 и 2 — click/dblclick в ButtonLogic), 1.. с удержанием
+  uint8_t hold;     // 1 — после taps кликов кнопку держат
+  uint8_t type;     // ButtonActionType, 0 — нет действия
+  int16_t code;
+  int16_t subCode;
+};
+
+struct TapDanceTable
+{
+  uint8_t count;
+  TapDanceEntry entries[TAP_DANCE_MAX];
+};
+
+// Удержание, ушедшее в действие серии: остальные события этого удержания не выполняются
+struct TapDanceState
+{
+  KeyBits holding;
+};
+
+void tap_dance_init(TapDanceTable &t);
+bool tap_dance_entry_valid(const TapDanceEntry &e);
+const TapDanceEntry *tap_dance_find(const TapDanceTable &t, uint8_t layer, uint8_t key, uint8_t taps, bool hold);
+// Добавить или заменить запись той же серии; type 0 — удалить. false — запись неверна или таблица заполнена
+bool tap_dance_set(TapDanceTable &t, const TapDanceEntry &e);
+// Кнопки слоя, у которых есть серии (им нужен отложенный CLICK)
+void tap_dance_layer_keys(const TapDanceTable &t, uint8_t layer, KeyBits &out);
+
+void tap_dance_state_init(TapDanceState &s);
+// Событие движка кнопок (ButtonEngineEvent, taps) -> действие серии или nullptr.
+// suppress — обычное действие события выполнять не нужно: удержание после кликов заменено действием серии
+const TapDanceEntry *tap_dance_on_event(const TapDanceTable &t, TapDanceState &s, uint8_t layer, uint8_t key,
+                                        uint8_t event, uint8_t taps, bool &suppress);
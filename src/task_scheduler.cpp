@@ -0,0 +1,110 @@
+// task_scheduler.cpp — привязка планировщика к FreeRTOS: сон между периодами и выдача статистики
+#include "task_scheduler.h"
+#include "config.h"
+
+PeriodScheduler ioScheduler;
+PeriodScheduler appScheduler;
+
+static const uint32_t tickUs = portTICK_PERIOD_MS * 1000UL;
+
+static uint32_t sched_clock() { return micros(); }
+
+void task_scheduler_loop(PeriodScheduler &s)
+{
+  sched_start(s, micros());
+  TickType_t lastWake = xTaskGetTickCount();
+  uint32_t wakeUs = micros();
+  for (;;)
+  {
+    uint32_t waitUs = sched_run_due(s, sched_clock);
+
+    // Срок следующего периода от прошлого пробуждения, с округлением вверх: раньше срока не просыпаемся
+    uint32_t sinceWakeUs = micros() - wakeUs;
+    TickType_t ticks = (sinceWakeUs + waitUs + tickUs - 1) / tickUs;
+    // Отстали (задачи работали дольше периода) — спим хотя бы тик от текущего момента:
+    // vTaskDelayUntil с прошедшим сроком не уступает ядро, и на core 0 голодал бы IDLE (сторожевой таймер)
+    TickType_t now = xTaskGetTickCount();
+    if ((TickType_t)(now - lastWake) >= ticks)
+    {
+      lastWake = now;
+      ticks = 1;
+    }
+    vTaskDelayUntil(&lastWake, ticks);
+    wakeUs = micros();
+  }
+}
+
+// === API ===
+
+static String job_json(const SchedJob &j, uint32_t windowUs)
+{
+  String json = "{";
+  json += "\"name\":\"" + String(j.name) + "\",";
+  json += "\"periodUs\":" + String(j.periodUs) + ",";
+  json += "\"runs\":" + String(j.runs) + ",";
+  json += "\"misses\":" + String(j.misses) + ",";
+  json += "\"maxLateUs\":" + String(j.maxLateUs) + ",";
+  json += "\"maxRunUs\":" + String(j.maxRunUs) + ",";
+  json += "\"avgRunUs\":" + String(j.runs ? (uint32_t)(j.totalRunUs / j.runs) : 0) + ",";
+  json += "\"load\":" + String(windowUs ? (float)j.totalRunUs * 100.0f / windowUs : 0.0f, 2) + ",";
+  json += "\"hist\":[";
+  for (uint8_t b = 0; b < SCHED_HIST_BUCKETS; b++)
+  {
+    if (b)
+      json += ",";
+    json += String(j.hist[b]);
+  }
+  json += "]}";
+  return json;
+}
+
+static String scheduler_json(const PeriodScheduler &s)
+{
+  uint32_t windowUs = micros() - s.startUs;
+  String json = "{";
+  json += "\"name\":\"" + String(s.name) + "\",";
+  json += "\"windowMs\":" + String(windowUs / 1000) + ",";
+  json += "\"jobs\":[";
+  for (uint8_t i = 0; i < s.count; i++)
+  {
+    if (i)
+      json += ",";
+    json += job_json(s.jobs[i], windowUs);
+  }
+  json += "]}";
+  return json;
+}
+
+static String schedulers_json()
+{
+  // Статистику пишут задачи на своих ядрах; для диагностики рваное чтение отдельных счетчиков допустимо
+  String json = "{\"histLimitsUs\":[";
+  for (uint8_t b = 0; b < SCHED_HIST_BUCKETS - 1; b++)
+  {
+    if (b)
+      json += ",";
+    json += String(sched_hist_limits_us[b]);
+  }
+  json += "],\"tickUs\":" + String(tickUs) + ",";
+  json += "\"schedulers\":[" + scheduler_json(ioScheduler) + "," + scheduler_json(appScheduler) + "]}";
+  return json;
+}
+
+void register_scheduler_api(AsyncWebServer &server)
+{
+  server.on("/api/scheduler", HTTP_GET, [](AsyncWebServerRequest *request)
+            { request->send(200, "application/json", schedulers_json()); });
+
+  server.on("/api/scheduler", HTTP_POST, [](AsyncWebServerRequest *request)
+            {
+    if (request->hasParam("reset", true) && request->getParam("reset", true)->value().toInt())
+    {
+      // Сброс выполняют сами задачи в начале прохода — без гонки с записью статистики
+      ioScheduler.resetPending = true;
+      appScheduler.resetPending = true;
+#if DEBUG
+      Serial.println("[SCHED] Statistics reset requested");
+#endif
+    }
+    request->send(200, "application/json", schedulers_json()); });
+}
@@ -0,0 +1,15 @@
+// task_scheduler.h — циклы task_io и task_app на периодическом планировщике и его статистика по HTTP
+#pragma once
+
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+#include "period_scheduler.h"
+
+extern PeriodScheduler ioScheduler;     // Core 0: I2C (IMU, MCP23017, IP5306)
+extern PeriodScheduler appScheduler;    // Core 1: логика, LED, BLE
+
+// Бесконечный цикл задачи FreeRTOS: выполнение готовых задач и сон через vTaskDelayUntil до следующего периода
+void task_scheduler_loop(PeriodScheduler &s);
+
+// GET /api/scheduler — статистика задач; POST /api/scheduler (reset=1) — сброс статистики
+void register_scheduler_api(AsyncWebServer &server);
@@ -17,6 +17,10 @@
 #include "ip5306.h"
 #include "sleep_manager.h"
 #include "mcp_handler.h"
+#include "mouse_control.h"
+#include "task_scheduler.h"
+#include "i2c_service.h"
+#include "button_fsm.h"
 
 AsyncWebServer server(80);
 bool wifi_enabled = false;
@@ -182,6 +186,7 @@ void setup_web_interface()
   json += "\"leds_brightness\":" + String(LED_BRIGHTNESS) + ",";
   json += "\"status_led_index\":" + String(LED_STATUS_INDEX) + ",";
   json += ip5306_state(); // добавляем состояние питания
+  json += "," + mouse_control_state(); // IMU: время загрузки и калибровка
   json += "}";
 
   request->send(200, "application/json", json); });
@@ -214,6 +219,9 @@ void setup_web_interface()
     delay(500);
     ESP.restart(); });
 
+  // Раньше /api/buttons: тот перехватывает и вложенные пути
+  register_button_api(server);
+
   // API: получить конфигурацию кнопок
   server.on("/api/buttons", HTTP_GET, [](AsyncWebServerRequest *request)
             {
@@ -230,6 +238,13 @@ void setup_web_interface()
         json += "\"holdRelease\":{\"type\":" + String(b.holdRelease.type) + ",\"code\":" + String(b.holdRelease.code) + ",\"sub_code\":" + String(b.holdRelease.sub_code) + "},";
         json += "\"oneClickHold\":{\"type\":" + String(b.oneClickHold.type) + ",\"code\":" + String(b.oneClickHold.code) + ",\"sub_code\":" + String(b.oneClickHold.sub_code) + "},";
         json += "\"release\":{\"type\":" + String(b.release.type) + ",\"code\":" + String(b.release.code) + ",\"sub_code\":" + String(b.release.sub_code) + "},";
+        // Серии нажатий — только заданные: tap<N> и tap<N>Hold
+        const TapDanceTable &tapDance = get_tap_dance();
+        for (uint8_t t = 0; t < tapDance.count; t++) {
+          const TapDanceEntry &e = tapDance.entries[t];
+          if (e.layer != l || e.key != k) continue;
+          json += "\"tap" + String(e.taps) + (e.hold ? "Hold" : "") + "\":{\"type\":" + String(e.type) + ",\"code\":" + String(e.code) + ",\"sub_code\":" + String(e.subCode) + "},";
+        }
         json += "\"color\":" + String(get_button_colors(l,k)) + "}";
         if (k + 1 < NUM_DEFAULT_KEYS) json += ",";
       }
@@ -251,6 +266,7 @@ void setup_web_interface()
 
     String body = request->getParam("body", true)->value();
     // key:<layout>:<bnt id>;color:<int color>;click:<type>:<code>;double:<type>:<code>|key:<layout>:<bnt id>;color:<int color>;click:<type>:<code>
+    // Серии нажатий: tap<N>:<type>:<code>:<sub_code> (N = 3..8), tap<N>Hold:... (N = 1..8); type 0 — удалить
     char *json = (char *)body.c_str();
 
     size_t layer = 0;
@@ -288,6 +304,8 @@ void setup_web_interface()
         String action_name = String(json).substring(0, end_pos);
         ButtonActionKind action_type;
         bool is_action = true;
+        uint8_t taps = 0;
+        bool tap_hold = false;
         if (action_name == "click")
         {
           action_type = BUTTON_CLICK;
@@ -315,6 +333,13 @@ void setup_web_interface()
         else if (action_name == "release")
         {
           action_type = BUTTON_RELEASE;
+        }
+        else if (action_name.startsWith("tap"))
+        {
+          tap_hold = action_name.endsWith("Hold");
+          taps = action_name.substring(3, action_name.length() - (tap_hold ? 4 : 0)).toInt();
+          if (!taps)
+            is_action = false;
         }else{
           is_action= false;
         }
@@ -326,6 +351,16 @@ void setup_web_interface()
           type = (ButtonActionType)get_int_from_char(&json, ':');
         int16_t code = get_int_from_char(&json, ':');
         int16_t sub_code = get_int_from_char(&json, '|');
+        if (taps)
+        {
+          if (!set_tap_dance_action(layer, key, taps, tap_hold, type, code, sub_code))
+            Serial.printf("[WEB] Tap dance rejected: layer=%zu, key=%zu, taps=%u, hold=%d\n", layer, key, taps, tap_hold);
+#if DEBUG
+          else
+            Serial.printf("[WEB]     Set tap%u%s: layer=%zu, key=%zu, type=%hhu, code=%hd\n", taps, tap_hold ? "Hold" : "", layer, key, type, code);
+#endif
+          continue;
+        }
         set_button_action(layer, key, type, code, sub_code, action_type);
 #if DEBUG
         Serial.printf("[WEB]     Set %d: layer=%zu, key=%zu, type=%hhu, code=%hd\n", action_type,layer, key, type, code);
@@ -354,9 +389,57 @@ void setup_web_interface()
     }
     save_full_button_config();
     save_color_config();
+    save_tap_dance_config();
     print_config();
     request->send(200, "application/json", "{\"status\":\"saved\"}"); });
 
+  // API: действия жестов по слоям
+  server.on("/api/gestures", HTTP_GET, [](AsyncWebServerRequest *request)
+            {
+    String json = "[";
+    for (size_t l = 0; l < MAX_LAYERS; l++) {
+      json += "{";
+      for (uint8_t g = 0; g < GESTURE_COUNT; g++) {
+        const ButtonAction a = get_gesture_action(l, g);
+        json += "\"" + String(gesture_name(g)) + "\":{\"type\":" + String(a.type) + ",\"code\":" + String(a.code) + ",\"sub_code\":" + String(a.sub_code) + "}";
+        if (g + 1 < GESTURE_COUNT) json += ",";
+      }
+      json += "}";
+      if (l + 1 < MAX_LAYERS) json += ",";
+    }
+    json += "]";
+    request->send(200, "application/json", json); });
+
+  // API: сохранить действие жеста. gesture — номер или имя (flick_left, flick_right, shake, twist, raise)
+  server.on("/api/gestures", HTTP_POST, [](AsyncWebServerRequest *request)
+            {
+    if (!request->hasParam("layer", true) || !request->hasParam("gesture", true) || !request->hasParam("type", true))
+    {
+      request->send(400, "application/json", "{\"error\":\"Missing params\"}");
+      return;
+    }
+    uint8_t layer = request->getParam("layer", true)->value().toInt();
+    String name = request->getParam("gesture", true)->value();
+    uint8_t gesture = GESTURE_NONE;
+    for (uint8_t g = 0; g < GESTURE_COUNT; g++)
+      if (name == gesture_name(g) || name == String(g))
+        gesture = g;
+    if (layer >= MAX_LAYERS || gesture == GESTURE_NONE)
+    {
+      request->send(400, "application/json", "{\"error\":\"Invalid gesture\"}");
+      return;
+    }
+    ButtonActionType type = (ButtonActionType)request->getParam("type", true)->value().toInt();
+    int16_t code = request->hasParam("code", true) ? request->getParam("code", true)->value().toInt() : 0;
+    int16_t sub_code = request->hasParam("sub_code", true) ? request->getParam("sub_code", true)->value().toInt() : 0;
+    set_gesture_action(layer, gesture, type, code, sub_code);
+    if (!save_gesture_config())
+    {
+      request->send(500, "application/json", "{\"error\":\"Save failed\"}");
+      return;
+    }
+    request->send(200, "application/json", "{\"status\":\"saved\"}"); });
+
   // API: получить список событий
   server.on("/api/actions", HTTP_GET, [](AsyncWebServerRequest *request)
             { request->send(200, "application/json", get_action_list()); });
@@ -425,6 +508,9 @@ void setup_web_interface()
   register_action_api(server);
   handle_led_status_api(server);
   handle_power_status_api(server);
+  register_mouse_api(server);
+  register_scheduler_api(server);
+  register_i2c_api(server);
 
   server.begin();
 #if DEBUG
@@ -0,0 +1,254 @@
+#include <unity.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "absolute_pointer.h"
+
+static uint32_t rng_state = 7;
+static float noise(float amplitude)
+{
+  rng_state = rng_state * 1664525u + 1013904223u;
+  return ((int32_t)(rng_state >> 8) % 2001 - 1000) / 1000.0f * amplitude;
+}
+
+// Экран 1920x1080 на прямоугольнике 40x22.5 градуса вокруг нуля
+static AbsolutePointerConfig default_config(bool filter)
+{
+  AbsolutePointerConfig cfg = {};
+  cfg.left = -20;
+  cfg.right = 20;
+  cfg.top = -11.25f;
+  cfg.bottom = 11.25f;
+  cfg.width = 1920;
+  cfg.height = 1080;
+  cfg.filter.enabled = filter;
+  cfg.filter.minCutoff = 0.5f;
+  cfg.filter.beta = 8.0f;
+  cfg.filter.dCutoff = 10.0f;
+  return cfg;
+}
+
+// Имитация хоста: относительные отчеты двигают курсор, края экрана его останавливают
+struct Host
+{
+  int32_t x, y;
+  int steps;
+  int maxStep;
+};
+
+static void host_move(Host &h, const AbsolutePointerConfig &cfg, int32_t dx, int32_t dy)
+{
+  h.x += dx;
+  h.y += dy;
+  h.x = h.x < 0 ? 0 : (h.x >= cfg.width ? cfg.width - 1 : h.x);
+  h.y = h.y < 0 ? 0 : (h.y >= cfg.height ? cfg.height - 1 : h.y);
+  h.steps++;
+  if (abs(dx) > h.maxStep)
+    h.maxStep = abs(dx);
+  if (abs(dy) > h.maxStep)
+    h.maxStep = abs(dy);
+}
+
+// Отсчеты 200 Гц с заданными углами; возвращает число отсчетов с движением
+static int run(AbsolutePointer &p, const AbsolutePointerConfig &cfg, Host &h, float angleX, float angleY, int samples)
+{
+  int moved = 0;
+  for (int i = 0; i < samples; i++)
+  {
+    int32_t dx, dy;
+    if (absolute_pointer_step(p, cfg, angleX, angleY, 5000, dx, dy))
+    {
+      host_move(h, cfg, dx, dy);
+      moved++;
+    }
+  }
+  return moved;
+}
+
+void test_map_corners_center_and_clamp()
+{
+  AbsolutePointerConfig cfg = default_config(false);
+  AbsolutePointer p = {};
+  int32_t x, y;
+  absolute_pointer_map(p, cfg, -20, -11.25f, x, y);
+  TEST_ASSERT_EQUAL_INT32(0, x);
+  TEST_ASSERT_EQUAL_INT32(0, y);
+  absolute_pointer_map(p, cfg, 20, 11.25f, x, y);
+  TEST_ASSERT_EQUAL_INT32(1919, x);
+  TEST_ASSERT_EQUAL_INT32(1079, y);
+  absolute_pointer_map(p, cfg, 0, 0, x, y);
+  TEST_ASSERT_INT_WITHIN(1, 960, x);
+  TEST_ASSERT_INT_WITHIN(1, 540, y);
+  // За краем — край, а не перенос на другую сторону
+  absolute_pointer_map(p, cfg, 60, -40, x, y);
+  TEST_ASSERT_EQUAL_INT32(1919, x);
+  TEST_ASSERT_EQUAL_INT32(0, y);
+}
+
+void test_rect_across_wrap()
+{
+  AbsolutePointerConfig cfg = default_config(false);
+  cfg.left = 160;
+  cfg.right = -160; // 40 градусов через ±180
+  AbsolutePointer p = {};
+  int32_t x, y;
+  absolute_pointer_map(p, cfg, 179.9f, 0, x, y);
+  TEST_ASSERT_INT_WITHIN(2, 955, x);
+  absolute_pointer_map(p, cfg, -170, 0, x, y);
+  TEST_ASSERT_INT_WITHIN(2, 1440, x);
+}
+
+void test_home_then_track()
+{
+  AbsolutePointerConfig cfg = default_config(false);
+  AbsolutePointer p = {};
+  // Курсор хоста где угодно — после упора в угол оценка совпадает с хостом
+  Host h = {1234, 777, 0, 0};
+  absolute_pointer_begin(p, cfg, 0);
+  // Упор в угол — отчетами не больше 127, пока не уйдет ширина экрана с запасом
+  run(p, cfg, h, 5, -3, (1920 + ABSOLUTE_HOME_MARGIN + 126) / 127);
+  TEST_ASSERT_LESS_OR_EQUAL(127, h.maxStep);
+  TEST_ASSERT_EQUAL_INT32(0, h.x);
+  TEST_ASSERT_EQUAL_INT32(0, h.y);
+  run(p, cfg, h, 5, -3, 100);
+  TEST_ASSERT_EQUAL_INT32(p.x, h.x);
+  TEST_ASSERT_EQUAL_INT32(p.y, h.y);
+  int32_t x, y;
+  absolute_pointer_map(p, cfg, 5, -3, x, y);
+  TEST_ASSERT_EQUAL_INT32(x, h.x);
+  TEST_ASSERT_EQUAL_INT32(y, h.y);
+
+  // Пульт повернут — курсор переходит в новую точку и не уплывает
+  run(p, cfg, h, -12, 8, 50);
+  absolute_pointer_map(p, cfg, -12, 8, x, y);
+  TEST_ASSERT_EQUAL_INT32(x, h.x);
+  TEST_ASSERT_EQUAL_INT32(y, h.y);
+  TEST_ASSERT_EQUAL(0, run(p, cfg, h, -12, 8, 200));
+}
+
+void test_home_paced_to_report_rate()
+{
+  // Широкий экран, отсчеты 200 Гц, отчеты не чаще 7.5 мс: за любой отрезок шагов упора не больше, чем отчетов
+  AbsolutePointerConfig cfg = default_config(false);
+  cfg.width = 3840;
+  cfg.height = 2160;
+  AbsolutePointer p = {};
+  Host h = {3000, 2000, 0, 0};
+  absolute_pointer_begin(p, cfg, 7500);
+  int homeSteps = (3840 + ABSOLUTE_HOME_MARGIN + 126) / 127;
+  int samples = 0;
+  while (p.homeX || p.homeY)
+  {
+    run(p, cfg, h, 5, -3, 1);
+    samples++;
+    TEST_ASSERT_LESS_OR_EQUAL(samples * 5000 / 7500 + 1, h.steps);
+  }
+  TEST_ASSERT_EQUAL(homeSteps, h.steps);
+  TEST_ASSERT_EQUAL_INT32(0, h.x);
+  TEST_ASSERT_EQUAL_INT32(0, h.y);
+
+  // Часть движения потеряна (сжата или сброшена при отключении): повторный упор сохраняет перецентровку
+  run(p, cfg, h, 5, -3, 10);
+  absolute_pointer_recenter(p, cfg, p.angleX, p.angleY);
+  run(p, cfg, h, 5, -3, 10);
+  h.x += 400;
+  absolute_pointer_home(p, cfg);
+  run(p, cfg, h, 5, -3, 100);
+  TEST_ASSERT_INT_WITHIN(1, 1920, h.x);
+  TEST_ASSERT_INT_WITHIN(1, 1080, h.y);
+}
+
+void test_filter_reduces_jitter()
+{
+  // Рука держит указку на точке: тремор 0.1 градуса
+  AbsolutePointerConfig raw = default_config(false);
+  AbsolutePointerConfig smooth = default_config(true);
+  AbsolutePointer a = {}, b = {};
+  Host ha = {0, 0, 0, 0}, hb = {0, 0, 0, 0};
+  absolute_pointer_begin(a, raw, 0);
+  absolute_pointer_begin(b, smooth, 0);
+  run(a, raw, ha, 0, 0, 100);
+  run(b, smooth, hb, 0, 0, 100);
+  long pathA = 0, pathB = 0;
+  for (int i = 0; i < 2000; i++)
+  {
+    float t = i * 0.005f;
+    float ax = 0.1f * sinf(t * 2 * 3.14159f * 9.0f) + noise(0.05f);
+    float ay = 0.1f * cosf(t * 2 * 3.14159f * 8.0f) + noise(0.05f);
+    int32_t dx, dy;
+    if (absolute_pointer_step(a, raw, ax, ay, 5000, dx, dy))
+      pathA += abs(dx) + abs(dy);
+    if (absolute_pointer_step(b, smooth, ax, ay, 5000, dx, dy))
+      pathB += abs(dx) + abs(dy);
+  }
+  char msg[96];
+  snprintf(msg, sizeof(msg), "jitter path: raw %ld px, filtered %ld px", pathA, pathB);
+  TEST_MESSAGE(msg);
+  TEST_ASSERT_LESS_THAN(pathA / 4, pathB);
+}
+
+void test_recenter_moves_current_direction_to_center()
+{
+  AbsolutePointerConfig cfg = default_config(false);
+  AbsolutePointer p = {};
+  Host h = {0, 0, 0, 0};
+  absolute_pointer_begin(p, cfg, 0);
+  // Рыскание ушло: пульт смотрит в центр экрана, а угол уже 30 градусов
+  run(p, cfg, h, 30, 4, 100);
+  TEST_ASSERT_EQUAL_INT32(1919, h.x);
+  absolute_pointer_recenter(p, cfg, p.angleX, p.angleY);
+  run(p, cfg, h, 30, 4, 10);
+  TEST_ASSERT_INT_WITHIN(1, 960, h.x);
+  TEST_ASSERT_INT_WITHIN(1, 540, h.y);
+  run(p, cfg, h, 40, 4, 10);
+  TEST_ASSERT_INT_WITHIN(1, 1440, h.x);
+}
+
+void test_calibration_two_corners()
+{
+  AbsolutePointerConfig cfg = default_config(false);
+  AbsoluteCalibration c = {};
+  TEST_ASSERT_FALSE(absolute_calibration_capture(c, cfg, -15, -8));
+  TEST_ASSERT_EQUAL_UINT8(1, c.step);
+  TEST_ASSERT_TRUE(absolute_calibration_capture(c, cfg, 15, 9));
+  TEST_ASSERT_EQUAL_FLOAT(-15, cfg.left);
+  TEST_ASSERT_EQUAL_FLOAT(-8, cfg.top);
+  TEST_ASSERT_EQUAL_FLOAT(15, cfg.right);
+  TEST_ASSERT_EQUAL_FLOAT(9, cfg.bottom);
+
+  // Оба угла в одной точке — прямоугольник не принимается, калибровка начинается заново
+  AbsolutePointerConfig before = cfg;
+  TEST_ASSERT_FALSE(absolute_calibration_capture(c, cfg, 3, 3));
+  TEST_ASSERT_FALSE(absolute_calibration_capture(c, cfg, 3.5f, 3.2f));
+  TEST_ASSERT_EQUAL_UINT8(0, c.step);
+  TEST_ASSERT_EQUAL_FLOAT(before.left, cfg.left);
+  TEST_ASSERT_EQUAL_FLOAT(before.right, cfg.right);
+}
+
+void test_config_valid()
+{
+  AbsolutePointerConfig cfg = default_config(true);
+  TEST_ASSERT_TRUE(absolute_pointer_config_valid(cfg));
+  cfg.width = 0;
+  TEST_ASSERT_FALSE(absolute_pointer_config_valid(cfg));
+  cfg = default_config(true);
+  cfg.bottom = NAN;
+  TEST_ASSERT_FALSE(absolute_pointer_config_valid(cfg));
+  cfg = default_config(true);
+  cfg.right = cfg.left + 1;
+  TEST_ASSERT_FALSE(absolute_pointer_config_valid(cfg));
+}
+
+int main(int argc, char **argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_map_corners_center_and_clamp);
+  RUN_TEST(test_rect_across_wrap);
+  RUN_TEST(test_home_then_track);
+  RUN_TEST(test_home_paced_to_report_rate);
+  RUN_TEST(test_filter_reduces_jitter);
+  RUN_TEST(test_recenter_moves_current_direction_to_center);
+  RUN_TEST(test_calibration_two_corners);
+  RUN_TEST(test_config_valid);
+  return UNITY_END();
+}
@@ -0,0 +1,112 @@
+#include <unity.h>
+#include <math.h>
+#include "accel_curve.h"
+
+static AccelCurveConfig make_curve(uint8_t type, float threshold, float param)
+{
+  AccelCurveConfig curve = {};
+  curve.type = type;
+  curve.minGain = 0.4f;
+  curve.maxGain = 2.0f;
+  curve.threshold = threshold;
+  curve.param = param;
+  return curve;
+}
+
+void test_step_matches_legacy_thresholds()
+{
+  AccelCurveConfig curve = make_curve(ACCEL_CURVE_STEP, 1.2f, 0.6f);
+  TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.4f, accel_curve_eval(curve, 0.3f));
+  TEST_ASSERT_FLOAT_WITHIN(1e-6f, 1.0f, accel_curve_eval(curve, 0.9f));
+  TEST_ASSERT_FLOAT_WITHIN(1e-6f, 2.0f, accel_curve_eval(curve, 1.5f));
+}
+
+void test_linear_and_power_reach_max_at_threshold()
+{
+  AccelCurveConfig linear = make_curve(ACCEL_CURVE_LINEAR, 2.0f, 0);
+  TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.4f, accel_curve_eval(linear, 0));
+  TEST_ASSERT_FLOAT_WITHIN(1e-6f, 1.2f, accel_curve_eval(linear, 1.0f));
+  TEST_ASSERT_FLOAT_WITHIN(1e-6f, 2.0f, accel_curve_eval(linear, 5.0f));
+
+  AccelCurveConfig power = make_curve(ACCEL_CURVE_POWER, 2.0f, 2.0f);
+  TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.8f, accel_curve_eval(power, 1.0f));
+  TEST_ASSERT_FLOAT_WITHIN(1e-6f, 2.0f, accel_curve_eval(power, 3.0f));
+}
+
+void test_points_interpolate_and_sort()
+{
+  AccelCurveConfig curve = make_curve(ACCEL_CURVE_POINTS, 1.0f, 0);
+  curve.pointCount = 4;
+  curve.points[0] = {2.0f, 3.0f};
+  curve.points[1] = {0.5f, 0.5f};
+  curve.points[2] = {1.0f, 1.0f};
+  curve.points[3] = {1.0f, 9.0f}; // повтор скорости — отбрасывается
+  TEST_ASSERT_TRUE(accel_curve_sanitize(curve));
+  TEST_ASSERT_EQUAL_UINT8(3, curve.pointCount);
+  TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.5f, accel_curve_eval(curve, 0.1f));
+  TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.75f, accel_curve_eval(curve, 0.75f));
+  TEST_ASSERT_FLOAT_WITHIN(1e-6f, 2.0f, accel_curve_eval(curve, 1.5f));
+  TEST_ASSERT_FLOAT_WITHIN(1e-6f, 3.0f, accel_curve_eval(curve, 10.0f));
+}
+
+void test_sanitize_rejects_bad_input()
+{
+  AccelCurveConfig curve = make_curve(ACCEL_CURVE_COUNT, 1.0f, 0);
+  TEST_ASSERT_FALSE(accel_curve_sanitize(curve));
+
+  curve = make_curve(ACCEL_CURVE_POINTS, 1.0f, 0);
+  curve.pointCount = 0;
+  TEST_ASSERT_FALSE(accel_curve_sanitize(curve));
+
+  curve = make_curve(ACCEL_CURVE_SIGMOID, NAN, 0);
+  curve.maxGain = 1000.0f;
+  TEST_ASSERT_TRUE(accel_curve_sanitize(curve));
+  TEST_ASSERT_TRUE(curve.threshold > 0);
+  TEST_ASSERT_TRUE(curve.param > 0); // ширина сигмоиды — делитель
+  TEST_ASSERT_TRUE(curve.maxGain <= 20.0f);
+}
+
+void test_sigmoid_lut_has_no_jumps()
+{
+  // Ступенчатая кривая дает скачок усиления 1.0 на пороге, сигмоида — плавный рост
+  AccelCurveConfig step = make_curve(ACCEL_CURVE_STEP, 1.2f, 0.6f);
+  AccelCurveConfig sigmoid = make_curve(ACCEL_CURVE_SIGMOID, 0.9f, 0.15f);
+  TEST_ASSERT_TRUE(accel_curve_sanitize(step));
+  TEST_ASSERT_TRUE(accel_curve_sanitize(sigmoid));
+  float stepLut[ACCEL_LUT_SIZE], sigmoidLut[ACCEL_LUT_SIZE];
+  accel_curve_build_lut(step, 1.0f, stepLut);
+  accel_curve_build_lut(sigmoid, 1.0f, sigmoidLut);
+
+  float stepJump = 0, sigmoidJump = 0;
+  for (int i = 1; i < ACCEL_LUT_SIZE; i++)
+  {
+    TEST_ASSERT_TRUE(sigmoidLut[i] >= sigmoidLut[i - 1]);
+    stepJump = fmaxf(stepJump, stepLut[i] - stepLut[i - 1]);
+    sigmoidJump = fmaxf(sigmoidJump, sigmoidLut[i] - sigmoidLut[i - 1]);
+  }
+  TEST_ASSERT_FLOAT_WITHIN(1e-6f, 1.0f, stepJump);
+  TEST_ASSERT_LESS_THAN(0.4f, sigmoidJump);
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.4f, sigmoidLut[0]);
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 2.0f, sigmoidLut[ACCEL_LUT_SIZE - 1]);
+}
+
+void test_lut_includes_sensitivity()
+{
+  AccelCurveConfig curve = make_curve(ACCEL_CURVE_LINEAR, 4.0f, 0);
+  float lut[ACCEL_LUT_SIZE];
+  accel_curve_build_lut(curve, 2.5f, lut);
+  for (int i = 0; i < ACCEL_LUT_SIZE; i++)
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 2.5f * accel_curve_eval(curve, (i + 0.5f) * ACCEL_LUT_STEP), lut[i]);
+}
+
+int main(int argc, char **argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_step_matches_legacy_thresholds);
+  RUN_TEST(test_linear_and_power_reach_max_at_threshold);
+  RUN_TEST(test_points_interpolate_and_sort);
+  RUN_TEST(test_sanitize_rejects_bad_input);
+  RUN_TEST(test_sigmoid_lut_has_no_jumps);
+  RUN_TEST(test_lut_includes_sensitivity);
+  return UNITY_END();
+}
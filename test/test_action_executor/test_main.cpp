@@ -0,0 +1,182 @@
+#include <unity.h>
+#include <string.h>
+#include "action_executor.h"
+
+// Типы шагов как в ButtonActionType
+#define T_NONE 0     // пауза code мс
+#define T_KEY 1      // нажатие клавиши на 5 мс
+#define T_CLICK 2    // мгновенный шаг
+#define KEY_PRESS_US 5000
+#define POLL_US 1000
+
+// Что увидел бы HID: шаг и начало/окончание
+struct Call
+{
+  uint32_t t;
+  uint8_t type;
+  int16_t code;
+  bool release;
+};
+
+static ActionExecutor exec;
+static Call calls[256];
+static uint32_t callCount;
+static uint32_t nowUs;
+
+static uint32_t step(void *ctx, const ActionStep &s, bool release)
+{
+  if (callCount < 256)
+    calls[callCount++] = {nowUs, s.type, s.code, release};
+  if (release)
+    return 0;
+  if (s.type == T_KEY)
+    return KEY_PRESS_US;
+  if (s.type == T_NONE)
+    return s.code * 1000UL;
+  return 0;
+}
+
+// Проходы исполнителя раз в POLL_US до endUs
+static void run_until(uint32_t endUs)
+{
+  for (; nowUs <= endUs; nowUs += POLL_US)
+    action_exec_poll(exec, nowUs, step, nullptr);
+}
+
+static const Call *find_call(uint8_t type, int16_t code, bool release)
+{
+  for (uint32_t i = 0; i < callCount; i++)
+    if (calls[i].type == type && calls[i].code == code && calls[i].release == release)
+      return &calls[i];
+  return nullptr;
+}
+
+void setUp()
+{
+  action_exec_init(exec);
+  callCount = 0;
+  nowUs = 0;
+}
+
+void tearDown() {}
+
+void test_key_press_released_after_timer()
+{
+  ActionStep key = {T_KEY, 'a', 0};
+  TEST_ASSERT_TRUE(action_exec_start(exec, ACTION_EXEC_SINGLE, &key, 1, nowUs));
+  TEST_ASSERT_EQUAL_UINT32(KEY_PRESS_US, action_exec_poll(exec, nowUs, step, nullptr));
+  TEST_ASSERT_EQUAL_UINT32(1, callCount);
+  TEST_ASSERT_FALSE(calls[0].release);
+
+  run_until(20000);
+  TEST_ASSERT_EQUAL_UINT32(2, callCount);
+  TEST_ASSERT_TRUE(calls[1].release);
+  TEST_ASSERT_EQUAL_UINT32(KEY_PRESS_US, calls[1].t);
+  TEST_ASSERT_EQUAL_UINT8(0, exec.active);
+  TEST_ASSERT_EQUAL_UINT32(1, exec.stats.finished);
+  TEST_ASSERT_EQUAL_UINT32(KEY_PRESS_US, exec.stats.lastJobUs);
+}
+
+void test_script_delay_does_not_block_other_jobs()
+{
+  // Скрипт: клавиша, пауза 100 мс, клавиша
+  ActionStep script[] = {{T_KEY, 'x', 0}, {T_NONE, 100, 0}, {T_KEY, 'y', 0}};
+  TEST_ASSERT_TRUE(action_exec_start(exec, 3, script, 3, nowUs));
+  run_until(20000);
+  // Во время паузы скрипта одиночное действие выполняется сразу
+  ActionStep click = {T_CLICK, 1, 0};
+  TEST_ASSERT_TRUE(action_exec_start(exec, ACTION_EXEC_SINGLE, &click, 1, nowUs));
+  uint32_t clickUs = nowUs;
+  run_until(200000);
+
+  TEST_ASSERT_EQUAL_UINT32(clickUs, find_call(T_CLICK, 1, false)->t);
+  TEST_ASSERT_EQUAL_UINT32(KEY_PRESS_US, find_call(T_KEY, 'x', true)->t);
+  TEST_ASSERT_EQUAL_UINT32(KEY_PRESS_US + 100000, find_call(T_NONE, 100, true)->t);
+  TEST_ASSERT_EQUAL_UINT32(KEY_PRESS_US + 100000, find_call(T_KEY, 'y', false)->t);
+  TEST_ASSERT_EQUAL_UINT32(2 * KEY_PRESS_US + 100000, exec.stats.maxJobUs);
+  TEST_ASSERT_EQUAL_UINT32(2, exec.stats.finished);
+  TEST_ASSERT_EQUAL_UINT8(2, exec.stats.maxActive);
+}
+
+void test_concurrent_scripts_interleave()
+{
+  ActionStep a[] = {{T_KEY, 'a', 0}, {T_NONE, 10, 0}, {T_KEY, 'b', 0}};
+  ActionStep b[] = {{T_KEY, '1', 0}, {T_NONE, 3, 0}, {T_KEY, '2', 0}};
+  TEST_ASSERT_TRUE(action_exec_start(exec, 1, a, 3, nowUs));
+  TEST_ASSERT_TRUE(action_exec_start(exec, 2, b, 3, nowUs));
+  TEST_ASSERT_EQUAL_UINT8(2, exec.active);
+  run_until(100000);
+
+  // Оба начались в одном проходе; короткая пауза второго закончилась раньше
+  TEST_ASSERT_EQUAL_UINT32(0, find_call(T_KEY, 'a', false)->t);
+  TEST_ASSERT_EQUAL_UINT32(0, find_call(T_KEY, '1', false)->t);
+  TEST_ASSERT_EQUAL_UINT32(KEY_PRESS_US + 3000, find_call(T_KEY, '2', false)->t);
+  TEST_ASSERT_EQUAL_UINT32(KEY_PRESS_US + 10000, find_call(T_KEY, 'b', false)->t);
+  TEST_ASSERT_EQUAL_UINT32(2, exec.stats.finished);
+  TEST_ASSERT_EQUAL_UINT8(0, exec.active);
+}
+
+void test_cancel_releases_held_key()
+{
+  ActionStep script[] = {{T_NONE, 50, 0}, {T_KEY, 'k', 0}, {T_NONE, 500, 0}, {T_KEY, 'z', 0}};
+  TEST_ASSERT_TRUE(action_exec_start(exec, 7, script, 4, nowUs));
+  run_until(52000); // клавиша 'k' нажата в 50 мс и еще держится
+  TEST_ASSERT_NOT_NULL(find_call(T_KEY, 'k', false));
+  TEST_ASSERT_NULL(find_call(T_KEY, 'k', true));
+  TEST_ASSERT_EQUAL_INT8(0, action_exec_find(exec, 7));
+
+  TEST_ASSERT_TRUE(action_exec_cancel(exec, 7, step, nullptr));
+  const Call *release = find_call(T_KEY, 'k', true);
+  TEST_ASSERT_NOT_NULL(release);
+  TEST_ASSERT_EQUAL_UINT32(nowUs, release->t);
+  TEST_ASSERT_EQUAL_INT8(-1, action_exec_find(exec, 7));
+  TEST_ASSERT_FALSE(action_exec_cancel(exec, 7, step, nullptr));
+
+  run_until(1000000);
+  TEST_ASSERT_NULL(find_call(T_KEY, 'z', false));
+  TEST_ASSERT_EQUAL_UINT32(1, exec.stats.cancelled);
+  TEST_ASSERT_EQUAL_UINT32(0, exec.stats.finished);
+}
+
+void test_full_and_empty_rejected()
+{
+  ActionStep wait = {T_NONE, 100, 0};
+  for (uint8_t i = 0; i < ACTION_EXEC_JOBS; i++)
+    TEST_ASSERT_TRUE(action_exec_start(exec, i, &wait, 1, nowUs));
+  TEST_ASSERT_FALSE(action_exec_start(exec, 9, &wait, 1, nowUs));
+  TEST_ASSERT_FALSE(action_exec_start(exec, ACTION_EXEC_SINGLE, &wait, 0, nowUs));
+  TEST_ASSERT_EQUAL_UINT32(2, exec.stats.rejected);
+  TEST_ASSERT_EQUAL_UINT32(ACTION_EXEC_JOBS, exec.stats.started);
+
+  run_until(200000);
+  TEST_ASSERT_EQUAL_UINT8(0, exec.active);
+  TEST_ASSERT_EQUAL_UINT32(ACTION_EXEC_IDLE, action_exec_poll(exec, nowUs, step, nullptr));
+  TEST_ASSERT_TRUE(action_exec_start(exec, 9, &wait, 1, nowUs));
+}
+
+void test_instant_steps_limited_per_poll()
+{
+  ActionStep steps[ACTION_EXEC_MAX_STEPS];
+  for (uint8_t i = 0; i < ACTION_EXEC_MAX_STEPS; i++)
+    steps[i] = {T_CLICK, i, 0};
+  TEST_ASSERT_TRUE(action_exec_start(exec, 1, steps, ACTION_EXEC_MAX_STEPS, nowUs));
+  TEST_ASSERT_EQUAL_UINT32(0, action_exec_poll(exec, nowUs, step, nullptr)); // остались шаги — продолжать сразу
+  TEST_ASSERT_EQUAL_UINT32(ACTION_EXEC_STEPS_PER_POLL, callCount);
+
+  run_until(10000);
+  TEST_ASSERT_EQUAL_UINT32(ACTION_EXEC_MAX_STEPS, callCount);
+  TEST_ASSERT_EQUAL_INT16(ACTION_EXEC_MAX_STEPS - 1, calls[callCount - 1].code);
+  TEST_ASSERT_EQUAL_UINT32(1, exec.stats.finished);
+}
+
+int main(int argc, char **argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_key_press_released_after_timer);
+  RUN_TEST(test_script_delay_does_not_block_other_jobs);
+  RUN_TEST(test_concurrent_scripts_interleave);
+  RUN_TEST(test_cancel_releases_held_key);
+  RUN_TEST(test_full_and_empty_rejected);
+  RUN_TEST(test_instant_steps_limited_per_poll);
+  return UNITY_END();
+}
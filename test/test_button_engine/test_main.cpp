@@ -0,0 +1,602 @@
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include "button_engine.h"
+
+#define TICK_MS 10
+static const ButtonTiming timing = {50, 500, 400, 500, TICK_MS}; // как было у GButton в button_fsm
+
+// === Эталон: логика GyverButton 3.8 (tick(state), без tickMode) и прежний цикл button_fsm ===
+struct RefButton
+{
+  uint16_t debounce = 50, timeout = 500, clickTimeout = 400, stepTimeout = 500;
+  uint8_t counter = 0, lastCounter = 0;
+  uint32_t timer = 0;
+  bool state = false, flag = false;
+  bool deb = false, hold = false, step = false, oneClick = false, isOne = false, isHolded = false,
+       isRelease = false, counterFlag = false, counterReset = false;
+
+  void tick(bool s, uint32_t now)
+  {
+    state = s;
+    if (state && !flag)
+    {
+      if (!deb)
+      {
+        deb = true;
+        timer = now;
+      }
+      else if (now - timer >= debounce)
+      {
+        flag = true;
+        oneClick = true;
+      }
+    }
+    else
+      deb = false;
+
+    if (!state && flag)
+    {
+      flag = false;
+      if (!hold)
+        counter++;
+      hold = false;
+      isRelease = true;
+      timer = now;
+      if (step)
+      {
+        lastCounter = 0;
+        counter = 0;
+        step = false;
+      }
+      if (oneClick)
+      {
+        oneClick = false;
+        isOne = true;
+      }
+    }
+
+    if (flag && state && (now - timer >= timeout) && !hold)
+    {
+      hold = true;
+      isHolded = true;
+      step = true;
+      oneClick = false;
+      timer = now;
+    }
+
+    if ((now - timer >= clickTimeout) && counter != 0 && !state)
+    {
+      lastCounter = counter;
+      counter = 0;
+      counterFlag = true;
+    }
+    if (counterReset)
+    {
+      lastCounter = 0;
+      counterFlag = false;
+      counterReset = false;
+    }
+  }
+  bool take(bool &f)
+  {
+    bool r = f;
+    f = false;
+    return r;
+  }
+  bool isDouble()
+  {
+    if (counterFlag && lastCounter == 2)
+    {
+      counterReset = true;
+      return true;
+    }
+    return false;
+  }
+  bool isStep(uint8_t clicks, uint32_t now)
+  {
+    if (counter == clicks && step && (now - timer >= stepTimeout))
+    {
+      timer = now;
+      return true;
+    }
+    return false;
+  }
+};
+
+struct Event
+{
+  uint32_t t;
+  uint8_t key;
+  uint8_t event;
+  uint8_t taps;
+};
+
+#define MAX_EVENTS 20000
+struct EventLog
+{
+  Event e[MAX_EVENTS];
+  uint32_t n;
+  uint32_t now;
+};
+
+static void log_event(void *ctx, uint8_t key, uint8_t event, uint8_t taps)
+{
+  EventLog *log = (EventLog *)ctx;
+  if (log->n < MAX_EVENTS)
+    log->e[log->n++] = {log->now, key, event, taps};
+}
+
+// Для сравнения с эталоном: у GyverButton нет события конца серии из 3+ кликов
+static void log_gyver_event(void *ctx, uint8_t key, uint8_t event, uint8_t taps)
+{
+  if (event != BUTTON_EVENT_TAPS)
+    log_event(ctx, key, event, taps);
+}
+
+static void ref_tick(RefButton *btn, bool *onHold, uint8_t keys, const KeyBits &raw, uint32_t now, EventLog &log)
+{
+  log.now = now;
+  for (uint8_t i = 0; i < keys; i++)
+  {
+    bool pressed = key_bits_test(raw, i);
+    RefButton &b = btn[i];
+    b.tick(pressed, now);
+    if (b.take(b.isOne))
+      log_event(&log, i, BUTTON_EVENT_CLICK, 0);
+    if (b.isDouble())
+      log_event(&log, i, BUTTON_EVENT_DOUBLE, 0);
+    if (pressed)
+    {
+      if (b.take(b.isHolded))
+      {
+        log_event(&log, i, BUTTON_EVENT_HOLD_START, 0);
+        onHold[i] = true;
+      }
+      if (b.isStep(0, now))
+        log_event(&log, i, BUTTON_EVENT_HOLD_REPEAT, 0);
+      if (b.isStep(1, now))
+        log_event(&log, i, BUTTON_EVENT_ONE_CLICK_HOLD, 0);
+    }
+    if (b.take(b.isRelease))
+    {
+      log_event(&log, i, onHold[i] ? BUTTON_EVENT_HOLD_RELEASE : BUTTON_EVENT_RELEASE, 0);
+      onHold[i] = false;
+    }
+  }
+}
+
+// === Сценарии: нажатия одной кнопки по отсчетам ===
+static ButtonEngine engine;
+static EventLog got;
+
+// pattern: '1' — нажата, '0' — отпущена, по отсчету на символ; движок уже настроен
+static void play_pattern(const char *pattern, uint32_t startMs = 1000)
+{
+  got.n = 0;
+  uint32_t now = startMs;
+  KeyBits raw;
+  for (const char *p = pattern; *p; p++, now += TICK_MS)
+  {
+    key_bits_clear(raw);
+    if (*p == '1')
+      key_bits_set(raw, 5);
+    got.now = now;
+    button_engine_tick(engine, raw, now, log_event, &got);
+  }
+}
+
+static void run_pattern(const char *pattern, uint32_t startMs = 1000)
+{
+  button_engine_init(engine, timing, 30);
+  play_pattern(pattern, startMs);
+}
+
+static void repeat(char *buf, char c, int n)
+{
+  size_t len = strlen(buf);
+  memset(buf + len, c, n);
+  buf[len + n] = 0;
+}
+
+static void assert_events(const uint8_t *expected, uint32_t count)
+{
+  TEST_ASSERT_EQUAL_UINT32(count, got.n);
+  for (uint32_t i = 0; i < count; i++)
+  {
+    TEST_ASSERT_EQUAL_UINT8(5, got.e[i].key);
+    TEST_ASSERT_EQUAL_UINT8(expected[i], got.e[i].event);
+  }
+}
+
+void test_click()
+{
+  static char p[256];
+  p[0] = 0;
+  repeat(p, '0', 3);
+  repeat(p, '1', 10);
+  repeat(p, '0', 60);
+  run_pattern(p);
+  const uint8_t expected[] = {BUTTON_EVENT_CLICK, BUTTON_EVENT_RELEASE};
+  assert_events(expected, 2);
+  TEST_ASSERT_EQUAL_UINT8(0, engine.active); // серия закончилась — слот свободен
+}
+
+void test_bounce_ignored()
+{
+  // Короче антидребезга (5 отсчетов < 6) — не нажатие
+  static char p[256];
+  p[0] = 0;
+  repeat(p, '1', 5);
+  repeat(p, '0', 2);
+  repeat(p, '1', 3);
+  repeat(p, '0', 50);
+  run_pattern(p);
+  TEST_ASSERT_EQUAL_UINT32(0, got.n);
+  TEST_ASSERT_EQUAL_UINT8(0, engine.active);
+}
+
+void test_double()
+{
+  static char p[256];
+  p[0] = 0;
+  repeat(p, '1', 8);
+  repeat(p, '0', 10);
+  repeat(p, '1', 8);
+  repeat(p, '0', 50);
+  run_pattern(p);
+  const uint8_t expected[] = {BUTTON_EVENT_CLICK, BUTTON_EVENT_RELEASE, BUTTON_EVENT_CLICK, BUTTON_EVENT_RELEASE,
+                              BUTTON_EVENT_DOUBLE};
+  assert_events(expected, 5);
+  // DOUBLE — через clickTimeoutMs после второго отпускания
+  TEST_ASSERT_EQUAL_UINT32(got.e[3].t + 400, got.e[4].t);
+}
+
+void test_hold_repeat_release()
+{
+  static char p[256];
+  p[0] = 0;
+  repeat(p, '1', 160); // 1.6 с
+  repeat(p, '0', 5);
+  run_pattern(p);
+  const uint8_t expected[] = {BUTTON_EVENT_HOLD_START, BUTTON_EVENT_HOLD_REPEAT, BUTTON_EVENT_HOLD_REPEAT,
+                              BUTTON_EVENT_HOLD_RELEASE};
+  assert_events(expected, 4);
+  TEST_ASSERT_EQUAL_UINT32(1000 + 500, got.e[0].t); // от первого отсчета нажатия
+  TEST_ASSERT_EQUAL_UINT32(got.e[0].t + 500, got.e[1].t);
+  TEST_ASSERT_EQUAL_UINT32(got.e[1].t + 500, got.e[2].t);
+}
+
+void test_one_click_hold()
+{
+  static char p[256];
+  p[0] = 0;
+  repeat(p, '1', 8);
+  repeat(p, '0', 10);
+  repeat(p, '1', 120);
+  repeat(p, '0', 60);
+  run_pattern(p);
+  const uint8_t expected[] = {BUTTON_EVENT_CLICK, BUTTON_EVENT_RELEASE, BUTTON_EVENT_HOLD_START,
+                              BUTTON_EVENT_ONE_CLICK_HOLD, BUTTON_EVENT_HOLD_RELEASE};
+  assert_events(expected, 5); // после удержания серия сброшена — DOUBLE нет
+}
+
+void test_sync_and_overflow()
+{
+  // Нажатые на старте отпускаются одним RELEASE; слоты кончились — тоже только RELEASE
+  button_engine_init(engine, timing, KEY_SNAPSHOT_BITS);
+  got.n = 0;
+  KeyBits raw;
+  key_bits_clear(raw);
+  key_bits_set(raw, 100);
+  button_engine_sync(engine, raw);
+  for (uint8_t k = 0; k < BUTTON_ENGINE_SLOTS + 1; k++)
+    key_bits_set(raw, k);
+  uint32_t now = 0;
+  for (int i = 0; i < 10; i++, now += TICK_MS)
+    button_engine_tick(engine, raw, now, log_event, &got);
+  TEST_ASSERT_EQUAL_UINT8(BUTTON_ENGINE_SLOTS, engine.active);
+  TEST_ASSERT_EQUAL_UINT32(1, engine.overflow);
+  key_bits_clear(raw);
+  button_engine_tick(engine, raw, now, log_event, &got);
+  TEST_ASSERT_EQUAL_UINT32(BUTTON_ENGINE_SLOTS * 2 + 2, got.n); // CLICK+RELEASE для слотов, RELEASE для 2 без слота
+  uint32_t releases = 0;
+  for (uint32_t i = 0; i < got.n; i++)
+    releases += got.e[i].event == BUTTON_EVENT_RELEASE;
+  TEST_ASSERT_EQUAL_UINT32(BUTTON_ENGINE_SLOTS + 2, releases);
+}
+
+void test_taps_and_hold_after_taps()
+{
+  // Три клика: CLICK на каждый (двойного у кнопки нет) и TAPS с числом кликов в конце серии
+  static char p[256];
+  p[0] = 0;
+  for (int i = 0; i < 3; i++)
+  {
+    repeat(p, '1', 8);
+    repeat(p, '0', 10);
+  }
+  repeat(p, '0', 40);
+  run_pattern(p);
+  const uint8_t expected[] = {BUTTON_EVENT_CLICK, BUTTON_EVENT_RELEASE, BUTTON_EVENT_CLICK, BUTTON_EVENT_RELEASE,
+                              BUTTON_EVENT_CLICK, BUTTON_EVENT_RELEASE, BUTTON_EVENT_TAPS};
+  assert_events(expected, 7);
+  TEST_ASSERT_EQUAL_UINT8(3, got.e[6].taps);
+  TEST_ASSERT_EQUAL_UINT32(got.e[5].t + 400, got.e[6].t);
+
+  // Два клика и удержание: HOLD_START знает число кликов, DOUBLE и TAPS нет
+  p[0] = 0;
+  repeat(p, '1', 8);
+  repeat(p, '0', 10);
+  repeat(p, '1', 8);
+  repeat(p, '0', 10);
+  repeat(p, '1', 60);
+  repeat(p, '0', 60);
+  run_pattern(p);
+  const uint8_t held[] = {BUTTON_EVENT_CLICK, BUTTON_EVENT_RELEASE, BUTTON_EVENT_CLICK, BUTTON_EVENT_RELEASE,
+                          BUTTON_EVENT_HOLD_START, BUTTON_EVENT_HOLD_RELEASE};
+  assert_events(held, 6);
+  TEST_ASSERT_EQUAL_UINT8(2, got.e[4].taps);
+}
+
+// === Отложенный клик и времена по кнопке ===
+static void init_deferred()
+{
+  button_engine_init(engine, timing, 30);
+  KeyBits defer;
+  key_bits_clear(defer);
+  key_bits_set(defer, 5);
+  button_engine_set_defer_click(engine, defer);
+}
+
+void test_deferred_click()
+{
+  // У кнопки есть двойной клик: CLICK — только когда второго клика уже не будет
+  static char p[256];
+  p[0] = 0;
+  repeat(p, '1', 10);
+  repeat(p, '0', 60);
+  init_deferred();
+  play_pattern(p);
+  const uint8_t expected[] = {BUTTON_EVENT_RELEASE, BUTTON_EVENT_CLICK};
+  assert_events(expected, 2);
+  TEST_ASSERT_EQUAL_UINT32(got.e[0].t + 400, got.e[1].t);
+}
+
+void test_deferred_double_without_click()
+{
+  static char p[256];
+  p[0] = 0;
+  repeat(p, '1', 8);
+  repeat(p, '0', 10);
+  repeat(p, '1', 8);
+  repeat(p, '0', 50);
+  init_deferred();
+  play_pattern(p);
+  const uint8_t expected[] = {BUTTON_EVENT_RELEASE, BUTTON_EVENT_RELEASE, BUTTON_EVENT_DOUBLE};
+  assert_events(expected, 3);
+
+  // Клик + удержание: отложенного CLICK нет, серия закончилась удержанием
+  p[0] = 0;
+  repeat(p, '1', 8);
+  repeat(p, '0', 10);
+  repeat(p, '1', 120);
+  repeat(p, '0', 60);
+  init_deferred();
+  play_pattern(p);
+  const uint8_t held[] = {BUTTON_EVENT_RELEASE, BUTTON_EVENT_HOLD_START, BUTTON_EVENT_ONE_CLICK_HOLD,
+                          BUTTON_EVENT_HOLD_RELEASE};
+  assert_events(held, 4);
+}
+
+void test_per_key_timing()
+{
+  static ButtonKeyTiming keyTiming[30];
+  memset(keyTiming, 0, sizeof(keyTiming));
+  keyTiming[5] = {20, 300, 150};
+
+  // 3 отсчета проходят антидребезг 20 мс (общий 50 мс их бы отбросил)
+  static char p[256];
+  p[0] = 0;
+  repeat(p, '1', 3);
+  repeat(p, '0', 20);
+  button_engine_init(engine, timing, 30);
+  button_engine_set_key_timing(engine, keyTiming);
+  play_pattern(p);
+  const uint8_t click[] = {BUTTON_EVENT_CLICK, BUTTON_EVENT_RELEASE};
+  assert_events(click, 2);
+
+  // Удержание через 300 мс, DOUBLE через 150 мс после отпускания
+  p[0] = 0;
+  repeat(p, '1', 40);
+  repeat(p, '0', 5);
+  play_pattern(p);
+  TEST_ASSERT_EQUAL_UINT8(BUTTON_EVENT_HOLD_START, got.e[0].event);
+  TEST_ASSERT_EQUAL_UINT32(1000 + 300, got.e[0].t);
+
+  p[0] = 0;
+  repeat(p, '1', 5);
+  repeat(p, '0', 5);
+  repeat(p, '1', 5);
+  repeat(p, '0', 20);
+  play_pattern(p);
+  TEST_ASSERT_EQUAL_UINT32(5, got.n);
+  TEST_ASSERT_EQUAL_UINT8(BUTTON_EVENT_DOUBLE, got.e[4].event);
+  TEST_ASSERT_EQUAL_UINT32(got.e[3].t + 150, got.e[4].t);
+
+  // Остальные кнопки — с общими временами
+  keyTiming[5] = {0, 0, 0};
+  button_engine_set_key_timing(engine, keyTiming);
+  p[0] = 0;
+  repeat(p, '1', 3);
+  repeat(p, '0', 20);
+  play_pattern(p);
+  TEST_ASSERT_EQUAL_UINT32(0, got.n);
+}
+
+// === Случайные трассы: поток событий совпадает с эталоном по кнопке, событию и времени ===
+static uint32_t rng = 2024;
+static uint32_t next_rand(uint32_t n)
+{
+  rng = rng * 1664525u + 1013904223u;
+  return (rng >> 8) % n;
+}
+
+// Человек: клики, двойные, удержания, дребезг в начале и конце нажатия
+struct HumanKey
+{
+  uint32_t untilMs;
+  bool down;
+};
+
+static void human_step(HumanKey &h, uint32_t now)
+{
+  if (now < h.untilMs)
+    return;
+  h.down = !h.down;
+  uint32_t r = next_rand(100);
+  if (h.down)
+    h.untilMs = now + (r < 10 ? 10 + next_rand(40) : r < 60 ? 60 + next_rand(200) : r < 85 ? 400 + next_rand(300) : 800 + next_rand(2000));
+  else
+    h.untilMs = now + (r < 10 ? 10 + next_rand(30) : r < 50 ? 80 + next_rand(300) : 400 + next_rand(3000));
+}
+
+static EventLog expected;
+static RefButton refButtons[KEY_SNAPSHOT_BITS];
+static bool refHold[KEY_SNAPSHOT_BITS];
+
+void test_matches_gyverbutton_traces()
+{
+  const uint8_t keys = 30;
+  const uint8_t pressers = 6; // одновременно нажатых не больше, чем слотов
+  static HumanKey humans[pressers];
+  uint8_t humanKey[pressers];
+  uint32_t totalEvents = 0;
+  for (uint32_t trace = 0; trace < 20; trace++)
+  {
+    button_engine_init(engine, timing, 30);
+    for (uint8_t i = 0; i < keys; i++)
+    {
+      refButtons[i] = RefButton();
+      refHold[i] = false;
+    }
+    for (uint8_t h = 0; h < pressers; h++)
+    {
+      humans[h] = {next_rand(500), false};
+      humanKey[h] = (uint8_t)(h * 5 + next_rand(5)); // разные кнопки
+    }
+    got.n = expected.n = 0;
+    uint32_t now = 100000 * trace + next_rand(1000);
+    for (uint32_t tick = 0; tick < 6000; tick++, now += TICK_MS)
+    {
+      KeyBits raw;
+      key_bits_clear(raw);
+      for (uint8_t h = 0; h < pressers; h++)
+      {
+        human_step(humans[h], now);
+        if (humans[h].down)
+          key_bits_set(raw, humanKey[h]);
+      }
+      ref_tick(refButtons, refHold, keys, raw, now, expected);
+      got.now = now;
+      button_engine_tick(engine, raw, now, log_gyver_event, &got);
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, engine.overflow);
+    TEST_ASSERT_EQUAL_UINT32(expected.n, got.n);
+    for (uint32_t i = 0; i < expected.n; i++)
+    {
+      char msg[96];
+      snprintf(msg, sizeof(msg), "trace %u event %u: t=%u key=%u ev=%u", trace, i, expected.e[i].t, expected.e[i].key,
+               expected.e[i].event);
+      TEST_ASSERT_EQUAL_UINT32_MESSAGE(expected.e[i].t, got.e[i].t, msg);
+      TEST_ASSERT_EQUAL_UINT8_MESSAGE(expected.e[i].key, got.e[i].key, msg);
+      TEST_ASSERT_EQUAL_UINT8_MESSAGE(expected.e[i].event, got.e[i].event, msg);
+    }
+    totalEvents += expected.n;
+  }
+  char msg[64];
+  snprintf(msg, sizeof(msg), "%u events over 20 traces x 60 s match", totalEvents);
+  TEST_MESSAGE(msg);
+}
+
+// === Стоимость отсчета и память: 30 экземпляров эталона против одного движка ===
+static void noop_event(void *ctx, uint8_t key, uint8_t event, uint8_t taps)
+{
+  if (event != BUTTON_EVENT_TAPS)
+    (*(uint32_t *)ctx)++;
+}
+
+static void ref_tick_noop(RefButton *btn, bool *onHold, uint8_t keys, const KeyBits &raw, uint32_t now, uint32_t &events)
+{
+  for (uint8_t i = 0; i < keys; i++)
+  {
+    bool pressed = key_bits_test(raw, i);
+    RefButton &b = btn[i];
+    b.tick(pressed, now);
+    events += b.take(b.isOne) + b.isDouble();
+    if (pressed)
+      events += b.take(b.isHolded) + b.isStep(0, now) + b.isStep(1, now);
+    events += b.take(b.isRelease);
+  }
+}
+
+static void bench(const char *name, uint8_t activeKeys)
+{
+  const uint8_t keys = 30;
+  const uint32_t ticks = 200000;
+  for (uint8_t i = 0; i < keys; i++)
+    refButtons[i] = RefButton();
+  button_engine_init(engine, timing, 30);
+  // Нажатые кнопки удерживаются, остальные отпущены
+  KeyBits raw;
+  key_bits_clear(raw);
+  for (uint8_t i = 0; i < activeKeys; i++)
+    key_bits_set(raw, i * 7 % keys);
+
+  uint32_t refEvents = 0, events = 0;
+  auto t0 = std::chrono::steady_clock::now();
+  for (uint32_t n = 0; n < ticks; n++)
+    ref_tick_noop(refButtons, refHold, keys, raw, n * TICK_MS, refEvents);
+  auto t1 = std::chrono::steady_clock::now();
+  for (uint32_t n = 0; n < ticks; n++)
+    button_engine_tick(engine, raw, n * TICK_MS, noop_event, &events);
+  auto t2 = std::chrono::steady_clock::now();
+
+  double refNs = std::chrono::duration<double, std::nano>(t1 - t0).count() / ticks;
+  double engNs = std::chrono::duration<double, std::nano>(t2 - t1).count() / ticks;
+  char msg[128];
+  snprintf(msg, sizeof(msg), "%s: 30 x GButton %.1f ns/tick, engine %.1f ns/tick (x%.1f), events %u/%u", name, refNs,
+           engNs, refNs / engNs, refEvents, events);
+  TEST_MESSAGE(msg);
+  TEST_ASSERT_EQUAL_UINT32(refEvents, events);
+}
+
+void test_benchmark()
+{
+  bench("idle    ", 0);
+  bench("1 held  ", 1);
+  bench("4 held  ", 4);
+  char msg[96];
+  snprintf(msg, sizeof(msg), "RAM: 30 x GButton-like %u B + onHold 30 B, engine %u B",
+           (unsigned)(30 * sizeof(RefButton)), (unsigned)sizeof(ButtonEngine));
+  TEST_MESSAGE(msg);
+}
+
+int main(int argc, char **argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_click);
+  RUN_TEST(test_bounce_ignored);
+  RUN_TEST(test_double);
+  RUN_TEST(test_hold_repeat_release);
+  RUN_TEST(test_one_click_hold);
+  RUN_TEST(test_sync_and_overflow);
+  RUN_TEST(test_taps_and_hold_after_taps);
+  RUN_TEST(test_deferred_click);
+  RUN_TEST(test_deferred_double_without_click);
+  RUN_TEST(test_per_key_timing);
+  RUN_TEST(test_matches_gyverbutton_traces);
+  RUN_TEST(test_benchmark);
+  return UNITY_END();
+}
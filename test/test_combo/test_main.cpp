@@ -0,0 +1,269 @@
+#include <unity.h>
+#include <string.h>
+#include "button_engine.h"
+#include "combo.h"
+
+#define TICK_MS 10
+#define KEYS 30
+static const ButtonTiming timing = {50, 500, 400, 500, TICK_MS};
+
+struct Edge
+{
+  uint32_t t;
+  uint8_t key;
+  bool down;
+};
+
+// Что выполнилось бы: сочетание (code) или действие кнопки (event)
+struct Fired
+{
+  uint32_t t;
+  uint8_t key;
+  int16_t comboCode; // -1 — событие кнопки
+  uint8_t event;
+};
+
+static ComboConfig cfg;
+static ComboTable table;
+static ComboMatcher matcher;
+static ButtonEngine engine;
+static Fired fired[64];
+static uint32_t firedCount;
+static uint32_t nowMs;
+static uint8_t layer;
+
+static void on_event(void *ctx, uint8_t key, uint8_t event, uint8_t taps)
+{
+  if (combo_consumed(matcher, key))
+    return;
+  if (firedCount < 64)
+    fired[firedCount++] = {nowMs, key, -1, event};
+}
+
+// Как в update_button_fsm: движок, затем сочетания по нажатым после антидребезга
+static void play(const Edge *edges, uint8_t count, uint32_t endMs, const ButtonKeyTiming *keyTiming = nullptr)
+{
+  combo_compile(cfg, table);
+  combo_matcher_init(matcher);
+  button_engine_init(engine, timing, KEYS);
+  button_engine_set_key_timing(engine, keyTiming);
+  firedCount = 0;
+
+  KeyBits raw;
+  key_bits_clear(raw);
+  uint8_t next = 0;
+  for (nowMs = 0; nowMs <= endMs; nowMs += TICK_MS)
+  {
+    for (; next < count && edges[next].t <= nowMs; next++)
+    {
+      if (edges[next].down)
+        key_bits_set(raw, edges[next].key);
+      else
+        key_bits_clear_bit(raw, edges[next].key);
+    }
+    button_engine_tick(engine, raw, nowMs, on_event, nullptr);
+    const ComboEntry *combo = combo_tick(table, matcher, engine.state, layer, nowMs);
+    if (combo)
+    {
+      button_engine_cancel(engine, matcher.consumed);
+      if (firedCount < 64)
+        fired[firedCount++] = {nowMs, 0xFF, combo->code, 0};
+    }
+  }
+}
+
+static void add(uint8_t l, uint8_t a, uint8_t b, uint8_t c, int16_t code)
+{
+  TEST_ASSERT_TRUE(cfg.count < COMBO_MAX);
+  cfg.entries[cfg.count++] = {l, {a, b, c, COMBO_NO_KEY}, 7, code, 0};
+}
+
+static uint32_t count_key_events(uint8_t key)
+{
+  uint32_t n = 0;
+  for (uint32_t i = 0; i < firedCount; i++)
+    n += fired[i].comboCode < 0 && fired[i].key == key;
+  return n;
+}
+
+static const Fired *find_combo(int16_t code)
+{
+  for (uint32_t i = 0; i < firedCount; i++)
+    if (fired[i].comboCode == code)
+      return &fired[i];
+  return nullptr;
+}
+
+void setUp()
+{
+  memset(&cfg, 0, sizeof(cfg));
+  cfg.windowMs = 50;
+  layer = 0;
+}
+
+void tearDown() {}
+
+void test_compile_groups_by_lowest_key()
+{
+  add(COMBO_ANY_LAYER, 2, 1, COMBO_NO_KEY, 12);
+  add(0, 3, 1, COMBO_NO_KEY, 13);
+  add(0, 5, 2, COMBO_NO_KEY, 25);
+  add(1, 7, 6, 4, 467);
+  add(0, 1, 2, COMBO_NO_KEY, 120);
+  TEST_ASSERT_TRUE(combo_config_valid(cfg, KEYS));
+  combo_compile(cfg, table);
+  TEST_ASSERT_EQUAL_UINT8(5, table.count);
+
+  uint8_t n;
+  uint8_t i = combo_candidates(table, 1, n);
+  TEST_ASSERT_EQUAL_UINT8(3, n);
+  TEST_ASSERT_EQUAL_INT16(12, table.entries[i + 2].code); // общий для всех слоев — после сочетаний слоя
+  combo_candidates(table, 2, n);
+  TEST_ASSERT_EQUAL_UINT8(1, n);
+  i = combo_candidates(table, 4, n);
+  TEST_ASSERT_EQUAL_UINT8(1, n);
+  TEST_ASSERT_EQUAL_INT16(467, table.entries[i].code);
+  combo_candidates(table, 3, n);
+  TEST_ASSERT_EQUAL_UINT8(0, n);
+  combo_candidates(table, 200, n);
+  TEST_ASSERT_EQUAL_UINT8(0, n);
+  TEST_ASSERT_EQUAL_UINT32((1u << 1) | (1u << 2) | (1u << 3) | (1u << 4) | (1u << 5) | (1u << 6) | (1u << 7),
+                           table.members.w[0]);
+}
+
+void test_validation()
+{
+  ComboEntry one = {0, {1, COMBO_NO_KEY, COMBO_NO_KEY, COMBO_NO_KEY}, 7, 0, 0};
+  ComboEntry dup = {0, {1, 1, COMBO_NO_KEY, COMBO_NO_KEY}, 7, 0, 0};
+  ComboEntry range = {0, {1, KEYS, COMBO_NO_KEY, COMBO_NO_KEY}, 7, 0, 0};
+  ComboEntry none = {0, {1, 2, COMBO_NO_KEY, COMBO_NO_KEY}, 0, 0, 0};
+  ComboEntry ok = {0, {1, 2, 3, 4}, 7, 0, 0};
+  TEST_ASSERT_FALSE(combo_entry_valid(one, KEYS));
+  TEST_ASSERT_FALSE(combo_entry_valid(dup, KEYS));
+  TEST_ASSERT_FALSE(combo_entry_valid(range, KEYS));
+  TEST_ASSERT_FALSE(combo_entry_valid(none, KEYS));
+  TEST_ASSERT_TRUE(combo_entry_valid(ok, KEYS));
+
+  cfg.windowMs = COMBO_WINDOW_MAX_MS + 1;
+  TEST_ASSERT_FALSE(combo_config_valid(cfg, KEYS));
+  cfg.windowMs = COMBO_WINDOW_MIN_MS;
+  TEST_ASSERT_TRUE(combo_config_valid(cfg, KEYS));
+}
+
+void test_window_must_be_shorter_than_hold()
+{
+  // Кнопка 1 в сочетании, удержание 150 мс, антидребезг 50: окно 200 мс дало бы HOLD_START до сочетания
+  ButtonKeyTiming keyTiming[KEYS] = {};
+  keyTiming[1].holdMs = 150;
+  cfg.count = 1;
+  cfg.entries[0] = {0, {1, 2, COMBO_NO_KEY, COMBO_NO_KEY}, 7, 0, 0};
+  cfg.windowMs = 200;
+  TEST_ASSERT_TRUE(combo_config_valid(cfg, KEYS));
+  TEST_ASSERT_FALSE(combo_window_fits_hold(cfg, keyTiming, 500, 50));
+  cfg.windowMs = 100; // удержание считается от касания: окно + антидребезг
+  TEST_ASSERT_FALSE(combo_window_fits_hold(cfg, keyTiming, 500, 50));
+  cfg.windowMs = 90;
+  TEST_ASSERT_TRUE(combo_window_fits_hold(cfg, keyTiming, 500, 50));
+  // Общие удержание и антидребезг — для кнопок без своих
+  TEST_ASSERT_FALSE(combo_window_fits_hold(cfg, keyTiming, 140, 50));
+  keyTiming[1].debounceMs = 70;
+  TEST_ASSERT_FALSE(combo_window_fits_hold(cfg, keyTiming, 500, 50));
+  keyTiming[1].debounceMs = 0;
+
+  // В движке: при окне 200 вторая кнопка на 180 мс опаздывает — кнопка 1 уже дала HOLD_START
+  cfg.entries[0].code = 42;
+  static const Edge late[] = {{0, 1, true}, {180, 2, true}, {400, 1, false}, {400, 2, false}};
+  cfg.windowMs = 200;
+  play(late, 4, 1000, keyTiming);
+  TEST_ASSERT_GREATER_THAN(0, count_key_events(1));
+  // Окно 90 проходит проверку: сочетание собирается до HOLD_START, кнопки молчат
+  static const Edge inWindow[] = {{0, 1, true}, {90, 2, true}, {400, 1, false}, {400, 2, false}};
+  cfg.windowMs = 90;
+  play(inWindow, 4, 1000, keyTiming);
+  TEST_ASSERT_EQUAL_UINT32(1, firedCount);
+  TEST_ASSERT_EQUAL_INT16(42, fired[0].comboCode);
+
+  // Кнопки вне сочетаний не ограничивают окно
+  keyTiming[1].holdMs = 0;
+  keyTiming[5].holdMs = 100;
+  TEST_ASSERT_TRUE(combo_window_fits_hold(cfg, keyTiming, 500, 50));
+}
+
+void test_chord_within_window_any_order()
+{
+  add(0, 3, 8, COMBO_NO_KEY, 38);
+  Edge edges[] = {{100, 8, true}, {130, 3, true}, {300, 3, false}, {320, 8, false}};
+  play(edges, 4, 1500);
+  const Fired *f = find_combo(38);
+  TEST_ASSERT_NOT_NULL(f);
+  // Вторая кнопка засчитана после антидребезга (6 отсчетов)
+  TEST_ASSERT_EQUAL_UINT32(130 + 50, f->t);
+  // Действия кнопок поглощены: ни CLICK, ни RELEASE, ни отложенного клика
+  TEST_ASSERT_EQUAL_UINT32(0, count_key_events(3));
+  TEST_ASSERT_EQUAL_UINT32(0, count_key_events(8));
+  TEST_ASSERT_EQUAL_UINT32(1, matcher.fired);
+}
+
+void test_outside_window_keys_act_alone()
+{
+  add(0, 3, 8, COMBO_NO_KEY, 38);
+  Edge edges[] = {{100, 3, true}, {200, 8, true}, {300, 3, false}, {320, 8, false}};
+  play(edges, 4, 1500);
+  TEST_ASSERT_NULL(find_combo(38));
+  TEST_ASSERT_EQUAL_UINT32(2, count_key_events(3)); // CLICK + RELEASE
+  TEST_ASSERT_EQUAL_UINT32(2, count_key_events(8));
+}
+
+void test_held_combo_suppresses_hold_and_next_press_is_normal()
+{
+  add(COMBO_ANY_LAYER, 3, 8, 9, 389);
+  Edge edges[] = {{100, 3, true}, {110, 8, true}, {120, 9, true},   {1500, 3, false},
+                  {1500, 8, false}, {1500, 9, false}, {2000, 3, true}, {2100, 3, false}};
+  layer = 2;
+  play(edges, 8, 3000);
+  TEST_ASSERT_NOT_NULL(find_combo(389));
+  TEST_ASSERT_EQUAL_UINT32(0, count_key_events(8));
+  TEST_ASSERT_EQUAL_UINT32(0, count_key_events(9));
+  // Удержание 1.4 с внутри сочетания событий не дало; следующее нажатие 3 — обычный клик
+  TEST_ASSERT_EQUAL_UINT32(2, count_key_events(3));
+  TEST_ASSERT_EQUAL_UINT8(BUTTON_EVENT_CLICK, fired[1].event);
+  TEST_ASSERT_EQUAL_UINT8(0, engine.active);
+}
+
+void test_subset_or_other_layer_does_not_fire()
+{
+  add(1, 3, 8, COMBO_NO_KEY, 38);
+  add(0, 3, 8, 9, 389);
+  Edge edges[] = {{100, 3, true}, {120, 8, true}, {300, 3, false}, {300, 8, false}};
+  play(edges, 4, 1500); // слой 0: {3, 8} есть только на слое 1, {3, 8, 9} не нажато целиком
+  TEST_ASSERT_EQUAL_UINT32(0, matcher.fired);
+  TEST_ASSERT_EQUAL_UINT32(2, count_key_events(3));
+
+  layer = 1;
+  play(edges, 4, 1500);
+  TEST_ASSERT_NOT_NULL(find_combo(38));
+}
+
+void test_non_member_keys_ignored()
+{
+  add(0, 3, 8, COMBO_NO_KEY, 38);
+  // Кнопка 5 не входит в сочетания: не мешает окну и работает как обычно
+  Edge edges[] = {{100, 3, true}, {110, 5, true}, {120, 8, true}, {300, 3, false}, {300, 8, false}, {300, 5, false}};
+  play(edges, 6, 1500);
+  TEST_ASSERT_NOT_NULL(find_combo(38));
+  TEST_ASSERT_EQUAL_UINT32(2, count_key_events(5));
+}
+
+int main(int argc, char **argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_compile_groups_by_lowest_key);
+  RUN_TEST(test_validation);
+  RUN_TEST(test_window_must_be_shorter_than_hold);
+  RUN_TEST(test_chord_within_window_any_order);
+  RUN_TEST(test_outside_window_keys_act_alone);
+  RUN_TEST(test_held_combo_suppresses_hold_and_next_press_is_normal);
+  RUN_TEST(test_subset_or_other_layer_does_not_fire);
+  RUN_TEST(test_non_member_keys_ignored);
+  return UNITY_END();
+}
@@ -0,0 +1,220 @@
+#include <unity.h>
+#include <math.h>
+#include <stdio.h>
+#include <chrono>
+#include <functional>
+#include "gesture.h"
+
+#define PERIOD_US 5000
+#define PI_F 3.14159265f
+
+static uint32_t rng_state = 4242;
+static float noise(float amplitude)
+{
+  rng_state = rng_state * 1664525u + 1013904223u;
+  return ((int32_t)(rng_state >> 8) % 2001 - 1000) / 1000.0f * amplitude;
+}
+
+static GestureConfig default_config()
+{
+  GestureConfig cfg = {250.0f, 150000, 250000, 4, 1200000, 120.0f, 60.0f, 600000, 1000000, 25.0f, 1500000, 400000};
+  return cfg;
+}
+
+// Полуволна синуса: 0 -> peak -> 0 за durationUs
+static float half_sine(uint32_t t, uint32_t startUs, uint32_t durationUs, float peak)
+{
+  if (t < startUs || t >= startUs + durationUs)
+    return 0;
+  return peak * sinf(PI_F * (t - startUs) / durationUs);
+}
+
+typedef std::function<GestureInput(uint32_t)> Scenario;
+
+struct Counts
+{
+  uint32_t total;
+  uint32_t by[GESTURE_COUNT];
+  uint8_t first;
+};
+
+static Counts run(const Scenario &scenario, uint32_t durationUs)
+{
+  GestureRecognizer g;
+  gesture_init(g, default_config());
+  Counts c = {};
+  c.first = GESTURE_NONE;
+  for (uint32_t t = 0; t < durationUs; t += PERIOD_US)
+  {
+    uint8_t gesture = gesture_update(g, scenario(t), PERIOD_US);
+    if (gesture != GESTURE_NONE)
+    {
+      if (c.first == GESTURE_NONE)
+        c.first = gesture;
+      c.by[gesture]++;
+      c.total++;
+    }
+  }
+  return c;
+}
+
+static GestureInput moving(float yaw, float pitch, float roll)
+{
+  GestureInput in = {yaw + noise(2.0f), pitch + noise(2.0f), roll + noise(2.0f), false};
+  return in;
+}
+
+// === Жесты ===
+
+void test_flick_right_with_slow_return()
+{
+  Counts c = run([](uint32_t t)
+                 { return moving(half_sine(t, 200000, 80000, -450.0f) + half_sine(t, 300000, 400000, 90.0f), 0, 0); },
+                 1500000);
+  TEST_ASSERT_EQUAL_UINT32(1, c.total);
+  TEST_ASSERT_EQUAL_UINT8(GESTURE_FLICK_RIGHT, c.first);
+}
+
+void test_flick_left_with_fast_return()
+{
+  // Возврат тоже выше порога: два всплеска, но это все еще взмах
+  Counts c = run([](uint32_t t)
+                 { return moving(half_sine(t, 200000, 80000, 450.0f) + half_sine(t, 300000, 120000, -300.0f), 10.0f, 0); },
+                 1500000);
+  TEST_ASSERT_EQUAL_UINT32(1, c.total);
+  TEST_ASSERT_EQUAL_UINT8(GESTURE_FLICK_LEFT, c.first);
+}
+
+void test_shake()
+{
+  Counts c = run([](uint32_t t)
+                 {
+                   float yaw = 0;
+                   for (int i = 0; i < 6; i++)
+                     yaw += half_sine(t, 200000 + i * 110000, 110000, i % 2 ? -380.0f : 380.0f);
+                   return moving(yaw, 0, 30.0f); },
+                 2000000);
+  TEST_ASSERT_EQUAL_UINT32(1, c.total);
+  TEST_ASSERT_EQUAL_UINT8(GESTURE_SHAKE, c.first);
+}
+
+void test_twist()
+{
+  Counts c = run([](uint32_t t)
+                 { return moving(20.0f, 0, half_sine(t, 200000, 400000, 300.0f)); },
+                 1200000);
+  TEST_ASSERT_EQUAL_UINT32(1, c.total);
+  TEST_ASSERT_EQUAL_UINT8(GESTURE_TWIST, c.first);
+}
+
+void test_raise_after_rest()
+{
+  Counts c = run([](uint32_t t)
+                 {
+                   if (t < 2000000)
+                   {
+                     GestureInput in = {noise(0.3f), noise(0.3f), noise(0.3f), true};
+                     return in;
+                   }
+                   return moving(15.0f, half_sine(t, 2000000, 800000, 90.0f), 0); },
+                 3500000);
+  TEST_ASSERT_EQUAL_UINT32(1, c.total);
+  TEST_ASSERT_EQUAL_UINT8(GESTURE_RAISE, c.first);
+}
+
+// === Ложные срабатывания: обычное использование, минута на сценарий ===
+#define FP_DURATION_US 60000000UL
+
+static void expect_no_gestures(const char *name, const Scenario &scenario)
+{
+  Counts c = run(scenario, FP_DURATION_US);
+  char msg[160];
+  snprintf(msg, sizeof(msg), "%s: %u false positives/min (flick %u/%u, shake %u, twist %u, raise %u)", name, (unsigned)c.total,
+           (unsigned)c.by[GESTURE_FLICK_LEFT], (unsigned)c.by[GESTURE_FLICK_RIGHT], (unsigned)c.by[GESTURE_SHAKE],
+           (unsigned)c.by[GESTURE_TWIST], (unsigned)c.by[GESTURE_RAISE]);
+  TEST_MESSAGE(msg);
+  TEST_ASSERT_EQUAL_UINT32(0, c.total);
+}
+
+void test_no_gestures_while_pointing()
+{
+  // Ведение курсора: плавные повороты до 180 град/с
+  expect_no_gestures("pointing", [](uint32_t t)
+                     {
+                       float s = t * 1e-6f;
+                       return moving(180.0f * sinf(s * 2.1f) * sinf(s * 0.37f), 90.0f * sinf(s * 1.3f), 25.0f * sinf(s * 0.8f)); });
+}
+
+void test_no_gestures_on_fast_sweeps()
+{
+  // Быстрые, но длинные переводы курсора через экран туда и обратно раз в секунду
+  expect_no_gestures("sweeps", [](uint32_t t)
+                     {
+                       uint32_t phase = t % 2000000;
+                       float yaw = half_sine(phase, 0, 400000, 320.0f) + half_sine(phase, 1000000, 400000, -320.0f);
+                       return moving(yaw, 0, 0); });
+}
+
+void test_no_gestures_on_tremor_and_walking()
+{
+  expect_no_gestures("tremor", [](uint32_t t)
+                     {
+                       float s = t * 1e-6f;
+                       return moving(20.0f * sinf(s * 2 * PI_F * 9.0f), 15.0f * sinf(s * 2 * PI_F * 8.3f), 20.0f * sinf(s * 2 * PI_F * 10.0f)); });
+  expect_no_gestures("walking", [](uint32_t t)
+                     {
+                       float s = t * 1e-6f;
+                       return moving(40.0f * sinf(s * 2 * PI_F * 1.8f), 60.0f * sinf(s * 2 * PI_F * 2.0f), 45.0f * sinf(s * 2 * PI_F * 1.0f)); });
+}
+
+void test_no_raise_on_flat_pickup()
+{
+  // Пульт взяли со стола, но не направили вверх; затем снова положили
+  expect_no_gestures("flat pickup", [](uint32_t t)
+                     {
+                       uint32_t phase = t % 6000000;
+                       if (phase < 3000000)
+                       {
+                         GestureInput in = {0, 0, 0, true};
+                         return in;
+                       }
+                       float s = phase * 1e-6f;
+                       return moving(60.0f * sinf(s * 3.0f), 12.0f * sinf(s * 2.0f), 0); });
+}
+
+void test_benchmark()
+{
+  GestureRecognizer g;
+  gesture_init(g, default_config());
+  const uint32_t samples = 1000000;
+  volatile uint32_t sink = 0;
+  auto t0 = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < samples; i++)
+  {
+    float s = i * 0.005f;
+    GestureInput in = {300.0f * sinf(s * 7.0f), 50.0f * sinf(s * 3.0f), 140.0f * sinf(s * 5.0f), (i / 1000) % 5 == 0};
+    sink += gesture_update(g, in, PERIOD_US);
+  }
+  auto t1 = std::chrono::steady_clock::now();
+  double ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / samples;
+  char msg[96];
+  snprintf(msg, sizeof(msg), "gesture_update: %.1f ns/sample (incl. sinf input generation)", ns);
+  TEST_MESSAGE(msg);
+  (void)sink;
+}
+
+int main(int argc, char **argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_flick_right_with_slow_return);
+  RUN_TEST(test_flick_left_with_fast_return);
+  RUN_TEST(test_shake);
+  RUN_TEST(test_twist);
+  RUN_TEST(test_raise_after_rest);
+  RUN_TEST(test_no_gestures_while_pointing);
+  RUN_TEST(test_no_gestures_on_fast_sweeps);
+  RUN_TEST(test_no_gestures_on_tremor_and_walking);
+  RUN_TEST(test_no_raise_on_flat_pickup);
+  RUN_TEST(test_benchmark);
+  return UNITY_END();
+}
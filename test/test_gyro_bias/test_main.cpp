@@ -0,0 +1,129 @@
+#include <unity.h>
+#include <math.h>
+#include "gyro_bias.h"
+
+static uint32_t rng_state = 777;
+static float noise(float amplitude)
+{
+  rng_state = rng_state * 1664525u + 1013904223u;
+  return ((int32_t)(rng_state >> 8) % 2001 - 1000) / 1000.0f * amplitude;
+}
+
+static GyroBiasModel model_at(float bx, float by, float bz, float temp)
+{
+  GyroBiasModel m = {{bx, by, bz}, temp, {0, 0, 0}};
+  return m;
+}
+
+// Блок отсчетов: истинное смещение + вращение + шум датчика
+static bool feed_block(GyroBiasTracker &t, const float bias[3], float rate, float temp)
+{
+  bool accepted = false;
+  for (int i = 0; i < GYRO_BIAS_BLOCK; i++)
+  {
+    float g[3] = {bias[0] + rate + noise(0.1f), bias[1] + noise(0.1f), bias[2] + noise(0.1f)};
+    accepted |= gyro_bias_update(t, g, temp);
+  }
+  return accepted;
+}
+
+void test_converges_while_still()
+{
+  GyroBiasTracker t;
+  gyro_bias_init(t, model_at(0, 0, 0, 30.0f));
+  const float real[3] = {0.6f, -0.4f, 0.2f};
+  for (int b = 0; b < 60; b++)
+    TEST_ASSERT_TRUE(feed_block(t, real, 0, 30.0f));
+
+  float out[3];
+  gyro_bias_get(t, 30.0f, out);
+  for (int i = 0; i < 3; i++)
+    TEST_ASSERT_FLOAT_WITHIN(0.02f, real[i], out[i]);
+  TEST_ASSERT_EQUAL_UINT32(60, t.acceptedBlocks);
+}
+
+void test_rejects_motion()
+{
+  GyroBiasTracker t;
+  gyro_bias_init(t, model_at(0.5f, 0, 0, 30.0f));
+  const float real[3] = {0.5f, 0, 0};
+
+  // Медленный равномерный поворот: дисперсия мала, но среднее далеко от смещения
+  TEST_ASSERT_FALSE(feed_block(t, real, 5.0f, 30.0f));
+
+  // Дрожание руки: большая дисперсия
+  bool accepted = false;
+  for (int i = 0; i < GYRO_BIAS_BLOCK; i++)
+  {
+    float g[3] = {0.5f + ((i & 1) ? 3.0f : -3.0f), 0, 0};
+    accepted |= gyro_bias_update(t, g, 30.0f);
+  }
+  TEST_ASSERT_FALSE(accepted);
+
+  float out[3];
+  gyro_bias_get(t, 30.0f, out);
+  TEST_ASSERT_EQUAL_FLOAT(0.5f, out[0]);
+  TEST_ASSERT_EQUAL_UINT32(0, t.acceptedBlocks);
+}
+
+void test_learns_temperature_slope()
+{
+  GyroBiasTracker t;
+  gyro_bias_init(t, model_at(1.0f, 0, 0, 25.0f));
+
+  // Прогрев от 25 до 45 °C, смещение X растет на 0.05 град/с на °C
+  const float slope = 0.05f;
+  for (int b = 0; b < 400; b++)
+  {
+    float temp = 25.0f + 20.0f * b / 400.0f;
+    float real[3] = {1.0f + slope * (temp - 25.0f), -0.3f, 0};
+    feed_block(t, real, 0, temp);
+  }
+
+  TEST_ASSERT_FLOAT_WITHIN(0.015f, slope, t.model.slope[0]);
+  TEST_ASSERT_FLOAT_WITHIN(0.015f, 0.0f, t.model.slope[1]);
+
+  // Предсказание при текущей температуре и небольшой экстраполяции
+  float out[3];
+  gyro_bias_get(t, 45.0f, out);
+  TEST_ASSERT_FLOAT_WITHIN(0.1f, 2.0f, out[0]);
+  gyro_bias_get(t, 48.0f, out);
+  TEST_ASSERT_FLOAT_WITHIN(0.15f, 2.15f, out[0]);
+  TEST_ASSERT_FLOAT_WITHIN(0.05f, -0.3f, out[1]);
+}
+
+void test_no_slope_without_temperature_span()
+{
+  GyroBiasTracker t;
+  gyro_bias_init(t, model_at(0, 0, 0, 30.0f));
+  const float real[3] = {0.3f, 0.3f, 0.3f};
+  for (int b = 0; b < 100; b++)
+    feed_block(t, real, 0, 30.0f + noise(0.3f));
+  for (int i = 0; i < 3; i++)
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, t.model.slope[i]);
+}
+
+void test_model_changed()
+{
+  GyroBiasModel a = model_at(0.5f, 0.1f, -0.2f, 30.0f);
+  GyroBiasModel b = a;
+  TEST_ASSERT_FALSE(gyro_bias_changed(a, b, 0.05f));
+  b.bias[1] += 0.03f;
+  TEST_ASSERT_FALSE(gyro_bias_changed(a, b, 0.05f));
+  b.bias[1] += 0.03f;
+  TEST_ASSERT_TRUE(gyro_bias_changed(a, b, 0.05f));
+  b = a;
+  b.slope[2] = 0.01f;
+  TEST_ASSERT_TRUE(gyro_bias_changed(a, b, 0.05f));
+}
+
+int main(int argc, char **argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_converges_while_still);
+  RUN_TEST(test_rejects_motion);
+  RUN_TEST(test_learns_temperature_slope);
+  RUN_TEST(test_no_slope_without_temperature_span);
+  RUN_TEST(test_model_changed);
+  return UNITY_END();
+}
@@ -0,0 +1,357 @@
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include "i2c_manager.h"
+
+// === Фейковая шина: карты регистров трех устройств, время транзакции на виртуальных часах ===
+#define IMU_ADDR 0x68
+#define MCP_ADDR 0x20
+#define POWER_ADDR 0x75
+
+#define FAKE_OVERHEAD_US 30 // старт, адрес, регистр, повторный старт
+#define FAKE_BYTE_US 23     // байт на 400 кГц
+
+static uint32_t nowUs;
+static uint32_t virtual_clock() { return nowUs; }
+
+static uint8_t regs[3][256];
+static uint8_t failNext[3];     // сколько следующих попыток к устройству вернут NACK
+static uint32_t extraUs[3];     // задержка устройства (растягивание такта)
+static uint32_t transactions;
+static char log_buf[256];       // порядок транзакций: буква устройства на каждую
+
+static int dev_index(uint8_t addr)
+{
+  return addr == IMU_ADDR ? 0 : addr == MCP_ADDR ? 1 : addr == POWER_ADDR ? 2 : -1;
+}
+
+static void log_transaction(int d)
+{
+  size_t n = strlen(log_buf);
+  if (n + 1 < sizeof(log_buf))
+  {
+    log_buf[n] = "imp"[d];
+    log_buf[n + 1] = 0;
+  }
+}
+
+static bool fake_read(uint8_t addr, uint8_t reg, uint8_t *buf, uint8_t len)
+{
+  int d = dev_index(addr);
+  if (d < 0)
+    return false;
+  transactions++;
+  nowUs += FAKE_OVERHEAD_US + extraUs[d];
+  if (failNext[d])
+  {
+    failNext[d]--;
+    return false;
+  }
+  log_transaction(d);
+  nowUs += FAKE_BYTE_US * len;
+  memcpy(buf, regs[d] + reg, len);
+  return true;
+}
+
+static bool fake_write(uint8_t addr, uint8_t reg, uint8_t val)
+{
+  int d = dev_index(addr);
+  if (d < 0)
+    return false;
+  transactions++;
+  nowUs += FAKE_OVERHEAD_US + extraUs[d];
+  if (failNext[d])
+  {
+    failNext[d]--;
+    return false;
+  }
+  log_transaction(d);
+  nowUs += FAKE_BYTE_US;
+  regs[d][reg] = val;
+  return true;
+}
+
+static const I2cBus fakeBus = {fake_read, fake_write};
+
+static I2cManager m;
+static int8_t imu, mcp, power;
+
+static void setup_bus()
+{
+  nowUs = 1000;
+  transactions = 0;
+  log_buf[0] = 0;
+  memset(failNext, 0, sizeof(failNext));
+  memset(extraUs, 0, sizeof(extraUs));
+  for (int d = 0; d < 3; d++)
+    for (int r = 0; r < 256; r++)
+      regs[d][r] = (uint8_t)(d * 64 + r);
+  i2c_manager_init(m, &fakeBus, virtual_clock);
+  imu = i2c_manager_add_device(m, IMU_ADDR, false, "imu");
+  mcp = i2c_manager_add_device(m, MCP_ADDR, true, "mcp");
+  power = i2c_manager_add_device(m, POWER_ADDR, false, "power");
+}
+
+// Результаты отложенных транзакций
+struct Result
+{
+  bool called;
+  bool ok;
+  uint8_t data[I2C_MAX_BATCH];
+  uint8_t len;
+};
+
+static void on_done(void *ctx, bool ok, const uint8_t *data, uint8_t len)
+{
+  Result *r = (Result *)ctx;
+  r->called = true;
+  r->ok = ok;
+  r->len = len;
+  if (data)
+    memcpy(r->data, data, len);
+}
+
+void test_devices_and_sync_stats()
+{
+  setup_bus();
+  TEST_ASSERT_EQUAL_INT8(0, imu);
+  TEST_ASSERT_EQUAL_INT8(1, mcp);
+  TEST_ASSERT_EQUAL_INT8(2, power);
+  TEST_ASSERT_EQUAL_INT8(mcp, i2c_manager_add_device(m, MCP_ADDR, true, "again"));
+  TEST_ASSERT_EQUAL_INT8(-1, i2c_manager_find(m, 0x50));
+
+  uint8_t buf[14];
+  TEST_ASSERT_TRUE(i2c_read(m, imu, 0x3B, buf, 14));
+  TEST_ASSERT_EQUAL_UINT8(0x3B, buf[0]);
+  TEST_ASSERT_EQUAL_UINT8(0x3B + 13, buf[13]);
+  TEST_ASSERT_TRUE(i2c_write(m, imu, 0x6B, 0x01));
+  TEST_ASSERT_EQUAL_UINT8(0x01, regs[0][0x6B]);
+
+  const I2cDeviceStats &s = m.devices[imu].stats;
+  TEST_ASSERT_EQUAL_UINT32(1, s.reads);
+  TEST_ASSERT_EQUAL_UINT32(1, s.writes);
+  TEST_ASSERT_EQUAL_UINT32(15, s.bytes);
+  TEST_ASSERT_EQUAL_UINT32(FAKE_OVERHEAD_US + 14 * FAKE_BYTE_US, s.maxLatencyUs);
+  TEST_ASSERT_EQUAL_UINT32(2 * FAKE_OVERHEAD_US + 15 * FAKE_BYTE_US, s.totalLatencyUs);
+  TEST_ASSERT_FALSE(i2c_read(m, 7, 0, buf, 1));
+}
+
+void test_retries_and_failures()
+{
+  setup_bus();
+  uint8_t v;
+  failNext[1] = 2;
+  TEST_ASSERT_TRUE(i2c_read(m, mcp, 0x12, &v, 1));
+  const I2cDeviceStats &s = m.devices[mcp].stats;
+  TEST_ASSERT_EQUAL_UINT32(2, s.nacks);
+  TEST_ASSERT_EQUAL_UINT32(2, s.retries);
+  TEST_ASSERT_EQUAL_UINT32(0, s.failures);
+
+  failNext[1] = 10;
+  TEST_ASSERT_FALSE(i2c_write(m, mcp, 0x00, 0xFF));
+  TEST_ASSERT_EQUAL_UINT32(5, s.nacks);
+  TEST_ASSERT_EQUAL_UINT32(4, s.retries);
+  TEST_ASSERT_EQUAL_UINT32(1, s.failures);
+  TEST_ASSERT_EQUAL_UINT8(7, failNext[1]); // 3 попытки: первая и два повтора
+
+  i2c_manager_reset_stats(m);
+  TEST_ASSERT_EQUAL_UINT32(0, s.nacks);
+  TEST_ASSERT_EQUAL_UINT32(0, s.reads);
+}
+
+void test_fifo_order()
+{
+  setup_bus();
+  Result r[4] = {};
+  TEST_ASSERT_TRUE(i2c_submit_read(m, power, 0x78, 1, on_done, &r[0]));
+  TEST_ASSERT_TRUE(i2c_submit_read(m, mcp, 0x12, 1, on_done, &r[1]));
+  TEST_ASSERT_TRUE(i2c_submit_read(m, power, 0x70, 1, on_done, &r[2]));
+  TEST_ASSERT_TRUE(i2c_submit_read(m, imu, 0x3A, 1, on_done, &r[3]));
+  TEST_ASSERT_EQUAL_UINT8(4, i2c_manager_service(m, 100000));
+  TEST_ASSERT_EQUAL_STRING("pmpi", log_buf);
+  for (int i = 0; i < 4; i++)
+    TEST_ASSERT_TRUE(r[i].called && r[i].ok);
+  TEST_ASSERT_EQUAL_UINT8(128 + 0x78, r[0].data[0]);
+  TEST_ASSERT_EQUAL_UINT8(128 + 0x70, r[2].data[0]);
+  // Ожидание в очереди учтено
+  TEST_ASSERT_TRUE(m.devices[power].stats.maxWaitUs > 0);
+}
+
+void test_batch_contiguous_reads()
+{
+  setup_bus();
+  Result a = {}, b = {}, c = {}, far = {};
+  i2c_submit_read(m, mcp, 0x13, 1, on_done, &b);
+  i2c_submit_read(m, mcp, 0x12, 1, on_done, &a);
+  i2c_submit_read(m, mcp, 0x14, 2, on_done, &c);
+  i2c_submit_read(m, mcp, 0x20, 1, on_done, &far);
+  TEST_ASSERT_EQUAL_UINT8(2, i2c_manager_service(m, 100000));
+  TEST_ASSERT_EQUAL_UINT32(2, transactions);
+  TEST_ASSERT_EQUAL_UINT32(2, m.devices[mcp].stats.merged);
+  TEST_ASSERT_EQUAL_UINT8(64 + 0x12, a.data[0]);
+  TEST_ASSERT_EQUAL_UINT8(64 + 0x13, b.data[0]);
+  TEST_ASSERT_EQUAL_UINT8(2, c.len);
+  TEST_ASSERT_EQUAL_UINT8(64 + 0x14, c.data[0]);
+  TEST_ASSERT_EQUAL_UINT8(64 + 0x15, c.data[1]);
+  TEST_ASSERT_EQUAL_UINT8(64 + 0x20, far.data[0]);
+  // Один пакет на 4 байта вместо трех транзакций
+  TEST_ASSERT_EQUAL_UINT32(4 + 1, m.devices[mcp].stats.bytes);
+}
+
+void test_batch_respects_writes_and_devices()
+{
+  setup_bus();
+  Result a = {}, b = {};
+  // Чтение после записи в тот же регистр видит новое значение
+  i2c_submit_read(m, mcp, 0x12, 1, on_done, &a);
+  i2c_submit_write(m, mcp, 0x13, 0xAB, nullptr, nullptr);
+  i2c_submit_read(m, mcp, 0x13, 1, on_done, &b);
+  TEST_ASSERT_EQUAL_UINT8(3, i2c_manager_service(m, 100000));
+  TEST_ASSERT_EQUAL_UINT8(0xAB, b.data[0]);
+  TEST_ASSERT_EQUAL_UINT32(0, m.devices[mcp].stats.merged);
+
+  // Без автоинкремента соседние регистры читаются по одному
+  Result p[2] = {};
+  i2c_submit_read(m, power, 0x20, 1, on_done, &p[0]);
+  i2c_submit_read(m, power, 0x21, 1, on_done, &p[1]);
+  TEST_ASSERT_EQUAL_UINT8(2, i2c_manager_service(m, 100000));
+  TEST_ASSERT_EQUAL_UINT8(128 + 0x21, p[1].data[0]);
+}
+
+void test_background_budget()
+{
+  setup_bus();
+  extraUs[2] = 400; // медленный контроллер питания
+  Result r[5] = {}, key = {};
+  for (int i = 0; i < 5; i++)
+    i2c_submit_read(m, power, 0x70 + i, 1, on_done, &r[i]);
+  // Первая за вызов — всегда; оценка остальных появляется из первой
+  TEST_ASSERT_EQUAL_UINT8(2, i2c_manager_service(m, 1000));
+  // Очередь одна на всех: поставленное позже ждет своей очереди, бюджет общий
+  i2c_submit_read(m, mcp, 0x12, 1, on_done, &key);
+  log_buf[0] = 0;
+  TEST_ASSERT_EQUAL_UINT8(2, i2c_manager_service(m, 1000));
+  TEST_ASSERT_EQUAL_STRING("pp", log_buf);
+  TEST_ASSERT_FALSE(key.called);
+  TEST_ASSERT_EQUAL_UINT8(2, i2c_manager_service(m, 1000));
+  TEST_ASSERT_EQUAL_STRING("pppm", log_buf);
+  TEST_ASSERT_TRUE(key.called && key.ok);
+  TEST_ASSERT_EQUAL_UINT8(0, i2c_manager_service(m, 1000));
+  for (int i = 0; i < 5; i++)
+    TEST_ASSERT_EQUAL_UINT8(128 + 0x70 + i, r[i].data[0]);
+}
+
+void test_failed_async_and_queue_full()
+{
+  setup_bus();
+  Result r = {};
+  failNext[2] = 10;
+  i2c_submit_read(m, power, 0x78, 1, on_done, &r);
+  i2c_manager_service(m, 1000);
+  TEST_ASSERT_TRUE(r.called);
+  TEST_ASSERT_FALSE(r.ok);
+  TEST_ASSERT_EQUAL_UINT32(1, m.devices[power].stats.failures);
+
+  for (int i = 0; i < I2C_QUEUE_SIZE; i++)
+    TEST_ASSERT_TRUE(i2c_submit_write(m, power, 0x00, i, nullptr, nullptr));
+  TEST_ASSERT_FALSE(i2c_submit_write(m, power, 0x00, 0, nullptr, nullptr));
+  TEST_ASSERT_EQUAL_UINT32(1, m.queueFull);
+  TEST_ASSERT_FALSE(i2c_submit_read(m, power, 0x00, I2C_MAX_BATCH + 1, nullptr, nullptr));
+}
+
+// Опрос как в task_io: каждые 5 мс IMU (14 байт) и два MCP, раз в N проходов — IP5306 (3 чтения + запись).
+// Задержка IMU — насколько его чтение сдвинулось от начала периода из-за фона предыдущего прохода
+static uint32_t simulate(bool managed, uint32_t *transactionCount)
+{
+  setup_bus();
+  extraUs[2] = 1500; // IP5306 отвечает медленно
+  uint32_t worst = 0;
+  uint32_t release = nowUs;
+  uint8_t buf[16];
+  for (int pass = 0; pass < 400; pass++)
+  {
+    if ((int32_t)(nowUs - release) > (int32_t)worst)
+      worst = nowUs - release;
+    if ((int32_t)(nowUs - release) < 0)
+      nowUs = release;
+    i2c_read(m, imu, 0x3B, buf, 14);
+    if (managed)
+    {
+      // Регистры GPIOA/GPIOB одним пакетом
+      i2c_read(m, mcp, 0x12, buf, 2);
+    }
+    else
+    {
+      i2c_read(m, mcp, 0x12, buf, 1);
+      i2c_read(m, mcp, 0x13, buf, 1);
+    }
+    if (pass % 50 == 0)
+    {
+      if (managed)
+      {
+        i2c_submit_read(m, power, 0x78, 1, nullptr, nullptr);
+        i2c_submit_read(m, power, 0x21, 1, nullptr, nullptr);
+        i2c_submit_write(m, power, 0x21, 0x10, nullptr, nullptr);
+        i2c_submit_read(m, power, 0x20, 1, nullptr, nullptr);
+      }
+      else
+      {
+        i2c_read(m, power, 0x78, buf, 1);
+        i2c_read(m, power, 0x21, buf, 1);
+        i2c_write(m, power, 0x21, 0x10);
+        i2c_read(m, power, 0x20, buf, 1);
+      }
+    }
+    if (managed)
+      i2c_manager_service(m, 2000);
+    release += 5000;
+  }
+  *transactionCount = transactions;
+  return worst;
+}
+
+void test_benchmark()
+{
+  uint32_t directTx, managedTx;
+  uint32_t direct = simulate(false, &directTx);
+  uint32_t managed = simulate(true, &managedTx);
+  char msg[160];
+  snprintf(msg, sizeof(msg), "IMU start delay behind IP5306 polling: inline %u us, managed %u us; transactions %u -> %u",
+           (unsigned)direct, (unsigned)managed, (unsigned)directTx, (unsigned)managedTx);
+  TEST_MESSAGE(msg);
+  TEST_ASSERT_EQUAL_UINT32(0, managed);
+  TEST_ASSERT_TRUE(direct > 0);
+  TEST_ASSERT_TRUE(managedTx < directTx);
+
+  // Накладные расходы менеджера на транзакцию (реальное время, шина без задержек)
+  setup_bus();
+  const uint32_t n = 2000000;
+  uint8_t buf[2];
+  auto t0 = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < n; i++)
+    fake_read(MCP_ADDR, 0x12, buf, 2);
+  auto t1 = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < n; i++)
+    i2c_read(m, mcp, 0x12, buf, 2);
+  auto t2 = std::chrono::steady_clock::now();
+  double raw = std::chrono::duration<double, std::nano>(t1 - t0).count() / n;
+  double viaManager = std::chrono::duration<double, std::nano>(t2 - t1).count() / n;
+  snprintf(msg, sizeof(msg), "sync read: bus %.1f ns, via manager %.1f ns (+%.1f ns)", raw, viaManager, viaManager - raw);
+  TEST_MESSAGE(msg);
+  TEST_ASSERT_EQUAL_UINT32(n, m.devices[mcp].stats.reads);
+}
+
+int main(int argc, char **argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_devices_and_sync_stats);
+  RUN_TEST(test_retries_and_failures);
+  RUN_TEST(test_fifo_order);
+  RUN_TEST(test_batch_contiguous_reads);
+  RUN_TEST(test_batch_respects_writes_and_devices);
+  RUN_TEST(test_background_budget);
+  RUN_TEST(test_failed_async_and_queue_full);
+  RUN_TEST(test_benchmark);
+  return UNITY_END();
+}
@@ -0,0 +1,389 @@
+#include <unity.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <filesystem>
+#include <vector>
+#include "imu_trace.h"
+
+// Воспроизведение трассы: IMU_TRACE_FILE=<путь к скачанному /api/mouse/trace.bin> pio test -e native -f test_imu_trace
+// Записанные трассы обычной работы без жестов (скачанные trace.bin) кладутся в IMU_TRACE_FIXTURES —
+// на них считаются ложные жесты
+#define IMU_TRACE_FIXTURES "test/test_imu_trace/fixtures"
+
+#define PERIOD_US 5000
+
+static uint32_t rng_state = 777;
+static float noise(float amplitude)
+{
+  rng_state = rng_state * 1664525u + 1013904223u;
+  return ((int32_t)(rng_state >> 8) % 2001 - 1000) / 1000.0f * amplitude;
+}
+
+static int16_t to_raw(float v, float lsb)
+{
+  float r = v * lsb;
+  return r > 32767 ? 32767 : (r < -32768 ? -32768 : (int16_t)lrintf(r));
+}
+
+// Сеанс: пульт в руке, повороты влево-вправо и наклоны, затем лежит на столе
+static std::vector<MpuRawSample> make_session(size_t count)
+{
+  std::vector<MpuRawSample> raw;
+  const float bias[3] = {1.2f, -0.7f, 0.4f};
+  for (size_t i = 0; i < count; i++)
+  {
+    float t = i * PERIOD_US * 1e-6f;
+    bool held = i < count * 3 / 4;
+    float yawRate = held ? 120.0f * sinf(t * 2.0f) + 1.5f * sinf(t * 57.0f) : 0;
+    float pitchRate = held ? 60.0f * cosf(t * 1.3f) : 0;
+    float n = held ? 0.01f : 0.002f;
+    MpuRawSample s;
+    s.accX = to_raw(noise(n), MPU6050_ACC_LSB);
+    s.accY = to_raw(noise(n), MPU6050_ACC_LSB);
+    s.accZ = to_raw(1.0f + noise(n), MPU6050_ACC_LSB);
+    s.gyroX = to_raw(pitchRate + bias[0] + noise(0.2f), MPU6050_GYRO_LSB);
+    s.gyroY = to_raw(bias[1] + noise(0.2f), MPU6050_GYRO_LSB);
+    s.gyroZ = to_raw(yawRate + bias[2] + noise(0.2f), MPU6050_GYRO_LSB);
+    s.temp = (int16_t)((30.0f - 36.53f) * 340.0f);
+    raw.push_back(s);
+  }
+  return raw;
+}
+
+static MotionConfig session_motion_config()
+{
+  MotionConfig cfg = {};
+  cfg.deadzone = 0.05f;
+  cfg.sensitivity = 6.0f;
+  cfg.curve.type = ACCEL_CURVE_SIGMOID;
+  cfg.curve.minGain = 0.4f;
+  cfg.curve.maxGain = 2.0f;
+  cfg.curve.threshold = 0.9f;
+  cfg.curve.param = 0.15f;
+  cfg.filter = {true, 1.0f, 16.0f, 10.0f};
+  motion_config_build(cfg);
+  return cfg;
+}
+
+// Скачиваемый файл из сегментов, как его отдает /api/mouse/trace.bin
+static std::vector<uint8_t> assemble_download(const ImuTraceHeader &h, const std::vector<uint8_t> (&segments)[2])
+{
+  std::vector<uint8_t> file((const uint8_t *)&h, (const uint8_t *)&h + sizeof(h));
+  uint8_t segment;
+  uint32_t offset;
+  for (uint32_t pos = 0;;)
+  {
+    uint32_t n = imu_trace_locate(h, pos, segment, offset);
+    if (!n)
+      break;
+    if (n > 1000)
+      n = 1000; // кусками, как просит веб-сервер
+    if (offset + n > segments[segment].size())
+      break; // записи нет в сегменте — файл выйдет короче и не совпадет с ожидаемым
+    file.insert(file.end(), segments[segment].begin() + offset, segments[segment].begin() + offset + n);
+    pos += n;
+  }
+  return file;
+}
+
+// Запись как в прошивке: цепочка обрабатывает отсчеты, записи дописываются в сегменты по capacity / 2
+static std::vector<uint8_t> record_session(const std::vector<MpuRawSample> &session, uint32_t capacity, long &sentX, long &sentY)
+{
+  static Mpu6050 mpu;
+  static ImuPipeline p;
+  static MotionConfig motion;
+  static MotionFixedConfig fixedCfg;
+  static int8_t mount[MOUNT_MATRIX_SIZE];
+  memset(&mpu, 0, sizeof(mpu));
+  p.mpu = &mpu;
+  p.quaternion = true;
+  GyroBiasModel model = {{1.0f, -0.5f, 0.5f}, 30.0f, {0, 0, 0}};
+  gyro_bias_init(p.bias, model);
+  StillnessConfig stillCfg = {0.0004f, 1.0f, 1500000, 200000};
+  stillness_init(p.stillness, stillCfg);
+  GestureConfig gestureCfg = {250.0f, 150000, 250000, 4, 1200000, 120.0f, 60.0f, 600000, 1000000, 25.0f, 1500000, 400000};
+  gesture_init(p.gestures, gestureCfg);
+  motion = session_motion_config();
+  motion_fixed_config_init(motion, fixedCfg);
+  mount_matrix_default(mount, 0, false);
+  ImuPipelineConfig cfg = {mount, &motion, &fixedCfg};
+  imu_pipeline_reset_orientation(p, 1.0f, 0.0f);
+
+  ImuTraceHeader h;
+  imu_trace_header_init(h, capacity, p, cfg, 1.0f, 0.0f);
+  std::vector<uint8_t> segments[2];
+  sentX = sentY = 0;
+  for (const MpuRawSample &raw : session)
+  {
+    MouseDelta d;
+    uint8_t flags = imu_pipeline_step(p, cfg, raw, PERIOD_US, d);
+    ImuTraceRecord r;
+    imu_trace_pack(raw, PERIOD_US, flags & IMU_STEP_MOVED, d, r);
+    std::vector<uint8_t> &segment = segments[imu_trace_segment(h, h.count)];
+    if (imu_trace_segment_offset(h, h.count) == 0)
+      segment.clear(); // сегмент открывается заново
+    segment.insert(segment.end(), (const uint8_t *)&r, (const uint8_t *)&r + sizeof(r));
+    h.count++;
+    sentX += r.dx;
+    sentY += r.dy;
+  }
+  return assemble_download(h, segments);
+}
+
+struct ReplayStats
+{
+  uint32_t samples;
+  long replayX, replayY;     // путь курсора после воспроизведения
+  long recordedX, recordedY; // путь курсора в трассе
+  long travel;               // сумма модулей смещений после воспроизведения
+  uint32_t mismatches;       // отсчеты, где смещение отличается от записанного
+  uint32_t gestures;         // распознанные жесты
+  double seconds;
+  double maxSampleNs;
+};
+
+static bool replay(const std::vector<uint8_t> &file, ReplayStats &st)
+{
+  memset(&st, 0, sizeof(st));
+  if (file.size() < sizeof(ImuTraceHeader))
+    return false;
+  ImuTraceHeader h;
+  memcpy(&h, &file[0], sizeof(h));
+  if (!imu_trace_header_valid(h))
+    return false;
+
+  Mpu6050 mpu;
+  ImuPipeline p;
+  MotionFixedConfig fixedCfg;
+  ImuPipelineConfig cfg;
+  imu_trace_replay_init(h, p, mpu, fixedCfg, cfg);
+
+  for (uint32_t i = imu_trace_first(h); i < h.count; i++)
+  {
+    uint32_t offset = imu_trace_offset(h, i);
+    if (offset + sizeof(ImuTraceRecord) > file.size())
+      return false;
+    ImuTraceRecord r;
+    memcpy(&r, &file[offset], sizeof(r));
+    MpuRawSample raw;
+    imu_trace_unpack(r, raw);
+
+    MouseDelta d;
+    auto t0 = std::chrono::steady_clock::now();
+    uint8_t flags = imu_pipeline_step(p, cfg, raw, r.dtUs, d);
+    auto t1 = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+    st.seconds += ns * 1e-9;
+    if (ns > st.maxSampleNs)
+      st.maxSampleNs = ns;
+
+    int16_t dx = (flags & IMU_STEP_MOVED) ? d.x : 0;
+    int16_t dy = (flags & IMU_STEP_MOVED) ? d.y : 0;
+    st.replayX += dx;
+    st.replayY += dy;
+    st.travel += labs(dx) + labs(dy);
+    st.recordedX += r.dx;
+    st.recordedY += r.dy;
+    if (dx != r.dx || dy != r.dy)
+      st.mismatches++;
+    if (flags & IMU_STEP_GESTURE)
+      st.gestures++;
+    st.samples++;
+  }
+  return true;
+}
+
+static void report(const char *name, const ReplayStats &st)
+{
+  char msg[256];
+  snprintf(msg, sizeof(msg), "%s: %u samples, %.0f samples/s, %.0f ns/sample (max %.0f), displacement %ld,%ld (recorded %ld,%ld), travel %ld, %u mismatches, %u gestures",
+           name, (unsigned)st.samples, st.samples / st.seconds, st.seconds * 1e9 / st.samples, st.maxSampleNs,
+           st.replayX, st.replayY, st.recordedX, st.recordedY, st.travel, (unsigned)st.mismatches, (unsigned)st.gestures);
+  TEST_MESSAGE(msg);
+}
+
+void test_buffer_push_pop_and_drop()
+{
+  static ImuTraceBuffer b;
+  imu_trace_buffer_reset(b);
+  ImuTraceRecord r = {};
+  for (int i = 0; i < IMU_TRACE_BUFFER; i++)
+  {
+    r.dtUs = i;
+    TEST_ASSERT_TRUE(imu_trace_push(b, r));
+  }
+  TEST_ASSERT_FALSE(imu_trace_push(b, r));
+  TEST_ASSERT_EQUAL_UINT32(1, b.dropped);
+  for (int i = 0; i < IMU_TRACE_BUFFER; i++)
+  {
+    TEST_ASSERT_TRUE(imu_trace_pop(b, r));
+    TEST_ASSERT_EQUAL_UINT16(i, r.dtUs);
+  }
+  TEST_ASSERT_FALSE(imu_trace_pop(b, r));
+}
+
+void test_segment_offsets()
+{
+  ImuTraceHeader h = {};
+  h.capacity = 8; // сегменты по 4 записи
+  TEST_ASSERT_EQUAL_UINT32(4, imu_trace_segment_size(h));
+  TEST_ASSERT_EQUAL_UINT8(0, imu_trace_segment(h, 3));
+  TEST_ASSERT_EQUAL_UINT8(1, imu_trace_segment(h, 4));
+  TEST_ASSERT_EQUAL_UINT8(0, imu_trace_segment(h, 9));
+  TEST_ASSERT_EQUAL_UINT32(1 * sizeof(ImuTraceRecord), imu_trace_segment_offset(h, 9));
+
+  h.count = 8; // оба сегмента заполнены, ничего не затерто
+  TEST_ASSERT_EQUAL_UINT32(0, imu_trace_first(h));
+  TEST_ASSERT_TRUE(imu_trace_exact(h));
+  TEST_ASSERT_EQUAL_UINT32(sizeof(ImuTraceHeader) + 3 * sizeof(ImuTraceRecord), imu_trace_offset(h, 3));
+
+  h.count = 10; // сегмент 0 открыт заново: сохранены записи 4..9
+  TEST_ASSERT_EQUAL_UINT32(4, imu_trace_first(h));
+  TEST_ASSERT_FALSE(imu_trace_exact(h));
+  TEST_ASSERT_EQUAL_UINT32(sizeof(ImuTraceHeader), imu_trace_offset(h, 4));
+
+  uint8_t segment;
+  uint32_t offset;
+  // Начало: запись 4 в сегменте 1, подряд до конца сегмента — 4 записи
+  TEST_ASSERT_EQUAL_UINT32(4 * sizeof(ImuTraceRecord), imu_trace_locate(h, 0, segment, offset));
+  TEST_ASSERT_EQUAL_UINT8(1, segment);
+  TEST_ASSERT_EQUAL_UINT32(0, offset);
+  // Середина записи 8: сегмент 0, до конца трассы остаток записи 8 и запись 9
+  TEST_ASSERT_EQUAL_UINT32(2 * sizeof(ImuTraceRecord) - 3, imu_trace_locate(h, 4 * sizeof(ImuTraceRecord) + 3, segment, offset));
+  TEST_ASSERT_EQUAL_UINT8(0, segment);
+  TEST_ASSERT_EQUAL_UINT32(3, offset);
+  TEST_ASSERT_EQUAL_UINT32(0, imu_trace_locate(h, 6 * sizeof(ImuTraceRecord), segment, offset));
+}
+
+void test_pack_roundtrip()
+{
+  MpuRawSample raw = {100, -200, 16384, -2000, 30, -40, 50};
+  MouseDelta d = {-300, 7};
+  ImuTraceRecord r;
+  imu_trace_pack(raw, 100000, true, d, r);
+  TEST_ASSERT_EQUAL_UINT16(0xFFFF, r.dtUs); // длинная пауза ограничивается
+  TEST_ASSERT_EQUAL_INT16(-300, r.dx);
+  MpuRawSample back;
+  imu_trace_unpack(r, back);
+  TEST_ASSERT_EQUAL_MEMORY(&raw, &back, sizeof(raw));
+  imu_trace_pack(raw, 5000, false, d, r);
+  TEST_ASSERT_EQUAL_INT16(0, r.dx);
+  TEST_ASSERT_EQUAL_INT16(0, r.dy);
+}
+
+void test_replay_is_deterministic()
+{
+  std::vector<MpuRawSample> session = make_session(8000);
+  long sentX, sentY;
+  std::vector<uint8_t> file = record_session(session, 8192, sentX, sentY);
+
+  ReplayStats st;
+  TEST_ASSERT_TRUE(replay(file, st));
+  report("synthetic", st);
+  TEST_ASSERT_EQUAL_UINT32(8000, st.samples);
+  TEST_ASSERT_EQUAL_UINT32(0, st.mismatches);
+  TEST_ASSERT_EQUAL_INT32(sentX, st.replayX);
+  TEST_ASSERT_EQUAL_INT32(sentY, st.replayY);
+  TEST_ASSERT_TRUE(labs(sentX) + labs(sentY) > 0);
+  TEST_ASSERT_EQUAL_UINT32(0, st.gestures); // обычное ведение курсора — без ложных жестов
+}
+
+void test_rotated_segments_replay_tail()
+{
+  // Сегменты меньше сеанса: сохраняется хвост, состояние начала известно лишь приблизительно
+  std::vector<MpuRawSample> session = make_session(8000);
+  long sentX, sentY;
+  std::vector<uint8_t> file = record_session(session, 3600, sentX, sentY);
+  // Записано 4 сегмента по 1800 и начат пятый: сохранены четвертый и начало пятого
+  TEST_ASSERT_EQUAL_UINT32(sizeof(ImuTraceHeader) + 2600 * sizeof(ImuTraceRecord), file.size());
+
+  ReplayStats st;
+  TEST_ASSERT_TRUE(replay(file, st));
+  report("wrapped", st);
+  TEST_ASSERT_EQUAL_UINT32(2600, st.samples);
+  TEST_ASSERT_GREATER_THAN(0, st.travel);
+}
+
+void test_rejects_bad_header()
+{
+  std::vector<uint8_t> file(sizeof(ImuTraceHeader), 0);
+  ReplayStats st;
+  TEST_ASSERT_FALSE(replay(file, st));
+}
+
+static bool read_file(const char *path, std::vector<uint8_t> &file)
+{
+  FILE *f = fopen(path, "rb");
+  if (!f)
+    return false;
+  file.clear();
+  uint8_t buf[4096];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0)
+    file.insert(file.end(), buf, buf + n);
+  fclose(f);
+  return true;
+}
+
+void test_replay_file_from_env()
+{
+  const char *path = getenv("IMU_TRACE_FILE");
+  if (!path)
+  {
+    TEST_MESSAGE("IMU_TRACE_FILE not set, skipped");
+    return;
+  }
+  std::vector<uint8_t> file;
+  TEST_ASSERT_TRUE(read_file(path, file));
+
+  ReplayStats st;
+  TEST_ASSERT_TRUE(replay(file, st));
+  report(path, st);
+}
+
+void test_recorded_traces_have_no_false_gestures()
+{
+  namespace fs = std::filesystem;
+  std::error_code ec;
+  uint32_t traces = 0, samples = 0, gestures = 0;
+  for (const fs::directory_entry &entry : fs::directory_iterator(IMU_TRACE_FIXTURES, ec))
+  {
+    if (entry.path().extension() != ".bin")
+      continue;
+    std::string path = entry.path().string();
+    std::vector<uint8_t> file;
+    TEST_ASSERT_TRUE(read_file(path.c_str(), file));
+    ReplayStats st;
+    TEST_ASSERT_TRUE_MESSAGE(replay(file, st), path.c_str());
+    report(path.c_str(), st);
+    traces++;
+    samples += st.samples;
+    gestures += st.gestures;
+  }
+  if (!traces)
+  {
+    TEST_MESSAGE("no recorded traces in " IMU_TRACE_FIXTURES ", skipped");
+    return;
+  }
+  char msg[128];
+  snprintf(msg, sizeof(msg), "recorded: %u traces, %u samples, %u false gestures", (unsigned)traces, (unsigned)samples, (unsigned)gestures);
+  TEST_MESSAGE(msg);
+  TEST_ASSERT_EQUAL_UINT32(0, gestures);
+}
+
+int main(int argc, char **argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_buffer_push_pop_and_drop);
+  RUN_TEST(test_segment_offsets);
+  RUN_TEST(test_pack_roundtrip);
+  RUN_TEST(test_replay_is_deterministic);
+  RUN_TEST(test_rotated_segments_replay_tail);
+  RUN_TEST(test_rejects_bad_header);
+  RUN_TEST(test_replay_file_from_env);
+  RUN_TEST(test_recorded_traces_have_no_false_gestures);
+  return UNITY_END();
+}
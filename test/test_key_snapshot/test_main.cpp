@@ -0,0 +1,218 @@
+#include <unity.h>
+#include <stdio.h>
+#include <chrono>
+#include "key_snapshot.h"
+
+// Кнопка как в HardwareKeyConfig: источник, пин, сторона (0 — клавиатура, 1 — мышь, 2 — обе)
+struct RefKey
+{
+  uint8_t word;
+  uint8_t bit;
+  uint8_t side;
+};
+
+static void build_layout(KeyLayout &l, const RefKey *keys, uint8_t count)
+{
+  key_layout_init(l);
+  for (uint8_t i = 0; i < count; i++)
+    TEST_ASSERT_TRUE(key_layout_add(l, i, keys[i].word, keys[i].bit, keys[i].side != 1, keys[i].side != 0));
+}
+
+// Раскладка на count кнопок: по 16 на MCP, последние 4 — GPIO (как в config.h: кнопки MCP, потом GPIO)
+static uint8_t make_keys(RefKey *keys, uint8_t count)
+{
+  static const uint8_t gpio[] = {17, 34, 35, 0};
+  uint8_t mcpKeys = count - 4;
+  for (uint8_t i = 0; i < mcpKeys; i++)
+    keys[i] = {(uint8_t)(i / 16), (uint8_t)(i % 16), (uint8_t)(i % 3)};
+  for (uint8_t i = 0; i < 4; i++)
+    keys[mcpKeys + i] = {(uint8_t)(KEY_GPIO_WORD + gpio[i] / 16), (uint8_t)(gpio[i] % 16), (uint8_t)(i % 3)};
+  return count;
+}
+
+// Прежний опрос: по кнопке, с ветвлением по стороне
+static void reference_scan(const RefKey *keys, uint8_t count, const uint16_t *words, uint8_t side, uint8_t *pressed)
+{
+  for (uint8_t i = 0; i < count; i++)
+  {
+    if (!(keys[i].side == side || keys[i].side == 2))
+    {
+      pressed[i] = 0;
+      continue;
+    }
+    pressed[i] = !(words[keys[i].word] & (1 << keys[i].bit));
+  }
+}
+
+static uint32_t rng = 12345;
+static uint16_t next_word()
+{
+  rng = rng * 1664525u + 1013904223u;
+  return (uint16_t)(rng >> 16);
+}
+
+void test_maps_sources_active_low()
+{
+  static const RefKey keys[] = {
+      {0, 0, 0}, {0, 15, 0}, {1, 4, 1}, {7, 9, 2}, {KEY_GPIO_WORD + 2, 2, 0} /* GPIO 34 */};
+  KeyLayout l;
+  build_layout(l, keys, 5);
+  TEST_ASSERT_EQUAL_UINT8(5, l.keyCount);
+  TEST_ASSERT_EQUAL_UINT8(5, l.nibbleCount);
+
+  uint16_t words[KEY_SOURCE_WORDS];
+  for (uint8_t i = 0; i < KEY_SOURCE_WORDS; i++)
+    words[i] = 0xFFFF;
+  KeyBits s;
+  key_snapshot_build(l, words, s);
+  TEST_ASSERT_FALSE(key_bits_any(s));
+
+  words[0] = (uint16_t)~(1u << 15); // MCP0 пин 15
+  words[7] = (uint16_t)~(1u << 9);  // MCP7 пин 9
+  words[KEY_GPIO_WORD + 2] = (uint16_t)~(1u << 2);
+  words[1] = (uint16_t)~(1u << 5);  // соседний пин без кнопки
+  key_snapshot_build(l, words, s);
+  TEST_ASSERT_FALSE(key_bits_test(s, 0));
+  TEST_ASSERT_TRUE(key_bits_test(s, 1));
+  TEST_ASSERT_FALSE(key_bits_test(s, 2));
+  TEST_ASSERT_TRUE(key_bits_test(s, 3));
+  TEST_ASSERT_TRUE(key_bits_test(s, 4));
+}
+
+void test_side_masks()
+{
+  static const RefKey keys[] = {{0, 0, 0}, {0, 1, 1}, {0, 2, 2}};
+  KeyLayout l;
+  build_layout(l, keys, 3);
+  TEST_ASSERT_EQUAL_UINT32(0x5, l.sideMask[0].w[0]); // клавиатура + обе
+  TEST_ASSERT_EQUAL_UINT32(0x6, l.sideMask[1].w[0]); // мышь + обе
+
+  uint16_t words[KEY_SOURCE_WORDS] = {0xFFF8};
+  KeyBits s;
+  key_snapshot_build(l, words, s);
+  TEST_ASSERT_EQUAL_UINT32(0x7, s.w[0]);
+  TEST_ASSERT_EQUAL_UINT32(0x5, key_bits_and(s, l.sideMask[0]).w[0]);
+  TEST_ASSERT_EQUAL_UINT32(0x6, key_bits_and(s, l.sideMask[1]).w[0]);
+}
+
+void test_edges_and_pop()
+{
+  KeyBits prev, cur, down, up;
+  key_bits_clear(prev);
+  key_bits_clear(cur);
+  key_bits_set(prev, 3);
+  key_bits_set(prev, 64);
+  key_bits_set(cur, 64);
+  key_bits_set(cur, 100);
+  key_bits_set(cur, 127);
+  key_snapshot_edges(prev, cur, down, up);
+
+  TEST_ASSERT_EQUAL_INT(100, key_bits_pop(down));
+  TEST_ASSERT_EQUAL_INT(127, key_bits_pop(down));
+  TEST_ASSERT_EQUAL_INT(-1, key_bits_pop(down));
+  TEST_ASSERT_EQUAL_INT(3, key_bits_pop(up));
+  TEST_ASSERT_EQUAL_INT(-1, key_bits_pop(up));
+
+  KeyBits changed = key_bits_xor(prev, cur);
+  TEST_ASSERT_FALSE(key_bits_test(changed, 64));
+}
+
+void test_rejects_out_of_range()
+{
+  KeyLayout l;
+  key_layout_init(l);
+  TEST_ASSERT_FALSE(key_layout_add(l, KEY_SNAPSHOT_BITS, 0, 0, true, true));
+  TEST_ASSERT_FALSE(key_layout_add(l, 0, KEY_SOURCE_WORDS, 0, true, true));
+  TEST_ASSERT_FALSE(key_layout_add(l, 0, 0, 16, true, true));
+  TEST_ASSERT_EQUAL_UINT8(0, l.nibbleCount);
+  TEST_ASSERT_TRUE(key_layout_add(l, KEY_SNAPSHOT_BITS - 1, KEY_SOURCE_WORDS - 1, 15, true, false));
+  TEST_ASSERT_EQUAL_UINT8(KEY_SNAPSHOT_BITS, l.keyCount);
+}
+
+void test_matches_per_key_scan()
+{
+  // 128 кнопок на 8 MCP и GPIO: снимок с маской стороны совпадает с прежним опросом по кнопке
+  static RefKey keys[KEY_SNAPSHOT_BITS];
+  static KeyLayout l;
+  uint8_t count = make_keys(keys, KEY_SNAPSHOT_BITS);
+  build_layout(l, keys, count);
+  uint16_t words[KEY_SOURCE_WORDS];
+  uint8_t ref[KEY_SNAPSHOT_BITS];
+  for (uint32_t round = 0; round < 1000; round++)
+  {
+    for (uint8_t i = 0; i < KEY_SOURCE_WORDS; i++)
+      words[i] = next_word();
+    uint8_t side = round & 1;
+    reference_scan(keys, count, words, side, ref);
+    KeyBits s;
+    key_snapshot_build(l, words, s);
+    s = key_bits_and(s, l.sideMask[side]);
+    for (uint8_t i = 0; i < count; i++)
+      TEST_ASSERT_EQUAL_UINT8(ref[i], key_bits_test(s, i));
+  }
+}
+
+// Стоимость одного скана: прежний проход по кнопкам против снимка (сбор + сторона + фронты)
+static void benchmark(uint8_t count)
+{
+  static RefKey keys[KEY_SNAPSHOT_BITS];
+  static KeyLayout l;
+  make_keys(keys, count);
+  build_layout(l, keys, count);
+
+  const uint32_t scans = 200000;
+  static uint16_t words[64][KEY_SOURCE_WORDS];
+  for (uint8_t r = 0; r < 64; r++)
+    for (uint8_t i = 0; i < KEY_SOURCE_WORDS; i++)
+      words[r][i] = next_word();
+
+  uint8_t pressed[KEY_SNAPSHOT_BITS];
+  uint32_t sumRef = 0;
+  auto t0 = std::chrono::steady_clock::now();
+  for (uint32_t n = 0; n < scans; n++)
+  {
+    reference_scan(keys, count, words[n & 63], n & 1, pressed);
+    sumRef += pressed[n % count];
+  }
+  auto t1 = std::chrono::steady_clock::now();
+
+  KeyBits prev, cur, down, up;
+  key_bits_clear(prev);
+  uint32_t sumSnap = 0;
+  auto t2 = std::chrono::steady_clock::now();
+  for (uint32_t n = 0; n < scans; n++)
+  {
+    key_snapshot_build(l, words[n & 63], cur);
+    cur = key_bits_and(cur, l.sideMask[n & 1]);
+    key_snapshot_edges(prev, cur, down, up);
+    prev = cur;
+    sumSnap += key_bits_test(cur, n % count) + (down.w[0] & 1);
+  }
+  auto t3 = std::chrono::steady_clock::now();
+
+  double refNs = std::chrono::duration<double, std::nano>(t1 - t0).count() / scans;
+  double snapNs = std::chrono::duration<double, std::nano>(t3 - t2).count() / scans;
+  char msg[128];
+  snprintf(msg, sizeof(msg), "%3u keys: per-key scan %.1f ns, snapshot %.1f ns (%u nibbles) [%u/%u]",
+           count, refNs, snapNs, l.nibbleCount, (unsigned)(sumRef & 1), (unsigned)(sumSnap & 1));
+  TEST_MESSAGE(msg);
+}
+
+void test_benchmark()
+{
+  benchmark(30);
+  benchmark(64);
+  benchmark(128);
+}
+
+int main(int argc, char **argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_maps_sources_active_low);
+  RUN_TEST(test_side_masks);
+  RUN_TEST(test_edges_and_pop);
+  RUN_TEST(test_rejects_out_of_range);
+  RUN_TEST(test_matches_per_key_scan);
+  RUN_TEST(test_benchmark);
+  return UNITY_END();
+}
@@ -0,0 +1,365 @@
+#include <unity.h>
+#include <math.h>
+#include <stdio.h>
+#include <chrono>
+#include <vector>
+#include "motion_pipeline.h"
+
+// Записанные потоки углов (X, Y) с шагом 10 мс. Значения квантованы до 1/1024 градуса —
+// это разрешение выхода фильтра MPU6050, поэтому оба пути получают одинаковый вход.
+struct AngleSample
+{
+  float x;
+  float y;
+};
+
+static float quantize(float v)
+{
+  return roundf(v * 1024.0f) / 1024.0f;
+}
+
+static uint32_t rng_state = 12345;
+static float noise(float amplitude)
+{
+  rng_state = rng_state * 1664525u + 1013904223u;
+  return ((int32_t)(rng_state >> 8) % 2001 - 1000) / 1000.0f * amplitude;
+}
+
+static std::vector<AngleSample> make_trace(int kind, size_t count)
+{
+  std::vector<AngleSample> trace;
+  float x = 0, y = 0;
+  for (size_t i = 0; i < count; i++)
+  {
+    float t = i * 0.01f;
+    switch (kind)
+    {
+    case 0: // покой, шум датчика
+      x = noise(0.4f);
+      y = noise(0.4f);
+      break;
+    case 1: // медленное ведение
+      x += 0.3f + noise(0.2f);
+      y += 0.15f * sinf(t) + noise(0.2f);
+      break;
+    case 2: // круги
+      x = 25.0f * cosf(t * 4.0f) + noise(0.1f);
+      y = 25.0f * sinf(t * 4.0f) + noise(0.1f);
+      break;
+    case 3: // резкие рывки
+      x += (i % 50 < 5) ? 40.0f : noise(0.3f);
+      y += (i % 70 < 3) ? -30.0f : noise(0.3f);
+      break;
+    }
+    if (x > 180.0f)
+      x -= 360.0f;
+    if (x < -180.0f)
+      x += 360.0f;
+    trace.push_back({quantize(x), quantize(y)});
+  }
+  return trace;
+}
+
+static MotionConfig default_config(uint8_t curveType = ACCEL_CURVE_STEP)
+{
+  MotionConfig cfg = {};
+  cfg.deadzone = 0.5f;
+  cfg.sensitivity = 2.5f;
+  cfg.curve.type = curveType;
+  cfg.curve.minGain = 0.4f;
+  cfg.curve.maxGain = 2.0f;
+  cfg.curve.threshold = curveType == ACCEL_CURVE_SIGMOID ? 0.9f : 1.2f;
+  cfg.curve.param = curveType == ACCEL_CURVE_SIGMOID ? 0.15f : 0.6f;
+  motion_config_build(cfg);
+  return cfg;
+}
+
+static void compare_paths(int kind, uint8_t curveType = ACCEL_CURVE_STEP, bool filter = false)
+{
+  std::vector<AngleSample> trace = make_trace(kind, 5000);
+  MotionConfig cfg = default_config(curveType);
+  cfg.filter = {filter, 1.0f, 16.0f, 10.0f};
+  MotionFixedConfig fixedCfg;
+  motion_fixed_config_init(cfg, fixedCfg);
+
+  MotionState fs, qs;
+  motion_state_reset(fs);
+  motion_state_reset(qs);
+
+  // Дробные остатки в float и Q16.16 округляются по-разному, поэтому целое смещение
+  // может появиться на отсчет раньше или позже — сравниваем накопленный путь
+  long sumFx = 0, sumFy = 0, sumQx = 0, sumQy = 0;
+  size_t reports = 0;
+  for (size_t i = 0; i < trace.size(); i++)
+  {
+    MouseDelta df = {0, 0}, dq = {0, 0};
+    if (motion_process_float(fs, cfg, trace[i].x, trace[i].y, MOTION_REF_PERIOD_US, df))
+    {
+      sumFx += df.x;
+      sumFy += df.y;
+      reports++;
+    }
+    if (motion_process_fixed(qs, fixedCfg, q16_from_float(trace[i].x), q16_from_float(trace[i].y), MOTION_REF_PERIOD_US, dq))
+    {
+      sumQx += dq.x;
+      sumQy += dq.y;
+    }
+    TEST_ASSERT_INT_WITHIN(1, sumFx, sumQx);
+    TEST_ASSERT_INT_WITHIN(1, sumFy, sumQy);
+  }
+  if (kind != 0)
+    TEST_ASSERT_GREATER_THAN(0, reports);
+}
+
+void test_rest_trace_matches()
+{
+  compare_paths(0);
+}
+
+void test_slow_trace_matches()
+{
+  compare_paths(1);
+}
+
+void test_circle_trace_matches()
+{
+  compare_paths(2);
+}
+
+void test_sigmoid_curve_matches()
+{
+  compare_paths(1, ACCEL_CURVE_SIGMOID);
+  compare_paths(2, ACCEL_CURVE_SIGMOID);
+  compare_paths(3, ACCEL_CURVE_SIGMOID);
+}
+
+void test_filtered_paths_match()
+{
+  // Медленное ведение после фильтра целиком в мертвой зоне — берем круги и рывки
+  compare_paths(2, ACCEL_CURVE_SIGMOID, true);
+  compare_paths(3, ACCEL_CURVE_SIGMOID, true);
+}
+
+void test_flick_trace_matches_without_clamp()
+{
+  compare_paths(3);
+
+  // Рывок больше одного HID-отчета не обрезается до ±127
+  MotionConfig cfg = default_config();
+  MotionFixedConfig fixedCfg;
+  motion_fixed_config_init(cfg, fixedCfg);
+  MotionState qs;
+  motion_state_reset(qs);
+  MouseDelta d;
+  TEST_ASSERT_TRUE(motion_process_fixed(qs, fixedCfg, q16_from_float(90.0f), q16_from_float(-90.0f), MOTION_REF_PERIOD_US, d));
+  TEST_ASSERT_EQUAL_INT16(450, d.x); // 90° * 2.5 * 2.0
+  TEST_ASSERT_EQUAL_INT16(-450, d.y);
+}
+
+// Постоянное усиление без мертвой зоны: суммарный путь курсора = путь угла * усиление
+static MotionConfig constant_gain_config(float gain)
+{
+  MotionConfig cfg = default_config(ACCEL_CURVE_LINEAR);
+  cfg.deadzone = 0;
+  cfg.sensitivity = gain;
+  cfg.curve.minGain = 1.0f;
+  cfg.curve.maxGain = 1.0f;
+  motion_config_build(cfg);
+  return cfg;
+}
+
+static void replay_preserves_displacement(int kind)
+{
+  std::vector<AngleSample> trace = make_trace(kind, 5000);
+  MotionConfig cfg = constant_gain_config(2.5f);
+  MotionFixedConfig fixedCfg;
+  motion_fixed_config_init(cfg, fixedCfg);
+  MotionState st;
+  motion_state_reset(st);
+
+  // Путь считается от нулевого угла — начального состояния MotionState
+  int32_t pendingX = 0, pendingY = 0;
+  long sentX = 0, sentY = 0, truncatedX = 0;
+  size_t reportCount = 0;
+  float prevX = 0;
+  double pathX = 0; // путь без свертки угла в [-180, 180)
+  for (size_t i = 0; i < trace.size(); i++)
+  {
+    MouseDelta d;
+    if (motion_process_fixed(st, fixedCfg, q16_from_float(trace[i].x), q16_from_float(trace[i].y), MOTION_REF_PERIOD_US, d))
+    {
+      pendingX += d.x;
+      pendingY += d.y;
+    }
+    // Прежнее поведение: усечение каждого отсчета и обрезка до ±127
+    int old = (int)((trace[i].x - prevX) * 2.5f);
+    float step = trace[i].x - prevX;
+    pathX += step >= 180.0f ? step - 360.0f : (step < -180.0f ? step + 360.0f : step);
+    prevX = trace[i].x;
+    truncatedX += old > 127 ? 127 : (old < -127 ? -127 : old);
+
+    // До 4 отчетов за отсчет, остаток переносится
+    int8_t rx, ry;
+    for (int r = 0; r < 4 && motion_take_report(pendingX, pendingY, rx, ry); r++)
+    {
+      TEST_ASSERT_TRUE(rx >= -HID_DELTA_MAX && rx <= HID_DELTA_MAX);
+      TEST_ASSERT_TRUE(ry >= -HID_DELTA_MAX && ry <= HID_DELTA_MAX);
+      sentX += rx;
+      sentY += ry;
+      reportCount++;
+    }
+  }
+  int8_t rx, ry;
+  while (motion_take_report(pendingX, pendingY, rx, ry))
+  {
+    sentX += rx;
+    sentY += ry;
+  }
+
+  double expectedX = pathX * 2.5;
+  double expectedY = trace.back().y * 2.5;
+  char msg[128];
+  snprintf(msg, sizeof(msg), "trace %d: expected %.1f, sent %ld, old trunc+clamp %ld (%zu reports)", kind, expectedX, sentX, truncatedX, reportCount);
+  TEST_MESSAGE(msg);
+  TEST_ASSERT_FLOAT_WITHIN(1.0, expectedX, sentX);
+  TEST_ASSERT_FLOAT_WITHIN(1.0, expectedY, sentY);
+}
+
+void test_replay_preserves_slow_displacement()
+{
+  replay_preserves_displacement(1);
+}
+
+void test_replay_preserves_flick_displacement()
+{
+  replay_preserves_displacement(3);
+}
+
+void test_report_split_keeps_direction()
+{
+  int32_t px = 300, py = -30;
+  int8_t rx, ry;
+  int reports = 0;
+  while (motion_take_report(px, py, rx, ry))
+  {
+    TEST_ASSERT_EQUAL_INT8(100, rx);
+    TEST_ASSERT_EQUAL_INT8(-10, ry);
+    reports++;
+  }
+  TEST_ASSERT_EQUAL_INT(3, reports);
+  TEST_ASSERT_EQUAL_INT32(0, px);
+  TEST_ASSERT_EQUAL_INT32(0, py);
+
+  px = 1;
+  py = 128;
+  long sx = 0, sy = 0;
+  while (motion_take_report(px, py, rx, ry))
+  {
+    sx += rx;
+    sy += ry;
+  }
+  TEST_ASSERT_EQUAL_INT(1, sx);
+  TEST_ASSERT_EQUAL_INT(128, sy);
+}
+
+void test_rate_independent_thresholds()
+{
+  // Одинаковая угловая скорость при 100 Гц и 200 Гц должна одинаково проходить мертвую зону
+  MotionConfig cfg = default_config();
+  MotionFixedConfig fixedCfg;
+  motion_fixed_config_init(cfg, fixedCfg);
+  MotionState st;
+  MouseDelta d;
+
+  // 0.45° за 5 мс = 0.9° за 10 мс — выше мертвой зоны 0.5
+  motion_state_reset(st);
+  TEST_ASSERT_TRUE(motion_process_fixed(st, fixedCfg, q16_from_float(0.45f), 0, 5000, d));
+  motion_state_reset(st);
+  TEST_ASSERT_TRUE(motion_process_float(st, cfg, 0.45f, 0, 5000, d));
+
+  // 0.45° за 10 мс — ниже мертвой зоны
+  motion_state_reset(st);
+  TEST_ASSERT_FALSE(motion_process_fixed(st, fixedCfg, q16_from_float(0.45f), 0, 10000, d));
+  motion_state_reset(st);
+  TEST_ASSERT_FALSE(motion_process_float(st, cfg, 0.45f, 0, 10000, d));
+}
+
+void test_angle_wrap_is_small_move()
+{
+  // Угол переходит через 180 -> -180: это 2°, а не -358°
+  MotionConfig cfg = constant_gain_config(1.0f);
+  MotionFixedConfig fixedCfg;
+  motion_fixed_config_init(cfg, fixedCfg);
+  MotionState st;
+  MouseDelta d;
+
+  motion_state_reset(st);
+  motion_process_fixed(st, fixedCfg, q16_from_float(179.0f), 0, MOTION_REF_PERIOD_US, d);
+  TEST_ASSERT_TRUE(motion_process_fixed(st, fixedCfg, q16_from_float(-179.0f), 0, MOTION_REF_PERIOD_US, d));
+  TEST_ASSERT_EQUAL_INT16(2, d.x);
+
+  motion_state_reset(st);
+  motion_process_float(st, cfg, -179.0f, 0, MOTION_REF_PERIOD_US, d);
+  TEST_ASSERT_TRUE(motion_process_float(st, cfg, 179.0f, 0, MOTION_REF_PERIOD_US, d));
+  TEST_ASSERT_EQUAL_INT16(-2, d.x);
+}
+
+void test_benchmark_float_vs_fixed()
+{
+  std::vector<AngleSample> trace = make_trace(2, 20000);
+  std::vector<q16_t> qx, qy;
+  for (const auto &s : trace)
+  {
+    qx.push_back(q16_from_float(s.x));
+    qy.push_back(q16_from_float(s.y));
+  }
+  MotionConfig cfg = default_config();
+  MotionFixedConfig fixedCfg;
+  motion_fixed_config_init(cfg, fixedCfg);
+
+  const int rounds = 50;
+  volatile int sink = 0;
+  MotionState st;
+  MouseDelta d;
+
+  motion_state_reset(st);
+  auto t0 = std::chrono::steady_clock::now();
+  for (int r = 0; r < rounds; r++)
+    for (size_t i = 0; i < trace.size(); i++)
+      if (motion_process_float(st, cfg, trace[i].x, trace[i].y, MOTION_REF_PERIOD_US, d))
+        sink += d.x + d.y;
+  auto t1 = std::chrono::steady_clock::now();
+
+  motion_state_reset(st);
+  for (int r = 0; r < rounds; r++)
+    for (size_t i = 0; i < trace.size(); i++)
+      if (motion_process_fixed(st, fixedCfg, qx[i], qy[i], MOTION_REF_PERIOD_US, d))
+        sink += d.x + d.y;
+  auto t2 = std::chrono::steady_clock::now();
+
+  double samples = (double)rounds * trace.size();
+  double floatNs = std::chrono::duration<double, std::nano>(t1 - t0).count() / samples;
+  double fixedNs = std::chrono::duration<double, std::nano>(t2 - t1).count() / samples;
+  char msg[96];
+  snprintf(msg, sizeof(msg), "float: %.2f ns/sample, fixed Q16.16: %.2f ns/sample", floatNs, fixedNs);
+  TEST_MESSAGE(msg);
+  (void)sink;
+}
+
+int main(int argc, char **argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_rest_trace_matches);
+  RUN_TEST(test_slow_trace_matches);
+  RUN_TEST(test_circle_trace_matches);
+  RUN_TEST(test_sigmoid_curve_matches);
+  RUN_TEST(test_filtered_paths_match);
+  RUN_TEST(test_flick_trace_matches_without_clamp);
+  RUN_TEST(test_replay_preserves_slow_displacement);
+  RUN_TEST(test_replay_preserves_flick_displacement);
+  RUN_TEST(test_report_split_keeps_direction);
+  RUN_TEST(test_rate_independent_thresholds);
+  RUN_TEST(test_angle_wrap_is_small_move);
+  RUN_TEST(test_benchmark_float_vs_fixed);
+  return UNITY_END();
+}
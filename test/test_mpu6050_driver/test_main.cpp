@@ -0,0 +1,336 @@
+#include <unity.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <deque>
+#include "mpu6050_driver.h"
+#include "imu_filter.h"
+
+// === Фейковая шина: карта регистров одного MPU6050 с FIFO ===
+static uint8_t regs[128];
+static std::deque<uint8_t> fifo;
+static uint32_t readTransactions = 0;
+static uint32_t writeTransactions = 0;
+static uint32_t bytesRead = 0;
+static uint32_t fifoResets = 0;
+
+static bool fake_read(uint8_t addr, uint8_t reg, uint8_t *buf, uint8_t len)
+{
+  if (addr != MPU6050_ADDR)
+    return false;
+  readTransactions++;
+  bytesRead += len;
+  if (reg == MPU6050_FIFO_R_W)
+  {
+    // Регистр FIFO не инкрементируется — каждый байт выталкивается из очереди
+    for (uint8_t i = 0; i < len; i++)
+    {
+      buf[i] = fifo.empty() ? 0 : fifo.front();
+      if (!fifo.empty())
+        fifo.pop_front();
+    }
+    return true;
+  }
+  if (reg + len > (int)sizeof(regs))
+    return false;
+  size_t count = fifo.size() > MPU6050_FIFO_SIZE ? MPU6050_FIFO_SIZE : fifo.size();
+  regs[MPU6050_FIFO_COUNTH] = count >> 8;
+  regs[MPU6050_FIFO_COUNTH + 1] = count & 0xFF;
+  memcpy(buf, regs + reg, len);
+  return true;
+}
+
+static bool fake_write(uint8_t addr, uint8_t reg, uint8_t val)
+{
+  if (addr != MPU6050_ADDR || reg >= sizeof(regs))
+    return false;
+  regs[reg] = val;
+  writeTransactions++;
+  if (reg == MPU6050_USER_CTRL && (val & 0x04))
+  {
+    fifo.clear();
+    fifoResets++;
+  }
+  return true;
+}
+
+// Положить кадр в FIFO: номер кадра кодируется в gyroX для проверки порядка
+static void push_frame(int16_t seq)
+{
+  int16_t words[7] = {100, 200, 16384, 0, seq, 0, 0};
+  for (int i = 0; i < 7; i++)
+  {
+    fifo.push_back((uint16_t)words[i] >> 8);
+    fifo.push_back(words[i] & 0xFF);
+  }
+}
+
+static const I2cBus fakeBus = {fake_read, fake_write};
+
+static void put16(uint8_t reg, int16_t v)
+{
+  regs[reg] = (uint16_t)v >> 8;
+  regs[reg + 1] = v & 0xFF;
+}
+
+// Поставить в регистры отсчет: ускорение в g, гироскоп в град/с
+static void set_sample(float ax, float ay, float az, float gx, float gy, float gz)
+{
+  put16(0x3B, (int16_t)lroundf(ax * MPU6050_ACC_LSB));
+  put16(0x3D, (int16_t)lroundf(ay * MPU6050_ACC_LSB));
+  put16(0x3F, (int16_t)lroundf(az * MPU6050_ACC_LSB));
+  put16(0x41, (int16_t)((25.0f - 36.53f) * 340.0f));
+  put16(0x43, (int16_t)lroundf(gx * MPU6050_GYRO_LSB));
+  put16(0x45, (int16_t)lroundf(gy * MPU6050_GYRO_LSB));
+  put16(0x47, (int16_t)lroundf(gz * MPU6050_GYRO_LSB));
+}
+
+void setUp()
+{
+  memset(regs, 0, sizeof(regs));
+  fifo.clear();
+  readTransactions = writeTransactions = bytesRead = fifoResets = 0;
+}
+
+void tearDown() {}
+
+void test_begin_configures_ranges()
+{
+  Mpu6050 dev;
+  TEST_ASSERT_EQUAL(0, mpu6050_begin(dev, &fakeBus));
+  TEST_ASSERT_EQUAL_HEX8(0x01, regs[MPU6050_PWR_MGMT_1]);
+  TEST_ASSERT_EQUAL_HEX8(0x08, regs[MPU6050_GYRO_CONFIG]);
+  TEST_ASSERT_EQUAL_HEX8(0x00, regs[MPU6050_ACCEL_CONFIG]);
+}
+
+void test_single_burst_per_sample()
+{
+  Mpu6050 dev;
+  mpu6050_begin(dev, &fakeBus);
+  set_sample(0.5f, -0.25f, 1.0f, 10.0f, -20.0f, 30.0f);
+  readTransactions = bytesRead = 0;
+
+  ImuSample s;
+  TEST_ASSERT_TRUE(mpu6050_read(dev, s));
+  TEST_ASSERT_EQUAL(1, readTransactions);
+  TEST_ASSERT_EQUAL(MPU6050_BURST_LEN, bytesRead);
+  TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.5f, s.accX);
+  TEST_ASSERT_FLOAT_WITHIN(0.001f, -0.25f, s.accY);
+  TEST_ASSERT_FLOAT_WITHIN(0.001f, 1.0f, s.accZ);
+  TEST_ASSERT_FLOAT_WITHIN(0.02f, 10.0f, s.gyroX);
+  TEST_ASSERT_FLOAT_WITHIN(0.02f, -20.0f, s.gyroY);
+  TEST_ASSERT_FLOAT_WITHIN(0.02f, 30.0f, s.gyroZ);
+  TEST_ASSERT_FLOAT_WITHIN(0.1f, 25.0f, s.temp);
+}
+
+void test_gyro_offsets_removed()
+{
+  Mpu6050 dev;
+  mpu6050_begin(dev, &fakeBus);
+  set_sample(0, 0, 1.0f, 1.5f, -0.8f, 0.3f);
+  TEST_ASSERT_TRUE(mpu6050_calc_gyro_offsets(dev, 50));
+
+  ImuSample s;
+  mpu6050_read(dev, s);
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 0, s.gyroX);
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 0, s.gyroY);
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 0, s.gyroZ);
+}
+
+void test_filter_converges_to_tilt()
+{
+  Mpu6050 dev;
+  mpu6050_begin(dev, &fakeBus);
+  // Наклон 30° вокруг оси X
+  set_sample(0, sinf(30 * M_PI / 180), cosf(30 * M_PI / 180), 0, 0, 0);
+
+  ImuFilter f;
+  imu_filter_reset(f);
+  ImuSample s;
+  for (int i = 0; i < 300; i++)
+  {
+    mpu6050_read(dev, s);
+    imu_filter_update(f, s, 0.01f);
+  }
+  TEST_ASSERT_FLOAT_WITHIN(0.1f, 30.0f, f.angleX);
+  TEST_ASSERT_FLOAT_WITHIN(0.1f, 0.0f, f.angleY);
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, cosf(30 * M_PI / 180), f.accZ);
+}
+
+void test_filter_follows_gyro_short_term()
+{
+  ImuFilter f;
+  imu_filter_reset(f);
+  ImuSample s = {0, 0, 1.0f, 100.0f, 0, 0, 25.0f};
+  imu_filter_update(f, s, 0.01f); // первый отсчет — по акселерометру
+  for (int i = 0; i < 10; i++)
+    imu_filter_update(f, s, 0.01f);
+  // 100 град/с * 0.1 с = 10°, акселерометр тянет к 0 — итог чуть меньше
+  TEST_ASSERT_GREATER_THAN(8.0f, f.angleX);
+  TEST_ASSERT_LESS_THAN(10.0f, f.angleX);
+}
+
+void test_fifo_begin_sets_rate_and_interrupt()
+{
+  Mpu6050 dev;
+  mpu6050_begin(dev, &fakeBus);
+  TEST_ASSERT_TRUE(mpu6050_fifo_begin(dev, 200));
+  TEST_ASSERT_EQUAL(4, regs[MPU6050_SMPLRT_DIV]);
+  TEST_ASSERT_EQUAL(5000, dev.samplePeriodUs);
+  TEST_ASSERT_EQUAL_HEX8(0xF8, regs[MPU6050_FIFO_EN]);
+  TEST_ASSERT_EQUAL_HEX8(0x01, regs[MPU6050_INT_ENABLE]);
+  TEST_ASSERT_EQUAL_HEX8(0x40, regs[MPU6050_USER_CTRL]);
+  TEST_ASSERT_EQUAL(1, fifoResets);
+}
+
+void test_sample_rate_change_resets_fifo()
+{
+  Mpu6050 dev;
+  mpu6050_begin(dev, &fakeBus);
+  mpu6050_fifo_begin(dev, 200);
+  push_frame(1);
+  push_frame(2);
+  fifoResets = 0;
+  TEST_ASSERT_TRUE(mpu6050_set_sample_rate(dev, 25));
+  TEST_ASSERT_EQUAL(39, regs[MPU6050_SMPLRT_DIV]);
+  TEST_ASSERT_EQUAL(40000, dev.samplePeriodUs);
+  TEST_ASSERT_EQUAL(1, fifoResets);
+  TEST_ASSERT_EQUAL(0, fifo.size());
+}
+
+void test_fifo_drain_in_order_with_one_count_read()
+{
+  Mpu6050 dev;
+  mpu6050_begin(dev, &fakeBus);
+  mpu6050_fifo_begin(dev, 200);
+  for (int i = 0; i < 5; i++)
+    push_frame(i);
+  readTransactions = 0;
+
+  ImuTimedSample out[16];
+  TEST_ASSERT_EQUAL(5, mpu6050_fifo_drain(dev, out, 16));
+  TEST_ASSERT_EQUAL(2, readTransactions); // счетчик + один пакет кадров
+  for (int i = 0; i < 5; i++)
+  {
+    TEST_ASSERT_EQUAL(i, out[i].raw.gyroX);
+    TEST_ASSERT_EQUAL(16384, out[i].raw.accZ);
+  }
+  TEST_ASSERT_EQUAL(0, (int)fifo.size());
+}
+
+void test_fifo_drain_splits_bursts_and_keeps_newest()
+{
+  Mpu6050 dev;
+  mpu6050_begin(dev, &fakeBus);
+  mpu6050_fifo_begin(dev, 200);
+  for (int i = 0; i < 20; i++)
+    push_frame(i);
+
+  ImuTimedSample out[16];
+  TEST_ASSERT_EQUAL(16, mpu6050_fifo_drain(dev, out, 16));
+  TEST_ASSERT_EQUAL(4, out[0].raw.gyroX); // 4 самых старых отброшены
+  TEST_ASSERT_EQUAL(19, out[15].raw.gyroX);
+  TEST_ASSERT_EQUAL(0, (int)fifo.size());
+}
+
+void test_fifo_overflow_and_misalignment_reset()
+{
+  Mpu6050 dev;
+  mpu6050_begin(dev, &fakeBus);
+  mpu6050_fifo_begin(dev, 200);
+  uint32_t resets = fifoResets;
+
+  for (int i = 0; i < 80; i++) // 1120 байт — переполнение
+    push_frame(i);
+  ImuTimedSample out[16];
+  TEST_ASSERT_EQUAL(0, mpu6050_fifo_drain(dev, out, 16));
+  TEST_ASSERT_EQUAL(1, dev.fifoOverflows);
+  TEST_ASSERT_EQUAL(resets + 1, fifoResets);
+
+  push_frame(1);
+  fifo.push_back(0); // неполный кадр
+  TEST_ASSERT_EQUAL(0, mpu6050_fifo_drain(dev, out, 16));
+  TEST_ASSERT_EQUAL(2, dev.fifoOverflows);
+
+  push_frame(7);
+  TEST_ASSERT_EQUAL(1, mpu6050_fifo_drain(dev, out, 16));
+  TEST_ASSERT_EQUAL(7, out[0].raw.gyroX);
+}
+
+void test_timestamps_follow_sample_clock_not_loop_jitter()
+{
+  ImuTimestamper ts;
+  imu_timestamper_reset(ts, 5000);
+  ImuTimedSample s[4];
+
+  // Первая пачка: 2 кадра, последний — в 100000 мкс
+  imu_timestamper_apply(ts, s, 2, 100000);
+  TEST_ASSERT_EQUAL(95000, s[0].tUs);
+  TEST_ASSERT_EQUAL(100000, s[1].tUs);
+  TEST_ASSERT_EQUAL(5000, s[1].dtUs);
+
+  // Цикл опоздал: 3 кадра, последний — в 115000 мкс
+  imu_timestamper_apply(ts, s, 3, 115000);
+  for (int i = 0; i < 3; i++)
+  {
+    TEST_ASSERT_EQUAL(105000 + i * 5000, s[i].tUs);
+    TEST_ASSERT_EQUAL(5000, s[i].dtUs);
+  }
+
+  // Отметка прерывания не обновилась — кадр сдвигается на период
+  imu_timestamper_apply(ts, s, 1, 115000);
+  TEST_ASSERT_EQUAL(120000, s[0].tUs);
+  TEST_ASSERT_EQUAL(5000, s[0].dtUs);
+
+  // Переход через переполнение micros()
+  imu_timestamper_reset(ts, 5000);
+  imu_timestamper_apply(ts, s, 1, 0xFFFFF000u);
+  imu_timestamper_apply(ts, s, 1, 0xFFFFF000u + 5000);
+  TEST_ASSERT_EQUAL(5000, s[0].dtUs);
+}
+
+void test_benchmark_read_and_filter()
+{
+  Mpu6050 dev;
+  mpu6050_begin(dev, &fakeBus);
+  set_sample(0.1f, 0.2f, 0.97f, 5.0f, -3.0f, 1.0f);
+  ImuFilter f;
+  imu_filter_reset(f);
+
+  const int samples = 200000;
+  readTransactions = bytesRead = 0;
+  ImuSample s;
+  auto t0 = std::chrono::steady_clock::now();
+  for (int i = 0; i < samples; i++)
+  {
+    mpu6050_read(dev, s);
+    imu_filter_update(f, s, 0.01f);
+  }
+  auto t1 = std::chrono::steady_clock::now();
+
+  TEST_ASSERT_EQUAL(samples, readTransactions);
+  char msg[128];
+  snprintf(msg, sizeof(msg), "read+filter: %.1f ns/sample, %.1f I2C transactions/sample, %.1f bytes/sample",
+           std::chrono::duration<double, std::nano>(t1 - t0).count() / samples,
+           (double)readTransactions / samples, (double)bytesRead / samples);
+  TEST_MESSAGE(msg);
+}
+
+int main(int argc, char **argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_begin_configures_ranges);
+  RUN_TEST(test_single_burst_per_sample);
+  RUN_TEST(test_gyro_offsets_removed);
+  RUN_TEST(test_filter_converges_to_tilt);
+  RUN_TEST(test_filter_follows_gyro_short_term);
+  RUN_TEST(test_fifo_begin_sets_rate_and_interrupt);
+  RUN_TEST(test_sample_rate_change_resets_fifo);
+  RUN_TEST(test_fifo_drain_in_order_with_one_count_read);
+  RUN_TEST(test_fifo_drain_splits_bursts_and_keeps_newest);
+  RUN_TEST(test_fifo_overflow_and_misalignment_reset);
+  RUN_TEST(test_timestamps_follow_sample_clock_not_loop_jitter);
+  RUN_TEST(test_benchmark_read_and_filter);
+  return UNITY_END();
+}
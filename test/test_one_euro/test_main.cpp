@@ -0,0 +1,200 @@
+#include <unity.h>
+#include <math.h>
+#include <stdio.h>
+#include <vector>
+#include "one_euro.h"
+
+#define DT_US 5000 // 200 Гц, как IMU_SAMPLE_RATE_HZ
+#define SCALE 2.0f // приведение к опорному периоду 10 мс
+
+static uint32_t rng_state = 4242;
+static float gauss(float sigma)
+{
+  // Сумма 4 равномерных — достаточно близко к нормальному шуму
+  float sum = 0;
+  for (int i = 0; i < 4; i++)
+  {
+    rng_state = rng_state * 1664525u + 1013904223u;
+    sum += (rng_state >> 8) / 16777216.0f - 0.5f;
+  }
+  return sum * sigma * 1.732f;
+}
+
+static float magnitude(float x, float y)
+{
+  float ax = fabsf(x), ay = fabsf(y);
+  return ax > ay ? ax + ay * 0.375f : ay + ax * 0.375f;
+}
+
+static OneEuroConfig default_filter()
+{
+  OneEuroConfig cfg;
+  cfg.enabled = true;
+  cfg.minCutoff = 1.0f;
+  cfg.beta = 16.0f;
+  cfg.dCutoff = 10.0f;
+  return cfg;
+}
+
+// Записанный поток смещений за отсчет (градусы): покой, разгон, ведение, остановка
+static std::vector<float> make_trace(float restNoise, float speed, size_t restLen, size_t moveLen)
+{
+  std::vector<float> dx;
+  for (size_t i = 0; i < restLen; i++)
+    dx.push_back(gauss(restNoise));
+  for (size_t i = 0; i < moveLen; i++)
+    dx.push_back(speed + gauss(restNoise));
+  for (size_t i = 0; i < restLen; i++)
+    dx.push_back(gauss(restNoise));
+  return dx;
+}
+
+struct FilterStats
+{
+  float restJitter;   // СКО смещения в покое после фильтра
+  float rawJitter;    // СКО до фильтра
+  float lagSamples;   // накопленное отставание пути в установившемся движении, в отсчетах
+  float totalError;   // потеря пути с учетом еще не выданного отставания (градусы)
+};
+
+static FilterStats run_float(const OneEuroConfig &cfg, const std::vector<float> &trace, size_t restLen, size_t moveLen, float speed)
+{
+  OneEuroState st;
+  one_euro_reset(st);
+  FilterStats stats = {};
+  double sumRaw = 0, sumOut = 0, restSq = 0, rawSq = 0, lagAcc = 0;
+  size_t lagCount = 0;
+  for (size_t i = 0; i < trace.size(); i++)
+  {
+    float x = trace[i], y = 0;
+    one_euro_float(st, cfg, x, y, magnitude(trace[i] * SCALE, 0), DT_US);
+    sumRaw += trace[i];
+    sumOut += x;
+    if (i > 50 && i < restLen)
+    {
+      restSq += x * x;
+      rawSq += trace[i] * trace[i];
+    }
+    // Установившееся движение: вторая половина участка
+    if (i > restLen + moveLen / 2 && i < restLen + moveLen)
+    {
+      lagAcc += (sumRaw - sumOut) / speed;
+      lagCount++;
+    }
+  }
+  stats.restJitter = sqrt(restSq / (restLen - 51));
+  stats.rawJitter = sqrt(rawSq / (restLen - 51));
+  stats.lagSamples = lagAcc / lagCount;
+  stats.totalError = fabs(sumRaw - sumOut - st.x); // st.x — отставание, которое еще будет выдано
+  return stats;
+}
+
+static FilterStats run_fixed(const OneEuroConfig &cfg, const std::vector<float> &trace, size_t restLen, size_t moveLen, float speed)
+{
+  OneEuroFixedConfig fcfg;
+  one_euro_fixed_config_init(cfg, fcfg);
+  OneEuroState st;
+  one_euro_reset(st);
+  FilterStats stats = {};
+  double sumRaw = 0, sumOut = 0, restSq = 0, rawSq = 0, lagAcc = 0;
+  size_t lagCount = 0;
+  for (size_t i = 0; i < trace.size(); i++)
+  {
+    q16_t x = q16_from_float(trace[i]), y = 0;
+    one_euro_fixed(st, fcfg, x, y, q16_from_float(magnitude(trace[i] * SCALE, 0)), DT_US);
+    float out = q16_to_float(x);
+    sumRaw += trace[i];
+    sumOut += out;
+    if (i > 50 && i < restLen)
+    {
+      restSq += out * out;
+      rawSq += trace[i] * trace[i];
+    }
+    if (i > restLen + moveLen / 2 && i < restLen + moveLen)
+    {
+      lagAcc += (sumRaw - sumOut) / speed;
+      lagCount++;
+    }
+  }
+  stats.restJitter = sqrt(restSq / (restLen - 51));
+  stats.rawJitter = sqrt(rawSq / (restLen - 51));
+  stats.lagSamples = lagAcc / lagCount;
+  stats.totalError = fabs(sumRaw - sumOut - q16_to_float(st.xq));
+  return stats;
+}
+
+static void report(const char *name, const FilterStats &s)
+{
+  char msg[160];
+  snprintf(msg, sizeof(msg), "%-14s jitter %.4f -> %.4f deg (x%.1f), lag %.2f samples, path error %.4f deg",
+           name, s.rawJitter, s.restJitter, s.rawJitter / s.restJitter, s.lagSamples, s.totalError);
+  TEST_MESSAGE(msg);
+}
+
+void test_benchmark_slow_and_fast_motion()
+{
+  const size_t restLen = 1000, moveLen = 400;
+  OneEuroConfig cfg = default_filter();
+  const float speeds[] = {0.25f, 1.0f, 3.0f}; // градусы за отсчет 5 мс
+  for (float speed : speeds)
+  {
+    std::vector<float> trace = make_trace(0.05f, speed, restLen, moveLen);
+    FilterStats f = run_float(cfg, trace, restLen, moveLen, speed);
+    FilterStats q = run_fixed(cfg, trace, restLen, moveLen, speed);
+    char name[32];
+    snprintf(name, sizeof(name), "float v=%.2f", speed);
+    report(name, f);
+    snprintf(name, sizeof(name), "Q16.16 v=%.2f", speed);
+    report(name, q);
+
+    // Фиксированная точка повторяет float
+    TEST_ASSERT_FLOAT_WITHIN(0.002f, f.restJitter, q.restJitter);
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, f.lagSamples, q.lagSamples);
+    // Путь сохраняется — фильтр только задерживает
+    TEST_ASSERT_LESS_THAN(0.01f, f.totalError);
+    TEST_ASSERT_LESS_THAN(0.01f, q.totalError);
+    // В покое дрожание заметно меньше
+    TEST_ASSERT_LESS_THAN(f.rawJitter / 3, f.restJitter);
+  }
+}
+
+void test_lag_shrinks_with_speed()
+{
+  const size_t restLen = 600, moveLen = 400;
+  OneEuroConfig cfg = default_filter();
+  std::vector<float> slow = make_trace(0.05f, 0.25f, restLen, moveLen);
+  std::vector<float> fast = make_trace(0.05f, 3.0f, restLen, moveLen);
+  FilterStats s = run_fixed(cfg, slow, restLen, moveLen, 0.25f);
+  FilterStats f = run_fixed(cfg, fast, restLen, moveLen, 3.0f);
+  TEST_ASSERT_LESS_THAN(s.lagSamples, f.lagSamples);
+  TEST_ASSERT_LESS_THAN(1.0f, f.lagSamples);
+}
+
+void test_cutoff_cache_follows_config()
+{
+  OneEuroConfig cfg = default_filter();
+  OneEuroFixedConfig fcfg;
+  one_euro_fixed_config_init(cfg, fcfg);
+  OneEuroState st;
+  one_euro_reset(st);
+  q16_t x = 0, y = 0;
+  one_euro_fixed(st, fcfg, x, y, 0, DT_US);
+  x = y = 0;
+  one_euro_fixed(st, fcfg, x, y, 0, DT_US);
+  q16_t alphaD = st.alphaD;
+
+  cfg.dCutoff = 40.0f;
+  one_euro_fixed_config_init(cfg, fcfg);
+  x = y = 0;
+  one_euro_fixed(st, fcfg, x, y, 0, DT_US);
+  TEST_ASSERT_GREATER_THAN(alphaD, st.alphaD);
+}
+
+int main(int argc, char **argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_benchmark_slow_and_fast_motion);
+  RUN_TEST(test_lag_shrinks_with_speed);
+  RUN_TEST(test_cutoff_cache_follows_config);
+  return UNITY_END();
+}
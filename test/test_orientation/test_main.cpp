@@ -0,0 +1,147 @@
+#include <unity.h>
+#include <math.h>
+#include "orientation.h"
+
+#define PERIOD_S 0.005f
+
+// Покой в наклоне: поворот устройства R = Rx(pitchDeg) * Ry(rollDeg), мир -> устройство через R^T
+static void body_from_world(float pitchDeg, float rollDeg, const float w[3], float out[3])
+{
+  float a = pitchDeg * 0.017453293f, b = rollDeg * 0.017453293f;
+  float ca = cosf(a), sa = sinf(a), cb = cosf(b), sb = sinf(b);
+  // R = Rx(a) * Ry(b)
+  float r[3][3] = {
+      {cb, 0, sb},
+      {sa * sb, ca, -sa * cb},
+      {-ca * sb, sa, ca * cb}};
+  for (int i = 0; i < 3; i++)
+    out[i] = r[0][i] * w[0] + r[1][i] * w[1] + r[2][i] * w[2];
+}
+
+static ImuSample tilted_sample(float pitchDeg, float rollDeg, const float worldRate[3])
+{
+  const float up[3] = {0, 0, 1};
+  float acc[3], gyro[3];
+  body_from_world(pitchDeg, rollDeg, up, acc);
+  body_from_world(pitchDeg, rollDeg, worldRate, gyro);
+  ImuSample s = {acc[0], acc[1], acc[2], gyro[0], gyro[1], gyro[2], 30.0f};
+  return s;
+}
+
+// Поворот вокруг вертикали с постоянной скоростью — наклон не меняется
+static void run_yaw(float pitchDeg, float rollDeg, float rate, OrientationFilter &f)
+{
+  orientation_reset(f, 1.0f, 0.0f);
+  const float still[3] = {0, 0, 0};
+  ImuSample rest = tilted_sample(pitchDeg, rollDeg, still);
+  for (int i = 0; i < 200; i++)
+    orientation_update(f, rest, PERIOD_S);
+  const float yaw[3] = {0, 0, rate};
+  ImuSample s = tilted_sample(pitchDeg, rollDeg, yaw);
+  float startYaw = f.yaw, startPitch = f.pitch;
+  for (int i = 0; i < 200; i++) // 1 с
+    orientation_update(f, s, PERIOD_S);
+  f.yaw -= startYaw;
+  f.pitch -= startPitch;
+}
+
+void test_level_yaw()
+{
+  OrientationFilter f;
+  run_yaw(0, 0, 60.0f, f);
+  TEST_ASSERT_FLOAT_WITHIN(0.5f, 60.0f, f.yaw);
+  TEST_ASSERT_FLOAT_WITHIN(0.5f, 0.0f, f.pitch);
+}
+
+void test_yaw_rate_independent_of_tilt()
+{
+  // Пульт поднят на 50° и завален на 60°: в углах Эйлера рыскание ушло бы в другие оси
+  OrientationFilter f;
+  run_yaw(50, 0, 60.0f, f);
+  TEST_ASSERT_FLOAT_WITHIN(1.0f, 60.0f, f.yaw);
+  TEST_ASSERT_FLOAT_WITHIN(1.0f, 0.0f, f.pitch);
+  run_yaw(0, 60, -60.0f, f);
+  TEST_ASSERT_FLOAT_WITHIN(1.0f, -60.0f, f.yaw);
+  TEST_ASSERT_FLOAT_WITHIN(1.0f, 0.0f, f.pitch);
+}
+
+void test_pitch_under_roll()
+{
+  // Завален на 45°, поворот вверх вокруг горизонтальной поперечной оси
+  OrientationFilter f;
+  orientation_reset(f, 1.0f, 0.0f);
+  const float still[3] = {0, 0, 0};
+  ImuSample rest = tilted_sample(0, 45, still);
+  for (int i = 0; i < 200; i++)
+    orientation_update(f, rest, PERIOD_S);
+  const float up[3] = {30.0f, 0, 0};
+  float start = f.pitch;
+  for (int i = 0; i < 200; i++)
+  {
+    ImuSample s = tilted_sample(i * PERIOD_S * 30.0f, 45, up);
+    orientation_update(f, s, PERIOD_S);
+  }
+  TEST_ASSERT_FLOAT_WITHIN(1.0f, 30.0f, f.pitch - start);
+  TEST_ASSERT_FLOAT_WITHIN(1.0f, 0.0f, f.yaw);
+}
+
+void test_yaw_wraps()
+{
+  OrientationFilter f;
+  run_yaw(0, 0, 400.0f, f);
+  // 400° за секунду: накопленный угол свернут в [-180, 180), остаток — 40°
+  TEST_ASSERT_FLOAT_WITHIN(1.0f, 40.0f, f.yaw);
+}
+
+void test_mount_matrix_validation()
+{
+  int8_t m[MOUNT_MATRIX_SIZE];
+  mount_matrix_default(m, 0, false);
+  int8_t identity[MOUNT_MATRIX_SIZE] = {1, 0, 0, 0, 1, 0, 0, 0, 1};
+  TEST_ASSERT_EQUAL_INT8_ARRAY(identity, m, MOUNT_MATRIX_SIZE);
+  TEST_ASSERT_TRUE(mount_matrix_valid(m));
+
+  for (int16_t rot = 0; rot < 360; rot += 90)
+  {
+    mount_matrix_default(m, rot, true);
+    TEST_ASSERT_TRUE(mount_matrix_valid(m));
+  }
+
+  int8_t mirror[MOUNT_MATRIX_SIZE] = {-1, 0, 0, 0, 1, 0, 0, 0, 1}; // отражение, определитель -1
+  TEST_ASSERT_FALSE(mount_matrix_valid(mirror));
+  int8_t dup[MOUNT_MATRIX_SIZE] = {1, 0, 0, 1, 0, 0, 0, 0, 1};
+  TEST_ASSERT_FALSE(mount_matrix_valid(dup));
+  int8_t big[MOUNT_MATRIX_SIZE] = {2, 0, 0, 0, 1, 0, 0, 0, 1};
+  TEST_ASSERT_FALSE(mount_matrix_valid(big));
+}
+
+void test_mount_apply_rotation()
+{
+  // Датчик повернут на 90°: его X — это Y устройства
+  int8_t m[MOUNT_MATRIX_SIZE];
+  mount_matrix_default(m, 90, false);
+  ImuSample s = {1.0f, 0, 0, 10.0f, 0, 5.0f, 30.0f};
+  mount_apply(m, s);
+  TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.0f, s.accX);
+  TEST_ASSERT_FLOAT_WITHIN(1e-6f, 1.0f, s.accY);
+  TEST_ASSERT_FLOAT_WITHIN(1e-6f, 10.0f, s.gyroY);
+  TEST_ASSERT_FLOAT_WITHIN(1e-6f, 5.0f, s.gyroZ);
+
+  // Перевернутый датчик: Z вниз
+  mount_matrix_default(m, 0, true);
+  ImuSample flipped = {0, 0, -1.0f, 0, 0, 0, 30.0f};
+  mount_apply(m, flipped);
+  TEST_ASSERT_FLOAT_WITHIN(1e-6f, 1.0f, flipped.accZ);
+}
+
+int main(int argc, char **argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_level_yaw);
+  RUN_TEST(test_yaw_rate_independent_of_tilt);
+  RUN_TEST(test_pitch_under_roll);
+  RUN_TEST(test_yaw_wraps);
+  RUN_TEST(test_mount_matrix_validation);
+  RUN_TEST(test_mount_apply_rotation);
+  return UNITY_END();
+}
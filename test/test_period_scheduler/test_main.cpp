@@ -0,0 +1,199 @@
+#include <unity.h>
+#include "period_scheduler.h"
+
+// Виртуальные часы: задачи «работают», сдвигая время на заданное число мкс
+static uint32_t nowUs;
+static uint32_t virtual_clock() { return nowUs; }
+
+static uint32_t workA, workB;
+static uint32_t runsA, runsB;
+static uint32_t startsA[64];
+static void job_a()
+{
+  if (runsA < 64)
+    startsA[runsA] = nowUs;
+  runsA++;
+  nowUs += workA;
+}
+static void job_b()
+{
+  runsB++;
+  nowUs += workB;
+}
+
+// Цикл задачи: выполнить готовое и «проспать» до следующего периода, как vTaskDelayUntil
+static void run_until(PeriodScheduler &s, uint32_t endUs)
+{
+  while (nowUs < endUs)
+  {
+    uint32_t wait = sched_run_due(s, virtual_clock);
+    nowUs += wait ? wait : 1;
+  }
+}
+
+static void setup(PeriodScheduler &s, uint32_t start)
+{
+  nowUs = start;
+  workA = workB = 0;
+  runsA = runsB = 0;
+  sched_init(s, "test");
+}
+
+void test_runs_at_exact_periods()
+{
+  PeriodScheduler s;
+  setup(s, 1000);
+  sched_add(s, "a", job_a, 5000);
+  sched_add(s, "b", job_b, 2000);
+  sched_start(s, nowUs);
+  run_until(s, 1000 + 100000);
+  TEST_ASSERT_EQUAL_UINT32(20, runsA);
+  TEST_ASSERT_EQUAL_UINT32(50, runsB);
+  for (uint32_t i = 0; i < 20; i++)
+    TEST_ASSERT_EQUAL_UINT32(1000 + i * 5000, startsA[i]);
+  TEST_ASSERT_EQUAL_UINT32(0, s.jobs[0].misses);
+  TEST_ASSERT_EQUAL_UINT32(0, s.jobs[1].misses);
+}
+
+void test_work_time_does_not_drift()
+{
+  // Задача работает 1.3 мс из 5 мс — старт все равно по сетке, а не через 5 мс после конца
+  PeriodScheduler s;
+  setup(s, 0);
+  workA = 1300;
+  sched_add(s, "a", job_a, 5000);
+  sched_start(s, nowUs);
+  run_until(s, 5000 * 40);
+  TEST_ASSERT_EQUAL_UINT32(40, runsA);
+  TEST_ASSERT_EQUAL_UINT32(39 * 5000, startsA[39]);
+  TEST_ASSERT_EQUAL_UINT32(0, s.jobs[0].misses);
+  TEST_ASSERT_EQUAL_UINT32(1300, s.jobs[0].maxRunUs);
+}
+
+void test_lower_priority_job_delayed_not_missed()
+{
+  // b ждет, пока работает a, но успевает в свой период
+  PeriodScheduler s;
+  setup(s, 0);
+  workA = 800;
+  sched_add(s, "a", job_a, 5000);
+  sched_add(s, "b", job_b, 2000);
+  sched_start(s, nowUs);
+  run_until(s, 100000);
+  TEST_ASSERT_EQUAL_UINT32(50, runsB);
+  TEST_ASSERT_EQUAL_UINT32(0, s.jobs[1].misses);
+  TEST_ASSERT_EQUAL_UINT32(800, s.jobs[1].maxLateUs);
+}
+
+void test_overrun_counts_misses_without_burst()
+{
+  PeriodScheduler s;
+  setup(s, 0);
+  sched_add(s, "a", job_a, 2000);
+  sched_add(s, "b", job_b, 2000);
+  sched_start(s, nowUs);
+  run_until(s, 10000);
+  TEST_ASSERT_EQUAL_UINT32(5, runsA);
+
+  // Один запуск b занял 9 мс: у a пропущены периоды 12, 14 и 16 мс, период 18 мс начат в 19 мс
+  workB = 9000;
+  uint32_t wait = sched_run_due(s, virtual_clock);
+  TEST_ASSERT_EQUAL_UINT32(19000, nowUs);
+  TEST_ASSERT_EQUAL_UINT32(0, wait);
+  workB = 0;
+  uint32_t before = runsA;
+  sched_run_due(s, virtual_clock);
+  // Один запуск вместо пачки догоняющих, дальше снова по старой сетке
+  TEST_ASSERT_EQUAL_UINT32(before + 1, runsA);
+  TEST_ASSERT_EQUAL_UINT32(3, s.jobs[0].misses);
+  TEST_ASSERT_EQUAL_UINT32(3, s.jobs[1].misses);
+  TEST_ASSERT_EQUAL_UINT32(7000, s.jobs[0].maxLateUs);
+  TEST_ASSERT_EQUAL_UINT32(1000, sched_run_due(s, virtual_clock));
+  run_until(s, 30000);
+  TEST_ASSERT_EQUAL_UINT32(28000, startsA[runsA - 1]);
+  TEST_ASSERT_EQUAL_UINT32(3, s.jobs[0].misses);
+}
+
+void test_histogram_buckets()
+{
+  PeriodScheduler s;
+  setup(s, 0);
+  sched_add(s, "a", job_a, 10000);
+  sched_start(s, nowUs);
+  const uint32_t work[] = {10, 49, 50, 150, 999, 4999, 5000, 9000};
+  for (uint32_t w : work)
+  {
+    workA = w;
+    sched_run_due(s, virtual_clock);
+    nowUs = s.jobs[0].releaseUs;
+  }
+  const SchedJob &j = s.jobs[0];
+  TEST_ASSERT_EQUAL_UINT32(2, j.hist[0]); // < 50
+  TEST_ASSERT_EQUAL_UINT32(1, j.hist[1]); // 50..100
+  TEST_ASSERT_EQUAL_UINT32(1, j.hist[2]); // 100..200
+  TEST_ASSERT_EQUAL_UINT32(0, j.hist[3]);
+  TEST_ASSERT_EQUAL_UINT32(1, j.hist[4]); // 500..1000
+  TEST_ASSERT_EQUAL_UINT32(0, j.hist[5]);
+  TEST_ASSERT_EQUAL_UINT32(1, j.hist[6]); // 2000..5000
+  TEST_ASSERT_EQUAL_UINT32(2, j.hist[7]); // >= 5000
+  TEST_ASSERT_EQUAL_UINT32(9000, j.maxRunUs);
+  TEST_ASSERT_EQUAL_UINT32(8, j.runs);
+
+  // Сброс по запросу применяется на следующем проходе, задача в нем уже учитывается заново
+  s.resetPending = true;
+  workA = 10;
+  sched_run_due(s, virtual_clock);
+  TEST_ASSERT_FALSE(s.resetPending);
+  TEST_ASSERT_EQUAL_UINT32(1, s.jobs[0].runs);
+  TEST_ASSERT_EQUAL_UINT32(1, s.jobs[0].hist[0]);
+  sched_reset_stats(s, nowUs);
+  TEST_ASSERT_EQUAL_UINT32(0, s.jobs[0].runs);
+  TEST_ASSERT_EQUAL_UINT32(0, s.jobs[0].hist[7]);
+  TEST_ASSERT_EQUAL_UINT32(0, s.jobs[0].maxRunUs);
+}
+
+void test_wait_and_clock_wrap()
+{
+  // Переполнение micros() через ~71 минуту не ломает сетку
+  PeriodScheduler s;
+  setup(s, 0xFFFFFFFFu - 3000);
+  sched_add(s, "a", job_a, 5000);
+  sched_add(s, "b", job_b, 2000);
+  sched_start(s, nowUs);
+  TEST_ASSERT_EQUAL_UINT32(2000, sched_run_due(s, virtual_clock));
+  nowUs += 2000;
+  TEST_ASSERT_EQUAL_UINT32(2000, sched_run_due(s, virtual_clock));
+  nowUs += 2000;
+  TEST_ASSERT_EQUAL_UINT32(1000, sched_run_due(s, virtual_clock));
+  run_until(s, 100000);
+  TEST_ASSERT_EQUAL_UINT32(0, s.jobs[0].misses);
+  TEST_ASSERT_EQUAL_UINT32(0, s.jobs[1].misses);
+  TEST_ASSERT_UINT32_WITHIN(1, 21, runsA);
+}
+
+void test_add_limits()
+{
+  PeriodScheduler s;
+  setup(s, 0);
+  TEST_ASSERT_EQUAL_INT8(-1, sched_add(s, "zero", job_a, 0));
+  TEST_ASSERT_EQUAL_INT8(-1, sched_add(s, "null", nullptr, 1000));
+  for (int i = 0; i < SCHED_MAX_JOBS; i++)
+    TEST_ASSERT_EQUAL_INT8(i, sched_add(s, "a", job_a, 1000));
+  TEST_ASSERT_EQUAL_INT8(-1, sched_add(s, "over", job_a, 1000));
+  PeriodScheduler empty;
+  sched_init(empty, "empty");
+  TEST_ASSERT_EQUAL_UINT32(0, sched_run_due(empty, virtual_clock));
+}
+
+int main(int argc, char **argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_runs_at_exact_periods);
+  RUN_TEST(test_work_time_does_not_drift);
+  RUN_TEST(test_lower_priority_job_delayed_not_missed);
+  RUN_TEST(test_overrun_counts_misses_without_burst);
+  RUN_TEST(test_histogram_buckets);
+  RUN_TEST(test_wait_and_clock_wrap);
+  RUN_TEST(test_add_limits);
+  return UNITY_END();
+}
@@ -0,0 +1,283 @@
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "report_scheduler.h"
+#include "motion_pipeline.h"
+
+// Имитация канала: опрос каждую 1 мс, движение от датчика 1 кГц
+struct Harness
+{
+  ReportScheduler s;
+  uint32_t nowUs;
+  long sumX, sumY;
+  long sumWheel;
+  int maxWheel;
+  uint32_t reports;
+  uint32_t lastReportUs;
+  uint32_t minGapUs;
+  uint8_t buttons;
+  uint32_t buttonEdges;
+};
+
+static void harness_init(Harness &h, uint32_t intervalUs, uint8_t backlog = 8)
+{
+  h = {};
+  report_scheduler_init(h.s, intervalUs, backlog);
+  h.minGapUs = 0xFFFFFFFF;
+}
+
+static void harness_poll(Harness &h, ReportLink link = REPORT_LINK_READY)
+{
+  HidMouseReport r;
+  if (!report_scheduler_poll(h.s, h.nowUs, link, r))
+    return;
+  if (h.reports)
+  {
+    uint32_t gap = h.nowUs - h.lastReportUs;
+    if (gap < h.minGapUs)
+      h.minGapUs = gap;
+  }
+  h.lastReportUs = h.nowUs;
+  h.reports++;
+  h.sumX += r.x;
+  h.sumY += r.y;
+  h.sumWheel += r.wheel;
+  if (abs(r.wheel) > h.maxWheel)
+    h.maxWheel = abs(r.wheel);
+  if (r.buttons != h.buttons)
+    h.buttonEdges++;
+  h.buttons = r.buttons;
+}
+
+void test_rate_limited_and_displacement_preserved()
+{
+  Harness h;
+  harness_init(h, 7500);
+  long addedX = 0, addedY = 0;
+  for (int ms = 0; ms < 1000; ms++)
+  {
+    int dx = (ms % 7) - 2, dy = (ms % 5 == 0) ? 3 : -1;
+    report_scheduler_add_motion(h.s, dx, dy);
+    addedX += dx;
+    addedY += dy;
+    h.nowUs = ms * 1000;
+    harness_poll(h);
+  }
+  for (int ms = 1000; ms < 1100; ms++)
+  {
+    h.nowUs = ms * 1000;
+    harness_poll(h);
+  }
+
+  char msg[96];
+  snprintf(msg, sizeof(msg), "1000 motion events -> %u reports, min gap %u us", (unsigned)h.reports, (unsigned)h.minGapUs);
+  TEST_MESSAGE(msg);
+  // 1 с при 7.5 мс — около 134 отчетов вместо 1000
+  TEST_ASSERT_LESS_OR_EQUAL(135, h.reports);
+  // Сетка 7.5 мс при опросе раз в 1 мс: отдельные промежутки 7 или 8 мс, в среднем не меньше интервала
+  TEST_ASSERT_GREATER_OR_EQUAL(7000, h.minGapUs);
+  TEST_ASSERT_GREATER_OR_EQUAL(7500, h.lastReportUs / (h.reports - 1));
+  TEST_ASSERT_EQUAL(addedX, h.sumX);
+  TEST_ASSERT_EQUAL(addedY, h.sumY);
+  TEST_ASSERT_FALSE(report_scheduler_pending(h.s));
+}
+
+void test_idle_sends_nothing()
+{
+  Harness h;
+  harness_init(h, 7500);
+  for (int ms = 0; ms < 500; ms++)
+  {
+    h.nowUs = ms * 1000;
+    harness_poll(h);
+  }
+  TEST_ASSERT_EQUAL_UINT32(0, h.reports);
+}
+
+void test_first_report_after_idle_is_immediate()
+{
+  Harness h;
+  harness_init(h, 7500);
+  h.nowUs = 50000;
+  report_scheduler_add_motion(h.s, 5, 0);
+  harness_poll(h);
+  TEST_ASSERT_EQUAL_UINT32(1, h.reports);
+
+  // После долгого простоя — снова сразу, без ожидания старой сетки
+  h.nowUs = 400000;
+  report_scheduler_add_motion(h.s, 5, 0);
+  harness_poll(h);
+  TEST_ASSERT_EQUAL_UINT32(2, h.reports);
+}
+
+void test_large_motion_split_over_intervals()
+{
+  Harness h;
+  harness_init(h, 7500);
+  report_scheduler_add_motion(h.s, 500, -250);
+  for (int ms = 0; ms < 100; ms++)
+  {
+    h.nowUs = ms * 1000;
+    harness_poll(h);
+  }
+  TEST_ASSERT_EQUAL_UINT32(4, h.reports);
+  TEST_ASSERT_EQUAL(500, h.sumX);
+  TEST_ASSERT_EQUAL(-250, h.sumY);
+}
+
+void test_congestion_merges_stale_motion()
+{
+  Harness h;
+  harness_init(h, 7500, 2);
+  // 200 мс канал занят: движение не копится очередью отчетов, а сливается
+  for (int ms = 0; ms < 200; ms++)
+  {
+    report_scheduler_add_motion(h.s, 3, 1);
+    h.nowUs = ms * 1000;
+    harness_poll(h, REPORT_LINK_BUSY);
+  }
+  TEST_ASSERT_EQUAL_UINT32(0, h.reports);
+  TEST_ASSERT_GREATER_THAN(0, h.s.congestedPolls);
+  TEST_ASSERT_EQUAL_UINT32(199, h.s.mergedEvents);
+  // Предел — 2 отчета: после освобождения канала остаток уходит за 2 отчета, направление сохранено
+  TEST_ASSERT_EQUAL_INT32(254, h.s.pendingX);
+  TEST_ASSERT_EQUAL_INT32(84, h.s.pendingY);
+
+  for (int ms = 200; ms < 300; ms++)
+  {
+    h.nowUs = ms * 1000;
+    harness_poll(h);
+  }
+  TEST_ASSERT_EQUAL_UINT32(2, h.reports);
+  TEST_ASSERT_EQUAL(254, h.sumX);
+  TEST_ASSERT_EQUAL(84, h.sumY);
+}
+
+void test_click_within_one_interval_not_lost()
+{
+  Harness h;
+  harness_init(h, 7500);
+  h.nowUs = 0;
+  report_scheduler_add_motion(h.s, 1, 0);
+  harness_poll(h); // первый отчет открывает интервал
+
+  // Нажатие и отпускание между отчетами
+  report_scheduler_press(h.s, 1);
+  report_scheduler_release(h.s, 1);
+  report_scheduler_add_motion(h.s, 4, 4);
+  for (int ms = 1; ms < 40; ms++)
+  {
+    h.nowUs = ms * 1000;
+    harness_poll(h);
+  }
+  TEST_ASSERT_EQUAL_UINT32(2, h.buttonEdges); // нажатие и отпускание — отдельными отчетами
+  TEST_ASSERT_EQUAL_UINT8(0, h.buttons);
+  TEST_ASSERT_EQUAL_UINT32(3, h.reports);
+  TEST_ASSERT_EQUAL(5, h.sumX);
+  TEST_ASSERT_EQUAL(4, h.sumY);
+}
+
+void test_hold_and_drag()
+{
+  Harness h;
+  harness_init(h, 7500);
+  report_scheduler_press(h.s, 2);
+  h.nowUs = 0;
+  harness_poll(h);
+  TEST_ASSERT_EQUAL_UINT8(2, h.buttons);
+  for (int ms = 1; ms < 100; ms++)
+  {
+    report_scheduler_add_motion(h.s, 1, 0);
+    h.nowUs = ms * 1000;
+    harness_poll(h);
+  }
+  report_scheduler_release(h.s, 2);
+  for (int ms = 100; ms < 120; ms++)
+  {
+    h.nowUs = ms * 1000;
+    harness_poll(h);
+  }
+  TEST_ASSERT_EQUAL_UINT8(0, h.buttons);
+  TEST_ASSERT_EQUAL_UINT32(2, h.buttonEdges);
+  TEST_ASSERT_EQUAL(99, h.sumX);
+}
+
+void test_wheel_merged_and_split()
+{
+  Harness h;
+  harness_init(h, 7500);
+  // Щелчки от датчика 1 кГц сливаются в отчеты, быстрая прокрутка делится по 127
+  for (int ms = 0; ms < 20; ms++)
+  {
+    report_scheduler_add_wheel(h.s, ms < 10 ? 1 : -30);
+    report_scheduler_add_motion(h.s, 0, 0);
+    h.nowUs = ms * 1000;
+    harness_poll(h);
+  }
+  for (int ms = 20; ms < 100; ms++)
+  {
+    h.nowUs = ms * 1000;
+    harness_poll(h);
+  }
+  TEST_ASSERT_EQUAL(10 - 300, h.sumWheel);
+  TEST_ASSERT_LESS_OR_EQUAL(127, h.maxWheel);
+  TEST_ASSERT_EQUAL(0, h.sumX);
+  TEST_ASSERT_FALSE(report_scheduler_pending(h.s));
+}
+
+void test_disconnect_drops_stale_motion_and_clicks()
+{
+  Harness h;
+  harness_init(h, 7500);
+  report_scheduler_press(h.s, 2); // держат во время отключения
+  h.nowUs = 0;
+  harness_poll(h);
+  TEST_ASSERT_EQUAL_UINT8(2, h.buttons);
+
+  // 300 мс без хоста: движение, колесо и клик не копятся
+  for (int ms = 1; ms < 300; ms++)
+  {
+    report_scheduler_add_motion(h.s, 5, -3);
+    report_scheduler_add_wheel(h.s, 1);
+    if (ms == 100)
+    {
+      report_scheduler_press(h.s, 1);
+      report_scheduler_release(h.s, 1);
+    }
+    h.nowUs = ms * 1000;
+    harness_poll(h, REPORT_LINK_DISCONNECTED);
+  }
+  TEST_ASSERT_EQUAL_UINT32(1, h.reports);
+  TEST_ASSERT_GREATER_THAN(0, h.s.disconnects);
+  TEST_ASSERT_EQUAL_UINT32(0, h.s.congestedPolls);
+
+  // Хост вернулся: одно сообщение с удерживаемой кнопкой, без скачка и без старого клика
+  h.buttons = 0; // хост после подключения не помнит кнопок
+  h.buttonEdges = 0;
+  for (int ms = 300; ms < 400; ms++)
+  {
+    h.nowUs = ms * 1000;
+    harness_poll(h);
+  }
+  TEST_ASSERT_EQUAL_UINT32(2, h.reports);
+  TEST_ASSERT_EQUAL_UINT8(2, h.buttons);
+  TEST_ASSERT_EQUAL_UINT32(1, h.buttonEdges);
+  TEST_ASSERT_EQUAL(0, h.sumX);
+  TEST_ASSERT_EQUAL(0, h.sumY);
+  TEST_ASSERT_EQUAL(0, h.sumWheel);
+}
+
+int main(int argc, char **argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_rate_limited_and_displacement_preserved);
+  RUN_TEST(test_idle_sends_nothing);
+  RUN_TEST(test_first_report_after_idle_is_immediate);
+  RUN_TEST(test_large_motion_split_over_intervals);
+  RUN_TEST(test_congestion_merges_stale_motion);
+  RUN_TEST(test_click_within_one_interval_not_lost);
+  RUN_TEST(test_hold_and_drag);
+  RUN_TEST(test_wheel_merged_and_split);
+  RUN_TEST(test_disconnect_drops_stale_motion_and_clicks);
+  return UNITY_END();
+}
@@ -0,0 +1,152 @@
+#include <unity.h>
+#include <math.h>
+#include "scroll.h"
+
+// Параметры как в config.h: сигмоида 0.5 -> 4.0 с центром 0.8 градуса за 10 мс
+static ScrollSettings default_settings()
+{
+  ScrollSettings s = {};
+  s.curve.type = ACCEL_CURVE_SIGMOID;
+  s.curve.minGain = 0.5f;
+  s.curve.maxGain = 4.0f;
+  s.curve.threshold = 0.8f;
+  s.curve.param = 0.2f;
+  s.sensitivity = 0.3f;
+  s.deadzone = 0.1f;
+  s.invert = 0;
+  s.layers = 0;
+  return s;
+}
+
+static ScrollConfig build(const ScrollSettings &settings)
+{
+  ScrollConfig cfg;
+  scroll_config_build(settings, cfg);
+  return cfg;
+}
+
+struct ScrollRun
+{
+  long total;   // сумма щелчков
+  int reports;  // отсчетов с ненулевым колесом
+  int maxStep;  // наибольший щелчок за отсчет
+};
+
+// Равномерный наклон: angle меняется на degrees за seconds с частотой hz
+static ScrollRun tilt(const ScrollConfig &cfg, float start, float degrees, float seconds, uint32_t hz)
+{
+  ScrollState state;
+  scroll_state_reset(state);
+  ScrollRun run = {0, 0, 0};
+  uint32_t dtUs = 1000000 / hz;
+  int n = (int)(seconds * hz);
+  for (int i = 0; i <= n; i++)
+  {
+    float angle = start + degrees * i / n;
+    if (angle >= 180.0f)
+      angle -= 360.0f;
+    int32_t wheel;
+    if (scroll_process(state, cfg, angle, dtUs, wheel))
+    {
+      run.total += wheel;
+      run.reports++;
+      if (abs(wheel) > run.maxStep)
+        run.maxStep = abs(wheel);
+    }
+  }
+  return run;
+}
+
+void test_slow_tilt_accumulates_fractions()
+{
+  ScrollConfig cfg = build(default_settings());
+  // 20 градусов за секунду: 0.2 градуса за 10 мс, на отсчет — доли щелчка
+  ScrollRun run = tilt(cfg, 0, -20.0f, 1.0f, 200);
+  int expected = (int)(20.0f * cfg.gain[(int)(0.2f / ACCEL_LUT_STEP)]);
+  TEST_ASSERT_INT_WITHIN(1, expected, run.total);
+  TEST_ASSERT_GREATER_THAN(1, run.reports);
+  TEST_ASSERT_EQUAL(1, run.maxStep);
+}
+
+void test_direction_and_invert()
+{
+  ScrollSettings settings = default_settings();
+  ScrollConfig cfg = build(settings);
+  // angle убывает при подъеме носа — прокрутка вверх
+  TEST_ASSERT_GREATER_THAN(0, tilt(cfg, 0, -30.0f, 0.5f, 200).total);
+  TEST_ASSERT_LESS_THAN(0, tilt(cfg, 0, 30.0f, 0.5f, 200).total);
+  settings.invert = 1;
+  cfg = build(settings);
+  TEST_ASSERT_LESS_THAN(0, tilt(cfg, 0, -30.0f, 0.5f, 200).total);
+}
+
+void test_independent_of_sample_rate()
+{
+  ScrollConfig cfg = build(default_settings());
+  long a = tilt(cfg, 0, -40.0f, 1.0f, 100).total;
+  long b = tilt(cfg, 0, -40.0f, 1.0f, 400).total;
+  TEST_ASSERT_INT_WITHIN(1, a, b);
+}
+
+void test_fast_tilt_accelerates()
+{
+  ScrollConfig cfg = build(default_settings());
+  // Тот же угол: медленно — построчно, резко — в разы больше щелчков
+  long slow = tilt(cfg, 0, -20.0f, 1.0f, 200).total;
+  long fast = tilt(cfg, 0, -20.0f, 0.1f, 200).total;
+  TEST_ASSERT_GREATER_THAN(slow * 3, fast);
+}
+
+void test_tremor_inside_deadzone()
+{
+  ScrollConfig cfg = build(default_settings());
+  ScrollState state;
+  scroll_state_reset(state);
+  long total = 0;
+  // Тремор 9 Гц с амплитудой 0.1 градуса: до 0.057 градуса за 10 мс
+  for (int i = 0; i < 2000; i++)
+  {
+    float angle = 0.1f * sinf(i * 0.005f * 2 * 3.14159f * 9.0f);
+    int32_t wheel;
+    if (scroll_process(state, cfg, angle, 5000, wheel))
+      total += wheel;
+  }
+  TEST_ASSERT_EQUAL(0, total);
+  TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0, state.rem);
+}
+
+void test_wrap_is_small_step()
+{
+  ScrollConfig cfg = build(default_settings());
+  // Переход через ±180 — та же прокрутка, что и вдали от границы
+  long nearWrap = tilt(cfg, 170.0f, 20.0f, 1.0f, 200).total;
+  long plain = tilt(cfg, 0, 20.0f, 1.0f, 200).total;
+  TEST_ASSERT_INT_WITHIN(1, plain, nearWrap);
+}
+
+void test_sanitize_rejects_invalid()
+{
+  ScrollSettings s = default_settings();
+  TEST_ASSERT_TRUE(scroll_settings_sanitize(s));
+  s.sensitivity = 0;
+  TEST_ASSERT_FALSE(scroll_settings_sanitize(s));
+  s = default_settings();
+  s.deadzone = NAN;
+  TEST_ASSERT_FALSE(scroll_settings_sanitize(s));
+  s = default_settings();
+  s.curve.type = ACCEL_CURVE_COUNT;
+  TEST_ASSERT_FALSE(scroll_settings_sanitize(s));
+}
+
+int main(int argc, char **argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_slow_tilt_accumulates_fractions);
+  RUN_TEST(test_direction_and_invert);
+  RUN_TEST(test_independent_of_sample_rate);
+  RUN_TEST(test_fast_tilt_accelerates);
+  RUN_TEST(test_tremor_inside_deadzone);
+  RUN_TEST(test_wrap_is_small_step);
+  RUN_TEST(test_sanitize_rejects_invalid);
+  return UNITY_END();
+}
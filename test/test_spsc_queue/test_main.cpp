@@ -0,0 +1,182 @@
+#include <unity.h>
+#include <stdio.h>
+#include <chrono>
+#include <thread>
+#include "spsc_queue.h"
+#include "input_events.h"
+
+void test_fifo_full_and_drop()
+{
+  static SpscQueue<uint32_t, 8> q;
+  spsc_reset(q);
+  uint32_t v;
+  TEST_ASSERT_FALSE(spsc_pop(q, v));
+  for (uint32_t i = 0; i < 8; i++)
+    TEST_ASSERT_TRUE(spsc_push(q, i));
+  TEST_ASSERT_EQUAL_UINT32(8, spsc_size(q));
+  TEST_ASSERT_FALSE(spsc_push(q, 99u));
+  TEST_ASSERT_EQUAL_UINT32(1, q.dropped);
+  for (uint32_t i = 0; i < 8; i++)
+  {
+    TEST_ASSERT_TRUE(spsc_pop(q, v));
+    TEST_ASSERT_EQUAL_UINT32(i, v);
+  }
+  TEST_ASSERT_FALSE(spsc_pop(q, v));
+  TEST_ASSERT_EQUAL_UINT32(0, spsc_size(q));
+}
+
+void test_index_wrap()
+{
+  // Индексы переполняют uint32_t — порядок и заполненность не ломаются
+  static SpscQueue<uint32_t, 4> q;
+  spsc_reset(q);
+  q.head = q.tail = 0xFFFFFFFEu;
+  q.tailSeen = q.headSeen = 0xFFFFFFFEu;
+  uint32_t v;
+  for (uint32_t round = 0; round < 3; round++)
+  {
+    for (uint32_t i = 0; i < 4; i++)
+      TEST_ASSERT_TRUE(spsc_push(q, round * 10 + i));
+    TEST_ASSERT_FALSE(spsc_push(q, 0u));
+    for (uint32_t i = 0; i < 4; i++)
+    {
+      TEST_ASSERT_TRUE(spsc_pop(q, v));
+      TEST_ASSERT_EQUAL_UINT32(round * 10 + i, v);
+    }
+  }
+  TEST_ASSERT_EQUAL_UINT32(3, q.dropped);
+}
+
+void test_events_keep_fields()
+{
+  static InputEventQueue q;
+  spsc_reset(q);
+  InputEvent e = {};
+  e.tUs = 123456;
+  e.type = INPUT_EVENT_KEYS;
+  e.index = 2;
+  e.pins = 0xFEFF;
+  TEST_ASSERT_TRUE(spsc_push(q, e));
+  e = {};
+  e.type = INPUT_EVENT_MOTION;
+  e.dx = -300;
+  e.dy = 7;
+  e.wheel = -1;
+  TEST_ASSERT_TRUE(spsc_push(q, e));
+  InputEvent r;
+  TEST_ASSERT_TRUE(spsc_pop(q, r));
+  TEST_ASSERT_EQUAL_UINT32(123456, r.tUs);
+  TEST_ASSERT_EQUAL_UINT8(INPUT_EVENT_KEYS, r.type);
+  TEST_ASSERT_EQUAL_UINT8(2, r.index);
+  TEST_ASSERT_EQUAL_UINT16(0xFEFF, r.pins);
+  TEST_ASSERT_TRUE(spsc_pop(q, r));
+  TEST_ASSERT_EQUAL_INT16(-300, r.dx);
+  TEST_ASSERT_EQUAL_INT16(7, r.dy);
+  TEST_ASSERT_EQUAL_INT16(-1, r.wheel);
+}
+
+// Писатель и читатель в разных потоках: каждое событие приходит один раз, по порядку и целиком.
+// Поля связаны между собой — рваное чтение элемента сразу видно
+#define STRESS_COUNT 1000000u
+
+static InputEventQueue stressQueue;
+
+// Ожидание другой стороны: сначала крутимся, потом отдаем процессор (на одноядерной машине иначе ждем конца кванта)
+static void backoff(uint32_t &spins)
+{
+  if (++spins < 64)
+    std::this_thread::yield();
+  else
+    std::this_thread::sleep_for(std::chrono::microseconds(10));
+}
+
+static void stress_producer()
+{
+  uint32_t spins = 0;
+  for (uint32_t i = 0; i < STRESS_COUNT;)
+  {
+    InputEvent e = {};
+    e.tUs = i;
+    e.type = INPUT_EVENT_MOTION;
+    e.index = (uint8_t)i;
+    e.pins = (uint16_t)~i;
+    e.dx = (int16_t)i;
+    e.dy = (int16_t)(i >> 16);
+    e.wheel = (int16_t)(i ^ 0x5A5A);
+    if (spsc_push(stressQueue, e))
+    {
+      i++;
+      spins = 0;
+    }
+    else
+      backoff(spins);
+  }
+}
+
+void test_two_threads()
+{
+  spsc_reset(stressQueue);
+  auto start = std::chrono::steady_clock::now();
+  std::thread producer(stress_producer);
+  uint32_t expected = 0, torn = 0, order = 0, spins = 0;
+  InputEvent e;
+  while (expected < STRESS_COUNT)
+  {
+    if (!spsc_pop(stressQueue, e))
+    {
+      backoff(spins);
+      continue;
+    }
+    spins = 0;
+    if (e.tUs != expected)
+      order++;
+    if (e.index != (uint8_t)e.tUs || e.pins != (uint16_t)~e.tUs || e.dx != (int16_t)e.tUs ||
+        e.dy != (int16_t)(e.tUs >> 16) || e.wheel != (int16_t)(e.tUs ^ 0x5A5A))
+      torn++;
+    expected = e.tUs + 1;
+  }
+  producer.join();
+  double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  char msg[128];
+  snprintf(msg, sizeof(msg), "2 threads: %u events in %.3f s, %.1f M events/s, %u full-queue retries",
+           STRESS_COUNT, sec, STRESS_COUNT / sec / 1e6, (unsigned)stressQueue.dropped);
+  TEST_MESSAGE(msg);
+  TEST_ASSERT_EQUAL_UINT32(0, order);
+  TEST_ASSERT_EQUAL_UINT32(0, torn);
+  TEST_ASSERT_FALSE(spsc_pop(stressQueue, e));
+}
+
+void test_single_thread_ops()
+{
+  // Стоимость самой пары push/pop без ожидания другого ядра
+  static InputEventQueue q;
+  spsc_reset(q);
+  const uint32_t n = 10000000;
+  InputEvent e = {}, r = {};
+  uint32_t sum = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < n; i++)
+  {
+    e.tUs = i;
+    spsc_push(q, e);
+    spsc_pop(q, r);
+    sum += r.tUs;
+  }
+  double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  char msg[96];
+  snprintf(msg, sizeof(msg), "push+pop: %.1f M ops/s (%.2f ns/pair)", 2.0 * n / sec / 1e6, sec * 1e9 / n);
+  TEST_MESSAGE(msg);
+  TEST_ASSERT_EQUAL_UINT32((uint32_t)((uint64_t)n * (n - 1) / 2), sum);
+}
+
+int main(int argc, char **argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_fifo_full_and_drop);
+  RUN_TEST(test_index_wrap);
+  RUN_TEST(test_events_keep_fields);
+  RUN_TEST(test_two_threads);
+  RUN_TEST(test_single_thread_ops);
+  return UNITY_END();
+}
@@ -0,0 +1,120 @@
+#include <unity.h>
+#include <math.h>
+#include "stillness.h"
+
+static uint32_t rng_state = 99;
+static float noise(float amplitude)
+{
+  rng_state = rng_state * 1664525u + 1013904223u;
+  return ((int32_t)(rng_state >> 8) % 2001 - 1000) / 1000.0f * amplitude;
+}
+
+static StillnessConfig default_config()
+{
+  StillnessConfig cfg = {0.0004f, 1.0f, 1500000, 200000};
+  return cfg;
+}
+
+// Лежит на столе: шум датчика
+static ImuSample table_sample()
+{
+  ImuSample s = {noise(0.01f), noise(0.01f), 1.0f + noise(0.01f), noise(0.3f), noise(0.3f), noise(0.3f), 30.0f};
+  return s;
+}
+
+// В руке: тремор 8-10 Гц
+static ImuSample hand_sample(float t)
+{
+  float tremor = sinf(t * 2 * 3.14159f * 9.0f);
+  ImuSample s = {0.03f * tremor + noise(0.01f), noise(0.01f), 1.0f + noise(0.01f), 2.5f * tremor + noise(0.3f), 1.5f * tremor, noise(0.3f), 30.0f};
+  return s;
+}
+
+// Время до покоя (мкс) на столе при заданной частоте
+static uint32_t time_to_still(uint32_t periodUs)
+{
+  StillnessDetector d;
+  stillness_init(d, default_config());
+  for (uint32_t t = 0; t < 5000000; t += periodUs)
+  {
+    ImuSample s = table_sample();
+    if (stillness_update(d, s, periodUs))
+      return t;
+  }
+  return 0xFFFFFFFF;
+}
+
+void test_enters_still_on_table()
+{
+  uint32_t t = time_to_still(5000);
+  TEST_ASSERT_GREATER_OR_EQUAL(1500000, t);
+  TEST_ASSERT_LESS_THAN(2500000, t);
+}
+
+void test_rate_independent()
+{
+  // 200 Гц и 25 Гц в покое дают одинаковое время входа
+  uint32_t fast = time_to_still(5000);
+  uint32_t slow = time_to_still(40000);
+  TEST_ASSERT_UINT32_WITHIN(200000, fast, slow);
+}
+
+void test_hand_tremor_is_not_still()
+{
+  StillnessDetector d;
+  stillness_init(d, default_config());
+  for (int i = 0; i < 2000; i++)
+    stillness_update(d, hand_sample(i * 0.005f), 5000);
+  TEST_ASSERT_FALSE(d.still);
+  TEST_ASSERT_EQUAL_UINT32(0, d.transitions);
+}
+
+void test_pickup_exits_quickly_at_low_rate()
+{
+  StillnessDetector d;
+  stillness_init(d, default_config());
+  for (int i = 0; i < 100; i++)
+    stillness_update(d, table_sample(), 40000);
+  TEST_ASSERT_TRUE(d.still);
+
+  // Подъем со стола: поворот 30 град/с
+  int samples = 0;
+  while (d.still && samples < 10)
+  {
+    ImuSample s = table_sample();
+    s.gyroX += 30.0f;
+    s.accY += 0.1f;
+    stillness_update(d, s, 40000);
+    samples++;
+  }
+  TEST_ASSERT_FALSE(d.still);
+  TEST_ASSERT_EQUAL(1, samples);
+  TEST_ASSERT_EQUAL_UINT32(2, d.transitions);
+}
+
+void test_slow_drift_in_hand_resets_timer()
+{
+  // Короткие паузы меньше enterUs не переводят в покой
+  StillnessDetector d;
+  stillness_init(d, default_config());
+  for (int cycle = 0; cycle < 5; cycle++)
+  {
+    for (int i = 0; i < 200; i++) // 1 с покоя
+      stillness_update(d, table_sample(), 5000);
+    for (int i = 0; i < 40; i++) // 0.2 с движения
+      stillness_update(d, hand_sample(i * 0.005f), 5000);
+  }
+  TEST_ASSERT_FALSE(d.still);
+  TEST_ASSERT_EQUAL_UINT32(0, d.transitions);
+}
+
+int main(int argc, char **argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_enters_still_on_table);
+  RUN_TEST(test_rate_independent);
+  RUN_TEST(test_hand_tremor_is_not_still);
+  RUN_TEST(test_pickup_exits_quickly_at_low_rate);
+  RUN_TEST(test_slow_drift_in_hand_resets_timer);
+  return UNITY_END();
+}
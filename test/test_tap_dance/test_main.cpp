@@ -0,0 +1,246 @@
+#include <unity.h>
+#include <string.h>
+#include "button_engine.h"
+#include "tap_dance.h"
+
+#define TICK_MS 10
+static const ButtonTiming timing = {50, 500, 400, 500, TICK_MS};
+
+// Фронт кнопки с отметкой времени, как их видит update_button_fsm
+struct Edge
+{
+  uint32_t t;
+  uint8_t key;
+  bool down;
+};
+
+// Что выполнилось бы: действие серии (code записи) или обычное действие события
+struct Fired
+{
+  uint32_t t;
+  uint8_t key;
+  int16_t tapCode; // -1 — обычное действие события event
+  uint8_t event;
+};
+
+static TapDanceTable table;
+static TapDanceState state;
+static ButtonEngine engine;
+static Fired fired[64];
+static uint32_t firedCount;
+static uint32_t nowMs;
+static uint8_t layer;
+
+static void on_event(void *ctx, uint8_t key, uint8_t event, uint8_t taps)
+{
+  bool suppress = false;
+  const TapDanceEntry *e = tap_dance_on_event(table, state, layer, key, event, taps, suppress);
+  if (e && firedCount < 64)
+    fired[firedCount++] = {nowMs, key, e->code, event};
+  if (!suppress && event <= BUTTON_EVENT_RELEASE && firedCount < 64)
+    fired[firedCount++] = {nowMs, key, -1, event};
+}
+
+// Отсчеты раз в TICK_MS до endMs; фронты применяются на ближайшем отсчете
+static void play(const Edge *edges, uint8_t count, uint32_t endMs)
+{
+  button_engine_init(engine, timing, 16);
+  KeyBits defer;
+  tap_dance_layer_keys(table, layer, defer);
+  button_engine_set_defer_click(engine, defer);
+  tap_dance_state_init(state);
+  firedCount = 0;
+
+  KeyBits raw;
+  key_bits_clear(raw);
+  uint8_t next = 0;
+  for (nowMs = 0; nowMs <= endMs; nowMs += TICK_MS)
+  {
+    for (; next < count && edges[next].t <= nowMs; next++)
+    {
+      if (edges[next].down)
+        key_bits_set(raw, edges[next].key);
+      else
+        key_bits_clear_bit(raw, edges[next].key);
+    }
+    button_engine_tick(engine, raw, nowMs, on_event, nullptr);
+  }
+}
+
+static uint8_t taps_edges(Edge *out, uint8_t key, uint32_t startMs, uint8_t taps, uint32_t lastDownMs = 80)
+{
+  uint32_t t = startMs;
+  for (uint8_t i = 0; i < taps; i++)
+  {
+    out[i * 2] = {t, key, true};
+    t += i + 1 < taps ? 80 : lastDownMs;
+    out[i * 2 + 1] = {t, key, false};
+    t += 120;
+  }
+  return taps * 2;
+}
+
+static void add(uint8_t l, uint8_t key, uint8_t taps, bool hold, int16_t code)
+{
+  TEST_ASSERT_TRUE(tap_dance_set(table, {l, key, taps, hold, 1, code, 0}));
+}
+
+static uint32_t count_plain(uint8_t event)
+{
+  uint32_t n = 0;
+  for (uint32_t i = 0; i < firedCount; i++)
+    n += fired[i].tapCode < 0 && fired[i].event == event;
+  return n;
+}
+
+static const Fired *find_tap(int16_t code)
+{
+  for (uint32_t i = 0; i < firedCount; i++)
+    if (fired[i].tapCode == code)
+      return &fired[i];
+  return nullptr;
+}
+
+void setUp()
+{
+  tap_dance_init(table);
+  layer = 0;
+}
+
+void tearDown() {}
+
+void test_table_set_replace_remove()
+{
+  add(0, 3, 3, false, 100);
+  add(0, 3, 3, false, 101); // та же серия — замена
+  add(1, 3, 3, false, 200);
+  add(0, 3, 2, true, 300);
+  TEST_ASSERT_EQUAL_UINT8(3, table.count);
+  TEST_ASSERT_EQUAL_INT16(101, tap_dance_find(table, 0, 3, 3, false)->code);
+  TEST_ASSERT_NULL(tap_dance_find(table, 0, 3, 3, true));
+
+  // Неверные серии: 1-2 клика без удержания — это click/dblclick, 0 кликов с удержанием — обычный hold
+  TEST_ASSERT_FALSE(tap_dance_set(table, {0, 3, 2, false, 1, 0, 0}));
+  TEST_ASSERT_FALSE(tap_dance_set(table, {0, 3, 0, true, 1, 0, 0}));
+  TEST_ASSERT_FALSE(tap_dance_set(table, {0, 3, TAP_DANCE_MAX_TAPS + 1, false, 1, 0, 0}));
+
+  TEST_ASSERT_TRUE(tap_dance_set(table, {0, 3, 3, false, 0, 0, 0})); // type 0 — удалить
+  TEST_ASSERT_EQUAL_UINT8(2, table.count);
+  TEST_ASSERT_NULL(tap_dance_find(table, 0, 3, 3, false));
+  TEST_ASSERT_EQUAL_INT16(300, tap_dance_find(table, 0, 3, 2, true)->code);
+
+  KeyBits keys;
+  tap_dance_layer_keys(table, 0, keys);
+  TEST_ASSERT_EQUAL_UINT32(1u << 3, keys.w[0]);
+
+  for (uint8_t k = 0; table.count < TAP_DANCE_MAX; k++)
+    add(2, k, 4, false, k);
+  TEST_ASSERT_FALSE(tap_dance_set(table, {3, 0, 4, false, 1, 0, 0}));
+  TEST_ASSERT_TRUE(tap_dance_set(table, {2, 0, 4, false, 1, 7, 0})); // замена в полной таблице
+}
+
+void test_triple_and_quadruple()
+{
+  add(0, 5, 3, false, 3);
+  add(0, 5, 4, false, 4);
+  Edge edges[16];
+
+  uint8_t n = taps_edges(edges, 5, 100, 3);
+  play(edges, n, 2000);
+  const Fired *f = find_tap(3);
+  TEST_ASSERT_NOT_NULL(f);
+  TEST_ASSERT_EQUAL_UINT8(BUTTON_EVENT_TAPS, f->event);
+  // Третье отпускание — 100 + 3 * 80 + 2 * 120, действие — через clickTimeoutMs
+  TEST_ASSERT_EQUAL_UINT32(100 + 3 * 80 + 2 * 120 + 400, f->t);
+  TEST_ASSERT_NULL(find_tap(4));
+  TEST_ASSERT_EQUAL_UINT32(0, count_plain(BUTTON_EVENT_CLICK)); // у кнопки есть серии — CLICK отложен и не нужен
+  TEST_ASSERT_EQUAL_UINT32(3, count_plain(BUTTON_EVENT_RELEASE));
+
+  n = taps_edges(edges, 5, 100, 4);
+  play(edges, n, 2000);
+  TEST_ASSERT_NOT_NULL(find_tap(4));
+  TEST_ASSERT_NULL(find_tap(3));
+
+  // Пять кликов: записи нет — ничего, кроме отпусканий
+  n = taps_edges(edges, 5, 100, 5);
+  play(edges, n, 3000);
+  TEST_ASSERT_EQUAL_UINT32(5, firedCount);
+}
+
+void test_single_click_still_fires()
+{
+  add(0, 5, 3, false, 3);
+  Edge edges[4];
+  uint8_t n = taps_edges(edges, 5, 100, 1);
+  play(edges, n, 1000);
+  TEST_ASSERT_EQUAL_UINT32(1, count_plain(BUTTON_EVENT_CLICK));
+  TEST_ASSERT_NULL(find_tap(3));
+}
+
+void test_tap_then_hold()
+{
+  add(0, 5, 2, true, 22);
+  Edge edges[8];
+  // Два клика, третье нажатие держат 900 мс
+  uint8_t n = taps_edges(edges, 5, 100, 3, 900);
+  play(edges, n, 3000);
+  const Fired *f = find_tap(22);
+  TEST_ASSERT_NOT_NULL(f);
+  TEST_ASSERT_EQUAL_UINT8(BUTTON_EVENT_HOLD_START, f->event);
+  TEST_ASSERT_EQUAL_UINT32(100 + 2 * 200 + 500, f->t); // holdMs от начала третьего нажатия
+  // Удержание целиком ушло в серию: обычных hold и holdRelease нет
+  TEST_ASSERT_EQUAL_UINT32(0, count_plain(BUTTON_EVENT_HOLD_START));
+  TEST_ASSERT_EQUAL_UINT32(0, count_plain(BUTTON_EVENT_HOLD_RELEASE));
+  TEST_ASSERT_EQUAL_UINT32(0, count_plain(BUTTON_EVENT_DOUBLE));
+  TEST_ASSERT_EQUAL_UINT32(0, count_plain(BUTTON_EVENT_CLICK));
+
+  // Без кликов перед удержанием — обычное удержание
+  Edge hold[] = {{100, 5, true}, {1000, 5, false}};
+  play(hold, 2, 2000);
+  TEST_ASSERT_NULL(find_tap(22));
+  TEST_ASSERT_EQUAL_UINT32(1, count_plain(BUTTON_EVENT_HOLD_START));
+  TEST_ASSERT_EQUAL_UINT32(1, count_plain(BUTTON_EVENT_HOLD_RELEASE));
+}
+
+void test_one_tap_hold_replaces_one_click_hold()
+{
+  add(0, 5, 1, true, 11);
+  Edge edges[4];
+  uint8_t n = taps_edges(edges, 5, 100, 2, 1500);
+  play(edges, n, 3000);
+  TEST_ASSERT_NOT_NULL(find_tap(11));
+  TEST_ASSERT_EQUAL_UINT32(0, count_plain(BUTTON_EVENT_ONE_CLICK_HOLD));
+  TEST_ASSERT_EQUAL_UINT32(0, count_plain(BUTTON_EVENT_HOLD_RELEASE));
+}
+
+void test_layers_and_other_keys()
+{
+  add(1, 5, 3, false, 3);
+  Edge edges[16];
+  uint8_t n = taps_edges(edges, 5, 100, 3);
+  play(edges, n, 2000); // слой 0: серии нет, клики сразу
+  TEST_ASSERT_NULL(find_tap(3));
+  TEST_ASSERT_EQUAL_UINT32(3, count_plain(BUTTON_EVENT_CLICK));
+
+  layer = 1;
+  play(edges, n, 2000);
+  TEST_ASSERT_NOT_NULL(find_tap(3));
+
+  // Серии на кнопке 5 не мешают соседней кнопке 6
+  n = taps_edges(edges, 6, 100, 3);
+  play(edges, n, 2000);
+  TEST_ASSERT_NULL(find_tap(3));
+  TEST_ASSERT_EQUAL_UINT32(3, count_plain(BUTTON_EVENT_CLICK));
+}
+
+int main(int argc, char **argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_table_set_replace_remove);
+  RUN_TEST(test_triple_and_quadruple);
+  RUN_TEST(test_single_click_still_fires);
+  RUN_TEST(test_tap_then_hold);
+  RUN_TEST(test_one_tap_hold_replaces_one_click_hold);
+  RUN_TEST(test_layers_and_other_keys);
+  return UNITY_END();
+}